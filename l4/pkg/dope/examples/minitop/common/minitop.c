@@ -49,7 +49,8 @@ static void update_thread(void *arg) {
 		max = minitop_get_num();
 		if (max > DISPLAY_MAX_THREADS) max = DISPLAY_MAX_THREADS;
 
-		/* update bars for available threads */
+		/* update bars for available threads, all in one call to DOpE */
+		dope_batch_begin(app_id);
 		for (i=0; i<max; i++) {
 			dope_cmdf(app_id, "tid%d.set(-text \"%x.%x\")",
 			 i+1, minitop_get_taskid(i), minitop_get_threadid(i));
@@ -64,6 +65,7 @@ static void update_thread(void *arg) {
 		for ( ; i<DISPLAY_MAX_THREADS; i++) {
 			dope_cmdf(app_id, "ld%d.barconfig(load, -value 0)", i+1);
 		}
+		dope_batch_end(app_id, NULL, 0);
 
 		/* wait until next update */
 		minitop_usleep((long)(update_rate * 1000.0 * 1000.0));
@@ -83,6 +85,7 @@ int main(int argc,char **argv) {
 	#include "minitop.dpi"
 	
 	/* create list of load displays and place them into a grid */
+	dope_batch_begin(app_id);
 	for (i=1; i<=DISPLAY_MAX_THREADS; i++) {
 		dope_cmdf(app_id, "tid%d = new Label()", i);
 		dope_cmdf(app_id, "dg.place(tid%d, -column 1 -row %d -align e)", i,i);
@@ -98,6 +101,8 @@ int main(int argc,char **argv) {
 	}
 	dope_cmd( app_id, "df.set(-content dg)");
 	dope_cmdf(app_id, "dispwin.set(-workw 215 -workh 1000)");
+	if (dope_batch_end(app_id, NULL, 0))
+		printf("MiniTop: creating the load displays failed\n");
 	
 	/* start update thread */
 	minitop_thread_create(update_thread, NULL);
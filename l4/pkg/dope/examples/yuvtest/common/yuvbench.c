@@ -0,0 +1,106 @@
+/*
+ * \brief   YUV image cache benchmark
+ * \date    2026-10-19
+ *
+ * Replays the image traffic of a desktop with many YUV VScreens: a
+ * set of small, scaled VScreens and a few video-sized ones are
+ * refreshed with every frame, larger pictures only now and then. DOpE
+ * must be started with '--cachestats <sec>' to report the hit rate of
+ * its image cache.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the DOpE package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** DOpE SPECIFIC INCLUDES ***/
+#include "dopestd.h"
+#include <dopelib.h>
+#include <vscreen.h>
+
+/*** LOCAL INCLUDES ***/
+#include "startup.h"
+
+#define NUM_HOT    12      /* small scaled VScreens, refreshed often  */
+#define NUM_VIDEO   4      /* video-sized VScreens, refreshed always  */
+#define NUM_COLD    6      /* pictures, refreshed now and then        */
+#define NUM_VSCR   (NUM_HOT + NUM_VIDEO + NUM_COLD)
+#define NUM_FRAMES 2000
+
+static long app_id;
+static void *sync_server;     /* VScreen server used to wait for a frame */
+
+
+/*** OPEN WINDOW WITH A YUV VSCREEN OF THE GIVEN SIZE ***
+ *
+ * The window is bigger than the VScreen, which is scaled to fit.
+ */
+static void open_vscr(int i, int w, int h, int win_w, int win_h) {
+	char name[16];
+	u8 *fb;
+
+	dope_cmdf(app_id, "w%d = new Window()", i);
+	dope_cmdf(app_id, "v%d = new VScreen()", i);
+	dope_cmdf(app_id, "v%d.setmode(%d,%d,\"YUV420\")", i, w, h);
+	dope_cmdf(app_id, "v%d.set(-fixw none -fixh none)", i);
+	dope_cmdf(app_id, "w%d.set(-background off -content v%d)", i, i);
+	dope_cmdf(app_id, "w%d.set(-x %d -y %d -workw %d -workh %d)",
+	          i, 20 + (i % 6)*110, 20 + (i / 6)*140, win_w, win_h);
+	dope_cmdf(app_id, "w%d.open()", i);
+
+	/* mid gray, the content does not matter */
+	snprintf(name, sizeof(name), "v%d", i);
+	fb = vscr_get_fb(app_id, name);
+	if (fb) memset(fb, 128, w*h + w*h/2);
+
+	if (!sync_server) sync_server = vscr_get_server_id(app_id, name);
+}
+
+
+int main(int argc, char **argv) {
+	unsigned long r = 1;
+	int i, f;
+
+	native_startup(argc, argv);
+
+	if (dope_init()) return -1;
+	app_id = dope_init_app("YUV-Bench");
+
+	for (i = 0; i < NUM_HOT; i++)
+		open_vscr(i, 64 + 8*i, 48 + 6*i, 96 + 8*i, 72 + 6*i);
+	for (; i < NUM_HOT + NUM_VIDEO; i++)
+		open_vscr(i, 176, 144, 264, 216);
+	for (; i < NUM_VSCR; i++)
+		open_vscr(i, 320 + 16*(i - NUM_HOT - NUM_VIDEO), 240, 320, 240);
+
+	for (f = 0; f < NUM_FRAMES; f++) {
+		dope_batch_begin(app_id);
+
+		/* three quarters of the hot VScreens and all videos */
+		for (i = 0; i < NUM_HOT + NUM_VIDEO; i++) {
+			r = r*1103515245 + 12345;
+			if ((i < NUM_HOT) && ((r >> 16) % 4 == 0)) continue;
+			dope_cmdf(app_id, "v%d.refresh()", i);
+		}
+
+		/* one picture every eighth frame */
+		r = r*1103515245 + 12345;
+		if ((r >> 16) % 8 == 0)
+			dope_cmdf(app_id, "v%d.refresh()",
+			          NUM_HOT + NUM_VIDEO + (int)((r >> 8) % NUM_COLD));
+
+		dope_batch_end(app_id, NULL, 0);
+
+		/* wait until DOpE has drawn the frame */
+		vscr_server_waitsync(sync_server);
+	}
+	printf("YUV-Bench: %d frames replayed\n", NUM_FRAMES);
+
+	dope_eventloop(app_id);
+	return 0;
+}
@@ -39,4 +39,8 @@
 
 #define DOPECMD_WARN_TRUNC_RET_STR  11  /* return string was truncated */
 
+/*** limits of command batches, must match exec_batch in dope.idl ***/
+#define DOPE_BATCH_BUF_SIZE      4096  /* bytes of null-terminated commands   */
+#define DOPE_BATCH_MAX_ERRORS      32  /* failed commands reported per call   */
+
 #endif /* __DOPE_INCLUDE_DOPEDEF_H_ */
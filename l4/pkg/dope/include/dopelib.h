@@ -64,6 +64,11 @@ typedef union dopelib_event_union {
 	keyrepeat_event keyrepeat;
 } dope_event;
 
+typedef struct dope_batch_error {
+	int index;                      /* position of command in the batch */
+	int err;                        /* error code returned by DOpE */
+} dope_batch_error;
+
 
 /*** INITIALISE DOpE LIBRARY ***/
 L4_CV long  dope_init(void);
@@ -131,6 +136,34 @@ L4_CV int dope_reqf(long app_id, char *dst, int dst_size, const char *cmdf, ...)
   __attribute__((format (printf, 4, 5)));
 
 
+/*** START BATCH OF DOpE COMMANDS ***
+ *
+ * Until dope_batch_end is called, dope_cmd and dope_cmdf only queue their
+ * commands and return 0. The queued commands are transferred to DOpE with
+ * a single call when the batch buffer is full, before dope_req and
+ * dope_reqf, and by dope_batch_end. Batches may be nested, only the
+ * dope_batch_end matching the outermost dope_batch_begin executes the
+ * pending commands.
+ *
+ * \param app_id  DOpE application id
+ * \return        0 on success
+ */
+L4_CV int dope_batch_begin(long app_id);
+
+
+/*** EXECUTE PENDING COMMANDS AND FINISH BATCH ***
+ *
+ * \param app_id      DOpE application id
+ * \param errors      destination for index and error code of failed
+ *                    commands, may be NULL
+ * \param max_errors  capacity of errors
+ * \return            number of failed commands of the whole batch,
+ *                    0 for an inner batch of nested batches,
+ *                    negative if no batch was started
+ */
+L4_CV int dope_batch_end(long app_id, dope_batch_error *errors, int max_errors);
+
+
 /*** BIND AN EVENT TO A DOpE WIDGET ***
  *
  * \param app_id      DOpE application id
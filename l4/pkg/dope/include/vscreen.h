@@ -39,6 +39,19 @@ L4_CV void *vscr_map_smb(char *smb_ident);
 L4_CV void *vscr_get_fb(int app_id, const char *vscr_name);
 
 
+/*** RETURN LOCAL ADDRESS OF A FRAME BUFFER OF A MULTI-BUFFERED VSCREEN ***
+ *
+ * \param app_id     DOpE application id to which the VScreen widget belongs
+ * \param vscr_name  name of the VScreen widget
+ * \param buffer     index of the frame buffer
+ * \return           address of the frame buffer in the local address space
+ *
+ * The number of frame buffers is set via the VScreen's 'buffers'
+ * attribute. Buffer 0 is displayed initially.
+ */
+L4_CV void *vscr_get_buffer(int app_id, const char *vscr_name, int buffer);
+
+
 /*** RELEASE VSCREEN BUFFER FROM LOCAL ADDRESS SPACE ***
  *
  * \param fb_adr   start address of the vscreen buffer
@@ -93,3 +106,18 @@ L4_CV void  vscr_server_waitsync(void *vscr_server_id);
 L4_CV void  vscr_server_refresh(void *vscr_server_id, int x, int y, int w, int h);
 
 
+/*** PUBLISH COMPLETED FRAME OF A MULTI-BUFFERED VSCREEN ***
+ *
+ * \param buffer  index of the frame buffer that holds the new frame
+ * \return        index of the frame buffer to draw the next frame into,
+ *                or -1 on error
+ *
+ * For VScreens with a framerate, the frame is displayed with the next
+ * periodic redraw. With three buffers, this function never waits for
+ * the redraw. Frames that were not displayed yet are replaced by newer
+ * ones. With two buffers, the function returns after the new frame got
+ * displayed because the old frame is still on screen until then.
+ */
+L4_CV int   vscr_server_publish(void *vscr_server_id, int buffer);
+
+
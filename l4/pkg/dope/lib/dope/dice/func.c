@@ -59,6 +59,7 @@ long dope_init_app(const char *app_name) {
 		memset(app, 0, sizeof(struct dopelib_app));
 	}
 	dopelib_apps[id] = app;
+	app->batch_active = 0;
 
 	/* init event queue that is shared between listener and main thread */
 	if (dopelib_init_eventqueue(id) < 0) return -1;
@@ -91,6 +92,123 @@ long dope_deinit_app(long id) {
 
 
 
+/*** REMEMBER FAILED COMMAND OF A BATCH ***/
+static void batch_error(struct dopelib_app *app, int index, int err) {
+	if (app->batch_num_errs >= DOPE_BATCH_MAX_ERRORS) return;
+	app->batch_errs[app->batch_num_errs].index = index;
+	app->batch_errs[app->batch_num_errs].err   = err;
+	app->batch_num_errs++;
+}
+
+
+/*** TRANSFER QUEUED COMMANDS TO DOPE ***
+ *
+ * The caller must hold dopelib_cmd_mutex.
+ */
+static void submit_batch(struct dopelib_app *app) {
+	long errs[2*DOPE_BATCH_MAX_ERRORS];
+	int i, ret, errs_len = 2*DOPE_BATCH_MAX_ERRORS;
+	DICE_DECLARE_ENV(_env);
+
+	if (!app->batch_cnt) return;
+
+	ret = dope_manager_exec_batch_call(dope_server, app->app_id,
+	                                   app->batch_buf, app->batch_len,
+	                                   errs, &errs_len, &_env);
+	if (ret < 0) {
+
+		/* the whole batch was rejected */
+		for (i = 0; i < app->batch_cnt; i++)
+			batch_error(app, app->batch_base + i, ret);
+		app->batch_failed += app->batch_cnt;
+	} else {
+		for (i = 0; i + 1 < errs_len; i += 2)
+			batch_error(app, app->batch_base + errs[i], errs[i + 1]);
+		app->batch_failed += ret;
+	}
+
+	app->batch_base += app->batch_cnt;
+	app->batch_len   = 0;
+	app->batch_cnt   = 0;
+}
+
+
+/*** APPEND COMMAND TO THE BATCH BUFFER ***
+ *
+ * The caller must hold dopelib_cmd_mutex.
+ */
+static void queue_cmd(struct dopelib_app *app, const char *cmd) {
+	int ret, len = strlen(cmd) + 1;
+	DICE_DECLARE_ENV(_env);
+
+	if (app->batch_len + len > DOPE_BATCH_BUF_SIZE) submit_batch(app);
+
+	/* command does not fit into an empty batch, execute it on its own */
+	if (len > DOPE_BATCH_BUF_SIZE) {
+		ret = dope_manager_exec_cmd_call(dope_server, app->app_id, cmd, &_env);
+		if (ret < 0) {
+			batch_error(app, app->batch_base, ret);
+			app->batch_failed++;
+		}
+		app->batch_base++;
+		return;
+	}
+
+	memcpy(app->batch_buf + app->batch_len, cmd, len);
+	app->batch_len += len;
+	app->batch_cnt++;
+}
+
+
+/*** INTERFACE: START BATCH OF DOPE COMMANDS ***/
+int dope_batch_begin(long id) {
+	struct dopelib_app *app = get_app(id);
+	if (!app || !dope_server) return -1;
+
+	dopelib_mutex_lock(dopelib_cmd_mutex);
+
+	/* a nested begin keeps the pending commands and errors */
+	if (!app->batch_active) {
+		app->batch_len      = 0;
+		app->batch_cnt      = 0;
+		app->batch_base     = 0;
+		app->batch_failed   = 0;
+		app->batch_num_errs = 0;
+	}
+	app->batch_active++;
+	dopelib_mutex_unlock(dopelib_cmd_mutex);
+	return 0;
+}
+
+
+/*** INTERFACE: EXECUTE PENDING COMMANDS AND FINISH BATCH ***/
+int dope_batch_end(long id, dope_batch_error *errors, int max_errors) {
+	struct dopelib_app *app = get_app(id);
+	int i, ret;
+	if (!app) return -1;
+
+	dopelib_mutex_lock(dopelib_cmd_mutex);
+	if (!app->batch_active) {
+		dopelib_mutex_unlock(dopelib_cmd_mutex);
+		return -1;
+	}
+
+	/* only the outermost end executes the batch */
+	if (--app->batch_active) {
+		dopelib_mutex_unlock(dopelib_cmd_mutex);
+		return 0;
+	}
+	submit_batch(app);
+
+	for (i = 0; errors && (i < max_errors) && (i < app->batch_num_errs); i++)
+		errors[i] = app->batch_errs[i];
+
+	ret = app->batch_failed;
+	dopelib_mutex_unlock(dopelib_cmd_mutex);
+	return ret;
+}
+
+
 /*** INTERFACE: EXEC DOPE COMMAND AND REQUEST RESULT ***
  *
  * \param id       virtual DOpE application id
@@ -102,6 +220,12 @@ int dope_req(long id, char *res, int res_max, const char *cmd) {
 	struct dopelib_app *app = dopelib_apps[id];
 	DICE_DECLARE_ENV(_env);
 	if (!app || !cmd || !dope_server) return -1;
+
+	/* the request must see the effects of queued commands */
+	dopelib_mutex_lock(dopelib_cmd_mutex);
+	if (app->batch_active) submit_batch(app);
+	dopelib_mutex_unlock(dopelib_cmd_mutex);
+
 	return dope_manager_exec_req_call(dope_server, app->app_id,
 	                                  cmd, res, &res_max, &_env);
 }
@@ -136,6 +260,15 @@ int dope_reqf(long app_id, char *res, int res_max, const char *format, ...) {
 int dope_cmd(long id, const char *cmd) {
 	DICE_DECLARE_ENV(_env);
 	if (!cmd || (id < 0) || (id >= MAX_DOPE_CLIENTS) || !dopelib_apps[id]) return -1;
+
+	dopelib_mutex_lock(dopelib_cmd_mutex);
+	if (dopelib_apps[id]->batch_active) {
+		queue_cmd(dopelib_apps[id], cmd);
+		dopelib_mutex_unlock(dopelib_cmd_mutex);
+		return 0;
+	}
+	dopelib_mutex_unlock(dopelib_cmd_mutex);
+
 	return dope_manager_exec_cmd_call(dope_server, dopelib_apps[id]->app_id, cmd, &_env);
 }
 
@@ -22,6 +22,7 @@
 #define MAX_DOPE_CLIENTS 8
 
 #include "dopelib.h"
+#include "dopedef.h"
 #include "sync.h"
 
 struct dopelib_app {
@@ -34,6 +35,16 @@ struct dopelib_app {
 	struct dopelib_sem *queue_sem;
 	CORBA_Object_base listener;
 	void *listener_ptid;         /* only used by the linux version */
+
+	/* command batch between dope_batch_begin and dope_batch_end */
+	int  batch_active;           /* nesting depth of batches              */
+	int  batch_len;              /* bytes of queued commands              */
+	int  batch_cnt;              /* number of queued commands             */
+	int  batch_base;             /* index of the first queued command     */
+	int  batch_failed;           /* number of failed commands so far      */
+	int  batch_num_errs;         /* number of valid entries in batch_errs */
+	dope_batch_error batch_errs[DOPE_BATCH_MAX_ERRORS];
+	char batch_buf[DOPE_BATCH_BUF_SIZE];
 };
 
 extern struct dopelib_app *dopelib_apps[MAX_DOPE_CLIENTS];
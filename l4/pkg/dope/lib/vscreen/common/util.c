@@ -13,6 +13,9 @@
  * COPYING file for details.
  */
 
+/*** GENERAL INCLUDES ***/
+#include <string.h>
+
 /*** DOpE INCLUDES ***/
 #include "dopelib.h"
 #include "vscreen.h"
@@ -26,6 +29,15 @@ void *vscr_get_fb(int app_id, const char *vscr) {
 }
 
 
+/*** INTERFACE: MAP FRAME BUFFER OF A MULTI-BUFFERED VSCREEN WIDGET ***/
+void *vscr_get_buffer(int app_id, const char *vscr, int buffer) {
+	char retbuf[256];
+	dope_reqf(app_id, retbuf, 256, "%s.map(-buffer %d)", vscr, buffer);
+	if (!strncmp(retbuf, "Error", 5)) return NULL;
+	return vscr_map_smb(retbuf);
+}
+
+
 /*** INTERFACE: GET VSCREEN SERVER OF THE SPECIFIED WIDGET ***/
 void *vscr_get_server_id(int app_id, const char *vscr) {
 	char retbuf[256];
@@ -161,6 +161,15 @@ void vscr_server_refresh(void *id, int x, int y, int w, int h) {
 }
 
 
+/*** INTERFACE: PUBLISH FRAME OF A MULTI-BUFFERED VSCREEN ***/
+int vscr_server_publish(void *id, int buffer) {
+	CORBA_Environment env = dice_default_environment;
+	long i = ((long)id) - 1;
+	if (!valid_index(i)) return -1;
+	return dope_vscr_publish_call(&vscreens[i].tid, buffer, &env);
+}
+
+
 /*** INTERFACE: UNMAP FRAME BUFFER OF VSCREEN WIDGET ***/
 int vscr_free_fb(void *fb) {
 	return l4rm_detach(fb);
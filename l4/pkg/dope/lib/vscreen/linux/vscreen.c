@@ -118,6 +118,8 @@ void vscr_server_waitsync(void *id) {
 
 void vscr_server_refresh(void *id, int x, int y, int w, int h) { }
 
+int vscr_server_publish(void *id, int buffer) { return -1; }
+
 void *vscr_connect_server(char *ident) { return NULL; }
 
 void vscr_release_server_id(void *id) {}
@@ -0,0 +1,235 @@
+/*
+ * \brief   DOpE portable pixel line kernels and runtime selection
+ * \date    2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the DOpE package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#include "dopestd.h"
+#include "blit.h"
+
+static int scale_xbuf[MAX_SCALE_W];
+
+
+/*******************************
+ *** YUV420 TO RGB16 TABLES ***
+ *******************************/
+
+static const s32 Inverse_Table_6_9[8][4] = {
+	{117504, 138453, 13954, 34903}, /* no sequence_display_extension */
+	{117504, 138453, 13954, 34903}, /* ITU-R Rec. 709 (1990) */
+	{104597, 132201, 25675, 53279}, /* unspecified */
+	{104597, 132201, 25675, 53279}, /* reserved */
+	{104448, 132798, 24759, 53109}, /* FCC */
+	{104597, 132201, 25675, 53279}, /* ITU-R Rec. 624-4 System B, G */
+	{104597, 132201, 25675, 53279}, /* SMPTE 170M */
+	{117579, 136230, 16907, 35559}  /* SMPTE 240M (1987) */
+};
+
+static u16  tab_16[197 + 2*682 + 256 + 132];
+static u16 *table_rV[256];
+static u16 *table_gU[256];
+static int  table_gV[256];
+static u16 *table_bU[256];
+
+
+static int div_r(int dividend, int divisor) {
+	if (dividend > 0)
+		return (dividend + (divisor>>1)) / divisor;
+	else
+		return -((-dividend + (divisor>>1)) / divisor);
+}
+
+
+static void init_yuv2rgb(void) {
+	int i;
+	u8 table_Y[1024];
+	u16 *table_r, *table_g, *table_b;
+
+	int crv =  Inverse_Table_6_9[6][0];
+	int cbu =  Inverse_Table_6_9[6][1];
+	int cgu = -Inverse_Table_6_9[6][2];
+	int cgv = -Inverse_Table_6_9[6][3];
+
+	for (i = 0; i < 1024; i++) {
+		int j;
+		j = (76309 * (i - 384 - 16) + 32768) >> 16;
+		j = (j < 0) ? 0 : ((j > 255) ? 255 : j);
+		table_Y[i] = j;
+	}
+
+	table_r = tab_16 + 197;
+	table_b = tab_16 + 197 + 685;
+	table_g = tab_16 + 197 + 2*682;
+
+	for (i = -197; i < 256+197; i++)
+		table_r[i] = (table_Y[i + 384] >> 3) << 11;
+
+	for (i = -132; i < 256+132; i++)
+		table_g[i] = (table_Y[i + 384] >> 2) << 5;
+
+	for (i = -232; i < 256+232; i++)
+		table_b[i] = (table_Y[i + 384] >> 3);
+
+	for (i = 0; i < 256; i++) {
+		table_rV[i] = table_r + div_r(crv * (i - 128), 76309);
+		table_gU[i] = table_g + div_r(cgu * (i - 128), 76309);
+		table_gV[i] =           div_r(cgv * (i - 128), 76309);
+		table_bU[i] = table_b + div_r(cbu * (i - 128), 76309);
+	}
+}
+
+
+/********************
+ *** LINE KERNELS ***
+ ********************/
+
+static void copy_c(void *dst, const void *src, int bytes) {
+	memcpy(dst, src, bytes);
+}
+
+
+static void yuv420_rgb16_c(u16 *dst1, u16 *dst2, const u8 *y1, const u8 *y2,
+                           const u8 *u, const u8 *v, int w) {
+	for (; w >= 2; w -= 2, y1 += 2, y2 += 2, dst1 += 2, dst2 += 2) {
+		const u16 *r = table_rV[*v];
+		const u16 *g = table_gU[*u] + table_gV[*v];
+		const u16 *b = table_bU[*u];
+		u++; v++;
+
+		dst1[0] = r[y1[0]] + g[y1[0]] + b[y1[0]];
+		dst1[1] = r[y1[1]] + g[y1[1]] + b[y1[1]];
+		dst2[0] = r[y2[0]] + g[y2[0]] + b[y2[0]];
+		dst2[1] = r[y2[1]] + g[y2[1]] + b[y2[1]];
+	}
+}
+
+
+static void scale16_c(u16 *dst, const u16 *src, const int *xoffs, int w) {
+	for (; w >= 4; w -= 4, dst += 4, xoffs += 4) {
+		dst[0] = src[xoffs[0]];
+		dst[1] = src[xoffs[1]];
+		dst[2] = src[xoffs[2]];
+		dst[3] = src[xoffs[3]];
+	}
+	for (; w--; ) *dst++ = src[*xoffs++];
+}
+
+
+blit_ops blit_c = {
+	copy_c,
+	yuv420_rgb16_c,
+	scale16_c,
+};
+
+blit_ops *blit = &blit_c;
+
+
+/*** CHECK IF THE CPU SUPPORTS SSE2 ***/
+static int cpu_has_sse2(void) {
+#if defined(__x86_64__)
+	return 1;   /* part of the architecture */
+#elif defined(__i386__)
+	unsigned long flags_a, flags_b;
+	unsigned eax, edx;
+
+	/* check if the cpuid instruction is present (EFLAGS.ID is writable) */
+	asm volatile ("pushf; pop %0; mov %0, %1; xor %2, %0;"
+	              "push %0; popf; pushf; pop %0; push %1; popf"
+	              : "=&r" (flags_a), "=&r" (flags_b)
+	              : "i" (0x200000));
+	if (!((flags_a ^ flags_b) & 0x200000)) return 0;
+
+	/* save ebx, which may hold the GOT pointer */
+	asm volatile ("push %%ebx; cpuid; pop %%ebx"
+	              : "=a" (eax), "=d" (edx) : "a" (1) : "ecx");
+
+	/* FXSR (24) implies that the kernel saves the SSE registers */
+	return (edx & (1 << 26)) && (edx & (1 << 24));
+#else
+	return 0;
+#endif
+}
+
+
+const char *blit_init(void) {
+	init_yuv2rgb();
+
+	if (cpu_has_sse2()) {
+		blit = &blit_sse2;
+		return "SSE2";
+	}
+	blit = &blit_c;
+	return "C";
+}
+
+
+/************************
+ *** IMAGE OPERATIONS ***
+ ************************/
+
+void blit_yuv420_rgb16(int w, int h, const u8 *src_yuv420, u16 *dst) {
+	const u8 *py = src_yuv420;
+	const u8 *pu = src_yuv420 + w*h;
+	const u8 *pv = src_yuv420 + w*h + w*h/4;
+	int pairs = w & ~1;
+
+	for (h >>= 1; h--; py += 2*w, pu += w/2, pv += w/2, dst += 2*w) {
+		blit->yuv420_rgb16(dst, dst + w, py, py + w, pu, pv, pairs);
+
+		/* the last column of odd-sized images has no chroma samples */
+		if (pairs && pairs < w) {
+			dst[w - 1]   = dst[w - 2];
+			dst[2*w - 1] = dst[2*w - 2];
+		}
+	}
+}
+
+
+const int *blit_scale_offsets(int sx, int mx, int w) {
+	int i;
+
+	if (w > MAX_SCALE_W) w = MAX_SCALE_W;
+	for (i = 0; i < w; i++, sx += mx)
+		scale_xbuf[i] = sx >> 16;
+
+	return scale_xbuf;
+}
+
+
+static void scale16_strip(u16 *dst, int dst_w, int w, int h,
+                          const u16 *src, int src_w,
+                          int sx, int sy, int mx, int my) {
+	const u16 *s, *last = NULL;
+	const int *xoffs = blit_scale_offsets(sx, mx, w);
+
+	for (; h--; sy += my, dst += dst_w, last = s) {
+		s = src + (sy>>16)*src_w;
+
+		if (s == last)
+			blit->copy(dst, dst - dst_w, w*2);
+		else if (mx == 1<<16)
+			blit->copy(dst, s + xoffs[0], w*2);
+		else
+			blit->scale16(dst, s, xoffs, w);
+	}
+}
+
+
+void blit_scale16(u16 *dst, int dst_w, int w, int h,
+                  const u16 *src, int src_w,
+                  int sx, int sy, int mx, int my) {
+	int n;
+
+	for (; w > 0; w -= n, dst += n, sx += n*mx) {
+		n = MIN(w, MAX_SCALE_W);
+		scale16_strip(dst, dst_w, n, h, src, src_w, sx, sy, mx, my);
+	}
+}
@@ -0,0 +1,175 @@
+/*
+ * \brief   DOpE SSE2 pixel line kernels
+ * \date    2026-10-19
+ *
+ * This file must be compiled with -msse2. The kernels are only used if
+ * blit_init detected SSE2 at runtime.
+ *
+ * The YUV420 converter computes the same values as the lookup tables of
+ * the C version. The luma curve of the tables is
+ *
+ *   clamp((76309 * (i - 16) + 32768) >> 16)
+ *
+ * with 76309 = 65536 + 10773, which fits into 16bit multiplications.
+ * The chroma offsets are rounded divisions by 76309. They are computed
+ * via 32bit products with constants scaled by 2^13, which reproduce
+ * the rounded values for all 256 chroma samples.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the DOpE package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#include "dopestd.h"
+#include "blit.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+/* chroma coefficients of SMPTE 170M scaled by 2^13 / 76309 */
+#define K_RV    11229
+#define K_BU    14192
+#define K_GU  (-2756)
+#define K_GV  (-5720)
+
+
+/*** COPY BYTES, THE DESTINATION STAYS IN THE CACHE ***/
+static void copy_sse2(void *dst, const void *src, int bytes) {
+	u8 *d = dst;
+	const u8 *s = src;
+
+	for (; bytes >= 64; bytes -= 64, s += 64, d += 64) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(s +  0));
+		__m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+		__m128i c = _mm_loadu_si128((const __m128i *)(s + 32));
+		__m128i e = _mm_loadu_si128((const __m128i *)(s + 48));
+		_mm_storeu_si128((__m128i *)(d +  0), a);
+		_mm_storeu_si128((__m128i *)(d + 16), b);
+		_mm_storeu_si128((__m128i *)(d + 32), c);
+		_mm_storeu_si128((__m128i *)(d + 48), e);
+	}
+	for (; bytes >= 16; bytes -= 16, s += 16, d += 16)
+		_mm_storeu_si128((__m128i *)d, _mm_loadu_si128((const __m128i *)s));
+
+	memcpy(d, s, bytes);
+}
+
+
+/*** ROUND(C * K / 2^13) FOR EIGHT SIGNED 16BIT CHROMA VALUES ***/
+static inline __m128i chroma_offset(__m128i c, int k) {
+	const __m128i one  = _mm_set1_epi16(1);
+	const __m128i kb   = _mm_set1_epi32((1 << 28) | (k & 0xffff));
+	__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(c, one), kb);
+	__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(c, one), kb);
+
+	lo = _mm_srai_epi32(lo, 13);
+	hi = _mm_srai_epi32(hi, 13);
+	return _mm_packs_epi32(lo, hi);
+}
+
+
+/*** APPLY LUMA CURVE TO Y + OFFSET, RESULT IS 0..255 ***/
+static inline __m128i luma(__m128i y, __m128i d) {
+	const __m128i k    = _mm_set1_epi16(10773);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max  = _mm_set1_epi16(255);
+	__m128i x = _mm_add_epi16(y, d);
+
+	/* x + ((10773 * x + 32768) >> 16) */
+	x = _mm_add_epi16(_mm_add_epi16(x, _mm_mulhi_epi16(x, k)),
+	                  _mm_srli_epi16(_mm_mullo_epi16(x, k), 15));
+	return _mm_min_epi16(_mm_max_epi16(x, zero), max);
+}
+
+
+static inline __m128i rgb16(__m128i y, __m128i dr, __m128i dg, __m128i db) {
+	__m128i r = _mm_slli_epi16(_mm_srli_epi16(luma(y, dr), 3), 11);
+	__m128i g = _mm_slli_epi16(_mm_srli_epi16(luma(y, dg), 2), 5);
+	__m128i b =                _mm_srli_epi16(luma(y, db), 3);
+	return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+
+/*** CONVERT 16 LUMA SAMPLES, EACH CHROMA OFFSET IS USED FOR TWO PIXELS ***/
+static inline void yuv_line16(u16 *dst, const u8 *y,
+                              __m128i dr, __m128i dg, __m128i db) {
+	const __m128i zero = _mm_setzero_si128();
+	__m128i yy = _mm_loadu_si128((const __m128i *)y);
+
+	_mm_storeu_si128((__m128i *)(dst + 0),
+	                 rgb16(_mm_unpacklo_epi8(yy, zero),
+	                       _mm_unpacklo_epi16(dr, dr),
+	                       _mm_unpacklo_epi16(dg, dg),
+	                       _mm_unpacklo_epi16(db, db)));
+	_mm_storeu_si128((__m128i *)(dst + 8),
+	                 rgb16(_mm_unpackhi_epi8(yy, zero),
+	                       _mm_unpackhi_epi16(dr, dr),
+	                       _mm_unpackhi_epi16(dg, dg),
+	                       _mm_unpackhi_epi16(db, db)));
+}
+
+
+static void yuv420_rgb16_sse2(u16 *dst1, u16 *dst2, const u8 *y1, const u8 *y2,
+                              const u8 *u, const u8 *v, int w) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c128 = _mm_set1_epi16(128);
+	const __m128i c16  = _mm_set1_epi16(16);
+
+	for (; w >= 16; w -= 16, y1 += 16, y2 += 16, u += 8, v += 8,
+	                dst1 += 16, dst2 += 16) {
+		__m128i uu = _mm_loadl_epi64((const __m128i *)u);
+		__m128i vv = _mm_loadl_epi64((const __m128i *)v);
+		__m128i dr, dg, db;
+
+		uu = _mm_sub_epi16(_mm_unpacklo_epi8(uu, zero), c128);
+		vv = _mm_sub_epi16(_mm_unpacklo_epi8(vv, zero), c128);
+
+		/* the luma bias of 16 is folded into the offsets */
+		dr = _mm_sub_epi16(chroma_offset(vv, K_RV), c16);
+		db = _mm_sub_epi16(chroma_offset(uu, K_BU), c16);
+		dg = _mm_sub_epi16(_mm_add_epi16(chroma_offset(uu, K_GU),
+		                                 chroma_offset(vv, K_GV)), c16);
+
+		yuv_line16(dst1, y1, dr, dg, db);
+		yuv_line16(dst2, y2, dr, dg, db);
+	}
+
+	if (w) blit_c.yuv420_rgb16(dst1, dst2, y1, y2, u, v, w);
+}
+
+
+/*** GATHER EIGHT PIXELS IN A REGISTER AND STORE THEM AT ONCE ***/
+static void scale16_sse2(u16 *dst, const u16 *src, const int *xoffs, int w) {
+	for (; w >= 8; w -= 8, dst += 8, xoffs += 8) {
+		__m128i p = _mm_cvtsi32_si128(src[xoffs[0]]);
+		p = _mm_insert_epi16(p, src[xoffs[1]], 1);
+		p = _mm_insert_epi16(p, src[xoffs[2]], 2);
+		p = _mm_insert_epi16(p, src[xoffs[3]], 3);
+		p = _mm_insert_epi16(p, src[xoffs[4]], 4);
+		p = _mm_insert_epi16(p, src[xoffs[5]], 5);
+		p = _mm_insert_epi16(p, src[xoffs[6]], 6);
+		p = _mm_insert_epi16(p, src[xoffs[7]], 7);
+		_mm_storeu_si128((__m128i *)dst, p);
+	}
+	for (; w--; ) *dst++ = src[*xoffs++];
+}
+
+
+blit_ops blit_sse2 = {
+	copy_sse2,
+	yuv420_rgb16_sse2,
+	scale16_sse2,
+};
+
+#else /* __SSE2__ */
+
+/* never selected on this platform, see blit_init */
+blit_ops blit_sse2;
+
+#endif /* __SSE2__ */
@@ -8,6 +8,12 @@
  * used for every kind of  data the primary  use
  * of this module is the management of image and
  * font caches.
+ *
+ * Elements are evicted in least-recently-used
+ * order. The index returned by add_elem contains
+ * a generation count of the element slot so that
+ * get_elem never returns a successor that reused
+ * the slot.
  */
 
 /*
@@ -21,36 +27,155 @@
 
 #include "dopestd.h"
 #include "cache.h"
+#include "tick.h"
+
+/*
+ * Elements bigger than max_size/CACHE_LARGE_DIV are admitted only if
+ * their ident was refused recently. Thus, a large element that is used
+ * only once does not flush the whole cache. An element bigger than
+ * max_size is kept as the only entry.
+ */
+#define CACHE_LARGE_DIV 4
+#define CACHE_GHOSTS    8
 
 struct cache_elem {
 	void  *data;               /* cached data block */
 	s32    size;               /* size of data block */
 	s32    ident;              /* data block identifier */
 	void (*destroy)(void *);   /* data block destroy function */
+	s32    gen;                /* incremented with each reuse of the slot */
+	s32    prev, next;         /* neighbours in lru list or free list */
 };
 
 struct cache {
-	s32 max_entries;                /* size of ring buffer */
+	s32 max_entries;                /* number of element slots */
 	s32 max_size;                   /* max amount of cached data */
 	s32 curr_size;                  /* current amount of cached data */
-	s32 idxtokill;                  /* 'oldest' ring buffer index */
-	s32 idxtoadd;                   /* ring buffer index for new element */
-	struct cache_elem *elem; /* pointer to ring buffer */
+	s32 max_gen;                    /* max generation that fits into an index */
+	s32 mru, lru;                   /* ends of the lru list, -1 if empty */
+	s32 free;                       /* first unused slot, -1 if none */
+	s32 ghosts[CACHE_GHOSTS];       /* idents of refused large elements */
+	s32 ghost_idx;                  /* next ghost to replace */
+	char *name;                     /* name used for statistics output */
+	struct cache_stats stats;
+	struct cache *next_cache;       /* next cache in statistics list */
+	struct cache_elem *elem;        /* array of element slots */
 };
 
+static struct tick_services *tick;
+
+static struct cache *first_cache;   /* caches that report statistics */
+
+extern int config_cachestats;
+
 int init_cache(struct dope_services *d);
 
 
+/***********************
+ *** LRU LIST HELPERS ***
+ ***********************/
+
+/*** REMOVE SLOT FROM LRU LIST ***/
+static void lru_unlink(CACHE *c, s32 slot) {
+	struct cache_elem *e = c->elem + slot;
+
+	if (e->prev >= 0) c->elem[e->prev].next = e->next;
+	else c->mru = e->next;
+
+	if (e->next >= 0) c->elem[e->next].prev = e->prev;
+	else c->lru = e->prev;
+}
+
+
+/*** INSERT SLOT AS MOST RECENTLY USED ELEMENT ***/
+static void lru_push(CACHE *c, s32 slot) {
+	struct cache_elem *e = c->elem + slot;
+
+	e->prev = -1;
+	e->next = c->mru;
+	if (c->mru >= 0) c->elem[c->mru].prev = slot;
+	else c->lru = slot;
+	c->mru = slot;
+}
+
+
+/*** RESOLVE INDEX TO SLOT OF A CACHED ELEMENT, -1 IF VANISHED ***/
+static s32 lookup(CACHE *c, s32 index) {
+	s32 slot;
+
+	if (index < 0) return -1;
+	slot = index % c->max_entries;
+	if (!c->elem[slot].data || c->elem[slot].gen != index / c->max_entries)
+		return -1;
+	return slot;
+}
+
+
+/*** FREE ELEMENT OF A SLOT AND PUT THE SLOT INTO THE FREE LIST ***/
+static void drop_slot(CACHE *c, s32 slot) {
+	struct cache_elem *e = c->elem + slot;
+
+	INFO(printf("Cache(drop_slot): removing element %d\n", (int)slot);)
+	lru_unlink(c, slot);
+	if (e->destroy) e->destroy(e->data);
+	else free(e->data);
+	c->curr_size -= e->size;
+	c->stats.entries--;
+	e->data = NULL;
+	e->next = c->free;
+	c->free = slot;
+}
+
+
+/*** CHECK IF A LARGE ELEMENT WAS REFUSED BEFORE ***
+ *
+ * Returns 1 if the element should be admitted. Otherwise, its ident is
+ * remembered for the next attempt.
+ */
+static int admit_large(CACHE *c, s32 ident) {
+	int i;
+
+	for (i = 0; i < CACHE_GHOSTS; i++) {
+		if (c->ghosts[i] != ident) continue;
+		c->ghosts[i] = 0;
+		return 1;
+	}
+	c->ghosts[c->ghost_idx] = ident;
+	c->ghost_idx = (c->ghost_idx + 1) % CACHE_GHOSTS;
+	return 0;
+}
+
+
+/*** TICK CALLBACK: PRINT STATISTICS OF ALL CACHES ***/
+static int print_stats(void *arg) {
+	struct cache *c;
+	u32 lookups;
+
+	for (c = first_cache; c; c = c->next_cache) {
+		lookups = c->stats.hits + c->stats.misses;
+		printf("Cache(%s): %u hits, %u misses (%u%% hits), %u evicted, "
+		       "%u refused, %d entries, %d bytes\n", c->name,
+		       (unsigned)c->stats.hits, (unsigned)c->stats.misses,
+		       lookups ? (unsigned)((100ULL*c->stats.hits)/lookups) : 0,
+		       (unsigned)c->stats.evictions, (unsigned)c->stats.rejects,
+		       (int)c->stats.entries, (int)c->curr_size);
+	}
+	return 1;
+}
+
 
 /*************************
  *** SERVICE FUNCTIONS ***
  *************************/
 
 /*** CREATE NEW CACHE ***/
-static CACHE *create(s32 max_entries,s32 max_size) {
+static CACHE *create(s32 max_entries,s32 max_size,char *name) {
 	struct cache *c;
+	s32 i;
 
-	/* get memory for cache struct and the ring buffer */
+	if (max_entries < 1) return NULL;
+
+	/* get memory for cache struct and the element slots */
 	c = (struct cache *)zalloc(sizeof(struct cache)
 	                         + sizeof(struct cache_elem)*max_entries);
 	if (!c) {
@@ -61,59 +186,57 @@ static CACHE *create(s32 max_entries,s32 max_size) {
 	/* set values in cache struct */
 	c->max_entries = max_entries;
 	c->max_size    = max_size;
+	c->max_gen     = 0x7fffffff / max_entries - 1;
+	c->name        = name;
 	c->elem = (struct cache_elem *)((long)c + sizeof(struct cache));
+	c->mru  = c->lru = -1;
+
+	/* chain all slots into the free list */
+	for (i = 0; i < max_entries; i++) c->elem[i].next = i + 1;
+	c->elem[max_entries - 1].next = -1;
 
+	c->next_cache = first_cache;
+	first_cache   = c;
 	return c;
 }
 
 
 /*** REMOVE ELEMENT FROM CACHE ***/
 static void remove_elem(CACHE *cache,s32 index) {
-	struct cache_elem *e;
+	s32 slot;
 	if (!cache) {
 		INFO(printf("Cache(remove_elem): cache == NULL\n");)
 		return;
 	}
-	if (index >= cache->max_entries) {
-		INFO(printf("Cache(remove_elem): index out of range\n");)
+	slot = lookup(cache, index);
+	if (slot < 0) {
+		INFO(printf("Cache(remove_elem): element %d is not cached\n",(int)index);)
 		return;
 	}
-	e=cache->elem + index;
-	INFO(printf("Cache(remove_element): removing element %u\n",index);)
-	if (e->data) {
-		if (e->destroy) e->destroy(e->data);
-		else free(e->data);
-		cache->curr_size -= e->size;
-		e->data=NULL;
-	}
+	drop_slot(cache, slot);
 }
 
 
 /*** DESTROY CACHE ***/
 static void destroy(CACHE *cache) {
-	s32 i;
+	struct cache **c;
 	if (!cache) return;
 
 	/* free cache entries */
-	for (i=0;i<cache->max_entries;i++) remove_elem(cache,i);
+	while (cache->lru >= 0) drop_slot(cache, cache->lru);
+
+	/* unlink from statistics list */
+	for (c = &first_cache; *c; c = &(*c)->next_cache) {
+		if (*c != cache) continue;
+		*c = cache->next_cache;
+		break;
+	}
 
 	/* free cache struct itself */
 	free(cache);
 }
 
 
-static void reduce_cachesize(CACHE *cache,long needed_size) {
-	if (!cache) return;
-
-	INFO(printf("Cache(reduce_cachesize): old size is %u\n",cache->curr_size);)
-	while (cache->curr_size > needed_size) {
-		remove_elem(cache,cache->idxtokill);
-		cache->idxtokill = (cache->idxtokill + 1)%(cache->max_entries);
-	}
-	INFO(printf("Cache(reduce_cachesize): new size is %u\n",cache->curr_size);)
-}
-
-
 /*** INSERT ELEMENT INTO CACHE ***/
 /* parameters:                                                               */
 /*   elem     - data block to add to cache                                   */
@@ -126,59 +249,80 @@ static void reduce_cachesize(CACHE *cache,long needed_size) {
 /* returns:                                                                  */
 /*   index to cache element. The cached element can be accessed later using  */
 /*   the function get_element with this index and the identifier as args.    */
+/*   If the element is not admitted, -1 is returned and the caller keeps the */
+/*   ownership of the data block.                                            */
 /**/
 static s32 add_elem(CACHE *cache,void *elem,s32 elemsize,s32 ident,void (*destroy)(void *)) {
 	struct cache_elem *e;
-	s32 new_idx;
+	s32 slot;
 
-	if (!cache) return -1;
+	if (!cache || !elem) return -1;
 
-	/* check if cache grows bigger that its maximum size */
-	if (cache->curr_size + elemsize > cache->max_size) {
-		reduce_cachesize(cache,cache->max_size - elemsize);
+	/* do not let large elements flush the cache at their first use */
+	if ((elemsize > cache->max_size/CACHE_LARGE_DIV) && !admit_large(cache, ident)) {
+		INFO(printf("Cache(add_elem): element of size %d refused\n",(int)elemsize);)
+		cache->stats.rejects++;
+		return -1;
 	}
 
-	new_idx = cache->idxtoadd;
-	e=cache->elem + new_idx;
-	INFO(printf("Cache(add_elem): add element at index %u\n",new_idx);)
-
-	/* gets another cache element overwritten? */
-	if (e->data) {
-		INFO(printf("Cache(add_elem): old element gets overwritten\n");)
-
-		/* remove old element */
-		remove_elem(cache,new_idx);
-		cache->idxtokill = (cache->idxtokill + 1)%(cache->max_entries);
+	/* evict least recently used elements until the new one fits or the
+	 * cache is empty */
+	while ((cache->lru >= 0)
+	    && ((cache->free < 0) || (cache->curr_size + elemsize > cache->max_size))) {
+		drop_slot(cache, cache->lru);
+		cache->stats.evictions++;
 	}
 
-	e->data=elem;
-	e->size=elemsize;
-	e->ident=ident;
-	e->destroy=destroy;
+	slot = cache->free;
+	e    = cache->elem + slot;
+	cache->free = e->next;
+	INFO(printf("Cache(add_elem): add element at slot %d\n",(int)slot);)
+
+	e->data    = elem;
+	e->size    = elemsize;
+	e->ident   = ident;
+	e->destroy = destroy;
+	e->gen     = (e->gen % cache->max_gen) + 1;
+	lru_push(cache, slot);
 
 	cache->curr_size += elemsize;
-	cache->idxtoadd = (cache->idxtoadd + 1)%(cache->max_entries);
+	cache->stats.entries++;
+	cache->stats.inserts++;
 
-	return new_idx;
+	return e->gen*cache->max_entries + slot;
 }
 
 
 /*** GET CACHED DATA ***/
 static void *get_elem(struct cache *cache,s32 index,s32 ident) {
+	s32 slot;
 
 	if (!cache) {
 		INFO(printf("Cache(get_elem): cache == NULL\n");)
 		return NULL;
 	}
-	if (index >= cache->max_entries) {
-		INFO(printf("Cache(get_elem): index %u out of range\n",index);)
+	slot = lookup(cache, index);
+	if ((slot < 0) || (cache->elem[slot].ident != ident)) {
+		INFO(printf("Cache(get_elem): element %d is not cached anymore\n",(int)index);)
+		cache->stats.misses++;
 		return NULL;
 	}
-	if ((cache->elem + index)->ident == ident) {
-		return (cache->elem + index)->data;
+
+	/* mark element as most recently used */
+	if (cache->mru != slot) {
+		lru_unlink(cache, slot);
+		lru_push(cache, slot);
 	}
-	INFO(printf("Cache(get_elem): element %u is not cached anymore\n",index);)
-	return NULL;
+	cache->stats.hits++;
+	return cache->elem[slot].data;
+}
+
+
+/*** REQUEST CACHE STATISTICS ***/
+static void get_stats(CACHE *cache,struct cache_stats *dst) {
+	if (!cache || !dst) return;
+	*dst = cache->stats;
+	dst->size = cache->curr_size;
 }
 
 
@@ -192,7 +336,8 @@ static struct cache_services services = {
 	destroy,
 	add_elem,
 	get_elem,
-	remove_elem
+	remove_elem,
+	get_stats,
 };
 
 
@@ -202,6 +347,12 @@ static struct cache_services services = {
  **************************/
 
 int init_cache(struct dope_services *d) {
+	tick = d->get_module("Tick 1.0");
+
+	/* print statistics periodically if requested at startup */
+	if (config_cachestats > 0)
+		tick->add(config_cachestats*1000, print_stats, NULL);
+
 	d->register_module("Cache 1.0",&services);
 	return 1;
 }
@@ -107,6 +107,52 @@ static struct fontman_services services = {
  *** MODULE ENTRY POINT ***
  **************************/
 
+/*** CONVERT FONT IMAGE TO RUNS OF SET PIXELS ***
+ *
+ * Strings are drawn transparently. With the runs, the screen
+ * handlers fill whole pixel runs instead of testing each pixel
+ * of the font image. The first pass counts the runs, the second
+ * pass stores them.
+ */
+static void gen_span_table(struct font *f) {
+	int c, j, x, w, n = 0, pass;
+	u8 *line;
+
+	for (pass = 0; pass < 2; pass++, n = 0) {
+		for (c = 0; c < 256; c++) {
+			for (j = 0; j < f->img_h; j++) {
+				line = f->image + j*f->img_w + f->offset_table[c];
+				if (pass) f->span_table[c*(f->img_h + 1) + j] = n;
+
+				for (x = 0; x < f->width_table[c]; x += w) {
+					if (!line[x]) { w = 1; continue; }
+					for (w = 1; (x + w < f->width_table[c]) && line[x + w] && (w < 255); w++);
+					if (pass) {
+						f->spans[2*n]     = x;
+						f->spans[2*n + 1] = w;
+					}
+					n++;
+				}
+			}
+			if (pass) f->span_table[c*(f->img_h + 1) + f->img_h] = n;
+		}
+
+		if (!pass) {
+			f->span_table = zalloc(256*(f->img_h + 1)*sizeof(s32));
+			f->spans      = zalloc(2*n + 1);
+			if (!f->span_table || !f->spans) {
+				INFO(printf("FontManager(gen_span_table): out of memory\n"));
+				if (f->span_table) free(f->span_table);
+				if (f->spans)      free(f->spans);
+				f->span_table = NULL;
+				f->spans      = NULL;
+				return;
+			}
+		}
+	}
+}
+
+
 static void add_font(struct fontconv_services *conv,void *fontdata,u32 font_id,struct font *dst) {
 
 	dst->font_id = font_id;
@@ -126,6 +172,7 @@ static void add_font(struct fontconv_services *conv,void *fontdata,u32 font_id,s
 	conv->gen_width_table(fontdata, dst->width_table);
 	conv->gen_offset_table(fontdata, dst->offset_table);
 	conv->gen_image(fontdata, dst->image);
+	gen_span_table(dst);
 }
 
 
@@ -20,6 +20,7 @@
 #include "clipping.h"
 #include "gfx.h"
 #include "gfx_handler.h"
+#include "blit.h"
 
 #define RGBA_TO_RGB16(c) (((c&0xf8000000)>>16)|((c&0x00fc0000)>>13)|((c&0x0000f800)>>11))
 #define COL16(r, g, b) (r<<11) + (g<<6) + b
@@ -148,15 +149,11 @@ static inline void paint_img_16(int x, int y, int img_w, int img_h, u16 *src) {
 }
 
 
-static s32 scale_xbuf[2000];
-
 /*** DRAW SCALED AND CLIPPED 16BIT IMAGE TO 16BIT SCREEN ***/
 static void paint_scaled_img_rgb16(int x, int y, int w, int h,
                                    int linewidth, int sw, int sh, u16 *src) {
 	int mx, my;
-	int i, j;
 	int sx = 0, sy = 0;
-	u16 *dst, *s, *d;
 
 	/* sanity check */
 	if (!src) return;
@@ -173,20 +170,8 @@ static void paint_scaled_img_rgb16(int x, int y, int w, int h,
 	if (!clip_img(clip_x1, clip_y1, clip_x2, clip_y2,
 	              &x, &y, &w, &h, &sx, &sy, mx, my)) return;
 
-	/* calculate start address */
-	dst = scr_adr + y*scr_width + x;
-
-	/* calculate x offsets */
-	for (i = w; i--; sx += mx)
-		scale_xbuf[i] = sx >> 16;
-
-	/* draw scaled image */
-	for (j = h; j--; sy += my, dst += scr_width) {
-		s = src + ((sy>>16)*linewidth);
-		d = dst;
-		for (i = w; i--; )
-			*(d++) = *(s + scale_xbuf[i]);
-	}
+	blit_scale16(scr_adr + y*scr_width + x, scr_width, w, h,
+	             src, linewidth, sx, sy, mx, my);
 }
 
 
@@ -194,8 +179,9 @@ static void paint_scaled_img_rgb16(int x, int y, int w, int h,
 static void paint_scaled_img_rgba32(int x, int y, int w, int h,
                                     int linewidth, int sw, int sh, u32 *src) {
 	int mx, my;
-	int i, j;
+	int i, j, n, y0;
 	int sx = 0, sy = 0;
+	const int *xoffs;
 	u16 *dst, *d;
 	u32 *s;
 
@@ -211,160 +197,22 @@ static void paint_scaled_img_rgba32(int x, int y, int w, int h,
 	/* calculate start address */
 	dst = scr_adr + y*scr_width + x;
 
-	/* calculate x offsets */
-	for (i = w; i--; sx += mx)
-		scale_xbuf[i] = sx >> 16;
-
-	/* draw scaled image */
-	for (j = h; j--; sy += my, dst += scr_width) {
-		s = src + ((sy>>16)*linewidth);
-		d = dst;
-		for (i = w; i--; d++) {
-			u32 color = *(s + scale_xbuf[i]);
-			int alpha = GFX_A(color);
-			if (alpha) *d = blend(*d, 255 - alpha) + blend(RGBA_TO_RGB16(color), alpha);
+	/* draw scaled image in strips covered by one x offset table */
+	for (y0 = sy; w > 0; w -= n, dst += n, sx += n*mx) {
+		n     = MIN(w, MAX_SCALE_W);
+		xoffs = blit_scale_offsets(sx, mx, n);
+
+		for (j = h, sy = y0, d = dst; j--; sy += my, d += scr_width - n) {
+			s = src + ((sy>>16)*linewidth);
+			for (i = 0; i < n; i++, d++) {
+				u32 color = *(s + xoffs[i]);
+				int alpha = GFX_A(color);
+				if (alpha) *d = blend(*d, 255 - alpha) + blend(RGBA_TO_RGB16(color), alpha);
+			}
 		}
 	}
 }
 
-/*** CONVERT A YUV420 IMAGE TO A 16-BIT HICOLOR IMAGE ***/
-
-static const s32 Inverse_Table_6_9[8][4] = {
-	{117504, 138453, 13954, 34903}, /* no sequence_display_extension */
-	{117504, 138453, 13954, 34903}, /* ITU-R Rec. 709 (1990) */
-	{104597, 132201, 25675, 53279}, /* unspecified */
-	{104597, 132201, 25675, 53279}, /* reserved */
-	{104448, 132798, 24759, 53109}, /* FCC */
-	{104597, 132201, 25675, 53279}, /* ITU-R Rec. 624-4 System B, G */
-	{104597, 132201, 25675, 53279}, /* SMPTE 170M */
-	{117579, 136230, 16907, 35559}  /* SMPTE 240M (1987) */
-};
-
-static u16 tab_16[197 + 2*682 + 256 + 132];
-static void *table_rV[256];
-static void *table_gU[256];
-static int   table_gV[256];
-static void *table_bU[256];
-
-#define RGB(i)\
-U = pu_[i];\
-	V = pv_[i];\
-	r = table_rV[V];\
-	g = (void *) (((u8 *)table_gU[U]) + table_gV[V]);\
-	b = table_bU[U];
-
-#define DST1(i)\
-Y = py_1[2*i];\
-	dst_1[2*i] = r[Y] + g[Y] + b[Y];\
-	Y = py_1[2*i+1];\
-	dst_1[2*i+1] = r[Y] + g[Y] + b[Y];
-
-#define DST2(i)\
-Y = py_2[2*i];\
-	dst_2[2*i] = r[Y] + g[Y] + b[Y];\
-	Y = py_2[2*i+1];\
-	dst_2[2*i+1] = r[Y] + g[Y] + b[Y];
-
-/* This is exactly the same code as yuv2rgb_c_32 except for the types of */
-/* r, g, b, dst_1, dst_2 */
-
-static void convert_yuv420_to_16(int width, int height, u8 *src_yuv420, u16 *dst_rgb16) {
-	void *dst =dst_rgb16;
-	u8 *py = src_yuv420;
-	u8 *pu = src_yuv420 + width*height;
-	u8 *pv = src_yuv420 + width*height + width*height/4;
-	int rgb_stride = width*2;
-	int y_stride = width;
-	int uv_stride = width/2;
-	int U, V, Y;
-	u16 * r, * g, * b;
-	u16 * dst_1, * dst_2;
-
-	height >>= 1;
-	do {
-
-		u8 * py_1 = py;
-		u8 * py_2 = py + y_stride;
-		u8 * pu_  = pu;
-		u8 * pv_  = pv;
-		void * _dst_1 = dst;
-		void * _dst_2 = ((u8 *)dst) + rgb_stride;
-		int width_ = width;
-
-		width_ >>= 3;
-		dst_1 = _dst_1;
-		dst_2 = _dst_2;
-
-		do {
-			RGB(0); DST1(0); DST2(0);
-			RGB(1); DST2(1); DST1(1);
-			RGB(2); DST1(2); DST2(2);
-			RGB(3); DST2(3); DST1(3);
-
-			pu_ += 4;
-			pv_ += 4;
-			py_1 += 8;
-			py_2 += 8;
-			dst_1 += 8;
-			dst_2 += 8;
-		} while (--width_);
-
-		py += 2 * y_stride;
-		pu += uv_stride;
-		pv += uv_stride;
-		dst = ((u8 *)dst) + 2 * rgb_stride;
-	} while (--height);
-}
-
-
-static int div_r(int dividend, int divisor) {
-	if (dividend > 0)
-		return (dividend + (divisor>>1)) / divisor;
-	else
-		return -((-dividend + (divisor>>1)) / divisor);
-}
-
-
-static int init_yuv2rgb(void) {
-	int i;
-	u8 table_Y[1024];
-	u16 * table_16 = &tab_16[0];
-	void *table_r = 0, *table_g = 0, *table_b = 0;
-
-	int crv =  Inverse_Table_6_9[6][0];
-	int cbu =  Inverse_Table_6_9[6][1];
-	int cgu = -Inverse_Table_6_9[6][2];
-	int cgv = -Inverse_Table_6_9[6][3];
-
-	for (i = 0; i < 1024; i++) {
-		int j;
-		j = (76309 * (i - 384 - 16) + 32768) >> 16;
-		j = (j < 0) ? 0 : ((j > 255) ? 255 : j);
-		table_Y[i] = j;
-	}
-
-	table_r = table_16 + 197;
-	table_b = table_16 + 197 + 685;
-	table_g = table_16 + 197 + 2*682;
-
-	for (i = -197; i < 256+197; i++)
-		((u16 *)table_r)[i] = (table_Y[i + 384] >> 3) << 11;
-
-	for (i = -132; i < 256+132; i++)
-		((u16 *)table_g)[i] = (table_Y[i + 384] >> 2) << 5;
-
-	for (i = -232; i < 256+232; i++)
-		((u16 *)table_b)[i] = (table_Y[i + 384] >> 3);
-
-	for (i = 0; i < 256; i++) {
-		table_rV[i] = (((u8 *)table_r) + 2 * div_r (crv * (i - 128), 76309));
-		table_gU[i] = (((u8 *)table_g) + 2 * div_r (cgu * (i - 128), 76309));
-		table_gV[i] = 2 * div_r (cgv * (i-128), 76309);
-		table_bU[i] = (((u8 *)table_b) + 2 * div_r (cbu * (i - 128), 76309));
-	}
-	return 0;
-}
-
 
 /*****************************
  *** GFX HANDLER FUNCTIONS ***
@@ -521,13 +369,18 @@ static s32 scr_draw_slice_16(struct gfx_ds_data *s, s16 x, s16 y, s16 w, s16 h,
 
 	case GFX_IMG_TYPE_YUV420:
 		{
-			u16 *src = cache->get_elem(imgcache, img->cache_idx, 123);
+			s32 ident = (s32)(long)img;
+			u16 *src = cache->get_elem(imgcache, img->cache_idx, ident);
 			if (!src) {
 				src = malloc(img_w*img_h*2);
-				img->cache_idx = cache->add_elem(imgcache, src, img_w*img_h*2, 123, NULL);
+				if (!src) break;
+				img->cache_idx = cache->add_elem(imgcache, src, img_w*img_h*2, ident, NULL);
 			}
-			convert_yuv420_to_16(img_w, img_h, img->handler->map(img->data), src);
+			blit_yuv420_rgb16(img_w, img_h, img->handler->map(img->data), src);
 			paint_scaled_img_rgb16(x, y, w, h, img_w, sw, sh, src + img_w*sy + sx);
+
+			/* buffer was not admitted to the cache */
+			if (img->cache_idx < 0) free(src);
 			break;
 		}
 	}
@@ -543,98 +396,49 @@ static s32 scr_draw_img_16(struct gfx_ds_data *s, s16 x, s16 y, s16 w, s16 h,
 	                         img, alpha);
 }
 
+/*** DRAW STRING ***
+ *
+ * The string is drawn line by line. For each line of the font, the
+ * pixel runs of all visible characters are filled.
+ */
 static s32 scr_draw_string_16(struct gfx_ds_data *ds, s16 x, s16 y,
                              s32 fg_rgba, u32 bg_rgba, s32 fnt_id,
                              char *str_signed) {
 	struct font *font = fontman->get_by_id(fnt_id);
-	s32 *wtab = font->width_table;
-	s32 *otab = font->offset_table;
-	s32 img_w = font->img_w;
-	s32 img_h = font->img_h;
-	u16 *dst = scr_adr + y*scr_width + x;
 	u8  *str = (u8 *)str_signed;
-	u8  *src = font->image;
-	u8  *s;
-	u16 *d;
-	s16 i, j;
-	s32 w;
-	s32 h = font->img_h;
-	u16 color = RGBA_TO_RGB16(fg_rgba);
-	if (!str) return -1;
-
-	/* check top clipping */
-	if (y < clip_y1) {
-		src += (clip_y1 - y)*img_w;   /* skip upper lines in font image */
-		h   -= (clip_y1 - y);         /* decrement number of lines to draw */
-		dst += (clip_y1 - y)*scr_width;
-	}
+	u8  *end, *c, *span, *last;
+	u16 *dst;
+	s32 *wtab, *stab;
+	s32  j, h, stride, cx, x1, x2;
+	u16  color = RGBA_TO_RGB16(fg_rgba);
 
-	/* check bottom clipping */
-	if (y+img_h - 1 > clip_y2)
-		h -= (y + img_h - 1 - clip_y2);  /* decr. number of lines to draw */
+	if (!str || !font || !font->span_table) return -1;
 
-	if (h < 1) return -1;
+	wtab   = font->width_table;
+	stab   = font->span_table;
+	stride = font->img_h + 1;
+
+	/* vertical clipping */
+	j = MAX(0, clip_y1 - y);
+	h = MIN(font->img_h, clip_y2 - y + 1);
+	if (j >= h) return -1;
 
 	/* skip characters that are completely hidden by the left clipping border */
-	while (*str && (x+wtab[(int)(*str)] < clip_x1)) {
-		x+=wtab[(int)(*str)];
-		dst+=wtab[(int)(*str)];
-		str++;
-	}
+	while (*str && (x + wtab[*str] <= clip_x1)) x += wtab[*str++];
 
-	/* draw left cutted character */
-	if (*str && (x+wtab[(int)(*str)] - 1 <= clip_x2) && (x < clip_x1)) {
-		w = wtab[(int)(*str)] - (clip_x1 - x);
-		s = src + otab[(int)(*str)] + (clip_x1 - x);
-		d = dst + (clip_x1 - x);
-		for (j = 0; j < h; j++) {
-			for (i = 0; i < w; i++) {
-				if (s[i]) d[i] = color;
-			}
-			s = s + img_w;
-			d = d + scr_width;
-		}
-		dst += wtab[(int)(*str)];
-		x   += wtab[(int)(*str)];
-		str++;
-	}
+	/* find first character that is hidden by the right clipping border */
+	for (end = str, cx = x; *end && (cx <= clip_x2); cx += wtab[*end++]);
 
-	/* draw horizontally full visible characters */
-	while (*str && (x + wtab[(int)(*str)] - 1 < clip_x2)) {
-		w = wtab[(int)(*str)];
-		s = src + otab[(int)(*str)];
-		d = dst;
-		for (j = 0; j < h; j++) {
-			for (i = 0; i < w; i++) {
-				if (s[i]) d[i] = color;
-			}
-			s = s + img_w;
-			d = d + scr_width;
-		}
-		dst += wtab[(int)(*str)];
-		x   += wtab[(int)(*str)];
-		str++;
-	}
+	for (dst = scr_adr + (y + j)*scr_width; j < h; j++, dst += scr_width) {
+		for (c = str, cx = x; c < end; cx += wtab[*c++]) {
+			span = font->spans + 2*stab[*c*stride + j];
+			last = font->spans + 2*stab[*c*stride + j + 1];
 
-	/* draw right cutted character */
-	if (*str) {
-		w = wtab[(int)(*str)];
-		s = src + otab[(int)(*str)];
-		d = dst;
-		if (x + w - 1 > clip_x2) {
-			w -= x + w - 1 - clip_x2;
-		}
-		if (x < clip_x1) {    /* check if character is also left-cutted */
-			w -= clip_x1 - x;
-			s += clip_x1 - x;
-			d += clip_x1 - x;
-		}
-		for (j = 0; j < h; j++) {
-			for (i = 0; i < w; i++) {
-				if (s[i]) d[i] = color;
+			for (; span < last; span += 2) {
+				x1 = MAX(cx + span[0], clip_x1);
+				x2 = MIN(cx + span[0] + span[1] - 1, clip_x2);
+				for (; x1 <= x2; x1++) dst[x1] = color;
 			}
-			s += img_w;
-			d += scr_width;
 		}
 	}
 	return 0;
@@ -756,9 +560,9 @@ int init_gfxscr16(struct dope_services *d) {
 	clip    = d->get_module("Clipping 1.0");
 	cache   = d->get_module("Cache 1.0");
 
-	imgcache = cache->create(100, 1000*1000);
+	imgcache = cache->create(100, 1000*1000, "yuv");
 
-	init_yuv2rgb();
+	blit_init();
 
 	d->register_module("GfxScreen16 1.0", &services);
 	return 1;
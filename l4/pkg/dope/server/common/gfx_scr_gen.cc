@@ -21,6 +21,7 @@
 #include "gfx.h"
 #include "gfx_handler.h"
 #include "gfx_colors.h"
+#include "blit.h"
 
 /*** Global information for DOpE modules */
 
@@ -33,152 +34,34 @@ static CACHE *imgcache;
 
 extern "C" int init_gfxscr16(struct dope_services *d);
 
-/*** CONVERT A YUV420 IMAGE TO A 16-BIT HICOLOR IMAGE ***/
-
-static const s32 Inverse_Table_6_9[8][4] = {
-	{117504, 138453, 13954, 34903}, /* no sequence_display_extension */
-	{117504, 138453, 13954, 34903}, /* ITU-R Rec. 709 (1990) */
-	{104597, 132201, 25675, 53279}, /* unspecified */
-	{104597, 132201, 25675, 53279}, /* reserved */
-	{104448, 132798, 24759, 53109}, /* FCC */
-	{104597, 132201, 25675, 53279}, /* ITU-R Rec. 624-4 System B, G */
-	{104597, 132201, 25675, 53279}, /* SMPTE 170M */
-	{117579, 136230, 16907, 35559}  /* SMPTE 240M (1987) */
-};
-
-static u16 tab_16[197 + 2*682 + 256 + 132];
-static void *table_rV[256];
-static void *table_gU[256];
-static int   table_gV[256];
-static void *table_bU[256];
-
-#define RGB(i)\
-U = pu_[i];\
-	V = pv_[i];\
-	r = (u16 *) table_rV[V];\
-	g = (u16 *) (((u8 *)table_gU[U]) + table_gV[V]);\
-	b = (u16 *) table_bU[U];
-
-#define DST1(i)\
-Y = py_1[2*i];\
-	dst_1[2*i] = r[Y] + g[Y] + b[Y];\
-	Y = py_1[2*i+1];\
-	dst_1[2*i+1] = r[Y] + g[Y] + b[Y];
-
-#define DST2(i)\
-Y = py_2[2*i];\
-	dst_2[2*i] = r[Y] + g[Y] + b[Y];\
-	Y = py_2[2*i+1];\
-	dst_2[2*i+1] = r[Y] + g[Y] + b[Y];
-
-/* This is exactly the same code as yuv2rgb_c_32 except for the types of */
-/* r, g, b, dst_1, dst_2 */
-
-static void convert_yuv420_to_16(int width, int height, u8 const *src_yuv420, u16 *dst_rgb16) {
-	void *dst =dst_rgb16;
-	u8 const *py = src_yuv420;
-	u8 const *pu = src_yuv420 + width*height;
-	u8 const *pv = src_yuv420 + width*height + width*height/4;
-	int rgb_stride = width*2;
-	int y_stride = width;
-	int uv_stride = width/2;
-	int U, V, Y;
-	u16 * r, * g, * b;
-	u16 * dst_1, * dst_2;
-
-	height >>= 1;
-	do {
-
-		u8 const * py_1 = py;
-		u8 const * py_2 = py + y_stride;
-		u8 const * pu_  = pu;
-		u8 const * pv_  = pv;
-		void * _dst_1 = dst;
-		void * _dst_2 = ((u8 *)dst) + rgb_stride;
-		int width_ = width;
-
-		width_ >>= 3;
-		dst_1 = (u16*)_dst_1;
-		dst_2 = (u16*)_dst_2;
-
-		do {
-			RGB(0); DST1(0); DST2(0);
-			RGB(1); DST2(1); DST1(1);
-			RGB(2); DST1(2); DST2(2);
-			RGB(3); DST2(3); DST1(3);
-
-			pu_ += 4;
-			pv_ += 4;
-			py_1 += 8;
-			py_2 += 8;
-			dst_1 += 8;
-			dst_2 += 8;
-		} while (--width_);
-
-		py += 2 * y_stride;
-		pu += uv_stride;
-		pv += uv_stride;
-		dst = ((u8 *)dst) + 2 * rgb_stride;
-	} while (--height);
-}
-
-
-static int div_r(int dividend, int divisor) {
-	if (dividend > 0)
-		return (dividend + (divisor>>1)) / divisor;
-	else
-		return -((-dividend + (divisor>>1)) / divisor);
-}
-
-
-static int init_yuv2rgb(void) {
-	int i;
-	u8 table_Y[1024];
-	u16 * table_16 = &tab_16[0];
-	void *table_r = 0, *table_g = 0, *table_b = 0;
+/*** Check if two color spaces are the same */
+template< typename A, typename B >
+struct Same_space { enum { Value = 0 }; };
 
-	int crv =  Inverse_Table_6_9[6][0];
-	int cbu =  Inverse_Table_6_9[6][1];
-	int cgu = -Inverse_Table_6_9[6][2];
-	int cgv = -Inverse_Table_6_9[6][3];
-
-	for (i = 0; i < 1024; i++) {
-		int j;
-		j = (76309 * (i - 384 - 16) + 32768) >> 16;
-		j = (j < 0) ? 0 : ((j > 255) ? 255 : j);
-		table_Y[i] = j;
-	}
+template< typename A >
+struct Same_space<A, A> { enum { Value = 1 }; };
 
-	table_r = table_16 + 197;
-	table_b = table_16 + 197 + 685;
-	table_g = table_16 + 197 + 2*682;
 
-	for (i = -197; i < 256+197; i++)
-		((u16 *)table_r)[i] = (table_Y[i + 384] >> 3) << 11;
+/*** Global data for the gfx_scr singleton */
+static void *scr_adr;
+static s32  clip_x1, clip_y1, clip_x2, clip_y2;
+static s32  scr_width, scr_height, scr_type;
 
-	for (i = -132; i < 256+132; i++)
-		((u16 *)table_g)[i] = (table_Y[i + 384] >> 2) << 5;
 
-	for (i = -232; i < 256+232; i++)
-		((u16 *)table_b)[i] = (table_Y[i + 384] >> 3);
+/*** SCALE IMAGE IN SCREEN FORMAT, RETURN 0 IF THERE IS NO KERNEL FOR IT ***/
+static int scale_native(u16 *dst, int w, int h, u16 const *src, int linewidth,
+                        int sx, int sy, int mx, int my) {
+	blit_scale16(dst, scr_width, w, h, src, linewidth, sx, sy, mx, my);
+	return 1;
+}
 
-	for (i = 0; i < 256; i++) {
-		table_rV[i] = (((u8 *)table_r) + 2 * div_r (crv * (i - 128), 76309));
-		table_gU[i] = (((u8 *)table_g) + 2 * div_r (cgu * (i - 128), 76309));
-		table_gV[i] = 2 * div_r (cgv * (i-128), 76309);
-		table_bU[i] = (((u8 *)table_b) + 2 * div_r (cbu * (i - 128), 76309));
-	}
+template< typename D, typename S >
+static int scale_native(D *dst, int w, int h, S const *src, int linewidth,
+                        int sx, int sy, int mx, int my) {
 	return 0;
 }
 
 
-/*** Global data for the gfx_scr singleton */
-static void *scr_adr;
-static s32  clip_x1, clip_y1, clip_x2, clip_y2;
-static s32  scr_width, scr_height, scr_type;
-static s32 scale_xbuf[2000];
-
-
 /*** PUBLIC gfx_ds_handler functions (colormode independent) */
 
 static void *scr_map(struct gfx_ds_data *s) {
@@ -362,10 +245,11 @@ private:
 	                             int linewidth, int sw, int sh,
 	                             typename T::Pixel const *src) {
 		int mx, my;
-		int i, j;
+		int i, j, n, y0;
 		int sx = 0, sy = 0;
+		const int *xoffs;
 		Pixel *dst, *d;
-		typename T::Pixel const *s;
+		typename T::Pixel const *s, *last;
 
 		/* sanity check */
 		if (!src) return;
@@ -385,16 +269,27 @@ private:
 		/* calculate start address */
 		dst = (Pixel*)scr_adr + y*scr_width + x;
 
-		/* calculate x offsets */
-		for (i = w; i--; sx += mx)
-			scale_xbuf[i] = sx >> 16;
-
-		/* draw scaled image */
-		for (j = h; j--; sy += my, dst += scr_width) {
-			s = src + ((sy>>16)*linewidth);
-			d = dst;
-			for (i = w; i--; )
-				Conv<T, Traits>::blit(*(s + scale_xbuf[i]), d++);
+		/* image in screen format */
+		if (Same_space<T, Traits>::Value
+		 && scale_native(dst, w, h, src, linewidth, sx, sy, mx, my))
+			return;
+
+		/* draw scaled image in strips covered by one x offset table,
+		 * repeated lines without alpha are copied */
+		for (y0 = sy; w > 0; w -= n, dst += n, sx += n*mx) {
+			n     = MIN(w, MAX_SCALE_W);
+			xoffs = blit_scale_offsets(sx, mx, n);
+
+			for (j = h, sy = y0, d = dst, last = 0; j--;
+			     sy += my, d += scr_width, last = s) {
+				s = src + ((sy>>16)*linewidth);
+				if (T::A::Size == 0 && s == last) {
+					blit->copy(d, d - scr_width, n*Traits::Bpp);
+					continue;
+				}
+				for (i = 0; i < n; i++)
+					Conv<T, Traits>::blit(*(s + xoffs[i]), d + i);
+			}
 		}
 	}
 
@@ -518,13 +413,18 @@ public:
 
 		case GFX_IMG_TYPE_YUV420:
 			{
-			  Rgb16::Pixel *src = (Rgb16::Pixel *)cache->get_elem(imgcache, img->cache_idx, 123);
+				s32 ident = (s32)(long)img;
+				Rgb16::Pixel *src = (Rgb16::Pixel *)cache->get_elem(imgcache, img->cache_idx, ident);
 				if (!src) {
 					src = (Rgb16::Pixel *)malloc(img_w*img_h*2);
-					img->cache_idx = cache->add_elem(imgcache, src, img_w*img_h*2, 123, NULL);
+					if (!src) break;
+					img->cache_idx = cache->add_elem(imgcache, src, img_w*img_h*2, ident, NULL);
 				}
-				convert_yuv420_to_16(img_w, img_h, (u8*)(img->handler->map(img->data)), src);
+				blit_yuv420_rgb16(img_w, img_h, (u8*)(img->handler->map(img->data)), src);
 				paint_scaled_img<Rgb16>(x, y, w, h, img_w, sw, sh, src + img_w*sy + sx);
+
+				/* buffer was not admitted to the cache */
+				if (img->cache_idx < 0) free(src);
 				break;
 			}
 		}
@@ -540,95 +440,43 @@ public:
 		                      img, alpha);
 	}
 
-	static s32 scr_draw_string(struct gfx_ds_data *ds, s16 x, s16 y, s32 fg_rgba, u32 bg_rgba, s32 fnt_id, char *str) {
+	/*** DRAW STRING LINE BY LINE, FILL THE PIXEL RUNS OF ALL CHARACTERS ***/
+	static s32 scr_draw_string(struct gfx_ds_data *ds, s16 x, s16 y, s32 fg_rgba, u32 bg_rgba, s32 fnt_id, char *str_signed) {
 		struct font *font = fontman->get_by_id(fnt_id);
-		s32 *wtab = font->width_table;
-		s32 *otab = font->offset_table;
-		s32 img_w = font->img_w;
-		s32 img_h = font->img_h;
-		Pixel *dst = (Pixel*)scr_adr + y*scr_width + x;
-		u8  const *src = font->image;
-		u8  const *s;
-		Pixel *d;
-		s16 i, j;
-		s32 w;
-		s32 h = font->img_h;
+		u8 const *str = (u8 const *)str_signed;
+		u8 const *end, *c, *span, *last;
+		Pixel *dst;
+		s32 *wtab, *stab;
+		s32  j, h, stride, cx, x1, x2;
 		Color color = Conv<Rgba32, Traits>::convert(fg_rgba);
-		if (!str) return -1;
 
-		/* check top clipping */
-		if (y < clip_y1) {
-			src += (clip_y1 - y)*img_w;   /* skip upper lines in font image */
-			h   -= (clip_y1 - y);         /* decrement number of lines to draw */
-			dst += (clip_y1 - y)*scr_width;
-		}
+		if (!str || !font || !font->span_table) return -1;
 
-		/* check bottom clipping */
-		if (y+img_h - 1 > clip_y2)
-			h -= (y + img_h - 1 - clip_y2);  /* decr. number of lines to draw */
+		wtab   = font->width_table;
+		stab   = font->span_table;
+		stride = font->img_h + 1;
 
-		if (h < 1) return -1;
+		/* vertical clipping */
+		j = MAX(0, clip_y1 - y);
+		h = MIN(font->img_h, clip_y2 - y + 1);
+		if (j >= h) return -1;
 
 		/* skip characters that are completely hidden by the left clipping border */
-		while (*str && (x+wtab[(int)(*str)] < clip_x1)) {
-			x+=wtab[(int)(*str)];
-			dst+=wtab[(int)(*str)];
-			str++;
-		}
+		while (*str && (x + wtab[*str] <= clip_x1)) x += wtab[*str++];
 
-		/* draw left cutted character */
-		if (*str && (x+wtab[(int)(*str)] - 1 <= clip_x2) && (x < clip_x1)) {
-			w = wtab[(int)(*str)] - (clip_x1 - x);
-			s = src + otab[(int)(*str)] + (clip_x1 - x);
-			d = dst + (clip_x1 - x);
-			for (j = 0; j < h; j++) {
-				for (i = 0; i < w; i++) {
-					if (s[i]) d[i] = color;
-				}
-				s = s + img_w;
-				d = d + scr_width;
-			}
-			dst += wtab[(int)(*str)];
-			x   += wtab[(int)(*str)];
-			str++;
-		}
+		/* find first character that is hidden by the right clipping border */
+		for (end = str, cx = x; *end && (cx <= clip_x2); cx += wtab[*end++]);
 
-		/* draw horizontally full visible characters */
-		while (*str && (x + wtab[(int)(*str)] - 1 < clip_x2)) {
-			w = wtab[(int)(*str)];
-			s = src + otab[(int)(*str)];
-			d = dst;
-			for (j = 0; j < h; j++) {
-				for (i = 0; i < w; i++) {
-					if (s[i]) d[i] = color;
-				}
-				s = s + img_w;
-				d = d + scr_width;
-			}
-			dst += wtab[(int)(*str)];
-			x   += wtab[(int)(*str)];
-			str++;
-		}
+		for (dst = (Pixel*)scr_adr + (y + j)*scr_width; j < h; j++, dst += scr_width) {
+			for (c = str, cx = x; c < end; cx += wtab[*c++]) {
+				span = font->spans + 2*stab[*c*stride + j];
+				last = font->spans + 2*stab[*c*stride + j + 1];
 
-		/* draw right cutted character */
-		if (*str) {
-			w = wtab[(int)(*str)];
-			s = src + otab[(int)(*str)];
-			d = dst;
-			if (x + w - 1 > clip_x2) {
-				w -= x + w - 1 - clip_x2;
-			}
-			if (x < clip_x1) {    /* check if character is also left-cutted */
-				w -= clip_x1 - x;
-				s += clip_x1 - x;
-				d += clip_x1 - x;
-			}
-			for (j = 0; j < h; j++) {
-				for (i = 0; i < w; i++) {
-					if (s[i]) d[i] = color;
+				for (; span < last; span += 2) {
+					x1 = MAX(cx + span[0], clip_x1);
+					x2 = MIN(cx + span[0] + span[1] - 1, clip_x2);
+					if (x1 <= x2) solid_hline(dst + x1, x2 - x1 + 1, color);
 				}
-				s += img_w;
-				d += scr_width;
 			}
 		}
 		return 0;
@@ -727,9 +575,9 @@ int init_gfxscr16(struct dope_services *d) {
 	clip    = (clipping_services*)d->get_module("Clipping 1.0");
 	cache   = (cache_services*)d->get_module("Cache 1.0");
 
-	imgcache = cache->create(100, 1000*1000);
+	imgcache = cache->create(100, 1000*1000, "yuv");
 
-	init_yuv2rgb();
+	blit_init();
 
 	d->register_module("GfxScreen16 1.0", &services);
 	return 1;
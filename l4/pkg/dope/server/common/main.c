@@ -106,6 +106,7 @@ int config_transparency  = 0;   /* use translucent effects                */
 int config_don_scheduler = 0;   /* use donation scheduler                 */
 int config_clackcommit   = 0;   /* deliver commit events on mouse release */
 int config_winborder     = 5;   /* size of window resize border           */
+int config_cachestats    = 0;   /* cache statistics interval in seconds   */
 
 int main(int argc,char **argv) {
 	INFO(char *dbg="Main(init): ");
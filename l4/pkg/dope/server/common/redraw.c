@@ -7,6 +7,15 @@
  * widgets.  Redraw-actions are stored in a queue
  * (by widgets) and executed later (at the end of
  * a period).
+ *
+ * The pending actions of a widget form its damage
+ * region, a short list of disjoint rectangles. The
+ * list is linked through the queue and its newest
+ * element is referenced by the widget, which makes
+ * the lookup for a new request O(1). A request is
+ * merged with a pending rectangle only if they
+ * overlap or if the bounding box does not waste
+ * too much area.
  */
 
 /*
@@ -39,10 +48,12 @@ WIDGET {
 };
 
 #define REDRAW_QUEUE_SIZE 5000
+#define REDRAW_MAX_RECTS  8     /* max. pending actions per widget */
 
 struct action {
 	WIDGET *wid;             /* associated widget */
 	int     x1, y1, x2, y2;  /* area on screen    */
+	s32     older, newer;    /* queued actions of the same widget */
 };
 
 static struct action action_queue[REDRAW_QUEUE_SIZE];
@@ -66,20 +77,49 @@ static u32 get_noque(void) {
 
 /*** DETERMINE IF SPECIFIED WIDGET IS CURRENTLY QUEUED ***/
 static s32 is_queued(WIDGET *w) {
-	s32 cmp_idx = last;
-	while (cmp_idx!=first) {
-		if (action_queue[cmp_idx].wid == w) return 1;
-		cmp_idx = (cmp_idx + 1) % REDRAW_QUEUE_SIZE;
-	}
-	return 0;
+	return w->wd->redraw_idx >= 0;
+}
+
+
+/*** RETURN POSITION OF ACTION IN THE QUEUE, 0 IS THE OLDEST ***/
+static inline s32 queue_pos(s32 idx) {
+	return (idx + REDRAW_QUEUE_SIZE - last) % REDRAW_QUEUE_SIZE;
+}
+
+
+/*** REMOVE ACTION FROM THE ACTION LIST OF ITS WIDGET ***/
+static inline void unlink_action(s32 idx) {
+	struct action *a = &action_queue[idx];
+
+	if (a->newer >= 0) action_queue[a->newer].older = a->older;
+	else a->wid->wd->redraw_idx = a->older;
+
+	if (a->older >= 0) action_queue[a->older].newer = a->newer;
+}
+
+
+/*** DROP ACTION THAT WAS MERGED INTO ANOTHER ONE ***
+ *
+ * The queue element stays in place but draws nothing.
+ */
+static inline void drop_action(s32 idx) {
+	struct action *a = &action_queue[idx];
+
+	unlink_action(idx);
+	a->wid->gen->dec_ref(a->wid);
+	a->wid = NULL;
+	a->x1 = a->y1 = a->x2 = 0;
+	a->y2 = -1;
 }
 
 
 /*** REMOVE LAST ELEMENT FROM ACTION QUEUE ***/
 static inline void remove_last_action(void) {
 	WIDGET *w;
-	if ((w = action_queue[last].wid))
+	if ((w = action_queue[last].wid)) {
+		unlink_action(last);
 		w->gen->dec_ref(w);
+	}
 	last = (last + 1) % REDRAW_QUEUE_SIZE;
 }
 
@@ -106,6 +146,24 @@ static inline int intersect(long ax1, long ay1, long ax2, long ay2,
 }
 
 
+/*** CHECK IF DRAWING THE BOUNDING BOX IS CHEAPER THAN DRAWING BOTH ***
+ *
+ * Overlapping rectangles are always merged. Otherwise, the bounding box
+ * may exceed the area of both rectangles by a quarter.
+ */
+static inline int worth_merging(long ax1, long ay1, long ax2, long ay2,
+                                long bx1, long by1, long bx2, long by2) {
+	long mx1, my1, mx2, my2, sum;
+
+	if (intersect(ax1, ay1, ax2, ay2, bx1, by1, bx2, by2)) return 1;
+
+	merge(ax1, ay1, ax2, ay2, bx1, by1, bx2, by2, &mx1, &my1, &mx2, &my2);
+
+	sum = (ax2 - ax1 + 1)*(ay2 - ay1 + 1) + (bx2 - bx1 + 1)*(by2 - by1 + 1);
+	return (mx2 - mx1 + 1)*(my2 - my1 + 1) <= sum + sum/4;
+}
+
+
 /*** SPLIT RECTANGLE INTO TWO DISJOINT RECTANGLES ***
  *
  * This function splits the source rectangle into two destination
@@ -130,12 +188,13 @@ static inline void split(int  sx1, int  sy1, int  sx2, int  sy2,
 }
 
 static void add_redraw_action(WIDGET *w, int x1, int y1, int x2, int y2) {
-	int curr_idx;
+	s32 i, target = -1, newest, cnt;
+	struct action *a;
 
 	if (x1 > x2 || y1 > y2) return;
 
 	/* check if the last queue element refers to the same widgets */
-	if (action_queue[last].wid == w) {
+	if (last != first && action_queue[last].wid == w) {
 		struct action *a = &action_queue[last];
 		long mx1, my1, mx2, my2;
 
@@ -152,34 +211,70 @@ static void add_redraw_action(WIDGET *w, int x1, int y1, int x2, int y2) {
 
 	if (x1 > x2 || y1 > y2) return;
 
-	/* skip last element */
-	curr_idx = (last == first) ? last : last + 1;
-
-	/* search for queue entry that affect the same widget */
-	while (curr_idx != first && action_queue[curr_idx].wid != w) {
-		curr_idx = (curr_idx + 1) % REDRAW_QUEUE_SIZE;
-	}
-
 //	printf("add_redraw_action: wid=%p type=%s, xywh=%d,%d,%d,%d\n", w, w->gen->get_type(w), x1, y1, x2 - x1 + 1,
 //	 y2 - y1 + 1);
 
-	/* if there are no queue entries left to check - add the action */
-	if (curr_idx == first) {
-		w->gen->inc_ref(w);
-		action_queue[first].wid = w;
-		action_queue[first].x1  = x1;
-		action_queue[first].y1  = y1;
-		action_queue[first].x2  = x2;
-		action_queue[first].y2  = y2;
-		first = (first + 1) % REDRAW_QUEUE_SIZE;
-		return;
+	/*
+	 * Merge the request with the pending actions of the widget. If it
+	 * grows, it may become worth merging with other actions as well.
+	 * The last queue element is skipped because it may be in progress.
+	 */
+	for (;;) {
+		newest = -1;
+		cnt    = 0;
+		for (i = w->wd->redraw_idx; i >= 0; i = action_queue[i].older) {
+			if (i == last || i == target) continue;
+			if (newest < 0) newest = i;
+			cnt++;
+
+			a = &action_queue[i];
+			if (worth_merging(x1, y1, x2, y2, a->x1, a->y1, a->x2, a->y2))
+				break;
+		}
+
+		/* too many rectangles, merge with the newest one */
+		if (i < 0 && target < 0 && cnt >= REDRAW_MAX_RECTS) i = newest;
+
+		if (i < 0) break;
+
+		a  = &action_queue[i];
+		x1 = MIN(x1, a->x1);
+		y1 = MIN(y1, a->y1);
+		x2 = MAX(x2, a->x2);
+		y2 = MAX(y2, a->y2);
+
+		/* keep the older queue position of both actions */
+		if (target < 0) {
+			target = i;
+		} else if (queue_pos(i) < queue_pos(target)) {
+			drop_action(target);
+			target = i;
+		} else {
+			drop_action(i);
+		}
+
+		a = &action_queue[target];
+		a->x1 = x1;
+		a->y1 = y1;
+		a->x2 = x2;
+		a->y2 = y2;
 	}
 
-	/* merge both redraw requests */
-	action_queue[curr_idx].x1 = MIN(action_queue[curr_idx].x1, x1);
-	action_queue[curr_idx].y1 = MIN(action_queue[curr_idx].y1, y1);
-	action_queue[curr_idx].x2 = MAX(action_queue[curr_idx].x2, x2);
-	action_queue[curr_idx].y2 = MAX(action_queue[curr_idx].y2, y2);
+	if (target >= 0) return;
+
+	/* add the action as newest rectangle of the widget */
+	w->gen->inc_ref(w);
+	a = &action_queue[first];
+	a->wid   = w;
+	a->x1    = x1;
+	a->y1    = y1;
+	a->x2    = x2;
+	a->y2    = y2;
+	a->newer = -1;
+	a->older = w->wd->redraw_idx;
+	if (a->older >= 0) action_queue[a->older].newer = first;
+	w->wd->redraw_idx = first;
+	first = (first + 1) % REDRAW_QUEUE_SIZE;
 }
 
 
@@ -347,13 +442,14 @@ static void verify(void) {
 
 	for (j = last; j != first; j = (j + 1) % REDRAW_QUEUE_SIZE) {
 		struct action *a1 = &action_queue[j];
-		i = (j + 1) % REDRAW_QUEUE_SIZE;
 
-		for (; i != first; i = (i + 1) % REDRAW_QUEUE_SIZE) {
+		if (!a1->wid) continue;
+
+		/* compare with the newer actions of the widget */
+		for (i = a1->newer; i >= 0; i = action_queue[i].newer) {
 			struct action *a2 = &action_queue[i];
 
-			if ((a1->wid == a2->wid)
-			 && intersect(a1->x1, a1->y1, a1->x2, a1->y2,
+			if (intersect(a1->x1, a1->y1, a1->x2, a1->y2,
 			              a2->x1, a2->y1, a2->x2, a2->y2)) {
 
 				 printf("Two queue elements refer to widget %p\n", a1->wid);
@@ -44,6 +44,7 @@ static struct loaddisplay_services *loaddisplay;
 struct timeslot {
 	WIDGET *w;
 	MUTEX  *sync_mutex;
+	void  (*frame_cb)(WIDGET *);
 } ts[NUM_SLOTS];
 
 extern SCREEN *curr_scr;
@@ -89,6 +90,7 @@ static void rt_remove_widget(WIDGET *w) {
 		if (ts[i].w == w) {
 			ts[i].w = NULL;
 			ts[i].sync_mutex = NULL;
+			ts[i].frame_cb   = NULL;
 			w->gen->dec_ref(w);
 			return;
 		}
@@ -121,6 +123,20 @@ static void rt_set_sync_mutex(WIDGET *w,MUTEX *m) {
 }
 
 
+/*** SET FUNCTION THAT IS CALLED BEFORE DRAWING OPERATIONS ***/
+static void rt_set_frame_callback(WIDGET *w, void (*cb)(WIDGET *)) {
+	s32 i;
+
+	/* search slot of the given widget */
+	for (i=0;i<NUM_SLOTS;i++) {
+		if (ts[i].w == w) {
+			ts[i].frame_cb = cb;
+			return;
+		}
+	}
+}
+
+
 /*** MAINLOOP OF DOpE ***
  *
  * Within the mainloop we must do the following things:
@@ -188,6 +204,7 @@ static void process_mainloop(void) {
 
 		if ((cw = ts[curr_slot].w)) {
 			cw->gen->lock(cw);
+			if (ts[curr_slot].frame_cb) ts[curr_slot].frame_cb(cw);
 			cw->gen->drawarea(cw, cw, 0, 0, cw->wd->w, cw->wd->h);
 			cw->gen->unlock(cw);
 		}
@@ -246,6 +263,7 @@ static struct scheduler_services services = {
 	rt_remove_widget,
 	rt_release_app,
 	rt_set_sync_mutex,
+	rt_set_frame_callback,
 	process_mainloop,
 };
 
@@ -1042,6 +1042,37 @@ static int exec_command(u32 app_id, const char *cmd, char *dst, int dst_len) {
 }
 
 
+/*** EXECUTE SEQUENCE OF DOPE COMMANDS ***
+ *
+ * \param cmds      null-terminated commands, one after the other
+ * \param cmds_len  length of cmds in bytes
+ * \param errs      destination for pairs of command index and error
+ * \param errs_len  in: capacity of errs, out: number of values stored
+ * \return          number of failed commands, or DOPECMD_ERR_UNCOMPLETE
+ *                  if cmds is empty or its last command is not terminated
+ */
+static int exec_batch(u32 app_id, const char *cmds, int cmds_len,
+                      long *errs, int *errs_len) {
+	int i, pos, ret, failed = 0, max = *errs_len;
+
+	*errs_len = 0;
+
+	/* reject the whole batch if it is empty or its last command is cut */
+	if (cmds_len <= 0 || cmds[cmds_len - 1]) return DOPECMD_ERR_UNCOMPLETE;
+
+	for (i = 0, pos = 0; pos < cmds_len; i++, pos += strlen(cmds + pos) + 1) {
+		ret = exec_command(app_id, cmds + pos, NULL, 0);
+		if (ret >= 0) continue;
+
+		failed++;
+		if (*errs_len + 2 > max) continue;
+		errs[(*errs_len)++] = i;
+		errs[(*errs_len)++] = ret;
+	}
+	return failed;
+}
+
+
 /****************************************
  *** SERVICE STRUCTURE OF THIS MODULE ***
  ****************************************/
@@ -1051,6 +1082,7 @@ static struct script_services services = {
 	register_widget_method,
 	register_widget_attrib,
 	exec_command,
+	exec_batch,
 };
 
 
@@ -34,7 +34,8 @@ struct vscreen;
 #include "keycodes.h"
 #include "window.h"
 
-#define MAX_IDENTS 40
+#define MAX_IDENTS  40
+#define MAX_BUFFERS 3
 
 #define VSCR_MOUSEMODE_FREE    0
 #define VSCR_MOUSEMODE_GRAB    1
@@ -66,6 +67,14 @@ struct vscreen_data {
 	char    smb_ident[64];       /* shared memory block identifier               */
 	void   *pixels;              /* pointer to page aligned pixel buffer         */
 	GFX_CONTAINER *image;        /* image representation (for drawing)           */
+	GFX_CONTAINER *buf[MAX_BUFFERS]; /* frame buffers of a multi-buffered vscreen  */
+	s32     img_type;            /* image type of the frame buffers              */
+	s8      num_buf;             /* number of frame buffers                      */
+	s8      front;               /* buffer that is currently displayed           */
+	s8      pending;             /* published buffer or -1                       */
+	s8      publish_wait;        /* publisher waits for the next frame switch    */
+	MUTEX  *buf_mutex;           /* protects front, pending and publish_wait     */
+	MUTEX  *latch_mutex;         /* released when the frame switch happened      */
 	s16     grabmouse;           /* mouse grab mode flag 0=free 1=grab 2=grabbed */
 	VSCREEN *share_next;         /* next vscreen widget with shared buffer       */
 	s32     vw, vh;              /* view size                                    */
@@ -114,6 +123,81 @@ static void vscr_share_join(VSCREEN *vs, VSCREEN *new) {
 }
 
 
+/*** SWITCH TO THE MOST RECENTLY PUBLISHED FRAME ***
+ *
+ * For real-time vscreens, this function is called by the scheduler
+ * right before each periodic redraw. Hence, a published frame is
+ * never displayed partially.
+ */
+static void vscr_latch(VSCREEN *vs) {
+	struct vscreen_data *vd = vs->vd;
+	GFX_CONTAINER *img;
+
+	thread->mutex_down(vd->buf_mutex);
+	if ((vd->pending >= 0) && (img = vd->buf[vd->pending])) {
+		gfx->inc_ref(img);
+		if (vd->image) gfx->dec_ref(vd->image);
+		vd->image   = img;
+		vd->pixels  = gfx->map(img);
+		vd->front   = vd->pending;
+	}
+	vd->pending = -1;
+
+	/* wake up a publisher that waits for its buffer to become free */
+	if (vd->publish_wait) {
+		vd->publish_wait = 0;
+		thread->mutex_up(vd->latch_mutex);
+	}
+	thread->mutex_up(vd->buf_mutex);
+}
+
+
+/*** RELEASE FRAME BUFFERS ***
+ *
+ * The currently displayed image stays referenced by vd->image.
+ */
+static void vscr_free_buffers(VSCREEN *vs) {
+	struct vscreen_data *vd = vs->vd;
+	int i;
+
+	/* do not leave a waiting publisher behind */
+	vscr_latch(vs);
+
+	for (i = 0; i < MAX_BUFFERS; i++) {
+		if (vd->buf[i]) gfx->dec_ref(vd->buf[i]);
+		vd->buf[i] = NULL;
+	}
+	vd->front = 0;
+}
+
+
+/*** ALLOCATE FRAME BUFFERS AND DISPLAY THE FIRST ONE ***
+ *
+ * \return  1 on success
+ */
+static int vscr_alloc_buffers(VSCREEN *vs, s32 width, s32 height, s32 type) {
+	struct vscreen_data *vd = vs->vd;
+	int i;
+
+	vscr_free_buffers(vs);
+
+	for (i = 0; i < vd->num_buf; i++) {
+		if (!(vd->buf[i] = gfx->alloc_img(width, height, type))) {
+			vscr_free_buffers(vs);
+			return 0;
+		}
+	}
+
+	gfx->inc_ref(vd->buf[0]);
+	if (vd->image) gfx->dec_ref(vd->image);
+	vd->image    = vd->buf[0];
+	vd->pixels   = gfx->map(vd->image);
+	vd->img_type = type;
+	gfx->get_ident(vd->image, &vd->smb_ident[0]);
+	return 1;
+}
+
+
 /******************************
  *** GENERAL WIDGET METHODS ***
  ******************************/
@@ -275,7 +359,10 @@ static void vscr_free_data(VSCREEN *vs) {
 	if ((userstate->get() == USERSTATE_GRAB) && (userstate->get_selected() == vs))
 		userstate->idle();
 	
-	if (vs->wd->ref_cnt == 0) vscr_share_exclude(vs);
+	if (vs->wd->ref_cnt == 0) {
+		vscr_free_buffers(vs);
+		vscr_share_exclude(vs);
+	}
 }
 
 
@@ -317,9 +404,17 @@ static void vscr_set_framerate(VSCREEN *vs, s32 framerate) {
 
 	if (framerate == 0) {
 		sched->remove(vs);
+		vs->vd->fps = 0;
+
+		/* no periodic redraw will pick up a pending frame anymore */
+		vscr_latch(vs);
 	} else {
-		sched->add(vs, 1000/framerate);
+		if (sched->add(vs, 1000/framerate) < 0) {
+			ERROR(printf("VScreen(set_framerate): no free real-time slot\n");)
+			return;
+		}
 		sched->set_sync_mutex(vs, vs->vd->sync_mutex);
+		sched->set_frame_callback(vs, vscr_latch);
 		vs->vd->fps = framerate;
 	}
 }
@@ -417,11 +512,8 @@ static s32 vscr_set_mode(VSCREEN *vs, s32 width, s32 height, char *mode) {
 	if (!vscr_probe_mode(vs, width, height, mode)) return 0;
 
 	/* destroy old image buffer and reset values */
-	switch (vs->vd->bpp) {
-	case 16:
-	case 32:
-		if (vs->vd->image) gfx->dec_ref(vs->vd->image);
-	}
+	vscr_free_buffers(vs);
+	if (vs->vd->image) gfx->dec_ref(vs->vd->image);
 
 	vs->vd->bpp     = 0;
 	vs->vd->xres    = 0;
@@ -442,13 +534,11 @@ static s32 vscr_set_mode(VSCREEN *vs, s32 width, s32 height, char *mode) {
 		return 0;
 	}
 
-	if ((vs->vd->image = gfx->alloc_img(width, height, type))) {
+	if (vscr_alloc_buffers(vs, width, height, type)) {
 		vs->vd->xres   = width;
 		vs->vd->yres   = height;
 		vs->vd->vw     = width;
 		vs->vd->vh     = height;
-		vs->vd->pixels = gfx->map(vs->vd->image);
-		gfx->get_ident(vs->vd->image, &vs->vd->smb_ident[0]);
 	} else {
 		ERROR(printf("VScreen(set_mode): out of memory!\n");)
 		return 0;
@@ -499,20 +589,112 @@ static void vscr_refresh(VSCREEN *vs, s32 x, s32 y, s32 w, s32 h) {
 }
 
 
+/*** SET NUMBER OF FRAME BUFFERS ***
+ *
+ * If a mode is already set, the buffers are reallocated and
+ * their content is lost.
+ */
+static void vscr_set_buffers(VSCREEN *vs, s32 num_buf) {
+	if (num_buf < 1)           num_buf = 1;
+	if (num_buf > MAX_BUFFERS) num_buf = MAX_BUFFERS;
+	if (num_buf == vs->vd->num_buf) return;
+
+	vs->vd->num_buf = num_buf;
+
+	/* vscreens that share the buffer of another vscreen have no own buffers */
+	if (!vs->vd->buf[0]) return;
+
+	if (!vscr_alloc_buffers(vs, vs->vd->xres, vs->vd->yres, vs->vd->img_type)) {
+		ERROR(printf("VScreen(set_buffers): out of memory!\n");)
+		vs->vd->num_buf = 1;
+		vscr_alloc_buffers(vs, vs->vd->xres, vs->vd->yres, vs->vd->img_type);
+	}
+}
+
+
+/*** REQUEST NUMBER OF FRAME BUFFERS ***/
+static s32 vscr_get_buffers(VSCREEN *vs) {
+	return vs->vd->num_buf;
+}
+
+
+/*** PUBLISH NEW FRAME ***
+ *
+ * \param buffer  buffer that contains the completed frame
+ * \return        buffer to draw the next frame into, or -1
+ *
+ * For real-time vscreens, the new frame is displayed with the next
+ * periodic redraw. With three buffers, the publisher never waits.
+ * A frame that was published but not displayed yet gets dropped in
+ * favour of the new one. With two buffers, the only buffer left for
+ * drawing is the one on screen. Therefore, the function returns
+ * not before the scheduler switched to the new frame.
+ */
+static s32 vscr_publish(VSCREEN *vs, s32 buffer) {
+	struct vscreen_data *vd = vs->vd;
+	s32 next;
+	int wait = 0;
+
+	if ((buffer < 0) || (buffer >= vd->num_buf) || !vd->buf[buffer]) return -1;
+
+	/* single-buffered vscreens are just refreshed */
+	if (vd->num_buf == 1) {
+		if (!vd->fps) vscr_refresh(vs, 0, 0, -1, -1);
+		return 0;
+	}
+
+	thread->mutex_down(vd->buf_mutex);
+	if (buffer == vd->front) {
+		thread->mutex_up(vd->buf_mutex);
+		return -1;
+	}
+
+	if ((vd->pending >= 0) && (vd->pending != buffer))
+		next = vd->pending;
+	else if (vd->num_buf == 2)
+		next = vd->front;
+	else
+		for (next = 0; (next == vd->front) || (next == buffer); next++);
+
+	vd->pending = buffer;
+	if (vd->fps && (vd->num_buf == 2))
+		wait = vd->publish_wait = 1;
+	thread->mutex_up(vd->buf_mutex);
+
+	if (wait) {
+		thread->mutex_down(vd->latch_mutex);
+
+	/* without periodic redraw, switch frames immediately */
+	} else if (!vd->fps) {
+		vscr_latch(vs);
+		vscr_refresh(vs, 0, 0, -1, -1);
+	}
+	return next;
+}
+
+
 /*** MAP VSCREEN BUFFER TO ANOTHER THREAD'S ADDRESS SPACE ***/
-static char *vscr_map(VSCREEN *vs, char *dst_thread_ident) {
+static char *vscr_map(VSCREEN *vs, char *dst_thread_ident, s32 buffer) {
 	s32 app_id;
 	char dst_th_buf[16];
 	THREAD *dst_th = (THREAD *)(void *)dst_th_buf;
-	
+	GFX_CONTAINER *img = vs->vd->image;
+
 	if (!vs->vd->image) return "Error: VScreen mode not initialized.";
 
+	/* select frame buffer of a multi-buffered vscreen */
+	if ((buffer < 0) || (buffer >= vs->vd->num_buf))
+		return "Error: VScreen buffer does not exist.";
+	if (vs->vd->buf[buffer]) img = vs->vd->buf[buffer];
+	else if (buffer) return "Error: VScreen buffer does not exist.";
+
 	/* if no valid thread identifier was suppied we map to the app's thread */
 	if (thread->ident2thread(dst_thread_ident, dst_th)) {
 		app_id = vs->gen->get_app_id(vs);
 		dst_th = appman->get_app_thread(app_id);
 	}
-	gfx->share(vs->vd->image, dst_th);
+	gfx->share(img, dst_th);
+	gfx->get_ident(img, &vs->vd->smb_ident[0]);
 	INFO(printf("VScreen(map): return vs->vd->smb_ident = %s\n", &vs->vd->smb_ident[0]));
 	return &vs->vd->smb_ident[0];
 }
@@ -528,6 +710,9 @@ static void vscr_share(VSCREEN *vs, VSCREEN *from) {
 
 	if (!from || !(new_image = from->vscr->get_image(from))) return;
 
+	/* the own frame buffers of a former set_mode are not shown anymore */
+	vscr_free_buffers(vs);
+
 	/*
 	 * Increment reference counter of new image before decrementing
 	 * the reference counter of the old one. If both images are the
@@ -574,6 +759,7 @@ static struct vscreen_methods vscreen_methods = {
 	vscr_reg_server,
 	vscr_waitsync,
 	vscr_refresh,
+	vscr_publish,
 	vscr_get_image,
 };
 
@@ -588,7 +774,11 @@ static VSCREEN *create(void) {
 	SET_WIDGET_DEFAULTS(new, struct vscreen, &vscreen_methods);
 
 	/* set widget type specific data */
-	new->vd->sync_mutex = thread->create_mutex(1);  /* locked */
+	new->vd->sync_mutex  = thread->create_mutex(1);  /* locked */
+	new->vd->buf_mutex   = thread->create_mutex(0);
+	new->vd->latch_mutex = thread->create_mutex(1);  /* locked */
+	new->vd->num_buf     = 1;
+	new->vd->pending     = -1;
 	new->wd->flags |= WID_FLAGS_CONCEALING | WID_FLAGS_EDITABLE;
 	return new;
 }
@@ -615,11 +805,13 @@ static void build_script_lang(void) {
 	script->reg_widget_method(widtype, "long probemode(long width, long height, string mode)", vscr_probe_mode);
 	script->reg_widget_method(widtype, "long setmode(long width, long height, string mode)", vscr_set_mode);
 	script->reg_widget_method(widtype, "string getserver()", vscr_get_server);
-	script->reg_widget_method(widtype, "string map(string thread=\"caller\")", vscr_map);
+	script->reg_widget_method(widtype, "string map(string thread=\"caller\", long buffer=0)", vscr_map);
 	script->reg_widget_method(widtype, "void refresh(long x=0, long y=0, long w=-1, long h=-1)", vscr_refresh);
+	script->reg_widget_method(widtype, "long publish(long buffer)", vscr_publish);
 	script->reg_widget_method(widtype, "void share(Widget from)", vscr_share);
 
 	script->reg_widget_attrib(widtype, "long framerate", vscr_get_framerate, vscr_set_framerate, gen_methods.update);
+	script->reg_widget_attrib(widtype, "long buffers", vscr_get_buffers, vscr_set_buffers, gen_methods.update);
 	script->reg_widget_attrib(widtype, "string fixw", NULL, vscr_set_fixw, gen_methods.update);
 	script->reg_widget_attrib(widtype, "string fixh", NULL, vscr_set_fixh, gen_methods.update);
 	script->reg_widget_attrib(widtype, "long mousex", vscr_get_mx, vscr_set_mx, gen_methods.update);
@@ -46,6 +46,7 @@ struct vtextscreen_data {
 	SHAREDMEM *smb;                 /* shared representation buffer id       */
 	char       smb_ident[64];       /* identifier for shared memory block    */
 	u8        *buffer;              /* pointer to text representation buffer */
+	u8        *shadow;              /* buffer content drawn last             */
 	char      *tmpstr;              /* string buffer for gfx output          */
 	int        fn_w, fn_h;          /* size of monospaced character          */
 	int        font_id;             /* font id of used monospaced font       */
@@ -143,28 +144,55 @@ static int vtextscr_draw(VTEXTSCREEN *vts, struct gfx_ds *ds, long x, long y, WI
 		ret |= vts->gen->drawbehind(vts, vts, 0, 0, vts->wd->w, vts->wd->h, origin);
 
 	if ((vts->vd->mode == VTEXTSCR_MODE_C8A8PLN)) {
-		u8   *cbuf, *abuf;
+		u8   *cbuf, *abuf, *cshd, *ashd, *csrc, *asrc;
 		char *s = vts->vd->tmpstr;
 		int   w = vts->vd->xres;
 		int   h = vts->vd->yres;
 		int   font_id = vts->vd->font_id;
-		int   i, j, len;
+		int   i, j, len, end, full;
 		int   b;
 		u32   bg, fg;
-		
+		int   cx = gfx->get_clip_x(ds) - x, cw = gfx->get_clip_w(ds);
+		int   cy = gfx->get_clip_y(ds) - y, ch = gfx->get_clip_h(ds);
+
+		/* character cells that intersect the clipping area */
+		int   i1 = MAX(0, cx/fn_w), i2 = MIN(w, (cx + cw + fn_w - 1)/fn_w);
+		int   j1 = MAX(0, cy/fn_h), j2 = MIN(h, (cy + ch + fn_h - 1)/fn_h);
+
+		/* character cells that are completely inside the clipping area */
+		int   f1 = MAX(0, (cx + fn_w - 1)/fn_w), f2 = MIN(w, (cx + cw)/fn_w);
+		int   g1 = MAX(0, (cy + fn_h - 1)/fn_h), g2 = MIN(h, (cy + ch)/fn_h);
+
 		/* draw text line */
-		for (j = 0; j < h; j++) {
-			cbuf = vts->vd->buffer + w*j;
-			abuf = vts->vd->buffer + w*(h+j);
-			
-			for (i = 0; i < w;) {
-				len = extract_substring(&cbuf[i], &abuf[i], s, w-i);
+		for (j = j1; j < j2; j++) {
+			cbuf = cshd = vts->vd->buffer + w*j;
+			abuf = ashd = vts->vd->buffer + w*(h+j);
+
+			/* the shadow holds what is on screen, so only completely
+			 * drawn cells are copied to it and drawn from there */
+			full = vts->vd->shadow && (j >= g1) && (j < g2) && (f1 < f2);
+			if (full) {
+				cshd = vts->vd->shadow + w*j;
+				ashd = vts->vd->shadow + w*(h+j);
+				memcpy(&cshd[f1], &cbuf[f1], f2 - f1);
+				memcpy(&ashd[f1], &abuf[f1], f2 - f1);
+			}
+
+			for (i = i1; i < i2;) {
+
+				/* partially visible cells at the edges come from buffer */
+				if (full && (i >= f1) && (i < f2)) {
+					csrc = cshd; asrc = ashd; end = f2;
+				} else {
+					csrc = cbuf; asrc = abuf; end = (i < f1) ? MIN(f1, i2) : i2;
+				}
+				len = extract_substring(&csrc[i], &asrc[i], s, end - i);
 				
 				/* set attibutes for this substring */
-				b = (abuf[i]>>6) & 3;
+				b = (asrc[i]>>6) & 3;
 				if (b>2) b = 2;
-				bg = bg_coltab[b + alpha_offset][abuf[i] & 7];
-				fg = fg_coltab[b][(abuf[i]>>3) & 7] | 0xff;
+				bg = bg_coltab[b + alpha_offset][asrc[i] & 7];
+				fg = fg_coltab[b][(asrc[i]>>3) & 7] | 0xff;
 
 				/* draw substring */
 				gfx->draw_box(ds, x + i*fn_w, y + j*fn_h, len*fn_w, fn_h, bg);
@@ -194,7 +222,7 @@ static int vtextscr_draw(VTEXTSCREEN *vts, struct gfx_ds *ds, long x, long y, WI
 }
 
 
-static void vtextscr_refresh(VTEXTSCREEN *vts, s32 x, s32 y, s32 w, s32 h);
+static void vtextscr_redraw_cells(VTEXTSCREEN *vts, s32 x, s32 y, s32 w, s32 h);
 
 /*** WIDGET UPDATE ***/
 static void (*orig_update) (WIDGET *);
@@ -208,8 +236,8 @@ static void vtextscr_update(VTEXTSCREEN *vts) {
 		vts->vd->curs_x = vts->vd->curs_nx;
 		vts->vd->curs_y = vts->vd->curs_ny;
 
-		vtextscr_refresh(vts, vts->vd->curs_x, vts->vd->curs_y, 1, 1);
-		vtextscr_refresh(vts, curs_ox, curs_oy, 1, 1);
+		vtextscr_redraw_cells(vts, vts->vd->curs_x, vts->vd->curs_y, 1, 1);
+		vtextscr_redraw_cells(vts, curs_ox, curs_oy, 1, 1);
 	}
 
 	orig_update(vts);
@@ -257,6 +285,7 @@ static s32 vtextscr_set_mode(VTEXTSCREEN *vts, s32 width, s32 height, char *mode
 	/* destroy old buffer and reset values */
 	if (vts->vd->smb)    shmem->destroy(vts->vd->smb);
 	if (vts->vd->tmpstr) free(vts->vd->tmpstr);
+	if (vts->vd->shadow) free(vts->vd->shadow);
 	
 	/* reset widget specific data */
 	set_default_values(vts);
@@ -270,10 +299,13 @@ static s32 vtextscr_set_mode(VTEXTSCREEN *vts, s32 width, s32 height, char *mode
 
 		/* allocate string buffer for conversion to gfx primitives */
 		vts->vd->tmpstr = malloc(width + 3);
+
+		/* allocate buffer for detecting changed character cells */
+		vts->vd->shadow = malloc(width * height * 2);
 	}
 
 	/* if anything went wrong free all resources and return */
-	if (!type || !vts->vd->smb || !vts->vd->tmpstr) {
+	if (!type || !vts->vd->smb || !vts->vd->tmpstr || !vts->vd->shadow) {
 		
 		ERROR(printf("VTextScreen(set_mode): mode %s not supported!\n", mode);)
 		
@@ -281,6 +313,8 @@ static s32 vtextscr_set_mode(VTEXTSCREEN *vts, s32 width, s32 height, char *mode
 		vts->vd->smb = NULL;
 		if (vts->vd->tmpstr) free(vts->vd->tmpstr);
 		vts->vd->tmpstr = NULL;
+		if (vts->vd->shadow) free(vts->vd->shadow);
+		vts->vd->shadow = NULL;
 		return 0;
 	}
 
@@ -293,6 +327,7 @@ static s32 vtextscr_set_mode(VTEXTSCREEN *vts, s32 width, s32 height, char *mode
 	if (type == VTEXTSCR_MODE_C8A8PLN) {
 		memset(vts->vd->buffer, 0, width*height);
 		memset(vts->vd->buffer + width*height, (7<<3) + (3<<6), width*height);
+		memcpy(vts->vd->shadow, vts->vd->buffer, width*height*2);
 	}
 
 	vts->wd->update |= WID_UPDATE_MINMAX;
@@ -301,12 +336,10 @@ static s32 vtextscr_set_mode(VTEXTSCREEN *vts, s32 width, s32 height, char *mode
 }
 
 
-/*** UPDATE A SPECIFIED AREA OF TEXT ***/
-static void vtextscr_refresh(VTEXTSCREEN *vts, s32 x, s32 y, s32 w, s32 h) {
+/*** REDRAW A SPECIFIED AREA OF CHARACTER CELLS ***/
+static void vtextscr_redraw_cells(VTEXTSCREEN *vts, s32 x, s32 y, s32 w, s32 h) {
 	int sx1, sy1, sx2, sy2;
 
-	if (w == -1) w = vts->vd->xres;
-	if (h == -1) h = vts->vd->yres;
 	if (w < 1 || h < 1) return;
 
 	/* convert text position to pixel position */
@@ -319,6 +352,62 @@ static void vtextscr_refresh(VTEXTSCREEN *vts, s32 x, s32 y, s32 w, s32 h) {
 }
 
 
+/*** UPDATE A SPECIFIED AREA OF TEXT ***
+ *
+ * Only the character cells that changed since they were drawn last are
+ * redrawn. Changed cells of adjacent lines are merged into one area.
+ */
+static void vtextscr_refresh(VTEXTSCREEN *vts, s32 x, s32 y, s32 w, s32 h) {
+	int xres = vts->vd->xres, yres = vts->vd->yres;
+	int i1, i2, j;
+	int bx1 = 0, bx2 = 0, by1 = -1;   /* pending area of changed cells */
+	u8 *cbuf, *abuf, *cshd, *ashd;
+
+	if (w == -1) w = xres;
+	if (h == -1) h = yres;
+
+	/* clip area against text screen */
+	if (x < 0) { w += x; x = 0; }
+	if (y < 0) { h += y; y = 0; }
+	if (x + w > xres) w = xres - x;
+	if (y + h > yres) h = yres - y;
+	if (w < 1 || h < 1) return;
+
+	if (!vts->vd->shadow) {
+		vtextscr_redraw_cells(vts, x, y, w, h);
+		return;
+	}
+
+	for (j = y; j < y + h; j++) {
+		cbuf = vts->vd->buffer + xres*j;
+		abuf = vts->vd->buffer + xres*(yres + j);
+		cshd = vts->vd->shadow + xres*j;
+		ashd = vts->vd->shadow + xres*(yres + j);
+
+		/* find first and last changed cell of the line */
+		for (i1 = x; (i1 < x + w) && (cbuf[i1] == cshd[i1]) && (abuf[i1] == ashd[i1]); i1++);
+		for (i2 = x + w - 1; (i2 >= i1) && (cbuf[i2] == cshd[i2]) && (abuf[i2] == ashd[i2]); i2--);
+
+		/* unchanged line, redraw pending area of the lines above */
+		if (i1 > i2) {
+			if (by1 >= 0) vtextscr_redraw_cells(vts, bx1, by1, bx2 - bx1 + 1, j - by1);
+			by1 = -1;
+			continue;
+		}
+
+		if (by1 < 0) {
+			by1 = j;
+			bx1 = i1;
+			bx2 = i2;
+		} else {
+			bx1 = MIN(bx1, i1);
+			bx2 = MAX(bx2, i2);
+		}
+	}
+	if (by1 >= 0) vtextscr_redraw_cells(vts, bx1, by1, bx2 - bx1 + 1, j - by1);
+}
+
+
 /*** MAP VTEXTSCREEN BUFFER TO ANOTHER THREAD'S ADDRESS SPACE ***/
 static char *vtextscr_map(VTEXTSCREEN *vts, char *dst_thread_ident) {
 	s32 app_id;
@@ -668,6 +668,7 @@ static void default_widget_data(struct widget_data *d) {
 	d->parent  = (void *)0;
 	d->click   = (void *)0;
 	d->ref_cnt = 1;
+	d->redraw_idx = -1;
 	d->app_id  = -1;
 	d->bindings= 0;
 }
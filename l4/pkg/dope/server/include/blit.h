@@ -0,0 +1,95 @@
+/*
+ * \brief   DOpE pixel line kernels
+ * \date    2026-10-19
+ *
+ * The YUV420 conversion and the image scaler of the screen handlers
+ * operate on single pixel lines. The line kernels are implemented in
+ * plain C and, if the CPU supports it, with SSE2. blit_init selects the
+ * fastest variant at runtime.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the DOpE package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef _DOPE_BLIT_H_
+#define _DOPE_BLIT_H_
+
+#include "dopestd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_SCALE_W 2048   /* max width of one blit_scale_offsets table */
+
+typedef struct blit_ops {
+
+	/*** COPY BYTES, SOURCE AND DESTINATION MUST NOT OVERLAP ***/
+	void (*copy)         (void *dst, const void *src, int bytes);
+
+	/*** CONVERT TWO LINES OF A YUV420 IMAGE TO RGB16 ***
+	 *
+	 * The w pixels of the luma lines y1 and y2 share w/2 chroma samples
+	 * of u and v. w must be even.
+	 */
+	void (*yuv420_rgb16) (u16 *dst1, u16 *dst2, const u8 *y1, const u8 *y2,
+	                      const u8 *u, const u8 *v, int w);
+
+	/*** DST[I] = SRC[XOFFS[I]] FOR W 16BIT PIXELS ***/
+	void (*scale16)      (u16 *dst, const u16 *src, const int *xoffs, int w);
+
+} blit_ops;
+
+extern blit_ops *blit;        /* kernels selected by blit_init */
+extern blit_ops  blit_c;      /* portable kernels              */
+extern blit_ops  blit_sse2;   /* SSE2 kernels, x86 only        */
+
+
+/*** SELECT KERNELS FOR THE CURRENT CPU ***
+ *
+ * \return  name of the selected kernel set
+ */
+extern const char *blit_init(void);
+
+
+/*** CONVERT A YUV420 IMAGE TO A 16-BIT HICOLOR IMAGE ***/
+extern void blit_yuv420_rgb16(int w, int h, const u8 *src_yuv420, u16 *dst);
+
+
+/*** CALCULATE SOURCE OFFSETS OF W SCALED PIXELS ***
+ *
+ * Wider images must be processed in strips of at most MAX_SCALE_W
+ * pixels, w is clamped to this size.
+ *
+ * \param sx  16.16 fixed-point position of the first pixel
+ * \param mx  16.16 fixed-point distance of two pixels
+ * \return    offset table, valid until the next call
+ */
+extern const int *blit_scale_offsets(int sx, int mx, int w);
+
+
+/*** DRAW SCALED 16BIT IMAGE ***
+ *
+ * Each source line is scaled horizontally only once. Destination lines
+ * that show the same source line are copied from the line above.
+ *
+ * \param dst, dst_w  destination and its line length in pixels
+ * \param src, src_w  source and its line length in pixels
+ * \param sx, sy      16.16 fixed-point position of the first pixel
+ * \param mx, my      16.16 fixed-point step per destination pixel
+ */
+extern void blit_scale16(u16 *dst, int dst_w, int w, int h,
+                         const u16 *src, int src_w,
+                         int sx, int sy, int mx, int my);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DOPE_BLIT_H_ */
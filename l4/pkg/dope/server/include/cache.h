@@ -19,12 +19,23 @@
 #define CACHE struct cache
 struct cache;
 
+struct cache_stats {
+	u32 hits;                       /* successful get_elem calls             */
+	u32 misses;                     /* get_elem calls for vanished elements  */
+	u32 inserts;                    /* elements admitted by add_elem         */
+	u32 rejects;                    /* elements refused by add_elem          */
+	u32 evictions;                  /* elements dropped to make room         */
+	s32 entries;                    /* number of cached elements             */
+	s32 size;                       /* current amount of cached data         */
+};
+
 struct cache_services {
-	CACHE *(*create)      (s32 max_entries,s32 max_size);
+	CACHE *(*create)      (s32 max_entries,s32 max_size,char *name);
 	void   (*destroy)     (CACHE *c);
 	s32    (*add_elem)    (CACHE *c,void *elem,s32 elemsize,s32 ident,void (*destroy)(void *));
 	void  *(*get_elem)    (CACHE *c,s32 index,s32 ident);
 	void   (*remove_elem) (CACHE *c,s32 index);
+	void   (*get_stats)   (CACHE *c,struct cache_stats *dst);
 };
 
 
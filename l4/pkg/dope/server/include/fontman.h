@@ -24,6 +24,14 @@ struct font {
 	s16  top,bottom;
 	u8  *image;
 	u8  *name;
+
+	/*
+	 * Horizontal runs of set pixels of all glyphs. The runs of line j of
+	 * character c are spans[2*i] (x offset) and spans[2*i + 1] (length)
+	 * for span_table[c*(img_h + 1) + j] <= i < span_table[c*(img_h + 1) + j + 1].
+	 */
+	s32 *span_table;
+	u8  *spans;
 };
 
 
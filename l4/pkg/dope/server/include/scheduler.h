@@ -47,6 +47,15 @@ struct scheduler_services {
 	void (*set_sync_mutex) (WIDGET *w, MUTEX *);
 
 
+	/*** REGISTER FRAME CALLBACK ***
+	 *
+	 * The scheduler calls this function right before each
+	 * periodic redraw of the widget. A widget can use it to
+	 * switch to a new frame at a well-defined point in time.
+	 */
+	void (*set_frame_callback) (WIDGET *w, void (*cb)(WIDGET *));
+
+
 	/*** MAINLOOP OF DOpE ***
 	 *
 	 * Within the mainloop we must update real-time widgets,
@@ -22,6 +22,8 @@ struct script_services {
 	void  (*reg_widget_method) (struct widtype *, char *desc, void *methadr);
 	void  (*reg_widget_attrib) (struct widtype *, char *desc, void *get, void *set, void *update);
 	int   (*exec_command)      (u32 app_id, const char *cmd, char *dst, int dst_len);
+	int   (*exec_batch)        (u32 app_id, const char *cmds, int cmds_len,
+	                            long *errs, int *errs_len);
 };
 
 
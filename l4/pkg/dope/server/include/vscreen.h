@@ -36,6 +36,7 @@ struct vscreen_methods {
 	void (*reg_server) (VSCREEN *, char *server_ident);
 	void (*waitsync)   (VSCREEN *);
 	void (*refresh)    (VSCREEN *, s32 x, s32 y, s32 w, s32 h);
+	s32  (*publish)    (VSCREEN *, s32 buffer);
 	GFX_CONTAINER *(*get_image) (VSCREEN *);
 };
 
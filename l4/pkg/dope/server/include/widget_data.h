@@ -68,6 +68,7 @@ struct widget_data {
 	WIDGET  *prev;              /* previous widget in a connected list */
 	void    (*click) (void *);  /* event handle routine                */
 	long    ref_cnt;            /* reference counter                   */
+	s32     redraw_idx;         /* newest pending redraw action or -1  */
 	s32     app_id;             /* application that owns the widget    */
 	struct binding *bindings;   /* event bindings                      */
 	struct new_binding *new_bindings;
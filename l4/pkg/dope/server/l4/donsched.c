@@ -49,6 +49,7 @@ struct job {
 	int               type;        /* type of job            */
 	l4_threadid_t     don_thread;  /* time donating thread   */
 	MUTEX            *sync_mutex;  /* redraw sync mutex      */
+	void            (*frame_cb)(WIDGET *); /* called before redraw */
 	WIDGET           *wid;         /* associated widget      */
 	u32               period;      /* period in msecs        */
 	u32               duration;    /* duration in usecs      */
@@ -211,8 +212,10 @@ static void exec_job(struct job *job) {
 			break;
 
 		case JOB_TYPE_RT:
-			if ((cw = job->wid))
+			if ((cw = job->wid)) {
+				if (job->frame_cb) job->frame_cb(cw);
 				cw->gen->drawarea(cw, cw, 0, 0, cw->gen->get_w(cw), cw->gen->get_h(cw));
+			}
 
 			if (job->sync_mutex)
 				thread->mutex_up(job->sync_mutex);
@@ -306,6 +309,14 @@ static void rt_set_sync_mutex(WIDGET *w, MUTEX *m) {
 }
 
 
+/*** SET FUNCTION THAT IS CALLED BEFORE DRAWING OPERATIONS ***/
+static void rt_set_frame_callback(WIDGET *w, void (*cb)(WIDGET *)) {
+	struct job *job = find_job_slot(w);
+	if (!job) return;
+	job->frame_cb = cb;
+}
+
+
 /*** MAINLOOP OF DOpE ***
  *
  * Within the mainloop we must do the following things:
@@ -377,6 +388,7 @@ static struct scheduler_services services = {
 	rt_remove_widget,
 	rt_remove_app,
 	rt_set_sync_mutex,
+	rt_set_frame_callback,
 	process_mainloop,
 };
 
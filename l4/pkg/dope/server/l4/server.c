@@ -169,6 +169,36 @@ long dope_manager_exec_req_component(CORBA_Object _dice_corba_obj,
 }
 
 
+long dope_manager_exec_batch_component(CORBA_Object _dice_corba_obj,
+                                       long app_id,
+                                       const char *cmds,
+                                       int cmds_len,
+                                       long errs[64],
+                                       int *errs_len,
+                                       CORBA_Server_Environment *_dice_corba_env) {
+	struct thread client_thread = { *_dice_corba_obj };
+	int ret;
+
+	/* check if the app_id belongs to the client */
+	if (!thread->thread_equal(&client_thread, appman->get_listener(app_id))) {
+		printf("Server(exec_batch): Error: permission denied\n");
+		*errs_len = 0;
+		return DOPE_ERR_PERM;
+	}
+
+	appman->reg_app_thread(app_id, (THREAD *)&client_thread);
+	INFO(printf("Server(exec_batch): %d bytes of commands requested by app_id=%u\n", cmds_len, (u32)app_id);)
+
+	/* execute the whole batch at once, the redraw sees all changes */
+	if (*errs_len > 64) *errs_len = 64;
+	appman->lock(app_id);
+	ret = script->exec_batch(app_id, cmds, cmds_len, errs, errs_len);
+	appman->unlock(app_id);
+	if (ret > 0) printf("DOpE(exec_batch): Error - %d commands failed\n", ret);
+	return ret;
+}
+
+
 long dope_manager_get_keystate_component(CORBA_Object _dice_corba_obj,
                                                long keycode,
                                                CORBA_Server_Environment *_dice_corba_env) {
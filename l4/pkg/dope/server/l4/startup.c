@@ -45,6 +45,7 @@ extern int config_don_scheduler;  /* use donation scheduling    */
 extern int config_transparency;   /* enable transparent windows */
 extern int config_clackcommit;    /* commit on mouse release    */
 extern int config_winborder;      /* size of window border      */
+extern int config_cachestats;     /* print cache statistics     */
 
 
 /*** GLOBAL L4 SPECIFIC VARIABLES ***/
@@ -73,12 +74,13 @@ static void do_args(int argc, char **argv) {
 		{"oldresize",     0, 0, 'r'},
 		{"winborder",     1, 0, 'b'},
 		{"menubar",       0, 0, 'm'},
+		{"cachestats",    1, 0, 's'},
 		{0, 0, 0, 0}
 	};
 
 	/* read command line arguments */
 	while (1) {
-		c = getopt_long(argc, argv, "fdtecrb:m", long_options, NULL);
+		c = getopt_long(argc, argv, "fdtecrb:ms:", long_options, NULL);
 
 		if (c == -1)
 			break;
@@ -116,6 +118,10 @@ static void do_args(int argc, char **argv) {
 				if (optarg) config_winborder = atol(optarg);
 				printf("DOpE(init): using window border size of %d\n", config_winborder);
 				break;
+			case 's':
+				if (optarg) config_cachestats = atol(optarg);
+				printf("DOpE(init): printing cache statistics every %d seconds\n", config_cachestats);
+				break;
 			default:
 				printf("DOpE(init): unknown option!\n");
 		}
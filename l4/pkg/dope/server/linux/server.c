@@ -107,6 +107,24 @@ long dope_manager_exec_req_component(CORBA_Object _dice_corba_obj,
 	return ret;
 }
 
+long dope_manager_exec_batch_component(CORBA_Object _dice_corba_obj,
+                                       long app_id,
+                                       const char *cmds,
+                                       int cmds_len,
+                                       long errs[64],
+                                       int *errs_len,
+                                       CORBA_Environment *_dice_corba_env) {
+	int ret;
+
+	INFO(printf("Server(exec_batch): %d bytes of commands requested by app_id=%lu\n", cmds_len, app_id);)
+	if (*errs_len > 64) *errs_len = 64;
+	appman->lock(app_id);
+	ret = script->exec_batch(app_id, cmds, cmds_len, errs, errs_len);
+	appman->unlock(app_id);
+	if (ret > 0) printf("DOpE(exec_batch): Error - %d commands failed\n", ret);
+	return ret;
+}
+
 long dope_manager_get_keystate_component(CORBA_Object _dice_corba_obj,
                                                long keycode,
                                                CORBA_Environment *_dice_corba_env) {
@@ -49,6 +49,14 @@ void dope_vscr_refresh_component(CORBA_Object _dice_corba_obj,
 	vs->vscr->refresh(vs,x,y,w,h);
 }
 
+int dope_vscr_publish_component(CORBA_Object _dice_corba_obj,
+                                int buffer,
+                                CORBA_Environment *_dice_corba_env) {
+
+	VSCREEN *vs = (VSCREEN *) _dice_corba_env->user_data;
+	return vs->vscr->publish(vs,buffer);
+}
+
 
 static void vscreen_server_thread(void *arg) {
 	char ident_buf[10];
@@ -0,0 +1,115 @@
+/*
+ * \brief   Throughput of the YUV420 converter and the image scaler
+ * \date    2026-10-19
+ *
+ * Runs the pixel line kernels of the screen handlers on the build host.
+ * Each kernel set is checked against the C kernels and timed for 720p
+ * and 1080p video frames.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the DOpE package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "dopestd.h"
+#include "blit.h"
+
+#define ROUNDS 50
+
+static struct { int w, h; const char *name; } formats[] = {
+	{ 1280,  720, "720p"  },
+	{ 1920, 1080, "1080p" },
+};
+
+
+static double now(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+
+/*** FRAMES PER SECOND OF CONVERTING A W*H YUV420 FRAME ***/
+static double bench_yuv(int w, int h, const u8 *yuv, u16 *dst) {
+	double t = now();
+	int i;
+
+	for (i = 0; i < ROUNDS; i++)
+		blit_yuv420_rgb16(w, h, yuv, dst);
+
+	return ROUNDS / (now() - t);
+}
+
+
+/*** FRAMES PER SECOND OF SCALING A SW*SH IMAGE TO DW*DH ***/
+static double bench_scale(int sw, int sh, int dw, int dh,
+                          const u16 *src, u16 *dst) {
+	double t = now();
+	int i;
+
+	for (i = 0; i < ROUNDS; i++)
+		blit_scale16(dst, dw, dw, dh, src, sw, 0, 0,
+		             (sw << 16) / dw, (sh << 16) / dh);
+
+	return ROUNDS / (now() - t);
+}
+
+
+int main(int argc, char **argv) {
+	static blit_ops *sets[] = { &blit_c, &blit_sse2 };
+	const char *best = blit_init();
+	int f, k, i;
+	double fps;
+
+	printf("best kernel set on this CPU: %s\n", best);
+
+	for (f = 0; f < sizeof(formats)/sizeof(*formats); f++) {
+		int w  = formats[f].w,  h  = formats[f].h;
+		int ow = formats[!f].w, oh = formats[!f].h;   /* other format */
+		u8  *yuv = malloc(w*h*3/2);
+		u16 *rgb = malloc(w*h*2);
+		u16 *ref = malloc(w*h*2);
+		u16 *scr = malloc(ow*oh*2);
+		u16 *sref = malloc(ow*oh*2);
+
+		for (i = 0; i < w*h*3/2; i++) yuv[i] = rand();
+
+		blit = &blit_c;
+		blit_yuv420_rgb16(w, h, yuv, ref);
+		blit_scale16(sref, ow, ow, oh, ref, w, 0, 0,
+		             (w << 16) / ow, (h << 16) / oh);
+
+		for (k = 0; k < sizeof(sets)/sizeof(*sets); k++) {
+			if (k && strcmp(best, "SSE2")) continue;
+			blit = sets[k];
+
+			fps = bench_yuv(w, h, yuv, rgb);
+			printf("%-5s %-4s yuv420->rgb16   %7.1f frames/s %s\n",
+			       formats[f].name, k ? "SSE2" : "C", fps,
+			       memcmp(rgb, ref, w*h*2) ? "MISMATCH" : "");
+
+			/* scale to the other format, 1:1 for comparison */
+			fps = bench_scale(w, h, ow, oh, ref, scr);
+			printf("%-5s %-4s scale to %-5s   %7.1f frames/s %s\n",
+			       formats[f].name, k ? "SSE2" : "C", formats[!f].name, fps,
+			       memcmp(scr, sref, ow*oh*2) ? "MISMATCH" : "");
+
+			fps = bench_scale(w, h, w, h, ref, rgb);
+			printf("%-5s %-4s scale 1:1         %7.1f frames/s %s\n",
+			       formats[f].name, k ? "SSE2" : "C", fps,
+			       memcmp(rgb, ref, w*h*2) ? "MISMATCH" : "");
+		}
+
+		free(yuv); free(rgb); free(ref); free(scr); free(sref);
+	}
+	return 0;
+}
@@ -87,6 +87,10 @@ dsi_socket_clear_flags(dsi_socket_t * socket, l4_uint32_t flags);
 int
 dsi_socket_test_flag(dsi_socket_t * socket, l4_uint32_t flag);
 
+int
+dsi_socket_set_watermarks(dsi_socket_t * socket, l4_uint32_t low,
+			  l4_uint32_t high);
+
 int 
 dsi_socket_set_event(dsi_socket_t * socket, l4_uint32_t events);
 
@@ -112,6 +116,17 @@ dsi_packet_get_abort(dsi_socket_t * socket);
 int
 dsi_packet_commit(dsi_socket_t * socket, dsi_packet_t * packet);
 
+int 
+dsi_packet_get_multi(dsi_socket_t * socket, dsi_packet_t ** packets,
+		     int * num);
+
+int
+dsi_packet_commit_multi(dsi_socket_t * socket, dsi_packet_t ** packets,
+			int num);
+
+int
+dsi_packet_flush(dsi_socket_t * socket);
+
 int 
 dsi_packet_add_data(dsi_socket_t * socket, dsi_packet_t * packet, 
 		    void *addr, l4_size_t size,
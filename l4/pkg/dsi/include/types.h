@@ -259,6 +259,15 @@ struct dsi_socket
                                                      in  dsi_packet_add_data()
                                                      to find next empty
                                                      element) */
+
+  /* watermark notification (DSI_SOCKET_WATERMARKS) */
+  l4_uint32_t               wm_low;             /*!< wakeup sender if fill
+                                                     level drops to wm_low */
+  l4_uint32_t               wm_high;            /*!< wakeup receiver if fill
+                                                     level rises to wm_high */
+  l4_int32_t                wakeup_pending;     /*!< index of packet the peer
+                                                     waits for, but was not
+                                                     woken up yet, -1 none */
   void *                    next_buf;           /**< next receive buffer if
 						 **  copy packet data */
 
@@ -307,6 +316,10 @@ struct dsi_socket
 						* release by receiver */
 #define DSI_SOCKET_MAP              0x00000010 /* map packet data */
 #define DSI_SOCKET_COPY             0x00000020 /* copy packet data */
+#define DSI_SOCKET_WATERMARKS       0x00000040 /* wakeup blocked peer only if
+						* the fill level crosses the
+						* watermark, see
+						* dsi_socket_set_watermarks() */
 
 #define DSI_SOCKET_USER_FLAGS       0x0000FFFF /* flags which can be set at 
 						* runtime */
@@ -54,6 +54,12 @@ dsi_down(dsi_semaphore_t * semaphore, dsi_sync_msg_t msg);
 extern inline int
 dsi_up(dsi_semaphore_t * semaphore, dsi_sync_msg_t msg);
 
+extern inline int
+dsi_up_nowake(dsi_semaphore_t * semaphore);
+
+extern inline int
+dsi_wakeup(dsi_sync_msg_t msg);
+
 extern inline int
 dsi_trylock(dsi_semaphore_t * semaphore);
 
@@ -134,6 +140,55 @@ dsi_down(dsi_semaphore_t * semaphore, dsi_sync_msg_t msg)
     }
 }
 
+/*****************************************************************************/
+/**
+ * \brief Unlock semaphore counter, but do not wakeup the remote component.
+ * 
+ * \param semaphore	Packet semaphore counter
+ *
+ * \return 1 if the remote work thread is waiting on the packet and must be
+ *         woken up using dsi_wakeup(), 0 otherwise
+ */
+/*****************************************************************************/ 
+extern inline int
+dsi_up_nowake(dsi_semaphore_t * semaphore)
+{
+  l4_int8_t old,tmp;
+
+  /* increment semaphore counter */
+  do
+    {
+      old = *semaphore;
+      tmp = old + 1;
+    }
+  while (!l4util_cmpxchg8((l4_uint8_t *)semaphore,old,tmp));
+
+  /* check new value of semaphore counter */
+  return (tmp <= 0);
+}
+
+/*****************************************************************************/
+/**
+ * \brief Wakeup remote work thread waiting on a packet.
+ * 
+ * \param msg		message
+ *
+ * \retval 0		success
+ * \retval !0		IPC error
+ *
+ * The remote work thread waits for a reply of our sync thread, which
+ * sends it if we tell it that the packet is committed.
+ */
+/*****************************************************************************/ 
+extern inline int
+dsi_wakeup(dsi_sync_msg_t msg)
+{
+  l4_msgdope_t result;
+
+  return l4_ipc_send(msg.sync_th,L4_IPC_SHORT_MSG,DSI_SYNC_COMMITED,
+                     msg.packet,L4_IPC_NEVER,&result);
+}
+
 /*****************************************************************************/
 /**
  * \brief Unlock semaphore counter.
@@ -155,29 +210,10 @@ dsi_down(dsi_semaphore_t * semaphore, dsi_sync_msg_t msg)
 extern inline int
 dsi_up(dsi_semaphore_t * semaphore, dsi_sync_msg_t msg)
 {
-  l4_int8_t old,tmp;
-  int ret;
-  l4_msgdope_t result;
-
-  /* increment semaphore counter */
-  do
-    {
-      old = *semaphore;
-      tmp = old + 1;
-    }
-  while (!l4util_cmpxchg8((l4_uint8_t *)semaphore,old,tmp));
+  if (dsi_up_nowake(semaphore))
+    /* remote work thread is waiting, wakeup our sync thread to do reply */
+    return dsi_wakeup(msg);
 
-  /* check new value of semaphore counter */
-  if (tmp <= 0)
-    {
-      /* remote work thread is waiting, wakeup our sync thread to do reply */
-      ret = l4_ipc_send(msg.sync_th,L4_IPC_SHORT_MSG,DSI_SYNC_COMMITED,
-			     msg.packet,L4_IPC_NEVER,&result);
-      if (ret)
-        //Panic("DSI sync message IPC error (0x%02x)!\n",ret);
-        ;
-      return ret;
-    } 
   return 0;
 }
 
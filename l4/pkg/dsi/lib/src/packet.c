@@ -156,6 +156,107 @@ __send_release_notification(dsi_socket_t * socket, dsi_packet_t * packet)
   return 0;
 }
 
+/*****************************************************************************/
+/**
+ * \brief Check if packet marks the end of the stream.
+ * \ingroup internal
+ * 
+ * \param socket         Socket descriptor
+ * \param packet         Packet descriptor
+ *
+ * \return 1 if the scatter gather list contains an EOS data area, 0 otherwise
+ */
+/*****************************************************************************/ 
+static inline int
+__is_eos_packet(dsi_socket_t * socket, dsi_packet_t * packet)
+{
+  l4_uint32_t sg_elem = packet->sg_list;
+
+  while (sg_elem != DSI_SG_ELEM_LAST)
+    {
+      if (socket->sg_lists[sg_elem].flags & DSI_DATA_AREA_EOS)
+	return 1;
+      sg_elem = socket->sg_lists[sg_elem].next;
+    }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief Send deferred wakeup message.
+ * \ingroup internal
+ * 
+ * \param socket         Socket descriptor
+ *
+ * \return 0 on success (or no wakeup pending), 
+ *         -DSI_ENOPACKET if the wakeup message failed
+ */
+/*****************************************************************************/ 
+static inline int
+__send_pending_wakeup(dsi_socket_t * socket)
+{
+  dsi_sync_msg_t msg;
+
+  if (socket->wakeup_pending < 0)
+    return 0;
+
+  LOGdL(DEBUG_SEND_PACKET || DEBUG_RECEIVE_PACKET,"wakeup peer, packet %d",
+        socket->wakeup_pending);
+
+  /* the peer is waiting for our sync thread */
+  msg.sync_th = socket->sync_th;
+  msg.packet = socket->wakeup_pending;
+  msg.rcv = L4_IPC_SHORT_MSG;
+  socket->wakeup_pending = -1;
+
+  if (dsi_wakeup(msg))
+    return -DSI_ENOPACKET;
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief Unlock packet semaphore, wakeup peer.
+ * \ingroup internal
+ * 
+ * \param socket         Socket descriptor
+ * \param semaphore      Packet semaphore (rx_sem on send, tx_sem on receive 
+ *                       sockets)
+ * \param packet         Packet index
+ * \param fill           Fill level after committing the packet
+ * \param force          Do not defer the wakeup
+ *
+ * \return 0 on success, -DSI_ENOPACKET if the wakeup message failed
+ *
+ * Without DSI_SOCKET_WATERMARKS this is just dsi_up(). Otherwise the
+ * wakeup of a peer waiting for the packet is deferred until the fill level 
+ * reached the high (send sockets) or low (receive sockets) watermark. The 
+ * peer waits for one packet at most, so we need to remember just one.
+ */
+/*****************************************************************************/ 
+static inline int
+__up_packet(dsi_socket_t * socket, dsi_semaphore_t * semaphore, int packet,
+	    l4_uint32_t fill, int force)
+{
+  if (dsi_up_nowake(semaphore))
+    socket->wakeup_pending = packet;
+
+  if (socket->wakeup_pending < 0)
+    return 0;
+
+  if (!force && (socket->flags & DSI_SOCKET_WATERMARKS))
+    {
+      if (IS_SEND_SOCKET(socket) && (fill < socket->wm_high))
+	return 0;
+      if (IS_RECEIVE_SOCKET(socket) && (fill > socket->wm_low))
+	return 0;
+    }
+
+  return __send_pending_wakeup(socket);
+}
+
 /*****************************************************************************/
 /**
  * \brief Find unused scatter gather list element.
@@ -212,6 +313,7 @@ __get_sg_elem(dsi_socket_t * socket, int * sg_elem)
  * \ingroup internal
  * 
  * \param  socket        Socket descriptor
+ * \param  block         Block if socket is a blocking socket
  * \retval packet        Index of next send packet
  *
  * \retval 0			on success (\a packet contains valid index)
@@ -223,12 +325,12 @@ __get_sg_elem(dsi_socket_t * socket, int * sg_elem)
  *				not exist
  *
  * If the packet is still used by the receiver, either block and wait until
- * it is released (if DSI_SOCKET_BLOCK flag is set in socket descriptor) or
- * return an error otherwise.
+ * it is released (if DSI_SOCKET_BLOCK flag is set in socket descriptor and
+ * \a block is set) or return an error otherwise.
  */
 /*****************************************************************************/ 
 static inline int
-__get_send_packet(dsi_socket_t * socket, int * packet)
+__get_send_packet(dsi_socket_t * socket, int * packet, int block)
 {
   dsi_sync_msg_t msg;
   dsi_packet_t * p = &socket->packets[socket->next_packet];
@@ -240,7 +342,7 @@ __get_send_packet(dsi_socket_t * socket, int * packet)
   if(socket->flags & DSI_SOCKET_BLOCK_ABORT) goto e_eeos;
   if (!dsi_trylock(&p->tx_sem)){
     /* We did not get the packet. This is not the normal case. */
-    if (SOCKET_BLOCK(socket)) {
+    if (block && SOCKET_BLOCK(socket)) {
       /* Blocking socket. Prepare for waiting. Our peer will not
          see that we block until we are inside dsi_down(). This
          means, the preparation might be for nothing, and that our
@@ -263,6 +365,10 @@ __get_send_packet(dsi_socket_t * socket, int * packet)
                               DSI_SYNC_NO_SEND_PACKET);
       }
 
+      /* the receiver must not wait for a deferred wakeup while we wait 
+       * for it */
+      __send_pending_wakeup(socket);
+
       /* block now */
       msg.sync_th = socket->remote_socket.sync_th;
       msg.packet = socket->next_packet;
@@ -383,6 +489,7 @@ __copy_receive_data(dsi_socket_t * socket, int packet_idx)
  * \ingroup internal
  * 
  * \param  socket        Socket descriptor
+ * \param  block         Block if socket is a blocking socket
  * \retval packet        Index of next receive packet
  *
  * \retval 0			on success (\a packet contains valid index)
@@ -396,7 +503,8 @@ __copy_receive_data(dsi_socket_t * socket, int packet_idx)
  *
  * If the packet is not available yet (sender didn't commit data), either
  * block and wait until sender commited data (if DSI_SOCKET_BLOCK flag is
- * set in socket descriptor) or return an error otherwise.
+ * set in socket descriptor and \a block is set) or return an error 
+ * otherwise.
  *
  * There are two ways to map/copy the data of a packet (required if 
  * DSI_SOCKET_MAP or DSI_SOCKET_COPY flags are set for the socket). If 
@@ -407,7 +515,7 @@ __copy_receive_data(dsi_socket_t * socket, int packet_idx)
  */
 /*****************************************************************************/ 
 static inline int 
-__get_receive_packet(dsi_socket_t * socket, int * packet)
+__get_receive_packet(dsi_socket_t * socket, int * packet, int block)
 {
   dsi_sync_msg_t msg;
   int result = -1;
@@ -426,7 +534,7 @@ __get_receive_packet(dsi_socket_t * socket, int * packet)
   /* Abort-Flag set in between? */
   if(socket->flags & DSI_SOCKET_BLOCK_ABORT) goto e_eeos;
   if(!dsi_trylock(&socket->packets[socket->next_packet].rx_sem)){
-    if (SOCKET_BLOCK(socket)) {
+    if (block && SOCKET_BLOCK(socket)) {
       /* Blocking socket. Prepare for waiting */
 
       /* Setup synchronization message */
@@ -472,6 +580,10 @@ __get_receive_packet(dsi_socket_t * socket, int * packet)
                               DSI_SYNC_NO_RECEIVE_PACKET);
       }
 
+      /* the sender must not wait for a deferred wakeup while we wait 
+       * for it */
+      __send_pending_wakeup(socket);
+
       /* block */
       result = dsi_down(&socket->packets[socket->next_packet].rx_sem,msg);
 
@@ -543,7 +655,7 @@ __get_receive_packet(dsi_socket_t * socket, int * packet)
 
 /*****************************************************************************/
 /**
- * \brief Commit send packet.
+ * \brief Prepare send packet for commit.
  * \ingroup internal
  * 
  * \param  socket        Socket descriptor
@@ -552,18 +664,11 @@ __get_receive_packet(dsi_socket_t * socket, int * packet)
  * \return 0 on success, error code otherwise
  *         - -L4_EINVAL     invalid packet descriptor
  *         - -DSI_ENODATA   tried to commit empty packet
- *	   - -DSI_ENOPACKET peer in blocking mode: committing required a
- *			    sync-message which failed
- *
- * The receiver can now use this packet. If the receiver is already waiting
- * for this packet, send wakup message to our synchronization thread.
  */
 /*****************************************************************************/ 
 static inline int
-__commit_send_packet(dsi_socket_t * socket, dsi_packet_t * packet)
+__prepare_send_packet(dsi_socket_t * socket, dsi_packet_t * packet)
 { 
-  dsi_sync_msg_t msg;
-
 #if DO_SANITY
   /* check packet descriptor */
   if (!__is_valid_packet(socket,packet))
@@ -577,28 +682,47 @@ __commit_send_packet(dsi_socket_t * socket, dsi_packet_t * packet)
   if (SOCKET_RELEASE_CALLBACK(socket))
     packet->flags |= DSI_PACKET_RELEASE_CALLBACK;
 
-  /* we possibly need to wakup receiver, setup synchronization message */
-  msg.sync_th = socket->sync_th; /* the receiver is waiting for our sync thread */
-  msg.packet = __get_packet_index(socket,packet);
+  return 0;
+}
 
-  LOGdL(DEBUG_SEND_PACKET,"commiting packet %d",msg.packet);
-  LOGdL(DEBUG_SEND_PACKET,"message to "l4util_idfmt,
-        l4util_idstr(msg.sync_th));
+/*****************************************************************************/
+/**
+ * \brief Commit send packet.
+ * \ingroup internal
+ * 
+ * \param  socket        Socket descriptor
+ * \param  packet        Packet descriptor, prepared by __prepare_send_packet()
+ * \param  fill          Fill level, packet already counted
+ *
+ * \return 0 on success, error code otherwise
+ *	   - -DSI_ENOPACKET peer in blocking mode: committing required a
+ *			    sync-message which failed
+ *
+ * The receiver can now use this packet. If the receiver is already waiting
+ * for this packet, send wakup message to our synchronization thread.
+ */
+/*****************************************************************************/ 
+static inline int
+__commit_send_packet(dsi_socket_t * socket, dsi_packet_t * packet,
+		     l4_uint32_t fill)
+{ 
+  int p = __get_packet_index(socket,packet);
+  int force = 0;
 
-  socket->header->packets_committed++;
+  LOGdL(DEBUG_SEND_PACKET,"commiting packet %d",p);
+
+  /* never defer the wakeup beyond the end of the stream */
+  if (socket->flags & DSI_SOCKET_WATERMARKS)
+    force = __is_eos_packet(socket,packet);
 
   /* commit packet, the rx_sem counter of the packet is used to synchronize 
    * valid send data (see __get_receive_packet) */
-  if(dsi_up(&packet->rx_sem,msg)) 
-    return -DSI_ENOPACKET;
-
-  /* done */
-  return 0;
+  return __up_packet(socket,&packet->rx_sem,p,fill,force);
 }
 
 /*****************************************************************************/
 /**
- * \brief Commit (release) received packet.
+ * \brief Release data of received packet.
  * \ingroup internal
  *
  * \param socket		socket descriptor
@@ -608,17 +732,14 @@ __commit_send_packet(dsi_socket_t * socket, dsi_packet_t * packet)
  * \retval -L4_EINVAL	        invalid packet descriptor
  * \retval -L4_EIPC		IPC error sending release notifcation to
  *				sender
- * \retval -DSI_ENOPACKET	peer in blocking mode: IPC error sending
- *				unblock-notification
  *
- * The send component can now use this packet for the next send packet. If
- * the sender is already waiting for the packet, send wakeup message.
+ * Unmap the packet data, notify sender and free the scatter gather list. 
+ * The packet itself is handed back by __commit_receive_packet().
  */
 /*****************************************************************************/ 
 static inline int
-__commit_receive_packet(dsi_socket_t * socket, dsi_packet_t * packet)
+__release_receive_packet(dsi_socket_t * socket, dsi_packet_t * packet)
 {
-  dsi_sync_msg_t msg;
   int i,j,sg_elem,a;
   int ret = 0;
   int do_unmap = socket->flags & DSI_SOCKET_MAP;
@@ -662,12 +783,6 @@ __commit_receive_packet(dsi_socket_t * socket, dsi_packet_t * packet)
     /* send release notification */
     ret = __send_release_notification(socket,packet);
 
-  /* we possibly need to wakup the sender, setup synchronization message */
-  msg.sync_th = socket->sync_th; /* the sender is waiting for our sync thread */
-  msg.packet = __get_packet_index(socket,packet);
-
-  socket->header->packets_committed--;
-  
   /* release scatter gather list elements */
   sg_elem = packet->sg_list;
   for (i = 0; i < packet->sg_len; i++)
@@ -689,12 +804,60 @@ __commit_receive_packet(dsi_socket_t * socket, dsi_packet_t * packet)
       return -L4_EINVAL;
     }
 
+  /* done */
+  return ret;
+}
+
+/*****************************************************************************/
+/**
+ * \brief Commit (release) received packet.
+ * \ingroup internal
+ *
+ * \param socket		socket descriptor
+ * \param packet		packet to commit, released by 
+ *				__release_receive_packet()
+ * \param fill			fill level, packet already uncounted
+ *
+ * \retval 0			success
+ * \retval -DSI_ENOPACKET	peer in blocking mode: IPC error sending
+ *				unblock-notification
+ *
+ * The send component can now use this packet for the next send packet. If
+ * the sender is already waiting for the packet, send wakeup message.
+ */
+/*****************************************************************************/ 
+static inline int
+__commit_receive_packet(dsi_socket_t * socket, dsi_packet_t * packet,
+			l4_uint32_t fill)
+{
   /* release packet, the tx_sem counter of the packet is used to synchronize 
    * the free packets (see __get_send_packet) */
-  if(dsi_up(&packet->tx_sem,msg)) return -DSI_ENOPACKET;
+  return __up_packet(socket,&packet->tx_sem,__get_packet_index(socket,packet),
+		     fill,0);
+}
 
-  /* done */
-  return ret;
+/*****************************************************************************/
+/**
+ * \brief Setup descriptor of packet returned to the user.
+ * \ingroup internal
+ * 
+ * \param  socket        Socket descriptor
+ * \param  i             Packet index
+ *
+ * \return packet descriptor
+ */
+/*****************************************************************************/ 
+static inline dsi_packet_t *
+__setup_packet(dsi_socket_t * socket, int i)
+{
+  dsi_packet_t * packet = &socket->packets[i];
+
+  if (IS_SEND_SOCKET(socket))
+    packet->sg_idx = DSI_SG_ELEM_LAST;
+  else
+    packet->sg_idx = packet->sg_list;
+
+  return packet;
 }
 
 /*****************************************************************************
@@ -732,9 +895,9 @@ dsi_packet_get(dsi_socket_t * socket, dsi_packet_t ** packet)
 
   /* get next send/receive packet */
   if (IS_SEND_SOCKET(socket))
-    ret = __get_send_packet(socket,&i);
+    ret = __get_send_packet(socket,&i,1);
   else if (IS_RECEIVE_SOCKET(socket))
-    ret = __get_receive_packet(socket,&i);
+    ret = __get_receive_packet(socket,&i,1);
   else
     {
       Panic("DSI: invalid socket");
@@ -754,13 +917,90 @@ dsi_packet_get(dsi_socket_t * socket, dsi_packet_t ** packet)
 #endif
 
   /* setup packet descriptor */
-  *packet = &socket->packets[i];
-  if (IS_SEND_SOCKET(socket))
-    (*packet)->sg_idx = DSI_SG_ELEM_LAST;
-  else
-    (*packet)->sg_idx = (*packet)->sg_list;
+  *packet = __setup_packet(socket,i);
+
+  /* done */
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief Request a batch of consecutive send/receive packets.
+ * \ingroup packet
+ * 
+ * \param  socket        Socket descriptor
+ * \retval packets       Packet descriptors, array of \a num elements
+ * \param  num           In: maximum number of packets to get, 
+ *                       out: number of packets got
+ * 
+ * \retval 0			on success (\a packets contains \a num
+ *				packets, at least one)
+ * \retval -L4_EINVAL		invalid socket or \a num
+ * \retval -DSI_ENOPACKET	non-blocking mode: next packet still used
+ *				by the peer
+ * \retval -DSI_ENOPACKET	blocking mode: block/unblock-ipc returned
+ *				an error
+ * \retval -DSI_EEOS            aborted by dsi_packet_get_abort()
+ * \retval -DSI_ECONNECT        blocking mode: communication peer does
+ *                              not exist
+ *
+ * Like dsi_packet_get(), but returns all packets in a row which are 
+ * available at once. A blocking socket only blocks for the first packet.
+ * The packets are in ring order and can be committed together using 
+ * dsi_packet_commit_multi().
+ */
+/*****************************************************************************/ 
+int 
+dsi_packet_get_multi(dsi_socket_t * socket, dsi_packet_t ** packets, 
+		     int * num)
+{
+  int ret = 0,i,n = 0;
+
+#if DO_SANITY
+  /* check socket descriptor */
+  if (!dsi_is_valid_socket(socket))
+    return -L4_EINVAL;
+#endif
+
+  if ((*num <= 0) || (*num > socket->header->num_packets))
+    return -L4_EINVAL;
+
+  while (n < *num)
+    {
+      /* leave a pending abort to the next call */
+      if (n && (socket->flags & DSI_SOCKET_BLOCK_ABORT))
+	break;
+
+      /* get next send/receive packet, only block for the first one */
+      if (IS_SEND_SOCKET(socket))
+	ret = __get_send_packet(socket,&i,n == 0);
+      else if (IS_RECEIVE_SOCKET(socket))
+	ret = __get_receive_packet(socket,&i,n == 0);
+      else
+	{
+	  Panic("DSI: invalid socket");
+	  return -L4_EINVAL;
+	}
+
+      if (ret)
+	break;
+
+      packets[n++] = __setup_packet(socket,i);
+    }
+
+  if (n == 0)
+    {
+      if ((ret != -DSI_ENOPACKET) && (ret != -DSI_EEOS))
+	LOG_Error("DSI: get packet failed: %s (%d)\n", l4env_errstr(ret), ret);
+      return ret;
+    }
+
+#if (DEBUG_SEND_PACKET || DEBUG_RECEIVE_PACKET)
+  LOGL("got %d packets",n);
+#endif
 
   /* done */
+  *num = n;
   return 0;
 }
 
@@ -873,7 +1113,36 @@ dsi_packet_get_nr(dsi_socket_t * socket, unsigned nr, dsi_packet_t ** packet)
 int
 dsi_packet_commit(dsi_socket_t * socket, dsi_packet_t * packet)
 {
-  int ret;
+  return dsi_packet_commit_multi(socket,&packet,1);
+}
+
+/*****************************************************************************/ 
+/**
+ * \brief Commit a batch of send / release a batch of receive packets.
+ * \ingroup packet
+ *
+ * \param socket	socket descriptor
+ * \param packets	packets to commit
+ * \param num		number of packets
+ *
+ * \retval 0		  success
+ * \retval -L4_EINVAL  invalid socket/packet descriptor
+ * \retval -DSI_ENODATA   tried to commit empty send packet
+ * \retval -DSI_ENOPACKET peer in blocking mode: committing required a
+ *			  sync-message which failed
+ *
+ * The packets must be committed in the order they were requested. The 
+ * fill level of the socket is updated once for the whole batch, and a 
+ * blocked peer is woken up once at most. If a packet is invalid, no
+ * packet is committed.
+ */
+/*****************************************************************************/ 
+int
+dsi_packet_commit_multi(dsi_socket_t * socket, dsi_packet_t ** packets,
+			int num)
+{
+  int ret = 0,err,i;
+  l4_uint32_t fill;
 
 #if DO_SANITY
   /* check socket descriptor */
@@ -881,17 +1150,65 @@ dsi_packet_commit(dsi_socket_t * socket, dsi_packet_t * packet)
     return -L4_EINVAL;
 #endif
 
-  /* commit send/recveive packet */
+  if (num <= 0)
+    return -L4_EINVAL;
+
+  /* commit send/recveive packets */
   if (IS_SEND_SOCKET(socket))
-    ret = __commit_send_packet(socket,packet);
+    {
+      for (i = 0; i < num; i++)
+	{
+	  ret = __prepare_send_packet(socket,packets[i]);
+	  if (ret)
+	    goto error;
+	}
+
+      fill = l4util_add32_res(&socket->header->packets_committed,num);
+
+      for (i = 0; i < num; i++)
+	{
+	  err = __commit_send_packet(socket,packets[i],fill);
+	  if (err)
+	    ret = err;
+	}
+    }
   else if (IS_RECEIVE_SOCKET(socket))
-    ret = __commit_receive_packet(socket,packet);
+    {
+#if DO_SANITY
+      /* check all packet descriptors before releasing the first one */
+      for (i = 0; i < num; i++)
+	{
+	  if (!__is_valid_packet(socket,packets[i]))
+	    {
+	      ret = -L4_EINVAL;
+	      goto error;
+	    }
+	}
+#endif
+
+      for (i = 0; i < num; i++)
+	{
+	  err = __release_receive_packet(socket,packets[i]);
+	  if (err)
+	    ret = err;
+	}
+
+      fill = l4util_sub32_res(&socket->header->packets_committed,num);
+
+      for (i = 0; i < num; i++)
+	{
+	  err = __commit_receive_packet(socket,packets[i],fill);
+	  if (err)
+	    ret = err;
+	}
+    }
   else
     {
       LOG_Error("DSI: invalid socket");
       return -L4_EINVAL;
     }
   
+ error:
   if (ret)
     {
       LOG_Error("DSI: commit packet failed: %s (%d)", l4env_errstr(ret), ret);
@@ -902,6 +1219,35 @@ dsi_packet_commit(dsi_socket_t * socket, dsi_packet_t * packet)
   return 0;
 }
 
+/*****************************************************************************/ 
+/**
+ * \brief Wakeup peer, ignoring the watermarks.
+ * \ingroup packet
+ *
+ * \param socket	socket descriptor
+ *
+ * \retval 0		  success
+ * \retval -L4_EINVAL  invalid socket descriptor
+ * \retval -DSI_ENOPACKET wakeup message failed
+ *
+ * With DSI_SOCKET_WATERMARKS set, a receiver blocked on a packet already 
+ * committed is not woken up before the high watermark is reached. A send 
+ * component which stops producing packets for a while must call this 
+ * function to hand out the packets committed so far.
+ */
+/*****************************************************************************/ 
+int
+dsi_packet_flush(dsi_socket_t * socket)
+{
+#if DO_SANITY
+  /* check socket descriptor */
+  if (!dsi_is_valid_socket(socket))
+    return -L4_EINVAL;
+#endif
+
+  return __send_pending_wakeup(socket);
+}
+
 /*****************************************************************************/
 /**
  * \brief Add data area to packet's scatter gather list.
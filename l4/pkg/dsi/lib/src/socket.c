@@ -279,6 +279,9 @@ dsi_socket_create(dsi_jcp_stream_t jcp_stream, dsi_stream_cfg_t cfg,
   s->packet_count = 0;
   s->next_packet = 0;
   s->next_sg_elem = 0;
+  s->wm_low = 0;
+  s->wm_high = s->header->num_packets;
+  s->wakeup_pending = -1;
   s->waiting = 0;
   s->clients = NULL;
 
@@ -611,6 +614,45 @@ dsi_socket_clear_flags(dsi_socket_t * socket, l4_uint32_t flags)
   return 0;
 }
 
+/*****************************************************************************/
+/**
+ * \brief Set fill level watermarks for deferred wakeups.
+ * \ingroup socket
+ * 
+ * \param  socket        Socket descriptor
+ * \param  low           Low watermark, used by the receive component
+ * \param  high          High watermark, used by the send component
+ *	
+ * \return 0 on success, error code otherwise:
+ *         - \c -L4_EINVAL  invalid socket descriptor or watermarks
+ *
+ * Only used if DSI_SOCKET_WATERMARKS is set. A send component then wakes
+ * up a blocked receiver not before \a high packets are committed, a 
+ * receive component wakes up a blocked sender not before the fill level 
+ * dropped to \a low. The default watermarks are 0 and the number of 
+ * packets. Wakeups are never deferred beyond a packet marking the end of
+ * the stream or a dsi_packet_get() which must block itself, a sender
+ * which pauses the stream otherwise must call dsi_packet_flush().
+ */
+/*****************************************************************************/ 
+int
+dsi_socket_set_watermarks(dsi_socket_t * socket, l4_uint32_t low,
+			  l4_uint32_t high)
+{
+  /* check socket descriptor */
+  if (!dsi_is_valid_socket(socket))
+    return -L4_EINVAL;
+
+  if ((low >= high) || (high > socket->header->num_packets))
+    return -L4_EINVAL;
+
+  socket->wm_low = low;
+  socket->wm_high = high;
+
+  /* done */
+  return 0;
+}
+
 /*****************************************************************************/
 /**
  * \brief Test socket flag.
@@ -33,6 +33,22 @@
 #define DSI_MAP         0   /// map data
 #define DSI_COPY        0   /// copy data
 
+/**
+ * packets per dsi_packet_get_multi()/dsi_packet_commit_multi(), 1 uses
+ * dsi_packet_get()/dsi_packet_commit(). Must be <= NUM_PACKETS.
+ */
+#define BATCH_SIZE      1
+
+/**
+ * wakeup blocked peer only if the fill level crosses a watermark 
+ * (DSI_SOCKET_WATERMARKS), receiver at WATERMARK_HIGH committed packets, 
+ * sender at WATERMARK_LOW. Must be WATERMARK_LOW < WATERMARK_HIGH <= 
+ * NUM_PACKETS, see dsi_socket_set_watermarks().
+ */
+#define USE_WATERMARKS  0
+#define WATERMARK_LOW   (NUM_PACKETS / 4)
+#define WATERMARK_HIGH  ((NUM_PACKETS * 3 + 3) / 4)
+
 /**
  * use filters?
  */
@@ -62,4 +78,17 @@
  */
 #define NUM_PACKETS  1
 
+/*****************************************************************************
+ * check config
+ *****************************************************************************/
+
+#if (BATCH_SIZE < 1) || (BATCH_SIZE > NUM_PACKETS)
+#  error "BATCH_SIZE must be in 1..NUM_PACKETS"
+#endif
+
+#if USE_WATERMARKS && \
+    ((WATERMARK_LOW >= WATERMARK_HIGH) || (WATERMARK_HIGH > NUM_PACKETS))
+#  error "invalid watermarks, need WATERMARK_LOW < WATERMARK_HIGH <= NUM_PACKETS"
+#endif
+
 #endif /* !_DSI_EXAMPLE___CONFIG_H */
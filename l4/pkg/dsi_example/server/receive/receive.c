@@ -52,6 +52,10 @@ receive_thread(void * data)
   int ret,count;
   l4_uint32_t num;
   dsi_packet_t * p;
+#if BATCH_SIZE > 1
+  dsi_packet_t * batch[BATCH_SIZE];
+  int j,n;
+#endif
   void *addr;
   l4_size_t size;
   l4_cpu_time_t t_start,t_end;
@@ -71,6 +75,69 @@ receive_thread(void * data)
   t_start = l4_rdtsc();
 
   count = 0;
+#if BATCH_SIZE > 1
+  while(1)
+    {
+      LOGdL(DO_DEBUG, "waiting for packets...");
+
+      /* get all packets available */
+      n = BATCH_SIZE;
+      ret = dsi_packet_get_multi(soc,batch,&n);
+#if DO_SANITY
+      if (ret)
+	{
+	  if (ret == -DSI_ENOPACKET)
+	    break;
+	  else
+	    {
+	      Panic("get packets failed (%d)",ret);
+	      return;
+	    }
+	}
+#else
+      if (ret == -DSI_ENOPACKET)
+	break;
+#endif
+
+      for (j = 0; j < n; j++)
+	{
+	  p = batch[j];
+	  count++;
+
+	  /* get packet number */
+	  ret = dsi_packet_get_no(soc,p,&num);
+#if DO_SANITY
+	  if (ret)
+	    {
+	      Panic("get packet number failed (%d)",ret);
+	      return;
+	    }
+#endif
+
+	  LOGdL(DO_DEBUG, "got packet, no %u", num);
+
+	  /* get packet data */
+	  ret = dsi_packet_get_data(soc,p,&addr,&size);
+#if DO_SANITY
+	  if (ret)
+	    {
+	      Panic("get data failed (%d)",ret);
+	      return;
+	    }
+#endif
+	}
+
+      /* immediately acknowledge packets */
+      ret = dsi_packet_commit_multi(soc,batch,n);
+#if DO_SANITY
+      if (ret)
+	{
+	  Panic("commit packets failed (%d)",ret);
+	  return;
+	}
+#endif
+    }
+#else
   while(1)
     {
       LOGdL(DO_DEBUG, "waiting for packet...");
@@ -135,6 +202,7 @@ receive_thread(void * data)
       KDEBUG("commited packet");
 #endif
     }
+#endif
 
   /* end measurement */
   t_end = l4_rdtsc();
@@ -215,6 +283,9 @@ dsi_example_receive_open_component(CORBA_Object _dice_corba_obj,
 #elif DSI_COPY
   flags |= DSI_SOCKET_COPY;
 #endif
+#if USE_WATERMARKS
+  flags |= DSI_SOCKET_WATERMARKS;
+#endif
   
   /* create socket */
   cfg.num_packets = NUM_PACKETS;
@@ -229,6 +300,16 @@ dsi_example_receive_open_component(CORBA_Object _dice_corba_obj,
       return -1;
     }
 
+#if USE_WATERMARKS
+  /* wakeup sender not before the fill level dropped to WATERMARK_LOW */
+  ret = dsi_socket_set_watermarks(soc,WATERMARK_LOW,WATERMARK_HIGH);
+  if (ret)
+    {
+      Panic("set watermarks failed");
+      return -1;
+    }
+#endif
+
   /* get socket reference */
   ret = dsi_socket_get_ref(soc,(dsi_socket_ref_t *)s);
   if (ret)
@@ -84,6 +84,10 @@ send_thread(void * data)
   int ret,i;
   unsigned long count;
   dsi_packet_t * p;
+#if BATCH_SIZE > 1
+  dsi_packet_t * batch[BATCH_SIZE];
+  int j,n;
+#endif
   void *start_addr, *addr;
   l4_size_t size;
   l4_cpu_time_t t_start,t_end;
@@ -112,6 +116,61 @@ send_thread(void * data)
   for (i = 0; i < NUM_ROUNDS; i++)
     {
       addr = start_addr;
+#if BATCH_SIZE > 1
+      while (addr < (start_addr + size))
+	{
+	  /* get as many packet descriptors as available at once */
+	  n = (start_addr + size - addr) / PACKET_SIZE;
+	  if (n > BATCH_SIZE)
+	    n = BATCH_SIZE;
+	  ret = dsi_packet_get_multi(soc,batch,&n);
+#if DO_SANITY
+	  if (ret)
+	    {
+	      Panic("get packets failed (%d)",ret);
+	      return;
+	    }
+#endif
+
+          LOGdL(DO_DEBUG, "got %d send packets, round %d, count %lu", 
+                n, i, count);
+
+	  for (j = 0; j < n; j++)
+	    {
+	      /* add data */
+	      ret = dsi_packet_add_data(soc,batch[j],addr,PACKET_SIZE,0);
+#if DO_SANITY
+	      if (ret)
+		{
+		  Panic("add data failed (%d)",ret);
+		  return;
+		}
+#endif
+
+	      /* set packet number */
+	      ret = dsi_packet_set_no(soc,batch[j],count++);
+#if DO_SANITY
+	      if (ret)  
+		{
+		  Panic("set packet number failed (%d)",ret);
+		  return;
+		}
+#endif
+	      addr += PACKET_SIZE;
+	    }
+
+	  /* commit packets */
+	  ret = dsi_packet_commit_multi(soc,batch,n);
+#if DO_SANITY
+	  if (ret)
+	    {
+	      Panic("commit packets failed (%d)",ret);
+	      return;
+	    }
+#endif
+          LOGdL(DO_DEBUG, "commited send packets...");
+	}
+#else
       while (addr < (start_addr + size))
 	{
 	  /* get packet descriptor */
@@ -162,6 +221,7 @@ send_thread(void * data)
 
 	  addr += PACKET_SIZE;
 	}
+#endif
     }
 
 #if TEST_ROUNDTRIP
@@ -197,6 +257,12 @@ send_thread(void * data)
   printf(" DSI type: copy, %u byte packets\n",PACKET_SIZE);
 #else
   printf(" DSI type: standard, %u byte packets\n",PACKET_SIZE);
+#endif
+  printf(" %u packets, batches of %u",NUM_PACKETS,BATCH_SIZE);
+#if USE_WATERMARKS
+  printf(", watermarks %u/%u\n",WATERMARK_LOW,WATERMARK_HIGH);
+#else
+  printf("\n");
 #endif
   printf(" send done (%lu packets, %lums total)\n", count, ms);
   printf(" cycles = %lu:%lu (%lu per packet)\n",
@@ -278,6 +344,9 @@ dsi_example_send_open_component(CORBA_Object _dice_corba_obj,
 #elif DSI_COPY
   flags |= DSI_SOCKET_COPY;
 #endif
+#if USE_WATERMARKS
+  flags |= DSI_SOCKET_WATERMARKS;
+#endif
   
   /* create socket */
   cfg.num_packets = NUM_PACKETS;
@@ -292,6 +361,16 @@ dsi_example_send_open_component(CORBA_Object _dice_corba_obj,
       return -1;
     }
 
+#if USE_WATERMARKS
+  /* wakeup receiver not before WATERMARK_HIGH packets are committed */
+  ret = dsi_socket_set_watermarks(soc,WATERMARK_LOW,WATERMARK_HIGH);
+  if (ret)
+    {
+      Panic("set watermarks failed");
+      return -1;
+    }
+#endif
+
   /* get socket reference */
   ret = dsi_socket_get_ref(soc,(dsi_socket_ref_t *)s);
   if (ret)
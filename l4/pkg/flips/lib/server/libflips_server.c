@@ -29,6 +29,7 @@ static int _DEBUG = 0;
 #define client_owns_sid(c,s) 1
 
 extern void flips_session_thread(void *arg);
+extern int liblinux_notify_accepted(int fd);
 
 struct recv_request {
 
@@ -89,6 +90,9 @@ l4vfs_net_io_accept_component (CORBA_Object _dice_corba_obj,
 
   *actual_len = *addrlen;
   err = accept(s,(struct sockaddr *) addr,actual_len);
+  /* the new socket inherited the select hooks of the listener */
+  if (err >= 0)
+    liblinux_notify_accepted(err);
 
   /* compute size of addr to send */
   if (*addrlen > *actual_len)
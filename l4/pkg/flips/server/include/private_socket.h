@@ -1,11 +1,28 @@
+
 #include <l4/socket_linux/socket_linux.h>
 #include <linux/sched.h>
 
+struct sock;
+struct socket;
+
+/* original callbacks of a sock, ours call them first */
+typedef struct socket_callbacks
+{
+    void (*state_change)(struct sock *sk);
+    void (*data_ready)(struct sock *sk, int bytes);
+    void (*write_space)(struct sock *sk);
+    void (*error_report)(struct sock *sk);
+} socket_callbacks_t;
+
 typedef struct socket_private
 {
     int mode;                 /* selected operations for non blocking */
     int non_block_mode;       /* currently possible non blocking operations */
-    l4_threadid_t *notif_tid; /* thread id of notify thread at client side */
-    wait_queue_t q;           /* our wait queue element for the socket */
+    l4_threadid_t notif_tid;  /* thread id of notify thread at client side */
+    int fd;
+    struct socket *sock;
+    struct socket_private *ready_next; /* next socket on the ready list */
+    int ready;                /* socket is on the ready list */
+    struct socket_private *hooked_next; /* next hooked socket in the bucket */
+    socket_callbacks_t *orig; /* original callbacks of the sock */
 } socket_private_t;
-
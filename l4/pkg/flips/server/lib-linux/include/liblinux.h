@@ -14,12 +14,22 @@ extern int  liblinux_proc_read(const char *path, char *dst, int offset,
                                int dst_len);
 extern int  liblinux_proc_write(const char *path, char *src, int src_len);
 
+/*** SELECT NOTIFICATION ***/
+typedef struct liblinux_notify
+{
+	int fd;
+	int mode;                 /* operations which will not block */
+	l4_threadid_t tid;        /* listener to notify */
+} liblinux_notify_t;
+
 extern void liblinux_init_notify(void);
 
 extern int liblinux_notify_request(int, int, l4_threadid_t *);
 extern int liblinux_notify_clear(int, int, l4_threadid_t *);
-extern int liblinux_select(int);
-extern int liblinux_get_max_fd(void);
+extern int liblinux_notify_release(int);
+extern int liblinux_notify_accepted(int);
+extern int liblinux_notify_get_ready(liblinux_notify_t *, int);
+extern void liblinux_notify_wait(void);
 
 #endif
 
@@ -24,17 +24,214 @@ static int _DEBUG = 0;
 #endif
 
 static struct task_struct *notif_tsk;
-static int max_fd;
+
+/* sockets whose state changed since the notify thread last looked,
+ * protected by lock, as are the sk->sk_user_data links */
+static socket_private_t *ready_first, *ready_last;
 static l4lock_t lock = L4LOCK_UNLOCKED;
 
+/* sockets with hooked callbacks hashed by their sock, protected by
+ * lock. user_data cannot point to the socket: accepted socks inherit it,
+ * so it must stay valid after the socket was freed. */
+#define NOTIFY_HASH_SIZE 64
+static socket_private_t *hooked[NOTIFY_HASH_SIZE];
+
+/* Original callbacks of hooked socks, sk->sk_user_data points here. The
+ * entries are never freed: socks cloned from a hooked listener inherit
+ * its callbacks and user_data, and may still use them after the listener
+ * was unhooked. There are only a few distinct sets, one per protocol. */
+#define NOTIFY_CALLBACK_SETS 8
+static socket_callbacks_t callback_sets[NOTIFY_CALLBACK_SETS];
+static int callback_sets_used;
+
 void liblinux_init_notify(void)
 {
 	notif_tsk = current;
 };
 
+/* queue socket for the notify thread, lock held */
+static void notify_queue(socket_private_t *sp)
+{
+	if (sp->ready)
+		return;
+
+	sp->ready = 1;
+	sp->ready_next = NULL;
+	if (ready_last)
+		ready_last->ready_next = sp;
+	else
+		ready_first = sp;
+	ready_last = sp;
+}
+
+/* drop socket from the ready list, lock held */
+static void notify_unqueue(socket_private_t *sp)
+{
+	socket_private_t **p;
+
+	if (! sp->ready)
+		return;
+
+	for (p = &ready_first; *p != sp; p = &(*p)->ready_next)
+		;
+	*p = sp->ready_next;
+	if (ready_last == sp) {
+		for (ready_last = ready_first;
+		     ready_last && ready_last->ready_next;
+		     ready_last = ready_last->ready_next)
+			;
+	}
+	sp->ready = 0;
+}
+
+/* hash bucket of the sockets hooked for sk */
+static socket_private_t **notify_bucket(struct sock *sk)
+{
+	return &hooked[((unsigned long) sk / sizeof(*sk)) % NOTIFY_HASH_SIZE];
+}
+
+/* find the callback set matching the current callbacks of sk, lock held */
+static socket_callbacks_t *notify_callbacks(struct sock *sk)
+{
+	socket_callbacks_t *cb;
+	int i;
+
+	for (i = 0; i < callback_sets_used; i++) {
+		cb = &callback_sets[i];
+		if (cb->state_change == sk->sk_state_change &&
+		    cb->data_ready   == sk->sk_data_ready &&
+		    cb->write_space  == sk->sk_write_space &&
+		    cb->error_report == sk->sk_error_report)
+			return cb;
+	}
+
+	if (callback_sets_used == NOTIFY_CALLBACK_SETS)
+		return NULL;
+
+	cb = &callback_sets[callback_sets_used++];
+	cb->state_change = sk->sk_state_change;
+	cb->data_ready   = sk->sk_data_ready;
+	cb->write_space  = sk->sk_write_space;
+	cb->error_report = sk->sk_error_report;
+	return cb;
+}
+
+/* find the socket whose callbacks we hooked for sk, lock held */
+static socket_private_t *notify_lookup(struct sock *sk)
+{
+	socket_private_t *sp;
+
+	for (sp = *notify_bucket(sk); sp; sp = sp->hooked_next)
+		if (sp->sock->sk == sk)
+			return sp;
+
+	return NULL;
+}
+
+/* give sk its original callbacks back, lock held */
+static void notify_unhook(struct sock *sk, socket_callbacks_t *cb)
+{
+	sk->sk_state_change = cb->state_change;
+	sk->sk_data_ready   = cb->data_ready;
+	sk->sk_write_space  = cb->write_space;
+	sk->sk_error_report = cb->error_report;
+	sk->sk_user_data    = NULL;
+}
+
+/* unhook socket and drop it from all lists, lock held */
+static void notify_remove(socket_private_t *sp)
+{
+	socket_private_t **p;
+
+	for (p = notify_bucket(sp->sock->sk); *p != sp; p = &(*p)->hooked_next)
+		;
+	*p = sp->hooked_next;
+
+	notify_unhook(sp->sock->sk, sp->orig);
+	notify_unqueue(sp);
+}
+
 /**
- *  add notify thread to wait queue of
- *  socket
+ * Socket callbacks: the stack calls them whenever the state of the
+ * socket changes. Return the original callbacks in orig, and queue the
+ * socket for the notify thread.
+ *
+ * A sock accepted from a hooked listener carries the listener's
+ * callbacks and user_data, it is reset to the original callbacks. If the
+ * socket was unhooked meanwhile, the callbacks of sk are the original
+ * ones again.
+ *
+ * Returns 1 if the socket was queued.
+ */
+static int notify_hook(struct sock *sk, socket_callbacks_t *orig)
+{
+	socket_callbacks_t *cb;
+	socket_private_t *sp = NULL;
+
+	l4lock_lock(&lock);
+	cb = sk->sk_user_data;
+	if (cb) {
+		*orig = *cb;
+		sp = notify_lookup(sk);
+		if (sp)
+			notify_queue(sp);
+		else
+			notify_unhook(sk, cb);
+	}
+	else {
+		orig->state_change = sk->sk_state_change;
+		orig->data_ready   = sk->sk_data_ready;
+		orig->write_space  = sk->sk_write_space;
+		orig->error_report = sk->sk_error_report;
+	}
+	l4lock_unlock(&lock);
+
+	return sp != NULL;
+}
+
+static void notify_state_change(struct sock *sk)
+{
+	socket_callbacks_t orig;
+	int queued = notify_hook(sk, &orig);
+
+	orig.state_change(sk);
+	if (queued)
+		wake_up_process(notif_tsk);
+}
+
+static void notify_data_ready(struct sock *sk, int bytes)
+{
+	socket_callbacks_t orig;
+	int queued = notify_hook(sk, &orig);
+
+	orig.data_ready(sk, bytes);
+	if (queued)
+		wake_up_process(notif_tsk);
+}
+
+static void notify_write_space(struct sock *sk)
+{
+	socket_callbacks_t orig;
+	int queued = notify_hook(sk, &orig);
+
+	orig.write_space(sk);
+	if (queued)
+		wake_up_process(notif_tsk);
+}
+
+static void notify_error_report(struct sock *sk)
+{
+	socket_callbacks_t orig;
+	int queued = notify_hook(sk, &orig);
+
+	orig.error_report(sk);
+	if (queued)
+		wake_up_process(notif_tsk);
+}
+
+/**
+ *  hook the socket callbacks so that state changes
+ *  are queued for the notify thread
  *  */
 int liblinux_notify_request(int fd, int mode, l4_threadid_t *notif_tid)
 {
@@ -49,6 +246,8 @@ int liblinux_notify_request(int fd, int mode, l4_threadid_t *notif_tid)
 		return err;
 	}
 
+	sk = sock->sk;
+
 	sp = (socket_private_t *) socket_get_private_data(fd);
 	if (! sp) {
 		sp = (socket_private_t *) kmalloc(sizeof(socket_private_t), GFP_KERNEL);
@@ -58,46 +257,61 @@ int liblinux_notify_request(int fd, int mode, l4_threadid_t *notif_tid)
 		}
 		memset(sp, 0, sizeof(socket_private_t));
 
+		sp->fd = fd;
+		sp->sock = sock;
 		sp->mode = mode;
-		sp->notif_tid = (l4_threadid_t *) notif_tid;
+		sp->notif_tid = *notif_tid;
 
-		sk = sock->sk;
+		LOGd(_DEBUG,"hook callbacks of sock");
 
-		LOGd(_DEBUG,"set on waitqueue of sock");
+		l4lock_lock(&lock);
+		/* accepted sock still carrying the callbacks of its listener */
+		if (sk->sk_user_data)
+			notify_unhook(sk, sk->sk_user_data);
+
+		sp->orig = notify_callbacks(sk);
+		if (! sp->orig) {
+			l4lock_unlock(&lock);
+			kfree(sp);
+			LOG_Error("too many different socket callbacks");
+			return -ENOMEM;
+		}
+		sp->hooked_next = *notify_bucket(sk);
+		*notify_bucket(sk) = sp;
+		sk->sk_user_data    = sp->orig;
+		sk->sk_state_change = notify_state_change;
+		sk->sk_data_ready   = notify_data_ready;
+		sk->sk_write_space  = notify_write_space;
+		sk->sk_error_report = notify_error_report;
+		l4lock_unlock(&lock);
 
-		init_waitqueue_entry(&(sp->q), notif_tsk);
-		add_wait_queue(sk->sk_sleep, &(sp->q));
+		socket_set_private_data(fd, (void *) sp);
 	}
 	else {
+		l4lock_lock(&lock);
 		sp->mode |= mode;
-		sp->notif_tid = (l4_threadid_t *) notif_tid;
+		sp->notif_tid = *notif_tid;
+		l4lock_unlock(&lock);
 	}
 
-	socket_set_private_data(fd, (void *) sp);
-
+	/* the socket may be nonblocking already, let
+	 * the notify thread test it */
 	l4lock_lock(&lock);
-	if (fd > max_fd) {
-		max_fd = fd;
-	}
+	notify_queue(sp);
 	l4lock_unlock(&lock);
-
-	/* wake up notify thread
-	 * to test if socket is already nonblocking */
 	wake_up_process(notif_tsk);
 
 	return 0;
 }
 
 /**
- * remove notify thread from wait queue of
- * socket
+ * restore the socket callbacks
  * */
 int liblinux_notify_clear(int fd, int mode, l4_threadid_t *notif_tid)
 {
-	int err, i, res;
+	int err;
 	struct socket *sock;
-	struct sock *sk;
-	socket_private_t *sp, *p;
+	socket_private_t *sp;
 
 	sock = sockfd_lookup(fd, &err);
 
@@ -112,97 +326,141 @@ int liblinux_notify_clear(int fd, int mode, l4_threadid_t *notif_tid)
 		return -EINVAL;
 	}
 
-	res = sp->mode - mode;
+	l4lock_lock(&lock);
 
 	/* check if we have to clear the notification */
-	if (res <= 0) {
-		sk = sock->sk;
+	if (sp->mode - mode <= 0) {
+		notify_remove(sp);
+		l4lock_unlock(&lock);
 
-		remove_wait_queue(sk->sk_sleep, &(sp->q));
 		socket_set_private_data(fd, NULL);
 		kfree(sp);
-
-		l4lock_lock(&lock);
-		if (fd == max_fd)
-		{
-			for (i=fd; i > 0; i--) {
-				p = socket_get_private_data(i-1);
-				if (! p) {
-					max_fd--;
-				}
-			}
-		}
-		l4lock_unlock(&lock);
-
-	}
-	else
-	{
-		/* check if it contains given mode */
-		if (sp->mode & mode) {
-			/* remove given mode */
-			sp->mode -= mode;
-			socket_set_private_data(fd, sp);
+		return 0;
 	}
+
+	/* check if it contains given mode */
+	if (sp->mode & mode) {
+		/* remove given mode */
+		sp->mode -= mode;
 	}
 
+	l4lock_unlock(&lock);
+
 	return 0;
 }
 
 /**
- * check if sockets are nonblocking
- * at this moment.
- */
-int liblinux_select(int fd)
+ * unhook a socket that is about to be closed, regardless
+ * of the selected modes
+ * */
+int liblinux_notify_release(int fd)
 {
-	int mask, err, ret = -1;
-	struct socket *sock;
 	socket_private_t *sp;
 
-	set_current_state(TASK_INTERRUPTIBLE);
+	sp = socket_get_private_data(fd);
+	if (! sp)
+		return 0;
+
+	l4lock_lock(&lock);
+	notify_remove(sp);
+	l4lock_unlock(&lock);
+
+	socket_set_private_data(fd, NULL);
+	kfree(sp);
+	return 0;
+}
+
+/**
+ * reset the callbacks a newly accepted socket inherited
+ * from its hooked listener
+ * */
+int liblinux_notify_accepted(int fd)
+{
+	int err;
+	struct socket *sock;
+	struct sock *sk;
 
 	sock = sockfd_lookup(fd, &err);
 
 	if (! sock) {
-		LOGd(_DEBUG,"Unknown fd (%d), err (%d)", fd, err);
-		return -EINVAL;
+		return err;
 	}
 
-	sp = (socket_private_t *) socket_get_private_data(fd);
+	sk = sock->sk;
 
-	if (! sp) {
-		LOGd(_DEBUG,"No private data found for fd (%d)", fd);
-		return -EINVAL;
-	}
+	l4lock_lock(&lock);
+	if (sk->sk_user_data && ! notify_lookup(sk))
+		notify_unhook(sk, sk->sk_user_data);
+	l4lock_unlock(&lock);
 
-	/* poll means to check if socket is nonblocking
-	* at this moment */
-	mask = sock->ops->poll(NULL, sock, NULL);
+	return 0;
+}
 
-	/* check for each nonblock operation */
-	if (mask & POLLIN_SET) {
-		sp->non_block_mode = SELECT_READ;
-	}
+/**
+ * check which of the queued sockets are nonblocking
+ * at this moment. Fills at most max entries of n and
+ * returns their number, sockets not handled stay queued.
+ */
+int liblinux_notify_get_ready(liblinux_notify_t *n, int max)
+{
+	int err, mask, mode, count = 0;
+	socket_private_t *sp;
 
-	if (mask & POLLOUT_SET) {
-		sp->non_block_mode |= SELECT_WRITE;
-	}
+	l4lock_lock(&lock);
 
-	if (mask & POLLEX_SET) {
-		sp->non_block_mode |= SELECT_EXCEPTION;
-	}
+	while (count < max && (sp = ready_first)) {
+		ready_first = sp->ready_next;
+		if (! ready_first)
+			ready_last = NULL;
+		sp->ready = 0;
+
+		/* the socket was closed without releasing it */
+		if (sockfd_lookup(sp->fd, &err) != sp->sock)
+			continue;
+
+		/* poll means to check if socket is nonblocking
+		 * at this moment */
+		mask = sp->sock->ops->poll(NULL, sp->sock, NULL);
+
+		mode = 0;
+		if (mask & POLLIN_SET)
+			mode |= SELECT_READ;
+		if (mask & POLLOUT_SET)
+			mode |= SELECT_WRITE;
+		if (mask & POLLEX_SET)
+			mode |= SELECT_EXCEPTION;
 
-	LOGd(_DEBUG,"fd (%d), non_block_mode (%d)", fd,
-              sp->non_block_mode);
+		sp->non_block_mode = mode;
 
-	ret = sp->mode & sp->non_block_mode;
+		LOGd(_DEBUG,"fd (%d), non_block_mode (%d)", sp->fd, mode);
+
+		if (sp->mode & mode) {
+			n[count].fd   = sp->fd;
+			n[count].mode = sp->mode & mode;
+			n[count].tid  = sp->notif_tid;
+			count++;
+		}
+	}
 
-	return ret;
+	l4lock_unlock(&lock);
+
+	return count;
 }
 
-int liblinux_get_max_fd()
+/**
+ * sleep until a socket is queued
+ */
+void liblinux_notify_wait(void)
 {
-	int n;
+	set_current_state(TASK_INTERRUPTIBLE);
+
+	if (ready_first)
+	{
+		set_current_state(TASK_RUNNING);
+		return;
+	}
 
-	n = max_fd;
-	return n;
+	/* callbacks queue before they wake us, a wakeup after the
+	 * check above is not lost */
+	schedule();
 }
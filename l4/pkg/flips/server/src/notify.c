@@ -10,43 +10,55 @@
 #include "liblinux.h"
 #include "private_socket.h"
 
-#define MAX_SELECT_FDS 128
+#define MAX_SELECT_FDS L4VFS_SELECT_LISTENER_BATCH
+
+/* send the notifications for one listener, entries of other
+ * listeners are moved to the front of n, returns their number */
+static int notify_listener(liblinux_notify_t *n, int count)
+{
+	object_handle_t fds[MAX_SELECT_FDS];
+	int modes[MAX_SELECT_FDS];
+	l4_threadid_t tid = n[0].tid;
+	int i, sent = 0, left = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		if (l4_thread_equal(n[i].tid, tid))
+		{
+			fds[sent]   = n[i].fd;
+			modes[sent] = n[i].mode;
+			sent++;
+		}
+		else
+			n[left++] = n[i];
+	}
+
+	if (sent == 1)
+		l4vfs_select_listener_send_notification(tid, fds[0], modes[0]);
+	else
+		l4vfs_select_listener_send_notifications(tid, fds, modes, sent);
+
+	return left;
+}
 
 void notify_select(void);
 void notify_select(void)
 {
-	int fd, ret, n;
-	socket_private_t *sp;
+	liblinux_notify_t n[MAX_SELECT_FDS];
+	int count;
 
 	for (;;)
 	{
-		/* get highest file descriptor that was selected */
-		n = liblinux_get_max_fd();
-
-		for (fd = 0; fd < n+1; fd++)
+		/* only sockets whose state changed are queued */
+		count = liblinux_notify_get_ready(n, MAX_SELECT_FDS);
+		if (! count)
 		{
-			/* check if fd is non blocking */
-			ret = liblinux_select(fd);
-
-			if (ret <= 0)
-			{
-				continue;
-			}
-			else
-			{
-				sp = socket_get_private_data(fd);
-				if (sp)
-				{
-					//LOG("send notification foundfd=%d maxfd=%d", fd, n);
-					/* send message to notify thread */
-					l4vfs_select_listener_send_notification(
-		                            (l4_threadid_t) *(sp->notif_tid),
-                		             fd,
-		                             ret);
-				}
-			}
+			liblinux_notify_wait();
+			continue;
 		}
-		schedule();
+
+		while (count)
+			count = notify_listener(n, count);
 	}
 }
 
@@ -62,6 +62,8 @@ l4_int32_t l4vfs_common_io_close_component(CORBA_Object _dice_corba_obj,
 	int err;
 	if (!client_owns_sid(CORBA_Object, s))
 		return -1;
+	/* the select notification must not outlive the socket */
+	liblinux_notify_release(s);
 	err = socket_close(s);
 	return err;
 }
@@ -21,6 +21,7 @@ static l4_threadid_t con_l4id;
 static l4_threadid_t vc_l4id;
 
 #define ROUNDS 40
+#define PSLIM_ROUNDS 20
 
 #define MEM(addr) 							\
 	asm volatile ("1: movl %%eax, (%%edi)	\n\t"			\
@@ -33,6 +34,89 @@ static l4_threadid_t vc_l4id;
 		      : "=c"(dummy), "=D"(dummy)			\
 		      : "a"(0xaaaaaaaa), "c"(1024*1024/16), "D"(addr))
 
+static unsigned
+us_since(l4_cpu_time_t start)
+{
+  return (unsigned)(l4_tsc_to_ns(l4_rdtsc() - start) / 1000);
+}
+
+/** Measure pSLIM requests of a console with a virtual framebuffer in the
+ * server: filling the screen, writing a screen of text and scrolling by
+ * one text line. */
+static int
+bench_pslim(void)
+{
+  CORBA_Environment _env = dice_default_environment;
+  l4_threadid_t vc2_l4id, dummy_l4id = L4_NIL_ID;
+  l4_uint8_t gmode;
+  l4_uint32_t xres, yres, bits_per_pixel, bytes_per_pixel, bytes_per_line;
+  l4_uint32_t accel_flags, fn_x, fn_y;
+  l4con_pslim_rect_t rect;
+  l4_cpu_time_t start;
+  short line[256];
+  int error, i, j, cols, rows;
+
+  if ((error = con_if_openqry_call(&con_l4id, 65536, 0, 0,
+				   L4THREAD_DEFAULT_PRIO,
+				   &vc2_l4id, CON_VFB, &_env)))
+    {
+      printf("Error %d opening vc\n", error);
+      return error;
+    }
+
+  if (con_vc_smode_call(&vc2_l4id, CON_OUT, &dummy_l4id, &_env)
+      || con_vc_graph_gmode_call(&vc2_l4id, &gmode, &xres, &yres,
+				 &bits_per_pixel, &bytes_per_pixel,
+				 &bytes_per_line, &accel_flags,
+				 &fn_x, &fn_y, &_env))
+    {
+      printf("Error setting up vc\n");
+      con_vc_close_call(&vc2_l4id, &_env);
+      return -1;
+    }
+
+  cols = xres / fn_x;
+  rows = yres / fn_y;
+  if (cols > sizeof(line)/sizeof(line[0]))
+    cols = sizeof(line)/sizeof(line[0]);
+
+  start = l4_rdtsc();
+  for (i=0; i<PSLIM_ROUNDS; i++)
+    {
+      rect = (l4con_pslim_rect_t){ 0, 0, xres, yres };
+      con_vc_pslim_fill_call(&vc2_l4id, &rect, i << 4, &_env);
+    }
+  printf("fill:   %6uus/screen\n", us_since(start) / PSLIM_ROUNDS);
+
+  start = l4_rdtsc();
+  for (i=0; i<PSLIM_ROUNDS; i++)
+    for (j=0; j<rows; j++)
+      {
+	int k;
+
+	/* light gray on black, the characters change with each line */
+	for (k=0; k<cols; k++)
+	  line[k] = 0x0700 | ('!' + (i + j + k) % 90);
+	con_vc_puts_attr_call(&vc2_l4id, line, 2*cols, 0, j*fn_y, &_env);
+      }
+  printf("text:   %6uus/screen\n", us_since(start) / PSLIM_ROUNDS);
+
+  start = l4_rdtsc();
+  for (i=0; i<PSLIM_ROUNDS*rows; i++)
+    {
+      for (j=0; j<cols; j++)
+	line[j] = 0x0700 | ('!' + (i + j) % 90);
+
+      rect = (l4con_pslim_rect_t){ 0, fn_y, xres, (rows-1)*fn_y };
+      con_vc_pslim_copy_call(&vc2_l4id, &rect, 0, 0, &_env);
+      con_vc_puts_attr_call(&vc2_l4id, line, 2*cols, 0, (rows-1)*fn_y, &_env);
+    }
+  printf("scroll: %6uus/line\n", us_since(start) / (PSLIM_ROUNDS*rows));
+
+  con_vc_close_call(&vc2_l4id, &_env);
+  return 0;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -63,6 +147,10 @@ main(int argc, char **argv)
       return -1;
     }
 
+  l4_calibrate_tsc();
+
+  bench_pslim();
+
   if ((error = con_if_openqry_call(&con_l4id, 65536, 0, 0, L4THREAD_DEFAULT_PRIO,
 			     &vc_l4id, CON_NOVFB, &_env)))
     {
@@ -92,8 +180,6 @@ main(int argc, char **argv)
 
   printf("ram at %08lx, fb at %08lx\n", (unsigned long)ram, write_addr);
 
-  l4_calibrate_tsc();
-
   l4util_cli();
   start = l4_rdtsc();
 
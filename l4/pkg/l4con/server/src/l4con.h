@@ -73,6 +73,11 @@ struct l4con_vc
   l4_uint8_t    vfb_in_server;	 /* =1: server has allocated a dataspace */
   l4_uint8_t    save_restore;    /* =1: save/restore to *vfb */
   l4_uint8_t    fb_mapped;	 /* =1: phys. framebuffer mapped to client */
+  l4_uint8_t    shadow;		 /* =1: vc is shown but draws into *vfb */
+  int           dirty_x1;
+  int           dirty_y1;	 /* damaged area of *vfb, flushed to the */
+  int           dirty_x2;	 /* screen by pslim_flush(); empty if */
+  int           dirty_y2;	 /* dirty_x2 < dirty_x1 */
   l4_uint32_t   vfb_size;	 /* size of vfb; depends on g_mode */
   l4lock_t      fb_lock;	 /* thread is `drawing' - mutex for fb */
   const l4con_pslim_color_t *color_tab;
@@ -31,6 +31,7 @@
 #include <l4/dm_mem/dm_mem.h>
 #if defined(ARCH_x86) || defined(ARCH_amd64)
 #include <l4/util/rdtsc.h>
+#include <l4/util/cpu.h>
 #endif
 
 /* LibC includes */
@@ -46,6 +47,8 @@
 #include "gmode.h"
 #include "l4con.h"
 #include "main.h"
+#include "pslim.h"
+#include "pslim_sse2.h"
 #include "vc.h"
 
 char LOG_tag[9] = "con";
@@ -55,6 +58,8 @@ int noaccel;				/* 1=disable pslim HW acceleration */
 int nolog;				/* 1=disable logging to logserver */
 int pan;				/* 1=pan display to 4MB boundary */
 int use_fastmemcpy = 1;			/* 1=fast memcpy using SSE2 */
+int use_sse2;				/* 1=pSLIM kernels using SSE2 */
+int use_shadow = 1;			/* 1=shown vc draws into its vfb */
 int cpu_load;
 int cpu_load_history;
 int vbemode;
@@ -382,7 +387,10 @@ do_switch(int i_new, int i_old)
   if (old != 0)
     {
       l4lock_lock(&old->fb_lock);
-      if (old->save_restore && old->vfb)
+      if (old->shadow)
+	/* the vfb is up to date, no need to read the screen */
+	old->shadow = 0;
+      else if (old->save_restore && old->vfb)
 	{
 	  /* save screen */
 	  if (use_fastmemcpy && (new->vfb_size % 4096 == 0))
@@ -408,6 +416,19 @@ do_switch(int i_new, int i_old)
       new->fb       = gr_vmem;
       new->pan_xofs = pan_offs_x;
       new->pan_yofs = pan_offs_y;
+      if (use_shadow && new->vfb_in_server && new->vfb && !new->fb_mapped
+	  && fg_do_copy == sw_copy && fg_do_fill == sw_fill)
+	{
+	  /* Without acceleration, drawing into the vfb and writing only
+	   * the damaged areas to the screen is cheaper. It also saves
+	   * reading the screen when switching away from this vc. */
+	  new->fb       = new->vfb;
+	  new->pan_xofs = 0;
+	  new->pan_yofs = 0;
+	  new->shadow   = 1;
+	  new->dirty_x1 = 0;
+	  new->dirty_x2 = -1;
+	}
       new->do_copy  = fg_do_copy;
       new->do_fill  = fg_do_fill;
       new->do_sync  = fg_do_sync;
@@ -421,11 +442,18 @@ do_switch(int i_new, int i_old)
            * it receives the EV_CON_REDRAW event. A malicous client could
            * "forget" to respond but now has the input focus. */
           vc_clear(new);
+          /* a shadowed vc cleared its vfb only */
+          pslim_flush(new);
         }
 
       if (new->save_restore && new->vfb)
 	{
 	  /* restore screen */
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+	  if (use_sse2)
+	    sse2_stream_copy(vis_vmem, new->vfb, new->vfb_size);
+	  else
+#endif
 	  if (use_fastmemcpy && (new->vfb_size % 4096 == 0))
 	    fast_memcpy_mmx2_32(vis_vmem, new->vfb, new->vfb_size);
 	  else
@@ -713,6 +741,7 @@ test_periodic(void)
 	{
 	  l4lock_lock(&vc[fg_vc]->fb_lock);
 	  vc_show_id(vc[fg_vc]);
+	  pslim_flush(vc[fg_vc]);
 	  l4lock_unlock(&vc[fg_vc]->fb_lock);
 	  update_id = 0;
 	  // force updating load indicator
@@ -724,6 +753,7 @@ test_periodic(void)
 	{
 	  l4lock_lock(&vc[fg_vc]->fb_lock);
 	  vc_show_drops_cscs_logo();
+	  pslim_flush(vc[fg_vc]);
 	  l4lock_unlock(&vc[fg_vc]->fb_lock);
 	}
 
@@ -746,6 +776,7 @@ test_periodic(void)
 	// update load indicator
 	vc_show_cpu_load(vc[fg_vc]);
 
+      pslim_flush(vc[fg_vc]);
       l4lock_unlock(&vc[fg_vc]->fb_lock);
       last_active_slow = clock;
 	  // restore UTCB
@@ -855,6 +886,20 @@ check_fast_memcpy(void)
   printf("Not using fast memcpy\n");
 }
 
+static void
+check_sse2(void)
+{
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+  /* fast memcpy checked that the SSE state is saved */
+  if (use_fastmemcpy && l4util_cpu_has_cpuid()
+      && (l4util_cpu_capabilities_nocheck() & (1 << 26)))
+    {
+      use_sse2 = 1;
+      printf("Using SSE2 pSLIM functions.\n");
+    }
+#endif
+}
+
 #if defined(ARCH_x86) || defined(ARCH_amd64)
 static int rdpmc_faulted;
 
@@ -942,6 +987,8 @@ main(int argc, const char *argv[])
 		    PARSE_CMD_SWITCH, 1, &nomouse,
 		    'n', "nofastmemcpy", "force to not use fast memcpy",
 		    PARSE_CMD_SWITCH, 0, &use_fastmemcpy,
+		    ' ', "noshadow", "draw directly to the screen",
+		    PARSE_CMD_SWITCH, 0, &use_shadow,
 		    'p', "pan", "use panning to restrict client window",
 		    PARSE_CMD_SWITCH, 1, &pan,
 		    ' ', "noshift", "no shift key for console switching",
@@ -967,6 +1014,7 @@ main(int argc, const char *argv[])
 
   /* check if CPU supports fast memcpy */
   check_fast_memcpy();
+  check_sse2();
   check_cpuload();
 
   vc_init();
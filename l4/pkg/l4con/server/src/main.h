@@ -23,6 +23,7 @@ extern l4_uint8_t  vc_mode;
 extern l4_threadid_t ev_partner_l4id, vc_partner_l4id;
 extern int want_vc, fg_vc;
 extern int noaccel, pan, use_s0, vbemode, use_fastmemcpy, cpu_load_history;
+extern int use_sse2, use_shadow;
 extern int update_id;
 
 void request_vc(int nr);
@@ -21,7 +21,9 @@
 /* local includes */
 #include "main.h"
 #include "l4con.h"
+#include "gmode.h"
 #include "pslim.h"
+#include "pslim_sse2.h"
 #include "con_hw/init.h"
 #include "con_yuv2rgb/yuv2rgb.h"
 
@@ -35,8 +37,6 @@ struct pslim_offset
 /* word_t endskip_y; */	/* snip lines */
 };
 
-extern l4_offs_t vis_offs;
-
 static inline void _bmap16msb(l4_uint8_t*, l4_uint8_t*, l4_uint32_t,
 			      l4_uint32_t, l4_uint32_t, l4_uint32_t,
 			      struct pslim_offset*, l4_uint32_t);
@@ -109,6 +109,47 @@ set_rgb24(l4_uint32_t r, l4_uint32_t g, l4_uint32_t b)
 
 #define OFFSET(x, y, ptr, bytepp) ptr += (y) * bwidth + (x) * (bytepp);
 
+/** Copy a line within the framebuffer. Lines of different rows never
+ * overlap. */
+static inline void
+copy_line(l4_uint8_t *dest, l4_uint8_t *src, l4_uint32_t bytes)
+{
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+  if (use_sse2)
+    sse2_copy(dest, src, bytes);
+  else
+#endif
+    memcpy(dest, src, bytes);
+}
+
+/** Note a changed area of the framebuffer.
+ * A shadowed vc draws into its vfb, the area is written to the screen
+ * by pslim_flush(). Otherwise, the hardware may need to know about the
+ * change (VMware, Fiasco-UX). */
+static inline void
+mark_dirty(struct l4con_vc *vc, int x, int y, int w, int h)
+{
+  if (vc->shadow)
+    {
+      if (vc->dirty_x2 < vc->dirty_x1)
+	{
+	  vc->dirty_x1 = x;
+	  vc->dirty_y1 = y;
+	  vc->dirty_x2 = x + w - 1;
+	  vc->dirty_y2 = y + h - 1;
+	}
+      else
+	{
+	  if (x         < vc->dirty_x1) vc->dirty_x1 = x;
+	  if (y         < vc->dirty_y1) vc->dirty_y1 = y;
+	  if (x + w - 1 > vc->dirty_x2) vc->dirty_x2 = x + w - 1;
+	  if (y + h - 1 > vc->dirty_y2) vc->dirty_y2 = y + h - 1;
+	}
+    }
+  else if (vc->do_drty)
+    vc->do_drty(x, y, w, h);
+}
+
 /* clipping */
 
 static inline int
@@ -308,6 +349,13 @@ _bmap16lsb(l4_uint8_t *vfb,
 
    for (i = 0; i < h; i++) {
       nobits += offset->preskip_x;
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+      if (use_sse2) {
+	 sse2_bmap16((l4_uint16_t*)vfb, bmap, nobits, fgc, bgc, w, 0);
+	 nobits += w;
+      }
+      else
+#endif
       for (j = 0; j < w; j++, nobits++) {
 	 k = nobits>>3;
 	 kmod = (nobits)%8;
@@ -339,17 +387,27 @@ _bmap16msb(l4_uint8_t *vfb,
     {
       unsigned char mask, *b;
       nobits += offset->preskip_x;
-      mask = 0x80 >> (nobits % 8);
-      b = bmap + nobits / 8;
-      for (j = 0; j < w; j++, nobits++)
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+      if (use_sse2)
 	{
-	  /* gcc is able to code the entire loop without using any jump
-	   * if compiled with -march=i686 (uses cmov instructions then) */
-	  *(l4_uint16_t*) (&vfb[2*j]) = (*b & mask)
-					? (l4_uint16_t) (fgc & 0xffff)
-					: (l4_uint16_t) (bgc & 0xffff);
-	  b += mask & 1;
-	  mask = (mask >> 1) | (mask << 7); /* gcc optimizes this into ROR */
+	  sse2_bmap16((l4_uint16_t*)vfb, bmap, nobits, fgc, bgc, w, 1);
+	  nobits += w;
+	}
+      else
+#endif
+	{
+	  mask = 0x80 >> (nobits % 8);
+	  b = bmap + nobits / 8;
+	  for (j = 0; j < w; j++, nobits++)
+	    {
+	      /* gcc is able to code the entire loop without using any jump
+	       * if compiled with -march=i686 (uses cmov instructions then) */
+	      *(l4_uint16_t*) (&vfb[2*j]) = (*b & mask)
+					    ? (l4_uint16_t) (fgc & 0xffff)
+					    : (l4_uint16_t) (bgc & 0xffff);
+	      b += mask & 1;
+	      mask = (mask >> 1) | (mask << 7); /* gcc optimizes this into ROR */
+	    }
 	}
       l4_sys_cache_clean_range((unsigned long)vfb,
                                (unsigned long)vfb + w*2);
@@ -450,6 +508,13 @@ _bmap32lsb(l4_uint8_t *vfb,
 
    for (i = 0; i < h; i++) {
       nobits += offset->preskip_x;
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+      if (use_sse2) {
+	 sse2_bmap32((l4_uint32_t*)vfb, bmap, nobits, fgc, bgc, w, 0);
+	 nobits += w;
+      }
+      else
+#endif
       for (j = 0; j < w; j++, nobits++) {
 	 l4_uint32_t *dest = (l4_uint32_t*)&vfb[4*j];
 	 k = nobits>>3;
@@ -482,6 +547,14 @@ _bmap32msb(l4_uint8_t *vfb,
 
    for (i = 0; i < h; i++) {
       nobits += offset->preskip_x;
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+      if (use_sse2) {
+	 sse2_bmap32((l4_uint32_t*)vfb, bmap, nobits,
+		     fgc & 0x00ffffff, bgc & 0x00ffffff, w, 1);
+	 nobits += w;
+      }
+      else
+#endif
       for (j = 0; j < w; j++, nobits++) {
 	 k = nobits>>3;
 	 kmod = (nobits)%8;
@@ -600,7 +673,7 @@ _copy16(l4_uint8_t *vfb,
   if (dy == y && dx == x)
     return;
 
-  if (y >= dy)
+  if (y == dy)
     {
       OFFSET( x,  y, src,  2);
       OFFSET(dx, dy, dest, 2);
@@ -612,14 +685,24 @@ _copy16(l4_uint8_t *vfb,
 	  dest += bwidth;
 	}
     }
+  else if (y > dy)
+    {
+      OFFSET( x,  y, src,  2);
+      OFFSET(dx, dy, dest, 2);
+      for (i = 0; i < h; i++)
+	{
+	  copy_line(dest, src, 2*w);
+	  src += bwidth;
+	  dest += bwidth;
+	}
+    }
   else
     {
       OFFSET( x,  y + h - 1, src,  2);
       OFFSET(dx, dy + h - 1, dest, 2);
       for (i = 0; i < h; i++)
 	{
-	  /* memmove can deal with overlapping regions */
-	  memmove(dest, src, 2*w);
+	  copy_line(dest, src, 2*w);
 	  src -= bwidth;
 	  dest -= bwidth;
 	}
@@ -705,7 +788,7 @@ _copy32(l4_uint8_t *vfb,
 	 }
 
       }
-      else {		/* copy from top to bottom */
+      else if (y == dy) {	/* copy from left to right */
 	 OFFSET( x,  y, src,  4);
 	 OFFSET(dx, dy, dest, 4);
 	 for (i = 0; i < h; i++) {
@@ -715,6 +798,15 @@ _copy32(l4_uint8_t *vfb,
 	    dest += bwidth;
 	 }
       }
+      else {		/* copy from top to bottom */
+	 OFFSET( x,  y, src,  4);
+	 OFFSET(dx, dy, dest, 4);
+	 for (i = 0; i < h; i++) {
+	    copy_line(dest, src, 4*w);
+	    src += bwidth;
+	    dest += bwidth;
+	 }
+      }
    }
    else {		/* copy from bottom to top */
       OFFSET( x,  y + h, src,  4);
@@ -722,8 +814,7 @@ _copy32(l4_uint8_t *vfb,
       for (i = 0; i < h; i++) {
 	 src -= bwidth;
 	 dest -= bwidth;
-	 for (j = 0; j < w; j++)
-	    *(l4_uint32_t*) (&dest[4*j]) = *(l4_uint32_t*) (&src[4*j]);
+	 copy_line(dest, src, 4*w);
       }
    }
 }
@@ -736,6 +827,17 @@ _fill16(l4_uint8_t *vfb,
 {
   int i,j;
 
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+  if (use_sse2)
+    {
+      l4_uint32_t pattern = (color & 0xffff) * 0x10001;
+
+      for (i = 0; i < h; i++, vfb += bwidth)
+	sse2_fill(vfb, pattern, w*2);
+      return;
+    }
+#endif
+
   for (i = 0; i < h; i++)
     {
       for (j = 0; j < w; j++)
@@ -769,6 +871,14 @@ _fill32(l4_uint8_t *vfb,
 {
    int i,j;
 
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+   if (use_sse2) {
+      for (i = 0; i < h; i++, vfb += bwidth)
+	 sse2_fill(vfb, color, w*4);
+      return;
+   }
+#endif
+
    for (i = 0; i < h; i++) {
       for (j = 0; j < w; j++)
 	 *(l4_uint32_t*) (&vfb[4*j]) = (l4_uint32_t)color;
@@ -800,9 +910,7 @@ sw_fill(struct l4con_vc *vc, int x, int y, int w, int h, unsigned color)
       _fill16(vfb, w, h, color, bwidth);
     }
 
-  /* force redraw of changed screen content (needed by VMware) */
-  if (vc->do_drty)
-    vc->do_drty(x, y, w, h);
+  mark_dirty(vc, x, y, w, h);
 }
 
 static inline void
@@ -850,9 +958,7 @@ sw_bmap(struct l4con_vc *vc, l4_int16_t x, l4_int16_t y, l4_uint32_t w,
 	}
     }
 
-  /* force redraw of changed screen content (needed by VMware) */
-  if (vc->do_drty)
-    vc->do_drty(x, y, w, h);
+  mark_dirty(vc, x, y, w, h);
 }
 
 static inline void
@@ -867,6 +973,13 @@ sw_set(struct l4con_vc *vc, l4_int16_t x, l4_int16_t y, l4_uint32_t w,
 
   OFFSET(x+xoffs, y+yoffs, vfb, bytepp);
 
+  if (!pmap && vc->fb == vc->vfb)
+    {
+      /* shadowed vc, the vfb only has to be written to the screen */
+      mark_dirty(vc, x+xoffs, y+yoffs, w, h);
+      return;
+    }
+
   if (!pmap)
     {
       /* copy from direct mapped framebuffer of client */
@@ -897,9 +1010,7 @@ sw_set(struct l4con_vc *vc, l4_int16_t x, l4_int16_t y, l4_uint32_t w,
       _set16(vfb, pmap, w, h, offset, bwidth, pwidth);
     }
 
-  /* force redraw of changed screen content (needed by VMware) */
-  if (vc->do_drty)
-    vc->do_drty(x+xoffs, y+yoffs, w, h);
+  mark_dirty(vc, x+xoffs, y+yoffs, w, h);
 }
 
 void
@@ -924,9 +1035,7 @@ sw_copy(struct l4con_vc *vc, int x, int y, int w, int h, int dx, int dy)
       _copy16(vfb, x, y, dx, dy, w, h, bwidth);
     }
 
-  /* force redraw of changed screen content (needed by VMware) */
-  if (vc->do_drty)
-    vc->do_drty(dx, dy, w, h);
+  mark_dirty(vc, dx, dy, w, h);
 }
 
 static inline void
@@ -941,9 +1050,49 @@ sw_cscs(struct l4con_vc *vc, l4_int16_t x, l4_int16_t y, l4_uint32_t w,
   (*yuv2rgb_render)(vc->fb+y*vc->bytes_per_line+x*vc->bytes_per_pixel,
 		    Y, U, V, w, h, vc->bytes_per_line, w, w/2);
 
+  mark_dirty(vc, x, y, w, h);
+}
+
+/** Write the damaged area of a shadowed vc to the screen.
+ * @pre have vc->fb_lock */
+void
+pslim_flush(struct l4con_vc *vc)
+{
+  l4_uint32_t bwidth = vc->bytes_per_line;
+  l4_uint32_t bytes;
+  l4_uint8_t *src, *dst;
+  int i;
+
+  if (!vc->shadow || vc->dirty_x2 < vc->dirty_x1)
+    return;
+
+  bytes = (vc->dirty_x2 - vc->dirty_x1 + 1) * vc->bytes_per_pixel;
+  src   = vc->vfb;
+  OFFSET(vc->dirty_x1, vc->dirty_y1, src, vc->bytes_per_pixel);
+  dst   = vis_vmem + (src - vc->vfb);
+
+  for (i = vc->dirty_y1; i <= vc->dirty_y2; i++)
+    {
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+      if (use_sse2)
+	sse2_stream_copy(dst, src, bytes);
+      else
+#endif
+	memcpy(dst, src, bytes);
+      l4_sys_cache_clean_range((unsigned long)dst,
+                               (unsigned long)dst + bytes);
+      src += bwidth;
+      dst += bwidth;
+    }
+
   /* force redraw of changed screen content (needed by VMware) */
   if (vc->do_drty)
-    vc->do_drty(x, y, w, h);
+    vc->do_drty(vc->dirty_x1 + pan_offs_x, vc->dirty_y1 + pan_offs_y,
+		vc->dirty_x2 - vc->dirty_x1 + 1,
+		vc->dirty_y2 - vc->dirty_y1 + 1);
+
+  vc->dirty_x1 = 0;
+  vc->dirty_x2 = -1;
 }
 
 /* SVGAlib calls this: FILLBOX */
@@ -35,6 +35,9 @@ extern
 void pslim_cscs(struct l4con_vc *vc, int from_user, l4con_pslim_rect_t *rect,
 		void* y, void* u, void* v, l4_uint8_t mode, l4_uint32_t scale);
 
+extern
+void pslim_flush(struct l4con_vc *vc);
+
 extern void sw_copy(struct l4con_vc*, int, int, int, int, int, int);
 extern void sw_fill(struct l4con_vc*, int, int, int, int, unsigned col);
 
@@ -0,0 +1,178 @@
+/* $Id$ */
+/**
+ * \file	con/server/src/pslim_sse2.c
+ * \brief	SSE2 versions of the pSLIM line kernels
+ *
+ * \date	10/2026
+ *
+ * This file must be compiled with -msse2. Each kernel processes one line
+ * of a rectangle, the callers in pslim.c step through the lines. */
+
+/* (c) 2026 'Technische Universitaet Dresden'
+ * This file is part of the con package, which is distributed under
+ * the terms of the GNU General Public License 2. Please see the
+ * COPYING file for details. */
+
+#include <string.h>
+#include <emmintrin.h>
+
+#include <l4/sys/types.h>
+
+/* local includes */
+#include "pslim_sse2.h"
+
+/** Copy non-overlapping memory, the destination stays in the cache. */
+void
+sse2_copy(l4_uint8_t *dst, const l4_uint8_t *src, l4_uint32_t bytes)
+{
+  for (; bytes >= 64; bytes -= 64, src += 64, dst += 64)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(src +  0));
+      __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+      __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+      __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+      _mm_storeu_si128((__m128i*)(dst +  0), a);
+      _mm_storeu_si128((__m128i*)(dst + 16), b);
+      _mm_storeu_si128((__m128i*)(dst + 32), c);
+      _mm_storeu_si128((__m128i*)(dst + 48), d);
+    }
+  for (; bytes >= 16; bytes -= 16, src += 16, dst += 16)
+    _mm_storeu_si128((__m128i*)dst, _mm_loadu_si128((const __m128i*)src));
+
+  memcpy(dst, src, bytes);
+}
+
+/** Copy non-overlapping memory using non-temporal stores. Used for
+ * writing to the video memory, which is never read back. */
+void
+sse2_stream_copy(l4_uint8_t *dst, const l4_uint8_t *src, l4_uint32_t bytes)
+{
+  l4_uint32_t head;
+
+  if (bytes < 64)
+    {
+      memcpy(dst, src, bytes);
+      return;
+    }
+
+  /* align destination to 16 bytes */
+  head = (16 - ((l4_addr_t)dst & 15)) & 15;
+  memcpy(dst, src, head);
+  dst += head; src += head; bytes -= head;
+
+  for (; bytes >= 64; bytes -= 64, src += 64, dst += 64)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(src +  0));
+      __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+      __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+      __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+      _mm_stream_si128((__m128i*)(dst +  0), a);
+      _mm_stream_si128((__m128i*)(dst + 16), b);
+      _mm_stream_si128((__m128i*)(dst + 32), c);
+      _mm_stream_si128((__m128i*)(dst + 48), d);
+    }
+  _mm_sfence();
+
+  memcpy(dst, src, bytes);
+}
+
+/** Fill memory with a 32-bit pattern. For 16-bit pixels, the pattern
+ * contains the color twice. bytes must be even. */
+void
+sse2_fill(l4_uint8_t *dst, l4_uint32_t pattern, l4_uint32_t bytes)
+{
+  __m128i v = _mm_set1_epi32(pattern);
+
+  for (; bytes >= 64; bytes -= 64, dst += 64)
+    {
+      _mm_storeu_si128((__m128i*)(dst +  0), v);
+      _mm_storeu_si128((__m128i*)(dst + 16), v);
+      _mm_storeu_si128((__m128i*)(dst + 32), v);
+      _mm_storeu_si128((__m128i*)(dst + 48), v);
+    }
+  for (; bytes >= 16; bytes -= 16, dst += 16)
+    _mm_storeu_si128((__m128i*)dst, v);
+  for (; bytes >= 4; bytes -= 4, dst += 4)
+    *(l4_uint32_t*)dst = pattern;
+  if (bytes)
+    *(l4_uint16_t*)dst = (l4_uint16_t)pattern;
+}
+
+/** Get 8 bits of the bitmap starting at bit nobits. The first pixel ends
+ * up in bit 7 (msb) or in bit 0 (lsb). */
+static inline unsigned
+bmap_byte(const l4_uint8_t *bmap, l4_uint32_t nobits, int msb)
+{
+  const l4_uint8_t *b = bmap + (nobits >> 3);
+  unsigned shift = nobits & 7;
+
+  /* don't touch the next byte, it may be beyond the end of the bitmap */
+  if (!shift)
+    return b[0];
+
+  return msb ? ((b[0] << shift) | (b[1] >> (8 - shift))) & 0xff
+             : ((b[0] >> shift) | (b[1] << (8 - shift))) & 0xff;
+}
+
+static inline int
+bmap_bit(const l4_uint8_t *bmap, l4_uint32_t nobits, int msb)
+{
+  return bmap[nobits >> 3] & (msb ? 0x80 >> (nobits & 7)
+				  : 0x01 << (nobits & 7));
+}
+
+/** Expand one line of a bitmap to 16-bit pixels. */
+void
+sse2_bmap16(l4_uint16_t *dst, const l4_uint8_t *bmap, l4_uint32_t nobits,
+	    l4_uint16_t fgc, l4_uint16_t bgc, l4_uint32_t w, int msb)
+{
+  const __m128i fg   = _mm_set1_epi16(fgc);
+  const __m128i bg   = _mm_set1_epi16(bgc);
+  const __m128i bits = msb
+    ? _mm_setr_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01)
+    : _mm_setr_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+
+  for (; w >= 8; w -= 8, nobits += 8, dst += 8)
+    {
+      __m128i m = _mm_set1_epi16(bmap_byte(bmap, nobits, msb));
+
+      /* all ones for pixels in foreground color */
+      m = _mm_cmpeq_epi16(_mm_and_si128(m, bits), bits);
+      _mm_storeu_si128((__m128i*)dst,
+		       _mm_or_si128(_mm_and_si128(m, fg),
+				    _mm_andnot_si128(m, bg)));
+    }
+
+  for (; w; w--, nobits++, dst++)
+    *dst = bmap_bit(bmap, nobits, msb) ? fgc : bgc;
+}
+
+/** Expand one line of a bitmap to 32-bit pixels. */
+void
+sse2_bmap32(l4_uint32_t *dst, const l4_uint8_t *bmap, l4_uint32_t nobits,
+	    l4_uint32_t fgc, l4_uint32_t bgc, l4_uint32_t w, int msb)
+{
+  const __m128i fg  = _mm_set1_epi32(fgc);
+  const __m128i bg  = _mm_set1_epi32(bgc);
+  const __m128i lo  = msb ? _mm_setr_epi32(0x80, 0x40, 0x20, 0x10)
+			  : _mm_setr_epi32(0x01, 0x02, 0x04, 0x08);
+  const __m128i hi  = msb ? _mm_setr_epi32(0x08, 0x04, 0x02, 0x01)
+			  : _mm_setr_epi32(0x10, 0x20, 0x40, 0x80);
+
+  for (; w >= 8; w -= 8, nobits += 8, dst += 8)
+    {
+      __m128i b  = _mm_set1_epi32(bmap_byte(bmap, nobits, msb));
+      __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(b, lo), lo);
+      __m128i m2 = _mm_cmpeq_epi32(_mm_and_si128(b, hi), hi);
+
+      _mm_storeu_si128((__m128i*)(dst + 0),
+		       _mm_or_si128(_mm_and_si128(m1, fg),
+				    _mm_andnot_si128(m1, bg)));
+      _mm_storeu_si128((__m128i*)(dst + 4),
+		       _mm_or_si128(_mm_and_si128(m2, fg),
+				    _mm_andnot_si128(m2, bg)));
+    }
+
+  for (; w; w--, nobits++, dst++)
+    *dst = bmap_bit(bmap, nobits, msb) ? fgc : bgc;
+}
@@ -0,0 +1,34 @@
+/* $Id$ */
+/**
+ * \file	con/server/src/pslim_sse2.h
+ * \brief	SSE2 versions of the pSLIM line kernels
+ *
+ * \date	10/2026 */
+
+/* (c) 2026 'Technische Universitaet Dresden'
+ * This file is part of the con package, which is distributed under
+ * the terms of the GNU General Public License 2. Please see the
+ * COPYING file for details. */
+
+#ifndef _PSLIM_SSE2_H
+#define _PSLIM_SSE2_H
+
+#include <l4/sys/l4int.h>
+
+/* The kernels are only available on x86 and amd64 and must only be used
+ * if use_sse2 is set. */
+
+extern void sse2_copy(l4_uint8_t *dst, const l4_uint8_t *src,
+		      l4_uint32_t bytes);
+extern void sse2_stream_copy(l4_uint8_t *dst, const l4_uint8_t *src,
+			     l4_uint32_t bytes);
+extern void sse2_fill(l4_uint8_t *dst, l4_uint32_t pattern,
+		      l4_uint32_t bytes);
+extern void sse2_bmap16(l4_uint16_t *dst, const l4_uint8_t *bmap,
+			l4_uint32_t nobits, l4_uint16_t fgc, l4_uint16_t bgc,
+			l4_uint32_t w, int msb);
+extern void sse2_bmap32(l4_uint32_t *dst, const l4_uint8_t *bmap,
+			l4_uint32_t nobits, l4_uint32_t fgc, l4_uint32_t bgc,
+			l4_uint32_t w, int msb);
+
+#endif /* !_PSLIM_SSE2_H */
@@ -221,6 +221,7 @@ vc_init()
       vc[i]->vc_number = i;
       vc[i]->mode      = CON_CLOSED;
       vc[i]->vfb       = 0;
+      vc[i]->shadow    = 0;
       vc[i]->fb_lock   = L4LOCK_UNLOCKED;
     }
 
@@ -362,17 +363,20 @@ vc_open_out(struct l4con_vc *vc)
       int error;
       char ds_name[32];
       l4dm_dataspace_t ds;
+      /* also cover the status bar, which is drawn into the vfb while the
+       * vc is shown through it (see do_switch) */
+      l4_size_t size = vc->yres * vc->bytes_per_line;
 
       sprintf(ds_name, "vfb for "l4util_idfmt, 
 	      l4util_idstr(vc->vc_partner_l4id));
-      if ((error = l4dm_mem_open(L4DM_DEFAULT_DSM, vc->vfb_size, 
+      if ((error = l4dm_mem_open(L4DM_DEFAULT_DSM, size,
 				 0, 0, ds_name, &ds)))
 	{
-	  LOG("Error %d requesting %d bytes for vc", error, vc->vfb_size);
+	  LOG("Error %d requesting %zd bytes for vc", error, size);
 	  Panic("open_vc_out");
 	  return -CON_ENOMEM;
 	}
-      if ((error = l4rm_attach(&ds, vc->vfb_size, 0,
+      if ((error = l4rm_attach(&ds, size, 0,
                                L4DM_RW | L4RM_SUPERPAGE_ALIGNED,
 			       (void**)&vc->vfb)))
 	{
@@ -380,7 +384,7 @@ vc_open_out(struct l4con_vc *vc)
 	  Panic("open_vc_out");
 	}
 
-      memset(vc->vfb, 0, vc->vfb_size);
+      memset(vc->vfb, 0, size);
       vc->fb       = vc->vfb;
       vc->pan_xofs = 0;
       vc->pan_yofs = 0;
@@ -413,6 +417,7 @@ vc_close(struct l4con_vc *this_vc)
       this_vc->vfb = 0;
     }
   this_vc->vfb_in_server = 0;
+  this_vc->shadow = 0;
   this_vc->fb = 0;
   l4lock_unlock(&this_vc->fb_lock);
 
@@ -1026,6 +1031,19 @@ con_vc_graph_mapfb_component(CORBA_Object _dice_corba_obj,
   this_vc->fb_mapped = 1;
   update_id = 1;
 
+  if (this_vc->shadow)
+    {
+      /* the client writes to the screen directly, so stop drawing into
+       * the vfb */
+      l4lock_lock(&this_vc->fb_lock);
+      pslim_flush(this_vc);
+      this_vc->shadow   = 0;
+      this_vc->fb       = gr_vmem;
+      this_vc->pan_xofs = pan_offs_x;
+      this_vc->pan_yofs = pan_offs_y;
+      l4lock_unlock(&this_vc->fb_lock);
+    }
+
   l4lock_unlock(&want_vc_lock);
 
   return 0;
@@ -1061,6 +1079,7 @@ con_vc_pslim_fill_component(CORBA_Object _dice_corba_obj,
   /* need fb_lock for drawing */
   l4lock_lock(&vc->fb_lock);
   vc_fill(vc, 1, (l4con_pslim_rect_t*)rect, color);
+  pslim_flush(vc);
   /* wait for any pending acceleration operation before return because the 
    * user has direct access to the framebuffer */
   if (vc->fb_mapped)
@@ -1088,6 +1107,7 @@ con_vc_pslim_copy_component(CORBA_Object _dice_corba_obj,
   l4lock_lock(&vc->fb_lock);
   if(vc->fb != 0)
     pslim_copy(vc, 1, (l4con_pslim_rect_t*)rect, dx, dy);
+  pslim_flush(vc);
   /* wait for any pending acceleration operation before return because the 
    * user has direct access to the framebuffer */
   if (vc->fb_mapped)
@@ -1124,6 +1144,7 @@ con_vc_pslim_bmap_component(CORBA_Object _dice_corba_obj,
   if (this_vc->fb != 0)
     pslim_bmap(this_vc, 1, (l4con_pslim_rect_t*)rect,
 	       fg_color, bg_color, map, bmap_type);
+  pslim_flush(this_vc);
   l4lock_unlock(&this_vc->fb_lock);
 
   return 0;
@@ -1148,6 +1169,7 @@ con_vc_pslim_set_component(CORBA_Object _dice_corba_obj,
   l4lock_lock(&vc->fb_lock);
   if(vc->fb != 0)
     pslim_set(vc, 1, (l4con_pslim_rect_t*)rect, map);
+  pslim_flush(vc);
   l4lock_unlock(&vc->fb_lock);
 
   return 0;
@@ -1195,6 +1217,7 @@ con_vc_pslim_cscs_component (CORBA_Object _dice_corba_obj,
 	  break;
 	}
     }
+  pslim_flush(vc);
   l4lock_unlock(&vc->fb_lock);
 
   return 0;
@@ -1217,6 +1240,7 @@ con_vc_puts_component (CORBA_Object _dice_corba_obj,
 
   l4lock_lock(&vc->fb_lock);
   ret = vc_puts(vc, 1, s, len, x, y, fg_color, bg_color);
+  pslim_flush(vc);
   l4lock_unlock(&vc->fb_lock);
 
   return ret;
@@ -1241,6 +1265,7 @@ con_vc_puts_scale_component(CORBA_Object _dice_corba_obj,
 
   l4lock_lock(&vc->fb_lock);
   ret = vc_puts_scale(vc, 1, s, len, x, y, fg_color, bg_color, scale_x, scale_y);
+  pslim_flush(vc);
   l4lock_unlock(&vc->fb_lock);
 
   return ret;
@@ -1293,6 +1318,7 @@ con_vc_puts_attr_component (CORBA_Object _dice_corba_obj,
 	    }
 	}
     }
+  pslim_flush(vc);
   /* wait for any pending acceleration operation before return because the 
    * user can directly access the framebuffer */
   if (vc->fb_mapped)
@@ -1343,6 +1369,7 @@ con_vc_direct_update_component(CORBA_Object _dice_corba_obj,
   l4lock_lock(&vc->fb_lock);
   if(vc->fb != 0)
     pslim_set(vc, 1, (l4con_pslim_rect_t*)rect, 0 /* use mapped vfb */);
+  pslim_flush(vc);
   l4lock_unlock(&vc->fb_lock);
   
   return 0;
@@ -1531,6 +1558,7 @@ con_vc_stream_cscs_component(CORBA_Object _dice_corba_obj,
       vc->logo_x = config.dest.x + 20;
       vc->logo_y = config.dest.y + 20;
 
+      pslim_flush(vc);
       l4lock_unlock(&vc->fb_lock);
     }
 
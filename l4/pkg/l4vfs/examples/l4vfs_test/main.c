@@ -15,6 +15,7 @@
 
 #include <l4/log/l4log.h>
 #include <l4/util/l4_macros.h>
+#include <l4/util/rdtsc.h>
 #include <l4/util/util.h>
 
 #include <dice/dice.h> // for CORBA_*
@@ -45,6 +46,31 @@ void CORBA_free(void * prt)
     free(prt);
 }
 
+/* Read a file in pieces of 'step' bytes, as parsers do. With O_DIRECT
+ * the io backend's read-ahead cache is bypassed. */
+static void bench_read(const char *name, int flags, int step)
+{
+    char buf[BUF_SIZE];
+    l4_cpu_time_t start;
+    int fd, ret, bytes = 0;
+
+    fd = open(name, O_RDONLY | flags);
+    if (fd < 0)
+    {
+        LOG("open(%s) failed, errno = %d", name, errno);
+        return;
+    }
+
+    start = l4_rdtsc();
+    while ((ret = read(fd, buf, step)) > 0)
+        bytes += ret;
+    LOG("%-14s %s step %4d: %6d bytes, %8u us", name,
+        flags ? "direct" : "cached", step, bytes,
+        (unsigned)l4_tsc_to_us(l4_rdtsc() - start));
+
+    close(fd);
+}
+
 int main(int argc, char* argv[])
 {
     struct dirent * dir;
@@ -131,6 +157,16 @@ int main(int argc, char* argv[])
     ret = close(fd);
     LOG("close() = %d", ret);
 
+    // read-ahead cache
+    l4_calibrate_tsc();
+    for (i = 1; i <= BUF_SIZE; i *= 32)
+    {
+        bench_read("/linux/hosts", O_DIRECT, i);
+        bench_read("/linux/hosts", 0, i);
+        bench_read("/file1", O_DIRECT, i);
+        bench_read("/file1", 0, i);
+    }
+
     // chdir checks
     ret = chdir("/");
     LOG("1. chdir(\"/\"): ret = %d, errno = %d", ret, errno);
@@ -14,6 +14,9 @@
 
 #define L4VFS_WRITE_RCVBUF_SIZE 65536
 
+/* max. number of segments in one readv / writev message */
+#define L4VFS_IOV_MAX 64
+
 //#include <sys/un.h>  // for 'struct sockaddr_un'
 //#define L4VFS_SOCKET_MAX_ADDRLEN (sizeof(struct sockaddr_un))
 // todo: DICE currently can not parse the above, so we hardcode the
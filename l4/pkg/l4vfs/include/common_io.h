@@ -42,6 +42,20 @@ int     l4vfs_fcntl(l4_threadid_t server,
                     int cmd,
                     long *arg);
 
+ssize_t l4vfs_readv(l4_threadid_t server,
+                    object_handle_t fd,
+                    char **buf,
+                    size_t *count,
+                    const l4vfs_size_t *lens,
+                    int segments);
+
+ssize_t l4vfs_writev(l4_threadid_t server,
+                     object_handle_t fd,
+                     const l4_int8_t *buf,
+                     size_t count,
+                     const l4vfs_size_t *lens,
+                     int segments);
+
 EXTERN_C_END
 
 #endif
@@ -15,12 +15,20 @@
 #include <l4/l4vfs/types.h>
 #include <l4/l4vfs/select_listener-client.h>
 
+/* max. number of notifications in one send_notifications() call, must
+ * match max_is() in select_listener.idl */
+#define L4VFS_SELECT_LISTENER_BATCH 32
+
 EXTERN_C_BEGIN
 
 int l4vfs_select_listener_send_notification(l4_threadid_t server,
                                             object_handle_t fd,
                                             int mode);
 
+int l4vfs_select_listener_send_notifications(l4_threadid_t server,
+                                             object_handle_t *fds,
+                                             int *modes, int count);
+
 int l4vfs_select_listener_start_listening(l4_threadid_t server,
                                object_handle_t *fd,
                                int *mode);
@@ -13,6 +13,7 @@
 #include <l4/l4vfs/common_io-client.h>
 #include <l4/sys/types.h>
 
+#include <errno.h>
 #include <stdlib.h>
 
 ssize_t l4vfs_read(l4_threadid_t server,
@@ -93,3 +94,64 @@ int l4vfs_fcntl(l4_threadid_t server,
                                       arg,
                                       &_dice_corba_env);
 }
+
+/* Servers built before readv / writev were added to common_io do not know
+ * the opcodes, tell the caller to fall back to read() / write() then.
+ */
+static ssize_t vector_io_error(CORBA_Environment *env, ssize_t ret)
+{
+    if (! DICE_HAS_EXCEPTION(env))
+        return ret;
+
+    if (DICE_EXCEPTION_MAJOR(env) == CORBA_SYSTEM_EXCEPTION &&
+        DICE_EXCEPTION_MINOR(env) == CORBA_DICE_EXCEPTION_WRONG_OPCODE)
+        return -ENOSYS;
+
+    return -EIO;
+}
+
+ssize_t l4vfs_readv(l4_threadid_t server,
+                    object_handle_t fd,
+                    char **buf,
+                    size_t *count,
+                    const l4vfs_size_t *lens,
+                    int segments)
+{
+    CORBA_Environment _dice_corba_env = dice_default_environment;
+    _dice_corba_env.malloc = (dice_malloc_func)malloc;
+    _dice_corba_env.free = (dice_free_func)free;
+    ssize_t ret;
+
+    ret = l4vfs_common_io_readv_call(&server,
+                                     fd,
+                                     buf,
+                                     count,
+                                     segments,
+                                     lens,
+                                     &_dice_corba_env);
+
+    return vector_io_error(&_dice_corba_env, ret);
+}
+
+ssize_t l4vfs_writev(l4_threadid_t server,
+                     object_handle_t fd,
+                     const l4_int8_t *buf,
+                     size_t count,
+                     const l4vfs_size_t *lens,
+                     int segments)
+{
+    CORBA_Environment _dice_corba_env = dice_default_environment;
+    _dice_corba_env.malloc = (dice_malloc_func)malloc;
+    _dice_corba_env.free = (dice_free_func)free;
+    ssize_t ret;
+
+    ret = l4vfs_common_io_writev_call(&server,
+                                      fd,
+                                      buf,
+                                      count,
+                                      segments,
+                                      lens,
+                                      &_dice_corba_env);
+
+    return vector_io_error(&_dice_corba_env, ret);
+}
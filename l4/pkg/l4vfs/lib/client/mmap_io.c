@@ -26,11 +26,18 @@ l4_int32_t l4vfs_mmap1(l4_threadid_t server,
                        l4vfs_off_t offset)
 {
     CORBA_Environment _dice_corba_env = dice_default_environment;
+    l4_int32_t ret;
     _dice_corba_env.malloc = (dice_malloc_func)malloc;
     _dice_corba_env.free = (dice_free_func)free;
 
-    return l4vfs_mmap_mmap_call(&server, ds, length, prot, flags, fd, offset,
-                                &_dice_corba_env);
+    ret = l4vfs_mmap_mmap_call(&server, ds, length, prot, flags, fd, offset,
+                               &_dice_corba_env);
+
+    // the server does not implement the mmap interface
+    if (DICE_HAS_EXCEPTION(&_dice_corba_env))
+        return -ENODEV;
+
+    return ret;
 }
 
 l4_int32_t l4vfs_msync(l4_threadid_t server,
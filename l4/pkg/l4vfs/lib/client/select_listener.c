@@ -26,3 +26,18 @@ int l4vfs_select_listener_send_notification(l4_threadid_t server,
                                                          &_dice_corba_env);
 }
 
+
+int l4vfs_select_listener_send_notifications(l4_threadid_t server,
+                                             object_handle_t *fds,
+                                             int *modes, int count)
+{
+     CORBA_Environment _dice_corba_env = dice_default_environment;
+     _dice_corba_env.malloc = (dice_malloc_func)malloc;
+     _dice_corba_env.free = (dice_free_func)free;
+
+     return l4vfs_select_listener_send_notifications_call(&server,
+                                                          count,
+                                                          fds,
+                                                          modes,
+                                                          &_dice_corba_env);
+}
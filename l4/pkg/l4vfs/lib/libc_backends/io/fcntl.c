@@ -30,6 +30,13 @@
 #include <l4/util/mbi_argv.h>   // for argc and argv[]
 #include <l4/names/libnames.h>
 
+#include "write_combine.h"
+#include "read_cache.h"
+
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+
 int fcntl( int fd, int cmd, ... )
 {
     file_desc_t fdesc;
@@ -94,9 +101,15 @@ int fcntl( int fd, int cmd, ... )
         ret = -EINVAL;
     }
     else
+    {
+        l4vfs_wc_flush();
+        // nonblocking and direct reads must reach the server
+        if (cmd == F_SETFL && (arg & (O_NONBLOCK | O_DIRECT)))
+            rc_disable(fd);
         ret = l4vfs_fcntl(fdesc.server_id,
                           fdesc.object_handle,
                           cmd,
                           &arg);
+    }
     return ret;
 }
@@ -38,6 +38,8 @@
 #include <l4/util/mbi_argv.h>   // for argc and argv[]
 #include <l4/names/libnames.h>
 
+#include "write_combine.h"
+
 #ifdef USE_UCLIBC
 int ioctl( int fd, unsigned long cmd, ... )
 #else
@@ -132,6 +134,7 @@ int ioctl( int fd, int cmd, ... )
     }
 
     // now we can call the server
+    l4vfs_wc_flush();
     ret = l4vfs_ioctl( fdesc.server_id,
                        fdesc.object_handle,
                        cmd,
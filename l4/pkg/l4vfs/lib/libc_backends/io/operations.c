@@ -39,6 +39,8 @@
 #include <l4/names/libnames.h>
 
 #include "operations.h"
+#include "read_cache.h"
+#include "write_combine.h"
 
 #ifdef DEBUG
 static int _DEBUG = 1;
@@ -180,6 +182,7 @@ int open(const char *pathname, int flags, ...)
     file_desc.object_id     = object_id;
     // now finally copy acquired data to local table and return
     ft_fill_entry(local_fd, file_desc);
+    rc_open(local_fd, flags);
     return local_fd;
 }
 
@@ -254,6 +257,10 @@ int close(int fd)
         return -1;
     }
 
+    wc_disable(fd);
+    l4vfs_wc_flush();
+    rc_close(fd);
+
     file_desc = ft_get_entry(fd);
     ret = l4vfs_close(file_desc.server_id, file_desc.object_handle);
     LOGd(_DEBUG, "server ret");
@@ -313,10 +320,12 @@ ssize_t read(int fd, void *buf, size_t count)
     }
 
     // 2.
-    ret = l4vfs_read(file_desc.server_id,
-                     file_desc.object_handle,
-                     &b,
-                     &count);
+    l4vfs_wc_flush();
+    if (! rc_read(fd, &file_desc, buf, count, &ret))
+        ret = l4vfs_read(file_desc.server_id,
+                         file_desc.object_handle,
+                         &b,
+                         &count);
 
     // 3.
     if (ret < 0)
@@ -371,6 +380,11 @@ ssize_t write(int fd, const void *buf, size_t count)
 
     // 2.
     LOGd(_DEBUG, "2. local fd '%d'", fd);
+    rc_invalidate(fd);
+    ret = wc_write(fd, &file_desc, buf, count);
+    if (ret != 0)
+        return ret;
+
     ret = l4vfs_write(file_desc.server_id,
                       file_desc.object_handle,
                       buf,
@@ -414,10 +428,12 @@ off_t lseek(int fd, off_t offset, int whence)
     // 2.
     LOGd(_DEBUG, "file_desc = '" l4util_idfmt ":%d'",
          l4util_idstr(file_desc.server_id), file_desc.object_handle);
-    ret = l4vfs_lseek(file_desc.server_id,
-                      file_desc.object_handle,
-                      offset,
-                      whence);
+    l4vfs_wc_flush();
+    if (! rc_lseek(fd, &file_desc, offset, whence, &ret))
+        ret = l4vfs_lseek(file_desc.server_id,
+                          file_desc.object_handle,
+                          offset,
+                          whence);
 
     // 3.
     if (ret < 0)
@@ -734,6 +750,7 @@ int fstat(int fd, struct stat *buf)
     LOGd(_DEBUG, "is ok");
 
     // 2.
+    l4vfs_wc_flush();
     ret = l4vfs_stat(file_desc.server_id, file_desc.object_id, &stat_buf);
     if (ret != 0)
     {
@@ -873,6 +890,8 @@ int dup(int oldfd)
     }
     LOGd(_DEBUG, "new fd '%d'", new_fd);
 
+    // both share the position at the server from now on
+    rc_disable(oldfd);
     file_desc = ft_get_entry(oldfd);
 
     ft_fill_entry(new_fd, file_desc);
@@ -980,6 +999,8 @@ void init_io(void)
             LOG("Failed to open stdout, fd = '%d', errno = %d", fd, errno);
             ft_fill_entry(1, file_desc);  // fill in dummy entry
         }
+        else
+            wc_enable(1);
     }
     else
         ft_fill_entry(1, file_desc);      // fill in dummy entry
@@ -999,6 +1020,8 @@ void init_io(void)
         }
         if (fd != 2)
             LOG("Failed to open stderr, fd = '%d', errno = %d", fd, errno);
+        else
+            wc_enable(2);
     }
 
     // now cleanup all the dummy entries again
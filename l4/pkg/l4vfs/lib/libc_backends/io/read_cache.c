@@ -0,0 +1,347 @@
+/**
+ * \file   l4vfs/lib/libc_backends/io/read_cache.c
+ * \brief  Per file descriptor read-ahead cache
+ *
+ * Small sequential reads (parsers reading byte by byte or line by line)
+ * would cost one IPC to the object server each. For file descriptors
+ * opened for reading, the first read() checks whether the object is
+ * seekable. If it is, reads are served from
+ *
+ *  - a read-only mapping of the whole file, if it is a regular file of
+ *    at most RC_MMAP_MAX bytes and the server implements the mmap
+ *    interface; seeks are then handled locally, or
+ *  - a read-ahead buffer, which is refilled with a window that starts
+ *    at RC_WINDOW_MIN and doubles with each sequential refill up to
+ *    RC_WINDOW_MAX. Seeks drop the buffer and shrink the window again.
+ *
+ * Before anything else that depends on the position at the server
+ * (write, readv / writev, dup), the cache is invalidated and the
+ * server's position is set to the one the application sees.
+ *
+ * Non-seekable objects (terminals, logs, pipes, sockets) are never
+ * cached, nor are descriptors opened with O_DIRECT or O_NONBLOCK. The
+ * mapping is a snapshot of the file at the time of the first read.
+ *
+ * \date   2026-10-19
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <l4/l4vfs/basic_io.h>
+#include <l4/l4vfs/common_io.h>
+#include <l4/l4vfs/file-table.h>
+#include <l4/log/l4log.h>
+
+#include "read_cache.h"
+
+#ifdef DEBUG
+static int _DEBUG = 1;
+#else
+static int _DEBUG = 0;
+#endif
+
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+
+enum
+{
+    RC_BUFFER = 1, // read-ahead buffer
+    RC_MMAP,       // mapping of the whole file
+};
+
+// rc_allowed[] bits, set by open()
+#define RC_ALLOW_BUFFER 1
+#define RC_ALLOW_MMAP   2
+
+typedef struct
+{
+    int     type;
+    // RC_BUFFER: buf[start..len) not yet read by the application
+    char  * buf;
+    size_t  start;
+    size_t  len;
+    size_t  size;
+    size_t  window;
+    // RC_MMAP: the file and the position the application sees
+    char  * map;
+    off_t   map_len;
+    off_t   pos;
+} read_cache_t;
+
+void * mmap_normal(void *start, size_t length, int prot, int flags, int fd,
+                   off_t offset);
+
+static unsigned char  rc_allowed[MAX_FILES_OPEN];
+static read_cache_t * rc[MAX_FILES_OPEN];
+
+static void rc_free(int fd)
+{
+    read_cache_t *c = rc[fd];
+
+    if (c->type == RC_MMAP)
+        munmap(c->map, c->map_len);
+    free(c->buf);
+    free(c);
+    rc[fd] = NULL;
+}
+
+/* first read() on fd, decide how to cache it */
+static read_cache_t * rc_setup(int fd, const file_desc_t *file_desc)
+{
+    read_cache_t *c;
+    l4vfs_stat_t st;
+    off_t pos;
+    void *map;
+
+    // also tells whether the object can seek at all
+    pos = l4vfs_lseek(file_desc->server_id, file_desc->object_handle,
+                      0, SEEK_CUR);
+    if (pos < 0)
+    {
+        LOGd(_DEBUG, "fd %d not seekable (%d), no cache", fd, (int)pos);
+        rc_allowed[fd] = 0;
+        return NULL;
+    }
+
+    c = calloc(1, sizeof(*c));
+    if (! c)
+        return NULL;
+
+    if ((rc_allowed[fd] & RC_ALLOW_MMAP) &&
+        l4vfs_stat(file_desc->server_id, file_desc->object_id, &st) == 0 &&
+        S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size <= RC_MMAP_MAX)
+    {
+        map = mmap_normal(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            LOGd(_DEBUG, "fd %d mapped, %d bytes", fd, (int)st.st_size);
+            c->type    = RC_MMAP;
+            c->map     = map;
+            c->map_len = st.st_size;
+            c->pos     = pos;
+            rc[fd]     = c;
+            return c;
+        }
+    }
+
+    c->type   = RC_BUFFER;
+    c->window = RC_WINDOW_MIN;
+    rc[fd]    = c;
+    return c;
+}
+
+static ssize_t rc_read_mmap(read_cache_t *c, void *buf, size_t count)
+{
+    if (c->pos >= c->map_len)
+        return 0;
+    if (count > c->map_len - c->pos)
+        count = c->map_len - c->pos;
+
+    memcpy(buf, c->map + c->pos, count);
+    c->pos += count;
+    return count;
+}
+
+static ssize_t rc_read_buffer(read_cache_t *c, const file_desc_t *file_desc,
+                              char *buf, size_t count)
+{
+    size_t n = 0, len;
+    ssize_t ret;
+    char *b;
+
+    // 1. what is left from the last refill
+    if (c->start < c->len)
+    {
+        n = c->len - c->start;
+        if (n > count)
+            n = count;
+        memcpy(buf, c->buf + c->start, n);
+        c->start += n;
+        if (n == count)
+            return n;
+    }
+
+    // the buffer is empty now, the server's position is ours
+
+    // 2. large reads go directly to the caller's buffer
+    if (count - n >= c->window)
+    {
+        b   = buf + n;
+        len = count - n;
+        ret = l4vfs_read(file_desc->server_id, file_desc->object_handle,
+                         &b, &len);
+        if (ret < 0)
+            return n ? n : ret;
+        return n + ret;
+    }
+
+    // 3. refill
+    if (c->size < c->window)
+    {
+        b = realloc(c->buf, c->window);
+        if (! b)
+            return n ? n : -ENOMEM;
+        c->buf  = b;
+        c->size = c->window;
+    }
+
+    b   = c->buf;
+    len = c->window;
+    ret = l4vfs_read(file_desc->server_id, file_desc->object_handle,
+                     &b, &len);
+    LOGd(_DEBUG, "refill window %d: %d", c->window, (int)ret);
+    if (ret <= 0)
+    {
+        c->start = c->len = 0;
+        return n ? n : ret;
+    }
+
+    c->start = 0;
+    c->len   = ret;
+    if (c->window < RC_WINDOW_MAX)
+        c->window *= 2;
+
+    len = count - n;
+    if (len > c->len)
+        len = c->len;
+    memcpy(buf + n, c->buf, len);
+    c->start = len;
+
+    return n + len;
+}
+
+/* set the server's position to the one the application sees */
+static void rc_sync(int fd, const file_desc_t *file_desc)
+{
+    read_cache_t *c = rc[fd];
+
+    if (c->type == RC_MMAP)
+        l4vfs_lseek(file_desc->server_id, file_desc->object_handle,
+                    c->pos, SEEK_SET);
+    else if (c->start < c->len)
+        l4vfs_lseek(file_desc->server_id, file_desc->object_handle,
+                    -(off_t)(c->len - c->start), SEEK_CUR);
+}
+
+void rc_open(int fd, int flags)
+{
+    if (fd < 0 || fd >= MAX_FILES_OPEN)
+        return;
+
+    rc_allowed[fd] = 0;
+    if (flags & (O_DIRECT | O_NONBLOCK))
+        return;
+
+    switch (flags & O_ACCMODE)
+    {
+    case O_RDONLY:
+        // mapping is fine, we never write
+        rc_allowed[fd] = RC_ALLOW_BUFFER | RC_ALLOW_MMAP;
+        break;
+    case O_RDWR:
+        rc_allowed[fd] = RC_ALLOW_BUFFER;
+        break;
+    }
+}
+
+void rc_close(int fd)
+{
+    if (fd < 0 || fd >= MAX_FILES_OPEN)
+        return;
+
+    if (rc[fd])
+        rc_free(fd);
+    rc_allowed[fd] = 0;
+}
+
+void rc_invalidate(int fd)
+{
+    file_desc_t file_desc;
+
+    if (fd < 0 || fd >= MAX_FILES_OPEN || ! rc[fd])
+        return;
+
+    file_desc = ft_get_entry(fd);
+    rc_sync(fd, &file_desc);
+    rc_free(fd);
+}
+
+void rc_disable(int fd)
+{
+    rc_invalidate(fd);
+    if (fd >= 0 && fd < MAX_FILES_OPEN)
+        rc_allowed[fd] = 0;
+}
+
+int rc_read(int fd, const file_desc_t *file_desc, void *buf,
+            size_t count, ssize_t *ret)
+{
+    read_cache_t *c;
+
+    if (fd < 0 || fd >= MAX_FILES_OPEN || ! rc_allowed[fd])
+        return 0;
+
+    c = rc[fd];
+    if (! c && ! (c = rc_setup(fd, file_desc)))
+        return 0;
+
+    if (c->type == RC_MMAP)
+        *ret = rc_read_mmap(c, buf, count);
+    else
+        *ret = rc_read_buffer(c, file_desc, buf, count);
+
+    return 1;
+}
+
+int rc_lseek(int fd, const file_desc_t *file_desc, off_t offset,
+             int whence, off_t *ret)
+{
+    read_cache_t *c;
+    off_t pos, ahead;
+
+    if (fd < 0 || fd >= MAX_FILES_OPEN || ! (c = rc[fd]))
+        return 0;
+
+    if (c->type == RC_MMAP)
+    {
+        switch (whence)
+        {
+        case SEEK_SET: pos = offset;              break;
+        case SEEK_CUR: pos = c->pos + offset;     break;
+        case SEEK_END: pos = c->map_len + offset; break;
+        default:       *ret = -EINVAL;            return 1;
+        }
+        if (pos < 0)
+        {
+            *ret = -EINVAL;
+            return 1;
+        }
+        *ret = c->pos = pos;
+        return 1;
+    }
+
+    // the server is ahead by what is still buffered
+    ahead = c->len - c->start;
+    if (whence == SEEK_CUR)
+        offset -= ahead;
+    c->start  = c->len = 0;
+    c->window = RC_WINDOW_MIN;
+
+    *ret = l4vfs_lseek(file_desc->server_id, file_desc->object_handle,
+                       offset, whence);
+    if (*ret < 0 && ahead)
+        l4vfs_lseek(file_desc->server_id, file_desc->object_handle,
+                    -ahead, SEEK_CUR);
+    return 1;
+}
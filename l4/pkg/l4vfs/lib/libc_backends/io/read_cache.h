@@ -0,0 +1,36 @@
+/**
+ * \file   l4vfs/lib/libc_backends/io/read_cache.h
+ * \brief  Per file descriptor read-ahead cache
+ *
+ * \date   2026-10-19
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#ifndef __L4VFS_LIB_BACKENDS_IO_READ_CACHE_H_
+#define __L4VFS_LIB_BACKENDS_IO_READ_CACHE_H_
+
+#include <sys/types.h>
+#include <l4/l4vfs/types.h>
+
+/* read-ahead window, doubled on each sequential refill */
+#define RC_WINDOW_MIN   4096
+#define RC_WINDOW_MAX   65536
+
+/* regular files up to this size are mmap()ed if the server supports it */
+#define RC_MMAP_MAX     (256 * 1024)
+
+void rc_open(int fd, int flags);
+void rc_close(int fd);
+void rc_disable(int fd);
+void rc_invalidate(int fd);
+
+/* Return 1 if the cache handled the call and *ret holds the result
+ * (-errno on error), 0 if the caller has to ask the server itself. */
+int  rc_read(int fd, const file_desc_t *file_desc, void *buf,
+             size_t count, ssize_t *ret);
+int  rc_lseek(int fd, const file_desc_t *file_desc, off_t offset,
+              int whence, off_t *ret);
+
+#endif
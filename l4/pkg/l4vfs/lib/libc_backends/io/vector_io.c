@@ -1,6 +1,6 @@
 /**
  * \file   l4vfs/lib/libc_backends/io/vector_io.c
- * \brief  vector io operations mapped to multiple single io calls
+ * \brief  vector io operations, using readv / writev of common_io
  *
  * \date   2004-06-01
  * \author Jens Syckor <js712688@inf.tu-dresden.de>
@@ -12,28 +12,164 @@
 
 /*** GENERAL INCLUDES ***/
 #include <errno.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/uio.h>
 
 /*** L4-SPECIFIC INCLUDES ***/
 #include <l4/l4vfs/basic_io.h>
+#include <l4/l4vfs/common_io.h>
 #include <l4/l4vfs/file-table.h>
 #include <l4/log/l4log.h>
 
+#include "read_cache.h"
+#include "write_combine.h"
+
 #ifdef DEBUG
 static int _DEBUG = 1;
 #else
 static int _DEBUG = 0;
 #endif
 
-/** VECTOR IO OPERATION WRITEV USING MULTIPLE WRITE CALLS **/
+/* Servers which answered readv / writev with -ENOSYS, we do not ask them
+ * again but use single read / write calls right away.
+ */
+#define NO_VECTOR_IO_SERVERS 8
+
+typedef struct
+{
+    l4_threadid_t server[NO_VECTOR_IO_SERVERS];
+    int           next;
+} no_vector_io_t;
+
+static no_vector_io_t no_readv, no_writev;
+
+static int has_vector_io(no_vector_io_t *no, l4_threadid_t server)
+{
+    int i;
+
+    for (i = 0; i < NO_VECTOR_IO_SERVERS; i++)
+        if (l4_thread_equal(no->server[i], server))
+            return 0;
+    return 1;
+}
+
+static void set_no_vector_io(no_vector_io_t *no, l4_threadid_t server)
+{
+    no->server[no->next] = server;
+    no->next = (no->next + 1) % NO_VECTOR_IO_SERVERS;
+}
+
+static int check_vector(const struct iovec *vector, int count)
+{
+    int i;
+
+    if (!vector)
+        return EFAULT;
+
+    if (count <= 0 || count > UIO_MAXIOV)
+        return EINVAL;
+
+    for (i = 0; i < count; i++)
+    {
+        if (! vector[i].iov_base && vector[i].iov_len)
+            return EFAULT;
+        if ((ssize_t) vector[i].iov_len < 0)
+            return EINVAL;
+    }
+
+    return 0;
+}
+
+/* Number of segments starting at vector[0] that fit into one message,
+ * 0 if the first one alone is too large. */
+static int batch_segments(const struct iovec *vector, int count,
+                          size_t *bytes)
+{
+    int n;
+
+    *bytes = 0;
+    for (n = 0; n < count && n < L4VFS_IOV_MAX; n++)
+    {
+        if (vector[n].iov_len > L4VFS_WRITE_RCVBUF_SIZE - *bytes)
+            break;
+        *bytes += vector[n].iov_len;
+    }
+
+    return n;
+}
+
+static ssize_t write_segment(file_desc_t *file_desc,
+                             const char *buf, size_t len)
+{
+    ssize_t res, done = 0;
+    size_t count;
+
+    while (done < len)
+    {
+        count = len - done;
+        res = l4vfs_write(file_desc->server_id, file_desc->object_handle,
+                          (const l4_int8_t *) buf + done, &count);
+        if (res <= 0)
+            return done ? done : res;
+        done += res;
+    }
+
+    return done;
+}
+
+static ssize_t write_batch(file_desc_t *file_desc, const struct iovec *vector,
+                           int n, size_t bytes)
+{
+    l4vfs_size_t lens[L4VFS_IOV_MAX];
+    ssize_t res, done;
+    char *buf;
+    int i;
+
+    if (has_vector_io(&no_writev, file_desc->server_id))
+    {
+        buf = malloc(bytes ? bytes : 1);
+        if (! buf)
+            return -ENOMEM;
+
+        for (i = 0, done = 0; i < n; i++)
+        {
+            memcpy(buf + done, vector[i].iov_base, vector[i].iov_len);
+            lens[i] = vector[i].iov_len;
+            done   += vector[i].iov_len;
+        }
+
+        res = l4vfs_writev(file_desc->server_id, file_desc->object_handle,
+                           (l4_int8_t *) buf, bytes, lens, n);
+        free(buf);
+
+        if (res != -ENOSYS)
+            return res;
+
+        set_no_vector_io(&no_writev, file_desc->server_id);
+    }
+
+    for (i = 0, done = 0; i < n; i++)
+    {
+        res = write_segment(file_desc, vector[i].iov_base, vector[i].iov_len);
+        if (res < 0)
+            return done ? done : res;
+        done += res;
+        if (res < vector[i].iov_len)
+            break;
+    }
+
+    return done;
+}
+
+/** VECTOR IO OPERATION WRITEV, MULTIPLE SEGMENTS PER IPC **/
 ssize_t writev(int fd, const struct iovec *vector, int count)
 {
-    int i, res;
+    int i, n, err;
     file_desc_t file_desc;
-    ssize_t ret = 0;
-    size_t len;
-    void *buf;
+    ssize_t ret = 0, res;
+    size_t bytes;
 
     if (! ft_is_open(fd))
     {
@@ -41,15 +177,9 @@ ssize_t writev(int fd, const struct iovec *vector, int count)
         return -1;
     }
 
-    if (!vector)
+    if ((err = check_vector(vector, count)))
     {
-        errno = EFAULT;
-        return -1;
-    }
-
-    if (count <= 0 || count > UIO_MAXIOV)
-    {
-        errno = EINVAL;
+        errno = err;
         return -1;
     }
 
@@ -61,40 +191,37 @@ ssize_t writev(int fd, const struct iovec *vector, int count)
         return -1;
     }
 
-    for (i=0; i < count; i++)
-    {
-        len = vector[i].iov_len;
-        buf = (void *) vector[i].iov_base;
+    l4vfs_wc_flush();
+    rc_invalidate(fd);
 
-        LOGd(_DEBUG,"len (%d) of iov (%d)", len, i);
+    for (i = 0; i < count; i += n)
+    {
+        n = batch_segments(vector + i, count - i, &bytes);
 
-        if (! buf || len < 0)
+        if (n == 0)
         {
-            if (! buf)
-            {
-                errno = EFAULT;
-            }
-            else
-            {
-                errno = EINVAL;
-            }
-
-            return ret;
+            // segment too large for one message
+            n     = 1;
+            bytes = vector[i].iov_len;
+            res   = write_segment(&file_desc, vector[i].iov_base, bytes);
         }
+        else
+            res = write_batch(&file_desc, vector + i, n, bytes);
 
-        res = l4vfs_write(file_desc.server_id,
-                          file_desc.object_handle, buf, &len);
+        LOGd(_DEBUG,"segments (%d), bytes (%d), written (%d)",
+             n, bytes, (int) res);
 
-        // check the case: res < vector[i].iov_len && res >= 0
-        if (res == vector[i].iov_len)
+        if (res < 0)
         {
-            ret += res;
-        }
-        else
-        {
-            errno = EAGAIN;
-            return ret;
+            if (ret)
+                break;
+            errno = -res;
+            return -1;
         }
+
+        ret += res;
+        if (res < bytes)
+            break;
     }
 
     LOGd(_DEBUG,"bytes written: %d", (int) ret);
@@ -102,30 +229,85 @@ ssize_t writev(int fd, const struct iovec *vector, int count)
     return ret;
 }
 
-/** VECTOR IO OPERATION READV USING MULTIPLE READ CALLS **/
-ssize_t readv(int fd, const struct iovec *vector, int count)
+static ssize_t read_batch(file_desc_t *file_desc, const struct iovec *vector,
+                          int n, size_t bytes)
 {
-    int i, res;
-    file_desc_t file_desc;
-    ssize_t ret = 0;
+    l4vfs_size_t lens[L4VFS_IOV_MAX];
+    ssize_t res, done;
     size_t len;
     char *buf;
+    int i;
 
-    if (! ft_is_open(fd))
+    if (n > 1 && has_vector_io(&no_readv, file_desc->server_id))
     {
-        errno = EBADF;
-        return -1;
+        buf = malloc(bytes);
+        if (! buf)
+            return -ENOMEM;
+
+        for (i = 0; i < n; i++)
+            lens[i] = vector[i].iov_len;
+
+        len = bytes;
+        res = l4vfs_readv(file_desc->server_id, file_desc->object_handle,
+                          &buf, &len, lens, n);
+
+        if (res > (ssize_t) bytes)
+            res = bytes;
+        if (res > 0)
+        {
+            // scatter into the caller's segments
+            for (i = 0, done = 0; done < res; i++)
+            {
+                len = vector[i].iov_len;
+                if (len > res - done)
+                    len = res - done;
+                memcpy(vector[i].iov_base, buf + done, len);
+                done += len;
+            }
+        }
+        free(buf);
+
+        if (res != -ENOSYS)
+            return res;
+
+        set_no_vector_io(&no_readv, file_desc->server_id);
     }
 
-    if (!vector)
+    for (i = 0, done = 0; i < n; i++)
+    {
+        buf = vector[i].iov_base;
+        len = vector[i].iov_len;
+        res = l4vfs_read(file_desc->server_id, file_desc->object_handle,
+                         &buf, &len);
+        if (res < 0)
+            return done ? done : res;
+        done += res;
+
+        /* could not read complete length but no error */
+        if (res != vector[i].iov_len)
+            break;
+    }
+
+    return done;
+}
+
+/** VECTOR IO OPERATION READV, MULTIPLE SEGMENTS PER IPC **/
+ssize_t readv(int fd, const struct iovec *vector, int count)
+{
+    int i, n, err;
+    file_desc_t file_desc;
+    ssize_t ret = 0, res;
+    size_t bytes;
+
+    if (! ft_is_open(fd))
     {
-        errno = EFAULT;
+        errno = EBADF;
         return -1;
     }
 
-    if (count <= 0 || count > UIO_MAXIOV)
+    if ((err = check_vector(vector, count)))
     {
-        errno = EINVAL;
+        errno = err;
         return -1;
     }
 
@@ -137,44 +319,32 @@ ssize_t readv(int fd, const struct iovec *vector, int count)
         return -1;
     }
 
-    for (i=0; i < count; i++)
+    l4vfs_wc_flush();
+    rc_invalidate(fd);
+
+    for (i = 0; i < count; i += n)
     {
-        len = vector[i].iov_len;
-        buf = vector[i].iov_base;
+        n = batch_segments(vector + i, count - i, &bytes);
 
-        if (! buf || len < 0)
+        if (n == 0)
         {
-            if (!buf)
-            {
-                errno = EFAULT;
-            }
-            else
-            {
-                errno = EINVAL;
-            }
-
-            return ret;
+            // segment too large for one message, read() it alone
+            n     = 1;
+            bytes = vector[i].iov_len;
         }
 
-        res = l4vfs_read(file_desc.server_id, file_desc.object_handle,
-                         &buf, &len);
-
-        if (res >= 0)
-        {
-            ret += res;
-
-            /* could not read complete length but no error */
-            if (res != vector[i].iov_len)
-            {
-                errno = 0;
-                return ret;
-            }
-        }
-        else
+        res = read_batch(&file_desc, vector + i, n, bytes);
+        if (res < 0)
         {
+            if (ret)
+                break;
             errno = -res;
             return -1;
         }
+
+        ret += res;
+        if (res < bytes)
+            break;
     }
 
     return ret;
@@ -0,0 +1,147 @@
+/**
+ * \file   l4vfs/lib/libc_backends/io/write_combine.c
+ * \brief  Collect small writes to terminals and logs into one IPC
+ *
+ * Programs writing to stdout / stderr often do so in small pieces
+ * (single characters, words, printf fragments), each costing a write
+ * IPC to term_server or the log server. For the fds enabled here, such
+ * writes are appended to a buffer that is sent on newline, when full,
+ * and before any other operation of the backend, so that the order of
+ * operations as seen by servers does not change.
+ *
+ * There is only one buffer: a write to another fd flushes it first.
+ *
+ * \date   2026-10-19
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#include <errno.h>
+#include <string.h>
+
+#include <l4/l4vfs/common_io.h>
+#include <l4/l4vfs/file-table.h>
+#include <l4/util/lock.h>
+#include <l4/crtx/ctor.h>
+#include <l4/log/l4log.h>
+
+#include "write_combine.h"
+
+static struct
+{
+    int                  fd;
+    file_desc_t          file_desc;
+    size_t               len;
+    char                 buf[WC_BUF_SIZE];
+} wc = { .fd = -1 };
+
+static unsigned char wc_fds[MAX_FILES_OPEN];
+static l4util_simple_lock_t wc_lock;
+
+static int wc_flush_locked(void)
+{
+    size_t done = 0, count;
+    ssize_t ret;
+
+    while (done < wc.len)
+    {
+        count = wc.len - done;
+        ret = l4vfs_write(wc.file_desc.server_id,
+                          wc.file_desc.object_handle,
+                          (l4_int8_t *)wc.buf + done,
+                          &count);
+        if (ret <= 0)
+        {
+            wc.len = 0;
+            return ret ? ret : -EIO;
+        }
+        done += ret;
+    }
+    wc.len = 0;
+
+    return 0;
+}
+
+int l4vfs_wc_flush(void)
+{
+    int ret;
+
+    if (wc.len == 0)
+        return 0;
+
+    l4_simple_lock(&wc_lock);
+    ret = wc_flush_locked();
+    l4_simple_unlock(&wc_lock);
+
+    return ret;
+}
+
+void wc_enable(int fd)
+{
+    if (fd >= 0 && fd < MAX_FILES_OPEN)
+        wc_fds[fd] = 1;
+}
+
+void wc_disable(int fd)
+{
+    if (fd < 0 || fd >= MAX_FILES_OPEN)
+        return;
+
+    wc_fds[fd] = 0;
+    if (wc.fd == fd)
+    {
+        l4vfs_wc_flush();
+        wc.fd = -1;
+    }
+}
+
+/* Returns count if the data was taken, -1 with errno set on error, and
+ * 0 if the caller has to write it itself (after the buffer has been
+ * flushed). */
+ssize_t wc_write(int fd, const file_desc_t *file_desc,
+                 const void *buf, size_t count)
+{
+    int ret = 0;
+
+    if (fd < 0 || fd >= MAX_FILES_OPEN || ! wc_fds[fd] ||
+        count >= WC_BUF_SIZE)
+    {
+        ret = l4vfs_wc_flush();
+        goto out;
+    }
+
+    l4_simple_lock(&wc_lock);
+
+    if (wc.len && (wc.fd != fd || count > WC_BUF_SIZE - wc.len))
+        ret = wc_flush_locked();
+
+    if (ret == 0)
+    {
+        memcpy(wc.buf + wc.len, buf, count);
+        wc.fd        = fd;
+        wc.file_desc = *file_desc;
+        wc.len      += count;
+
+        if (memchr(buf, '\n', count))
+            ret = wc_flush_locked();
+        if (ret == 0)
+            ret = count;
+    }
+
+    l4_simple_unlock(&wc_lock);
+
+ out:
+    if (ret < 0)
+    {
+        errno = -ret;
+        return -1;
+    }
+    return ret;
+}
+
+static void wc_exit(void)
+{
+    l4vfs_wc_flush();
+}
+L4C_DTOR(wc_exit, 2100);
@@ -0,0 +1,29 @@
+/**
+ * \file   l4vfs/lib/libc_backends/io/write_combine.h
+ * \brief  Collect small writes to terminals and logs into one IPC
+ *
+ * \date   2026-10-19
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#ifndef __L4VFS_LIB_BACKENDS_IO_WRITE_COMBINE_H_
+#define __L4VFS_LIB_BACKENDS_IO_WRITE_COMBINE_H_
+
+#include <sys/types.h>
+#include <l4/l4vfs/types.h>
+
+/* size of the combining buffer, larger writes go out directly */
+#define WC_BUF_SIZE 512
+
+void    wc_enable(int fd);
+void    wc_disable(int fd);
+ssize_t wc_write(int fd, const file_desc_t *file_desc,
+                 const void *buf, size_t count);
+
+/* Send out pending data. Called before every other operation, also by
+ * the select backend, so it is not static. Returns 0 or -errno. */
+int     l4vfs_wc_flush(void);
+
+#endif
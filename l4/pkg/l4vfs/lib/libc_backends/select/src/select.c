@@ -40,6 +40,10 @@ static int _DEBUG = 0;
 
 static l4thread_t notif_t = L4THREAD_INVALID_ID;
 
+/* from the io backend, pending combined writes must go out before we
+ * possibly wait for an answer to them */
+extern int l4vfs_wc_flush(void) __attribute__((weak));
+
 static int select_create_info(int n, fd_set *readfds, fd_set *writefds,
                               fd_set *exceptfds, select_info_t *select_infos);
 
@@ -270,6 +274,9 @@ int select(int n, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct t
         return -1;
     }
 
+    if (l4vfs_wc_flush)
+        l4vfs_wc_flush();
+
     sem = L4SEMAPHORE_INIT(0);
 
     /* true means we use select to sleep a time period specified in timeout */
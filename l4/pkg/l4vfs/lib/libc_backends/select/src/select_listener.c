@@ -62,11 +62,9 @@ void notify_listener_thread(void)
     select_internal_server_loop(&env);
 }
 
-l4_int32_t
-l4vfs_select_listener_send_notification_component(CORBA_Object _dice_corba_obj,
-                                                  object_handle_t fd,
-                                                  l4_int32_t mode,
-                                                  CORBA_Server_Environment *_dice_corba_env)
+/* wake up the select threads waiting for fd of server with mode */
+static l4_int32_t
+notify(l4_threadid_t server, object_handle_t fd, l4_int32_t mode)
 {
     listener_info_t *current;
     select_info_t *curr_select;
@@ -101,7 +99,7 @@ l4vfs_select_listener_send_notification_component(CORBA_Object _dice_corba_obj,
 
             fd_s = ft_get_entry(curr_select->local_fd);
 
-            if (l4_task_equal(fd_s.server_id, *_dice_corba_obj)
+            if (l4_task_equal(fd_s.server_id, server)
                  && fd_s.object_handle == fd
                  && (curr_select->mode & mode))
             {
@@ -125,6 +123,35 @@ l4vfs_select_listener_send_notification_component(CORBA_Object _dice_corba_obj,
     return 0;
 }
 
+l4_int32_t
+l4vfs_select_listener_send_notification_component(CORBA_Object _dice_corba_obj,
+                                                  object_handle_t fd,
+                                                  l4_int32_t mode,
+                                                  CORBA_Server_Environment *_dice_corba_env)
+{
+    return notify(*_dice_corba_obj, fd, mode);
+}
+
+l4_int32_t
+l4vfs_select_listener_send_notifications_component(CORBA_Object _dice_corba_obj,
+                                                   l4_int32_t count,
+                                                   const object_handle_t *handles,
+                                                   const l4_int32_t *modes,
+                                                   CORBA_Server_Environment *_dice_corba_env)
+{
+    l4_int32_t i, ret, err = 0;
+
+    /* report the first error, but deliver all others */
+    for (i = 0; i < count; i++)
+    {
+        ret = notify(*_dice_corba_obj, handles[i], modes[i]);
+        if (ret && ! err)
+            err = ret;
+    }
+
+    return err;
+}
+
 l4_int32_t
 select_internal_deregister_component(CORBA_Object _dice_corba_obj,
                                      l4thread_t select_tid,
@@ -0,0 +1,79 @@
+/**
+ * \file   l4vfs/lib/server/readv.c
+ * \brief  readv mapped to the read() of the server
+ *
+ * \date   2026-10-19
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#include <errno.h>
+#include <string.h>
+#include <common_io-server.h>
+#include <l4/log/l4log.h>
+
+/* Servers whose read() does not reply directly (but from a worker
+ * thread) must provide their own readv(), e.g. one returning -ENOSYS
+ * to make the client fall back to read().
+ */
+l4vfs_ssize_t
+l4vfs_common_io_readv_component(CORBA_Object _dice_corba_obj,
+                                object_handle_t handle,
+                                char **buf,
+                                l4vfs_size_t *count,
+                                int segments,
+                                const l4vfs_size_t *lens,
+                                CORBA_Server_Environment *_dice_corba_env)
+    __attribute__((weak));
+
+l4vfs_ssize_t
+l4vfs_common_io_readv_component(CORBA_Object _dice_corba_obj,
+                                object_handle_t handle,
+                                char **buf,
+                                l4vfs_size_t *count,
+                                int segments,
+                                const l4vfs_size_t *lens,
+                                CORBA_Server_Environment *_dice_corba_env)
+{
+    l4vfs_ssize_t ret, done = 0;
+    l4vfs_size_t len;
+    char *p;
+    short reply;
+    int i;
+
+    for (i = 0; i < segments; i++)
+    {
+        if (lens[i] > *count - done)
+            break;
+        if (lens[i] == 0)
+            continue;
+
+        p     = *buf + done;
+        len   = lens[i];
+        reply = DICE_REPLY;
+        ret   = l4vfs_common_io_read_component(_dice_corba_obj, handle,
+                                               &p, &len, &reply,
+                                               _dice_corba_env);
+        if (reply != DICE_REPLY)
+            LOG_Error("read() did not reply, server needs its own readv()");
+        if (ret < 0)
+        {
+            if (done)
+                break;
+            *count = 0;
+            return ret;
+        }
+
+        // read() may hand out its own buffer
+        if (ret > 0 && p != *buf + done)
+            memcpy(*buf + done, p, ret);
+
+        done += ret;
+        if (ret < lens[i])
+            break;
+    }
+
+    *count = done;
+    return done;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file   l4vfs/lib/server/writev.c
+ * \brief  writev mapped to the write() of the server
+ *
+ * \date   2026-10-19
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#include <errno.h>
+#include <common_io-server.h>
+#include <l4/log/l4log.h>
+
+/* Servers whose write() does not reply directly (but from a worker
+ * thread) must provide their own writev().
+ */
+l4vfs_ssize_t
+l4vfs_common_io_writev_component(CORBA_Object _dice_corba_obj,
+                                 object_handle_t handle,
+                                 const char *buf,
+                                 l4vfs_size_t count,
+                                 int segments,
+                                 const l4vfs_size_t *lens,
+                                 CORBA_Server_Environment *_dice_corba_env)
+    __attribute__((weak));
+
+l4vfs_ssize_t
+l4vfs_common_io_writev_component(CORBA_Object _dice_corba_obj,
+                                 object_handle_t handle,
+                                 const char *buf,
+                                 l4vfs_size_t count,
+                                 int segments,
+                                 const l4vfs_size_t *lens,
+                                 CORBA_Server_Environment *_dice_corba_env)
+{
+    l4vfs_ssize_t ret, done = 0;
+    l4vfs_size_t len;
+    short reply;
+    int i;
+
+    for (i = 0; i < segments; i++)
+    {
+        if (lens[i] > count - done)
+            return done ? done : -EINVAL;
+        if (lens[i] == 0)
+            continue;
+
+        len   = lens[i];
+        reply = DICE_REPLY;
+        ret   = l4vfs_common_io_write_component(_dice_corba_obj, handle,
+                                                buf + done, &len, &reply,
+                                                _dice_corba_env);
+        if (reply != DICE_REPLY)
+            LOG_Error("write() did not reply, server needs its own writev()");
+        if (ret < 0)
+            return done ? done : ret;
+
+        done += ret;
+        if (ret < lens[i])
+            break;
+    }
+
+    return done;
+}
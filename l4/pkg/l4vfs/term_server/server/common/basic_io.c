@@ -208,6 +208,20 @@ l4vfs_common_io_read_component(CORBA_Object _dice_corba_obj,
     return 0;
 }
 
+// read() replies from the worker thread, let the client fall back to it
+l4vfs_ssize_t
+l4vfs_common_io_readv_component(CORBA_Object _dice_corba_obj,
+                                object_handle_t h,
+                                char **buf,
+                                l4vfs_size_t *count,
+                                int segments,
+                                const l4vfs_size_t *lens,
+                                CORBA_Server_Environment *_dice_corba_env)
+{
+    *count = 0;
+    return -ENOSYS;
+}
+
 void l4vfs_common_io_notify_read_notify_component(
     CORBA_Object _dice_corba_obj,
     object_handle_t fd,
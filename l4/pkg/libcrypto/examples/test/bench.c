@@ -0,0 +1,138 @@
+/*
+ * \brief   Throughput of the AES implementations and modes.
+ * \date    2026-10-19
+ *
+ * Built once per AES implementation (crypto_bench_linux,
+ * crypto_bench_ttable). For every buffer size, the single-block functions
+ * are compared to the multi-block API, the CBC decryption of both, and
+ * CTR mode.
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/* general includes */
+#include <string.h>
+
+/* L4-specific includes */
+#include <l4/log/l4log.h>
+#include <l4/util/rdtsc.h>
+#include <l4/util/reboot.h>
+
+#include <l4/crypto/aes.h>
+#include <l4/crypto/cbc.h>
+#include <l4/crypto/ctr.h>
+
+/*
+ * ***************************************************************************
+ */
+
+#define BENCH_BYTES     (4 * 1024 * 1024)
+#define BENCH_MAX_BUF   16384
+
+enum {
+    BENCH_ECB,
+    BENCH_ECB_BLOCKS,
+    BENCH_CBC_ENC,
+    BENCH_CBC_DEC,
+    BENCH_CBC_DEC_BLOCKS,
+    BENCH_CTR,
+    BENCH_MAX,
+};
+
+static const char *bench_name[BENCH_MAX] = {
+    "ecb", "ecb blocks", "cbc enc", "cbc dec", "cbc dec blocks", "ctr"
+};
+
+static char buf[BENCH_MAX_BUF];
+static char iv[AES_BLOCK_SIZE];
+static char ctr[AES_BLOCK_SIZE];
+
+/*
+ * ***************************************************************************
+ */
+
+static void bench_run(int what, crypto_aes_ctx_t *ctx, unsigned int size) {
+
+    unsigned int i;
+
+    switch (what) {
+
+    case BENCH_ECB:
+        for (i = 0; i < size; i += AES_BLOCK_SIZE)
+            aes_cipher_encrypt(ctx, &buf[i], &buf[i]);
+        break;
+    case BENCH_ECB_BLOCKS:
+        aes_cipher_encrypt_blocks(ctx, buf, buf, size / AES_BLOCK_SIZE);
+        break;
+    case BENCH_CBC_ENC:
+        crypto_cbc_encrypt(aes_cipher_encrypt, ctx, AES_BLOCK_SIZE,
+                           buf, buf, iv, size);
+        break;
+    case BENCH_CBC_DEC:
+        crypto_cbc_decrypt(aes_cipher_decrypt, ctx, AES_BLOCK_SIZE,
+                           buf, buf, iv, size);
+        break;
+    case BENCH_CBC_DEC_BLOCKS:
+        crypto_cbc_decrypt_blocks(aes_cipher_decrypt_blocks, ctx,
+                                  AES_BLOCK_SIZE, buf, buf, iv, size);
+        break;
+    case BENCH_CTR:
+        crypto_ctr_crypt(aes_cipher_encrypt_blocks, ctx, AES_BLOCK_SIZE,
+                         buf, buf, ctr, size);
+        break;
+    }
+}
+
+static void bench(int what, crypto_aes_ctx_t *ctx, unsigned int size) {
+
+    l4_cpu_time_t start;
+    l4_uint64_t ns;
+    unsigned int n, rounds = BENCH_BYTES / size;
+
+    /* warm up caches and tables */
+    bench_run(what, ctx, size);
+
+    start = l4_rdtsc();
+    for (n = 0; n < rounds; n++)
+        bench_run(what, ctx, size);
+    ns = l4_tsc_to_ns(l4_rdtsc() - start);
+
+    if (ns == 0)
+        ns = 1;
+    LOG_printf("%-14s %5u bytes: %6u KB/s\n", bench_name[what], size,
+               (unsigned) ((l4_uint64_t) rounds * size * 1000000000 / ns
+                           / 1024));
+}
+
+/*
+ * ***************************************************************************
+ */
+int main(int argc, char **argv) {
+
+    static const unsigned int sizes[] = { 64, 1024, BENCH_MAX_BUF };
+    crypto_aes_ctx_t ctx;
+    char key[AES128_KEY_SIZE];
+    unsigned int s;
+    int what;
+
+    l4_calibrate_tsc();
+
+    memset(key, 0x5a, sizeof(key));
+    memset(buf, 0xa5, sizeof(buf));
+    aes_cipher_set_key(&ctx, key, AES128_KEY_SIZE, 0);
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        for (what = 0; what < BENCH_MAX; what++)
+            bench(what, &ctx, sizes[s]);
+
+    /* terminate Fiasco-UX */
+    l4util_reboot();
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * \brief   Throughput of the SHA1 implementations.
+ * \date    2026-10-19
+ *
+ * Built once per SHA1 implementation (crypto_sha1_bench_*). Hashes
+ * messages of different sizes one after the other and, if the
+ * implementation has sha1_digest_multi(), all at once.
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/* general includes */
+#include <string.h>
+
+/* L4-specific includes */
+#include <l4/log/l4log.h>
+#include <l4/util/rdtsc.h>
+#include <l4/util/reboot.h>
+
+#include <l4/crypto/sha1.h>
+
+/* only crypto_sha1_sse2 has it */
+#pragma weak sha1_digest_multi
+
+/*
+ * ***************************************************************************
+ */
+
+#define BENCH_BYTES     (4 * 1024 * 1024)
+#define BENCH_MSGS      8
+#define BENCH_MAX_BUF   (64 * 1024)
+
+static char buf[BENCH_MSGS][BENCH_MAX_BUF];
+static char digest[BENCH_MSGS][SHA1_DIGEST_SIZE];
+
+/*
+ * ***************************************************************************
+ */
+
+static void bench_report(const char *what, unsigned int size,
+                         l4_cpu_time_t tsc) {
+
+    l4_uint64_t ns = l4_tsc_to_ns(tsc);
+
+    if (ns == 0)
+        ns = 1;
+    LOG_printf("%-6s %5u bytes: %6u KB/s\n", what, size,
+               (unsigned) ((l4_uint64_t) BENCH_BYTES * 1000000000 / ns
+                           / 1024));
+}
+
+static void bench_single(unsigned int size) {
+
+    crypto_sha1_ctx_t ctx;
+    l4_cpu_time_t start;
+    unsigned int n, rounds = BENCH_BYTES / size;
+
+    start = l4_rdtsc();
+    for (n = 0; n < rounds; n++) {
+        sha1_digest_setup(&ctx);
+        sha1_digest_update(&ctx, buf[n % BENCH_MSGS], size);
+        sha1_digest_final(&ctx, digest[n % BENCH_MSGS]);
+    }
+    bench_report("single", size, l4_rdtsc() - start);
+}
+
+static void bench_multi(unsigned int size) {
+
+    const char *data[BENCH_MSGS];
+    unsigned int len[BENCH_MSGS];
+    char *out[BENCH_MSGS];
+    l4_cpu_time_t start;
+    unsigned int n, rounds = BENCH_BYTES / size / BENCH_MSGS;
+
+    for (n = 0; n < BENCH_MSGS; n++) {
+        data[n] = buf[n];
+        len[n]  = size;
+        out[n]  = digest[n];
+    }
+
+    start = l4_rdtsc();
+    for (n = 0; n < rounds; n++)
+        sha1_digest_multi(BENCH_MSGS, data, len, out);
+    bench_report("multi", size, l4_rdtsc() - start);
+}
+
+/*
+ * ***************************************************************************
+ */
+int main(int argc, char **argv) {
+
+    static const unsigned int sizes[] = { 64, 1024, 4096, BENCH_MAX_BUF };
+    unsigned int s;
+
+    l4_calibrate_tsc();
+
+    memset(buf, 0xa5, sizeof(buf));
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        bench_single(sizes[s]);
+        if (&sha1_digest_multi)
+            bench_multi(sizes[s]);
+    }
+
+    /* terminate Fiasco-UX */
+    l4util_reboot();
+
+    return 0;
+}
@@ -23,6 +23,7 @@
 #include <l4/crypto/sha1.h>
 #include <l4/crypto/aes.h>
 #include <l4/crypto/cbc.h>
+#include <l4/crypto/ctr.h>
 #include <l4/crypto/rsaref2/global.h>
 #include <l4/crypto/rsaref2/rsaref.h>
 #include <l4/crypto/rsaref2/rsa.h>
@@ -354,6 +355,115 @@ static int test_aes128_cbc(void) {
 #endif
 }
 
+static int test_aes128_ctr(void) {
+
+    /* NIST SP 800-38A: F.5.1 CTR-AES128.Encrypt */
+
+    const char key[] =
+        { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+          0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+    const char ctr_ref[] =
+        { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+          0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+    const char msg_ref[] =
+        { 0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+          0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+          0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+          0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+          0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+          0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+          0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+          0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10 };
+    const char msg_enc_ref[] =
+        { 0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26,
+          0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+          0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+          0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+          0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e,
+          0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+          0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1,
+          0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee };
+    char msg[64], msg_enc[64], ctr[16];
+    crypto_aes_ctx_t ctx;
+    int ret;
+
+    aes_cipher_set_key(&ctx, key, AES128_KEY_SIZE, 0);
+
+    memcpy(ctr, ctr_ref, 16);
+    crypto_ctr_crypt(aes_cipher_encrypt_blocks, &ctx, AES_BLOCK_SIZE,
+                     msg_ref, msg_enc, ctr, 64);
+    ret = memcmp(msg_enc, msg_enc_ref, 64);
+    if (ret != 0)
+        return ret;
+
+    /* in-place, with a partial block in the middle of the stream */
+    memcpy(ctr, ctr_ref, 16);
+    memcpy(msg, msg_enc, 64);
+    crypto_ctr_crypt(aes_cipher_encrypt_blocks, &ctx, AES_BLOCK_SIZE,
+                     msg, msg, ctr, 40);
+    crypto_ctr_crypt(aes_cipher_encrypt_blocks, &ctx, AES_BLOCK_SIZE,
+                     &msg[48], &msg[48], ctr, 16);
+    ret = memcmp(msg, msg_ref, 40);
+    if (ret != 0)
+        return ret;
+
+    return memcmp(&msg[48], &msg_ref[48], 16);
+}
+
+static int test_aes_blocks(void) {
+
+    /* Multi-block API against the single-block functions, and CBC
+     * decryption of RFC 3602 case #4 (see above) in-place. */
+
+    const char key[] =
+        { 0x56, 0xe4, 0x7a, 0x38, 0xc5, 0x59, 0x89, 0x74,
+          0xbc, 0x46, 0x90, 0x3d, 0xba, 0x29, 0x03, 0x49 };
+    const char iv[] =
+        { 0x8c, 0xe8, 0x2e, 0xef, 0xbe, 0xa0, 0xda, 0x3c,
+          0x44, 0x69, 0x9e, 0xd7, 0xdb, 0x51, 0xb7, 0xd9 };
+    const char msg_enc_ref[] =
+        { 0xc3, 0x0e, 0x32, 0xff, 0xed, 0xc0, 0x77, 0x4e,
+          0x6a, 0xff, 0x6a, 0xf0, 0x86, 0x9f, 0x71, 0xaa,
+          0x0f, 0x3a, 0xf0, 0x7a, 0x9a, 0x31, 0xa9, 0xc6,
+          0x84, 0xdb, 0x20, 0x7e, 0xb0, 0xef, 0x8e, 0x4e,
+          0x35, 0x90, 0x7a, 0xa6, 0x32, 0xc3, 0xff, 0xdf,
+          0x86, 0x8b, 0xb7, 0xb2, 0x9d, 0x3d, 0x46, 0xad,
+          0x83, 0xce, 0x9f, 0x9a, 0x10, 0x2e, 0xe9, 0x9d,
+          0x49, 0xa5, 0x3e, 0x87, 0xf4, 0xc3, 0xda, 0x55 };
+    char buf[11 * AES_BLOCK_SIZE], out[11 * AES_BLOCK_SIZE];
+    char block[AES_BLOCK_SIZE];
+    crypto_aes_ctx_t ctx;
+    int i, ret;
+
+    aes_cipher_set_key(&ctx, key, AES128_KEY_SIZE, 0);
+
+    /* 11 blocks: two full batches of four plus a remainder */
+    for (i = 0; i < sizeof(buf); i++)
+        buf[i] = i;
+
+    aes_cipher_encrypt_blocks(&ctx, out, buf, 11);
+    for (i = 0; i < 11; i++) {
+        aes_cipher_encrypt(&ctx, block, &buf[i * AES_BLOCK_SIZE]);
+        ret = memcmp(block, &out[i * AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+        if (ret != 0)
+            return ret;
+    }
+
+    aes_cipher_decrypt_blocks(&ctx, out, out, 11);
+    ret = memcmp(out, buf, sizeof(buf));
+    if (ret != 0)
+        return ret;
+
+    memcpy(buf, msg_enc_ref, 64);
+    crypto_cbc_decrypt_blocks(aes_cipher_decrypt_blocks, &ctx, AES_BLOCK_SIZE,
+                              buf, buf, iv, 64);
+    for (i = 0; i < 64; i++)
+        if (buf[i] != (char) (0xa0 + i))
+            return 1;
+
+    return 0;
+}
+
 static int test_sha1(void) {
     const char data[] =
         { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
@@ -405,6 +515,8 @@ int main(int argc, char **argv) {
     LOG_printf("test_rsa1024():    %d (0 expected)\n", test_rsa1024());
     LOG_printf("test_rsa2048():    %d (0 expected)\n", test_rsa2048());
     LOG_printf("test_aes128_cbc(): %d (0 expected)\n", test_aes128_cbc());
+    LOG_printf("test_aes128_ctr(): %d (0 expected)\n", test_aes128_ctr());
+    LOG_printf("test_aes_blocks(): %d (0 expected)\n", test_aes_blocks());
     LOG_printf("test_sha1():       %d (0 expected)\n", test_sha1());
 
     /* terminate Fiasco-UX */
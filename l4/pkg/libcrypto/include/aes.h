@@ -18,6 +18,7 @@
 #include "private/cipher.h"
 #include "private/aes_linux.h"
 #include "private/aes_openssl.h"
+#include "private/aes_ttable.h"
 
 /*
  * **************************************************************** 
@@ -37,6 +38,7 @@ typedef union
 {
     struct aes_c_ctx   __aes_linux;
     struct aes_586_ctx __aes_linux_586;
+    struct aes_ttable_ctx __aes_ttable;
     struct {
         AES_KEY __enc;
         AES_KEY __dec;
@@ -50,6 +52,8 @@ typedef union
 extern crypto_cipher_set_key_fn_t aes_cipher_set_key;
 extern crypto_cipher_encrypt_fn_t aes_cipher_encrypt;
 extern crypto_cipher_decrypt_fn_t aes_cipher_decrypt;
+extern crypto_cipher_encrypt_blocks_fn_t aes_cipher_encrypt_blocks;
+extern crypto_cipher_decrypt_blocks_fn_t aes_cipher_decrypt_blocks;
 
 #endif /* __CRYPTO_AES_H */
 
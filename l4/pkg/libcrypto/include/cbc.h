@@ -29,6 +29,10 @@ void crypto_cbc_decrypt(crypto_cipher_decrypt_fn_t decrypt,
                         void *ctx, unsigned int block_len,
                         const char *in, char *out, const char *iv,
                         unsigned int len);
+void crypto_cbc_decrypt_blocks(crypto_cipher_decrypt_blocks_fn_t decrypt,
+                               void *ctx, unsigned int block_len,
+                               const char *in, char *out, const char *iv,
+                               unsigned int len);
 
 #endif /* __CRYPTO_CBC_H */
 
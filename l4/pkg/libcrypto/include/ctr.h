@@ -0,0 +1,34 @@
+/*
+ * \brief   Header for counter mode.
+ * \date    2026-10-19
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef __CRYPTO_CTR_H
+#define __CRYPTO_CTR_H
+
+#include "private/cipher.h"
+
+/*
+ * **************************************************************** 
+ */
+
+/*
+ * Encryption and decryption are the same operation. len need not be a
+ * multiple of block_len. ctr is the initial counter block, on return it
+ * holds the counter to continue with; a partial last block uses up a
+ * whole counter.
+ */
+void crypto_ctr_crypt(crypto_cipher_encrypt_blocks_fn_t encrypt,
+                      void *ctx, unsigned int block_len,
+                      const char *in, char *out, char *ctr,
+                      unsigned int len);
+
+#endif /* __CRYPTO_CTR_H */
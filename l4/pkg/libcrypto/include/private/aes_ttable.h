@@ -0,0 +1,28 @@
+/*
+ * \brief   Private header for table-interleaved AES functions.
+ * \date    2026-10-19
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef __CRYPTO_AES_TTABLE_H
+#define __CRYPTO_AES_TTABLE_H
+
+#include <stdint.h>
+
+/* Round keys are kept as big-endian words, dkey is the key schedule of the
+ * equivalent inverse cipher. */
+
+struct aes_ttable_ctx {
+    uint32_t ekey[60];
+    uint32_t dkey[60];
+    unsigned int rounds;
+};
+
+#endif /* __CRYPTO_AES_TTABLE_H */
@@ -33,5 +33,16 @@ typedef void (*crypto_cipher_encrypt_fn_t)(void *ctx_arg, char *out,
 typedef void (*crypto_cipher_decrypt_fn_t)(void *ctx_arg, char *out,
                                            const char *in);
 
+/* Multi-block variants: process 'blocks' independent blocks per call.
+ * Implementations may interleave up to CRYPTO_CIPHER_BATCH blocks. */
+#define CRYPTO_CIPHER_BATCH 8
+
+typedef void (*crypto_cipher_encrypt_blocks_fn_t)(void *ctx_arg, char *out,
+                                                  const char *in,
+                                                  unsigned int blocks);
+typedef void (*crypto_cipher_decrypt_blocks_fn_t)(void *ctx_arg, char *out,
+                                                  const char *in,
+                                                  unsigned int blocks);
+
 #endif /* __CRYPTO_CIPHER_H */
 
@@ -24,5 +24,11 @@ typedef void (*crypto_digest_update_fn_t)(void *ctx, const char *data,
                                           unsigned int len);
 typedef void (*crypto_digest_final_fn_t) (void *ctx, char *out);
 
+/* out[i] = digest of data[i] (len[i] bytes) for n independent messages */
+typedef void (*crypto_digest_multi_fn_t) (unsigned int n,
+                                          const char * const data[],
+                                          const unsigned int len[],
+                                          char * const out[]);
+
 #endif /* __CRYPTO_DIGEST_H */
 
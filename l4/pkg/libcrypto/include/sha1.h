@@ -52,5 +52,8 @@ extern crypto_digest_setup_fn_t  sha1_digest_setup;
 extern crypto_digest_update_fn_t sha1_digest_update;
 extern crypto_digest_final_fn_t  sha1_digest_final;
 
+/* only provided by crypto_sha1_sse2 */
+extern crypto_digest_multi_fn_t  sha1_digest_multi;
+
 #endif /* __CRYPTO_SHA_H */
 
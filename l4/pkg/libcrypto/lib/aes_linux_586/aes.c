@@ -534,9 +534,27 @@ MODULE_ALIAS("aes");
 
 #else
 
+/* no interleaved implementation, one block after the other */
+
+static void aes_encrypt_blocks(void *ctx_arg, char *out, const char *in,
+                               unsigned int blocks)
+{
+	for (; blocks; blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+		aes_encrypt(ctx_arg, (u8 *) out, (const u8 *) in);
+}
+
+static void aes_decrypt_blocks(void *ctx_arg, char *out, const char *in,
+                               unsigned int blocks)
+{
+	for (; blocks; blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+		aes_decrypt(ctx_arg, (u8 *) out, (const u8 *) in);
+}
+
 crypto_cipher_set_key_fn_t aes_cipher_set_key = (crypto_cipher_set_key_fn_t) aes_set_key;
 crypto_cipher_encrypt_fn_t aes_cipher_encrypt = (crypto_cipher_encrypt_fn_t) aes_encrypt;
 crypto_cipher_decrypt_fn_t aes_cipher_decrypt = (crypto_cipher_decrypt_fn_t) aes_decrypt;
+crypto_cipher_encrypt_blocks_fn_t aes_cipher_encrypt_blocks = aes_encrypt_blocks;
+crypto_cipher_decrypt_blocks_fn_t aes_cipher_decrypt_blocks = aes_decrypt_blocks;
 
 static void init(void) __attribute__((constructor));
 static void init(void)
@@ -40,8 +40,24 @@ static void decrypt(void *ctx, unsigned char *out, const unsigned char *in) {
     AES_decrypt(in, out, &((crypto_aes_ctx_t *) ctx)->__aes_openssl.__dec);
 }
 
+static void encrypt_blocks(void *ctx, char *out, const char *in,
+                           unsigned int blocks) {
+
+    for (; blocks; blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+        encrypt(ctx, (unsigned char *) out, (const unsigned char *) in);
+}
+
+static void decrypt_blocks(void *ctx, char *out, const char *in,
+                           unsigned int blocks) {
+
+    for (; blocks; blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+        decrypt(ctx, (unsigned char *) out, (const unsigned char *) in);
+}
+
 crypto_cipher_set_key_fn_t aes_cipher_set_key = (crypto_cipher_set_key_fn_t) set_key;
 crypto_cipher_encrypt_fn_t aes_cipher_encrypt = (crypto_cipher_encrypt_fn_t) encrypt;
 crypto_cipher_decrypt_fn_t aes_cipher_decrypt = (crypto_cipher_decrypt_fn_t) decrypt;
+crypto_cipher_encrypt_blocks_fn_t aes_cipher_encrypt_blocks = encrypt_blocks;
+crypto_cipher_decrypt_blocks_fn_t aes_cipher_decrypt_blocks = decrypt_blocks;
 
 
@@ -0,0 +1,377 @@
+/*
+ * \brief   Table-interleaved AES implementation.
+ * \date    2026-10-19
+ *
+ * Classic 32-bit T-table AES. The multi-block functions run the rounds of
+ * four blocks side by side, so the table lookups of independent blocks
+ * overlap instead of waiting for each other. Tables are generated at
+ * startup to keep the binary small.
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/* general includes */
+#include <stdint.h>
+
+/* L4-specific includes */
+#include <l4/crypto/aes.h>
+
+/*
+ * *****************************************************************
+ */
+
+static uint32_t Te0[256], Te1[256], Te2[256], Te3[256];
+static uint32_t Td0[256], Td1[256], Td2[256], Td3[256];
+static uint8_t  sbox[256], sbox_inv[256];
+
+#define GETU32(p) (((uint32_t) (p)[0] << 24) | ((uint32_t) (p)[1] << 16) | \
+                   ((uint32_t) (p)[2] <<  8) |  (uint32_t) (p)[3])
+#define PUTU32(p, v) do { (p)[0] = (uint8_t) ((v) >> 24);  \
+                          (p)[1] = (uint8_t) ((v) >> 16);  \
+                          (p)[2] = (uint8_t) ((v) >>  8);  \
+                          (p)[3] = (uint8_t)  (v); } while (0)
+
+#define B0(x) ((x) >> 24)
+#define B1(x) (((x) >> 16) & 0xff)
+#define B2(x) (((x) >>  8) & 0xff)
+#define B3(x) ((x) & 0xff)
+
+static inline uint32_t ror8(uint32_t x) {
+
+    return (x >> 8) | (x << 24);
+}
+
+static inline uint8_t rol8(uint8_t x, int n) {
+
+    return (uint8_t) ((x << n) | (x >> (8 - n)));
+}
+
+static inline uint8_t xtime(uint8_t x) {
+
+    return (uint8_t) ((x << 1) ^ ((x & 0x80) ? 0x1b : 0));
+}
+
+static uint8_t gf_mul(uint8_t a, uint8_t b) {
+
+    uint8_t r = 0;
+
+    for (; b; b >>= 1, a = xtime(a))
+        if (b & 1)
+            r ^= a;
+    return r;
+}
+
+static void gen_tables(void) {
+
+    uint8_t p = 1, q = 1;
+    int i;
+
+    /* S-box: walk the multiplicative group with generator 3, q is the
+     * inverse of p */
+    do {
+        uint8_t x;
+
+        p = p ^ xtime(p);
+        q ^= q << 1;
+        q ^= q << 2;
+        q ^= q << 4;
+        if (q & 0x80)
+            q ^= 0x09;
+
+        x = q ^ rol8(q, 1) ^ rol8(q, 2) ^ rol8(q, 3) ^ rol8(q, 4);
+        sbox[p] = x ^ 0x63;
+    } while (p != 1);
+    sbox[0] = 0x63;
+
+    for (i = 0; i < 256; i++)
+        sbox_inv[sbox[i]] = i;
+
+    for (i = 0; i < 256; i++) {
+        uint8_t s = sbox[i], si = sbox_inv[i];
+
+        Te0[i] = ((uint32_t) xtime(s) << 24) | ((uint32_t) s << 16) |
+                 ((uint32_t) s << 8) | (uint8_t) (xtime(s) ^ s);
+        Te1[i] = ror8(Te0[i]);
+        Te2[i] = ror8(Te1[i]);
+        Te3[i] = ror8(Te2[i]);
+
+        Td0[i] = ((uint32_t) gf_mul(si, 0x0e) << 24) |
+                 ((uint32_t) gf_mul(si, 0x09) << 16) |
+                 ((uint32_t) gf_mul(si, 0x0d) << 8) | gf_mul(si, 0x0b);
+        Td1[i] = ror8(Td0[i]);
+        Td2[i] = ror8(Td1[i]);
+        Td3[i] = ror8(Td2[i]);
+    }
+}
+
+/*
+ * *****************************************************************
+ */
+
+static inline uint32_t sub_word(uint32_t w) {
+
+    return ((uint32_t) sbox[B0(w)] << 24) | ((uint32_t) sbox[B1(w)] << 16) |
+           ((uint32_t) sbox[B2(w)] << 8) | sbox[B3(w)];
+}
+
+static int aes_set_key(void *ctx_arg, const char *in_key, unsigned int key_len,
+                       unsigned int *flags) {
+
+    struct aes_ttable_ctx *ctx = ctx_arg;
+    const uint8_t *key = (const uint8_t *) in_key;
+    unsigned int nk = key_len / 4, total, i, r;
+    uint8_t rcon = 1;
+
+    if (key_len != 16 && key_len != 24 && key_len != 32)
+        return -1;
+
+    ctx->rounds = nk + 6;
+    total = 4 * (ctx->rounds + 1);
+
+    for (i = 0; i < nk; i++)
+        ctx->ekey[i] = GETU32(key + 4 * i);
+
+    for (i = nk; i < total; i++) {
+        uint32_t t = ctx->ekey[i - 1];
+
+        if (i % nk == 0) {
+            t = sub_word((t << 8) | (t >> 24)) ^ ((uint32_t) rcon << 24);
+            rcon = xtime(rcon);
+        } else if (nk > 6 && i % nk == 4)
+            t = sub_word(t);
+
+        ctx->ekey[i] = ctx->ekey[i - nk] ^ t;
+    }
+
+    /* equivalent inverse cipher: reverse round order, InvMixColumns on all
+     * but the first and last round key */
+    for (r = 0; r <= ctx->rounds; r++)
+        for (i = 0; i < 4; i++) {
+            uint32_t w = ctx->ekey[4 * (ctx->rounds - r) + i];
+
+            if (r > 0 && r < ctx->rounds)
+                w = Td0[sbox[B0(w)]] ^ Td1[sbox[B1(w)]] ^
+                    Td2[sbox[B2(w)]] ^ Td3[sbox[B3(w)]];
+            ctx->dkey[4 * r + i] = w;
+        }
+
+    return 0;
+}
+
+/*
+ * *****************************************************************
+ */
+
+#define ENC_ROUND(t, s, k)                                                  \
+    t[0] = Te0[B0(s[0])] ^ Te1[B1(s[1])] ^ Te2[B2(s[2])] ^ Te3[B3(s[3])] ^ k[0]; \
+    t[1] = Te0[B0(s[1])] ^ Te1[B1(s[2])] ^ Te2[B2(s[3])] ^ Te3[B3(s[0])] ^ k[1]; \
+    t[2] = Te0[B0(s[2])] ^ Te1[B1(s[3])] ^ Te2[B2(s[0])] ^ Te3[B3(s[1])] ^ k[2]; \
+    t[3] = Te0[B0(s[3])] ^ Te1[B1(s[0])] ^ Te2[B2(s[1])] ^ Te3[B3(s[2])] ^ k[3]
+
+#define ENC_LAST(t, k, i0, i1, i2, i3)                                   \
+    (((uint32_t) sbox[B0(t[i0])] << 24) ^ ((uint32_t) sbox[B1(t[i1])] << 16) ^ \
+     ((uint32_t) sbox[B2(t[i2])] << 8) ^ sbox[B3(t[i3])] ^ k)
+
+#define DEC_ROUND(t, s, k)                                                  \
+    t[0] = Td0[B0(s[0])] ^ Td1[B1(s[3])] ^ Td2[B2(s[2])] ^ Td3[B3(s[1])] ^ k[0]; \
+    t[1] = Td0[B0(s[1])] ^ Td1[B1(s[0])] ^ Td2[B2(s[3])] ^ Td3[B3(s[2])] ^ k[1]; \
+    t[2] = Td0[B0(s[2])] ^ Td1[B1(s[1])] ^ Td2[B2(s[0])] ^ Td3[B3(s[3])] ^ k[2]; \
+    t[3] = Td0[B0(s[3])] ^ Td1[B1(s[2])] ^ Td2[B2(s[1])] ^ Td3[B3(s[0])] ^ k[3]
+
+#define DEC_LAST(t, k, i0, i1, i2, i3)                                   \
+    (((uint32_t) sbox_inv[B0(t[i0])] << 24) ^                              \
+     ((uint32_t) sbox_inv[B1(t[i1])] << 16) ^                              \
+     ((uint32_t) sbox_inv[B2(t[i2])] << 8) ^ sbox_inv[B3(t[i3])] ^ k)
+
+static inline void load_block(uint32_t *s, const uint8_t *in,
+                              const uint32_t *k) {
+
+    s[0] = GETU32(in)      ^ k[0];
+    s[1] = GETU32(in + 4)  ^ k[1];
+    s[2] = GETU32(in + 8)  ^ k[2];
+    s[3] = GETU32(in + 12) ^ k[3];
+}
+
+static inline void enc_store(uint8_t *out, const uint32_t *t,
+                             const uint32_t *k) {
+
+    PUTU32(out,      ENC_LAST(t, k[0], 0, 1, 2, 3));
+    PUTU32(out + 4,  ENC_LAST(t, k[1], 1, 2, 3, 0));
+    PUTU32(out + 8,  ENC_LAST(t, k[2], 2, 3, 0, 1));
+    PUTU32(out + 12, ENC_LAST(t, k[3], 3, 0, 1, 2));
+}
+
+static inline void dec_store(uint8_t *out, const uint32_t *t,
+                             const uint32_t *k) {
+
+    PUTU32(out,      DEC_LAST(t, k[0], 0, 3, 2, 1));
+    PUTU32(out + 4,  DEC_LAST(t, k[1], 1, 0, 3, 2));
+    PUTU32(out + 8,  DEC_LAST(t, k[2], 2, 1, 0, 3));
+    PUTU32(out + 12, DEC_LAST(t, k[3], 3, 2, 1, 0));
+}
+
+/* Two rounds per iteration, so the state alternates between s and t
+ * without copying. rounds is even (10, 12, 14): one full round and the
+ * final round are left after the loop. */
+
+static void aes_encrypt(void *ctx_arg, char *out, const char *in) {
+
+    const struct aes_ttable_ctx *ctx = ctx_arg;
+    const uint32_t *k = ctx->ekey;
+    uint32_t s[4], t[4];
+    unsigned int r;
+
+    load_block(s, (const uint8_t *) in, k);
+    for (r = 1; r + 1 < ctx->rounds; r += 2) {
+        k += 4;
+        ENC_ROUND(t, s, k);
+        k += 4;
+        ENC_ROUND(s, t, k);
+    }
+    k += 4;
+    ENC_ROUND(t, s, k);
+    enc_store((uint8_t *) out, t, k + 4);
+}
+
+static void aes_decrypt(void *ctx_arg, char *out, const char *in) {
+
+    const struct aes_ttable_ctx *ctx = ctx_arg;
+    const uint32_t *k = ctx->dkey;
+    uint32_t s[4], t[4];
+    unsigned int r;
+
+    load_block(s, (const uint8_t *) in, k);
+    for (r = 1; r + 1 < ctx->rounds; r += 2) {
+        k += 4;
+        DEC_ROUND(t, s, k);
+        k += 4;
+        DEC_ROUND(s, t, k);
+    }
+    k += 4;
+    DEC_ROUND(t, s, k);
+    dec_store((uint8_t *) out, t, k + 4);
+}
+
+/*
+ * *****************************************************************
+ */
+
+/* Four blocks side by side, same round structure as above. */
+
+static void aes_encrypt4(const struct aes_ttable_ctx *ctx, uint8_t *out,
+                         const uint8_t *in) {
+
+    const uint32_t *k = ctx->ekey;
+    uint32_t a0[4], a1[4], a2[4], a3[4];
+    uint32_t b0[4], b1[4], b2[4], b3[4];
+    unsigned int r;
+
+    load_block(a0, in, k);
+    load_block(a1, in + 16, k);
+    load_block(a2, in + 32, k);
+    load_block(a3, in + 48, k);
+
+    for (r = 1; r + 1 < ctx->rounds; r += 2) {
+        k += 4;
+        ENC_ROUND(b0, a0, k);
+        ENC_ROUND(b1, a1, k);
+        ENC_ROUND(b2, a2, k);
+        ENC_ROUND(b3, a3, k);
+        k += 4;
+        ENC_ROUND(a0, b0, k);
+        ENC_ROUND(a1, b1, k);
+        ENC_ROUND(a2, b2, k);
+        ENC_ROUND(a3, b3, k);
+    }
+
+    k += 4;
+    ENC_ROUND(b0, a0, k);
+    ENC_ROUND(b1, a1, k);
+    ENC_ROUND(b2, a2, k);
+    ENC_ROUND(b3, a3, k);
+
+    k += 4;
+    enc_store(out,      b0, k);
+    enc_store(out + 16, b1, k);
+    enc_store(out + 32, b2, k);
+    enc_store(out + 48, b3, k);
+}
+
+static void aes_decrypt4(const struct aes_ttable_ctx *ctx, uint8_t *out,
+                         const uint8_t *in) {
+
+    const uint32_t *k = ctx->dkey;
+    uint32_t a0[4], a1[4], a2[4], a3[4];
+    uint32_t b0[4], b1[4], b2[4], b3[4];
+    unsigned int r;
+
+    load_block(a0, in, k);
+    load_block(a1, in + 16, k);
+    load_block(a2, in + 32, k);
+    load_block(a3, in + 48, k);
+
+    for (r = 1; r + 1 < ctx->rounds; r += 2) {
+        k += 4;
+        DEC_ROUND(b0, a0, k);
+        DEC_ROUND(b1, a1, k);
+        DEC_ROUND(b2, a2, k);
+        DEC_ROUND(b3, a3, k);
+        k += 4;
+        DEC_ROUND(a0, b0, k);
+        DEC_ROUND(a1, b1, k);
+        DEC_ROUND(a2, b2, k);
+        DEC_ROUND(a3, b3, k);
+    }
+
+    k += 4;
+    DEC_ROUND(b0, a0, k);
+    DEC_ROUND(b1, a1, k);
+    DEC_ROUND(b2, a2, k);
+    DEC_ROUND(b3, a3, k);
+
+    k += 4;
+    dec_store(out,      b0, k);
+    dec_store(out + 16, b1, k);
+    dec_store(out + 32, b2, k);
+    dec_store(out + 48, b3, k);
+}
+
+static void aes_encrypt_blocks(void *ctx_arg, char *out, const char *in,
+                               unsigned int blocks) {
+
+    for (; blocks >= 4; blocks -= 4, in += 64, out += 64)
+        aes_encrypt4(ctx_arg, (uint8_t *) out, (const uint8_t *) in);
+    for (; blocks; blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+        aes_encrypt(ctx_arg, out, in);
+}
+
+static void aes_decrypt_blocks(void *ctx_arg, char *out, const char *in,
+                               unsigned int blocks) {
+
+    for (; blocks >= 4; blocks -= 4, in += 64, out += 64)
+        aes_decrypt4(ctx_arg, (uint8_t *) out, (const uint8_t *) in);
+    for (; blocks; blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+        aes_decrypt(ctx_arg, out, in);
+}
+
+/*
+ * *****************************************************************
+ */
+
+crypto_cipher_set_key_fn_t aes_cipher_set_key = (crypto_cipher_set_key_fn_t) aes_set_key;
+crypto_cipher_encrypt_fn_t aes_cipher_encrypt = (crypto_cipher_encrypt_fn_t) aes_encrypt;
+crypto_cipher_decrypt_fn_t aes_cipher_decrypt = (crypto_cipher_decrypt_fn_t) aes_decrypt;
+crypto_cipher_encrypt_blocks_fn_t aes_cipher_encrypt_blocks = aes_encrypt_blocks;
+crypto_cipher_decrypt_blocks_fn_t aes_cipher_decrypt_blocks = aes_decrypt_blocks;
+
+static void init(void) __attribute__((constructor));
+static void init(void)
+{
+    gen_tables();
+}
@@ -19,6 +19,8 @@
 #include <stdint.h>
 #include <l4/crypto/cbc.h>
 
+#include "xor.h"
+
 /*
  * *****************************************************************
  */
@@ -81,5 +83,41 @@ void crypto_cbc_decrypt(crypto_cipher_decrypt_fn_t decrypt,
 }
 
 
+/*
+ * Unlike encryption, CBC decryption has no chaining between the block
+ * cipher calls, so up to CRYPTO_CIPHER_BATCH blocks are decrypted at once
+ * and the preceding ciphertext blocks are XORed in afterwards. Works
+ * in-place (in == out), the ciphertext is saved before it is overwritten.
+ */
+void crypto_cbc_decrypt_blocks(crypto_cipher_decrypt_blocks_fn_t decrypt,
+                               void *ctx, unsigned int block_len,
+                               const char *in, char *out,
+                               const char *iv, unsigned int len) {
+    unsigned int pos, chunk, i;
+    char prev[block_len];
+    char saved[CRYPTO_CIPHER_BATCH * block_len];
+    const char *c;
+
+    memcpy(prev, iv, block_len);
+
+    for (pos = 0; pos < len; pos += chunk) {
 
+        chunk = len - pos;
+        if (chunk > CRYPTO_CIPHER_BATCH * block_len)
+            chunk = CRYPTO_CIPHER_BATCH * block_len;
 
+        c = &in[pos];
+        if (in == out) {
+            memcpy(saved, c, chunk);
+            c = saved;
+        }
+
+        decrypt(ctx, &out[pos], c, chunk / block_len);
+
+        crypto_xor(&out[pos], prev, block_len);
+        for (i = block_len; i < chunk; i += block_len)
+            crypto_xor(&out[pos + i], &c[i - block_len], block_len);
+
+        memcpy(prev, &c[chunk - block_len], block_len);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * \brief   Counter mode for block cipher functions.
+ * \date    2026-10-19
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/* general includes */
+#include <string.h>
+
+/* L4-specific includes */
+#include <l4/crypto/ctr.h>
+
+#include "xor.h"
+
+/*
+ * *****************************************************************
+ */
+
+/* big-endian increment of the whole counter block */
+static inline void ctr_inc(unsigned char *ctr, unsigned int block_len) {
+
+    while (block_len-- > 0)
+        if (++ctr[block_len] != 0)
+            break;
+}
+
+/*
+ * *****************************************************************
+ */
+
+void crypto_ctr_crypt(crypto_cipher_encrypt_blocks_fn_t encrypt,
+                      void *ctx, unsigned int block_len,
+                      const char *in, char *out,
+                      char *ctr, unsigned int len) {
+    unsigned int pos, chunk, blocks, i;
+    char ctr_buf[CRYPTO_CIPHER_BATCH * block_len];
+    char key_buf[CRYPTO_CIPHER_BATCH * block_len];
+
+    for (pos = 0; pos < len; pos += chunk) {
+
+        chunk = len - pos;
+        if (chunk > CRYPTO_CIPHER_BATCH * block_len)
+            chunk = CRYPTO_CIPHER_BATCH * block_len;
+        blocks = (chunk + block_len - 1) / block_len;
+
+        /* the counter blocks are independent, encrypt them in one go */
+        for (i = 0; i < blocks; i++) {
+            memcpy(&ctr_buf[i * block_len], ctr, block_len);
+            ctr_inc((unsigned char *) ctr, block_len);
+        }
+        encrypt(ctx, key_buf, ctr_buf, blocks);
+
+        if (out != in)
+            memmove(&out[pos], &in[pos], chunk);
+        if (chunk % block_len == 0)
+            crypto_xor(&out[pos], key_buf, chunk);
+        else
+            for (i = 0; i < chunk; i++)
+                out[pos + i] ^= key_buf[i];
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * \brief   XOR helper for the modes of operation.
+ * \date    2026-10-19
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef __CRYPTO_MODES_XOR_H
+#define __CRYPTO_MODES_XOR_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * *****************************************************************
+ */
+
+/* dst ^= src, len is a multiple of sizeof(uint32_t) */
+static inline void crypto_xor(char *dst, const char *src, unsigned int len) {
+
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    for (; i + 16 <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_xor_si128(d, s));
+    }
+#endif
+    for (; i < len; i += sizeof(uint32_t)) {
+        uint32_t d, s;
+        memcpy(&d, &dst[i], sizeof(d));
+        memcpy(&s, &src[i], sizeof(s));
+        d ^= s;
+        memcpy(&dst[i], &d, sizeof(d));
+    }
+}
+
+#endif /* __CRYPTO_MODES_XOR_H */
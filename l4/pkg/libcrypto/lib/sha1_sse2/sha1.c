@@ -0,0 +1,439 @@
+/*
+ * \brief   SHA1 with SSE2 message schedule and multi-buffer hashing.
+ * \date    2026-10-19
+ *
+ * Single stream: the message schedule W[16..79] is computed four words at
+ * a time in SSE2 registers, together with the round constants. The rounds
+ * themselves stay scalar, they are one long dependency chain.
+ *
+ * Multi-buffer: four independent messages are hashed at once, one per
+ * 32-bit lane, so every SSE2 instruction does the work of one scalar
+ * round step for all four. A lane that finishes its message picks up the
+ * next one.
+ *
+ * Without __SSE2__ everything falls back to plain C.
+ */
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the libcrypto package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/* general includes */
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+/* L4-specific includes */
+#define __LIBCRYPTO_INTERNAL__
+#include <l4/crypto/sha1.h>
+
+/*
+ * *****************************************************************
+ */
+
+#define SHA1_BLOCK_SIZE 64
+#define MB_LANES        4
+
+#define K0 0x5A827999
+#define K1 0x6ED9EBA1
+#define K2 0x8F1BBCDC
+#define K3 0xCA62C1D6
+
+static const u32 sha1_iv[5] =
+    { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+static inline u32 rol(u32 x, int n) {
+
+    return (x << n) | (x >> (32 - n));
+}
+
+static inline u32 get_be32(const u8 *p) {
+
+    return ((u32) p[0] << 24) | ((u32) p[1] << 16) | ((u32) p[2] << 8) | p[3];
+}
+
+static inline void put_be32(u8 *p, u32 v) {
+
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/*
+ * *****************************************************************
+ */
+
+/* wk[i] = W[i] + K for round i */
+#ifdef __SSE2__
+
+static inline __m128i load_be(const u8 *in) {
+
+    __m128i x = _mm_loadu_si128((const __m128i *) in);
+
+#ifdef __SSSE3__
+    return _mm_shuffle_epi8(x, _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+                                            4, 5, 6, 7, 0, 1, 2, 3));
+#else
+    /* swap the 16-bit halves, then the bytes within them */
+    x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1);
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+#endif
+}
+
+static inline __m128i rol_epi32(__m128i x, int n) {
+
+    return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+}
+
+static void sha1_schedule(u32 *wk, const u8 *in) {
+
+    __m128i w[20], k;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        w[i] = load_be(in + 16 * i);
+        _mm_storeu_si128((__m128i *) &wk[4 * i],
+                         _mm_add_epi32(w[i], _mm_set1_epi32(K0)));
+    }
+
+    for (i = 4; i < 20; i++) {
+        /* W[t..t+3] for t = 4 * i; W[t+3] needs W[t] which is computed
+         * here, so its lane gets a zero first and is fixed up below */
+        __m128i w3  = _mm_srli_si128(w[i - 1], 4);
+        __m128i w14 = _mm_or_si128(_mm_srli_si128(w[i - 4], 8),
+                                   _mm_slli_si128(w[i - 3], 8));
+        __m128i t   = _mm_xor_si128(_mm_xor_si128(w3, w[i - 2]),
+                                    _mm_xor_si128(w14, w[i - 4]));
+
+        t = rol_epi32(t, 1);
+        w[i] = _mm_xor_si128(t, rol_epi32(_mm_slli_si128(t, 12), 1));
+
+        k = _mm_set1_epi32(i < 5 ? K0 : i < 10 ? K1 : i < 15 ? K2 : K3);
+        _mm_storeu_si128((__m128i *) &wk[4 * i], _mm_add_epi32(w[i], k));
+    }
+}
+
+#else /* !__SSE2__ */
+
+static void sha1_schedule(u32 *wk, const u8 *in) {
+
+    static const u32 k[4] = { K0, K1, K2, K3 };
+    u32 w[80];
+    int i;
+
+    for (i = 0; i < 16; i++)
+        w[i] = get_be32(in + 4 * i);
+    for (; i < 80; i++)
+        w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    for (i = 0; i < 80; i++)
+        wk[i] = w[i] + k[i / 20];
+}
+
+#endif /* __SSE2__ */
+
+#define F0(b, c, d) (((c ^ d) & b) ^ d)
+#define F1(b, c, d) (b ^ c ^ d)
+#define F2(b, c, d) (((b | c) & d) | (b & c))
+
+#define R(f, a, b, c, d, e, i)                         \
+    e += f(b, c, d) + wk[i] + rol(a, 5); b = rol(b, 30)
+
+#define R5(f, i)                                        \
+    R(f, a, b, c, d, e, i);     R(f, e, a, b, c, d, i + 1); \
+    R(f, d, e, a, b, c, i + 2); R(f, c, d, e, a, b, i + 3); \
+    R(f, b, c, d, e, a, i + 4)
+
+static void sha1_transform(u32 *state, const u8 *in) {
+
+    u32 wk[80];
+    u32 a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    sha1_schedule(wk, in);
+
+    R5(F0,  0); R5(F0,  5); R5(F0, 10); R5(F0, 15);
+    R5(F1, 20); R5(F1, 25); R5(F1, 30); R5(F1, 35);
+    R5(F2, 40); R5(F2, 45); R5(F2, 50); R5(F2, 55);
+    R5(F1, 60); R5(F1, 65); R5(F1, 70); R5(F1, 75);
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+/*
+ * *****************************************************************
+ */
+
+static void sha1_init(void *ctx) {
+
+    struct sha1_ctx *sctx = ctx;
+
+    sctx->count = 0;
+    memcpy(sctx->state, sha1_iv, sizeof(sha1_iv));
+}
+
+static void sha1_update(void *ctx, const char *data, unsigned int len) {
+
+    struct sha1_ctx *sctx = ctx;
+    const u8 *in = (const u8 *) data;
+    unsigned int fill = (sctx->count >> 3) & 0x3f;
+
+    sctx->count += (u64) len << 3;
+
+    if (fill) {
+        unsigned int n = SHA1_BLOCK_SIZE - fill;
+
+        if (len < n) {
+            memcpy(&sctx->buffer[fill], in, len);
+            return;
+        }
+        memcpy(&sctx->buffer[fill], in, n);
+        sha1_transform(sctx->state, sctx->buffer);
+        in  += n;
+        len -= n;
+    }
+
+    for (; len >= SHA1_BLOCK_SIZE; len -= SHA1_BLOCK_SIZE, in += SHA1_BLOCK_SIZE)
+        sha1_transform(sctx->state, in);
+
+    memcpy(sctx->buffer, in, len);
+}
+
+/* Padding and length for a message of count bits whose last, incomplete
+ * block (count / 8 % 64 bytes) is already in tail. Returns the number of
+ * blocks (1 or 2) in tail. */
+static unsigned int sha1_pad(u8 *tail, u64 count) {
+
+    unsigned int used = (count >> 3) & 0x3f;
+    unsigned int blocks = used < 56 ? 1 : 2;
+    u8 *len = tail + blocks * SHA1_BLOCK_SIZE - 8;
+
+    tail[used] = 0x80;
+    memset(&tail[used + 1], 0, len - &tail[used + 1]);
+    put_be32(len,     count >> 32);
+    put_be32(len + 4, count);
+
+    return blocks;
+}
+
+static void sha1_final(void *ctx, char *out) {
+
+    struct sha1_ctx *sctx = ctx;
+    u8 tail[2 * SHA1_BLOCK_SIZE];
+    unsigned int blocks, i;
+
+    memcpy(tail, sctx->buffer, (sctx->count >> 3) & 0x3f);
+    blocks = sha1_pad(tail, sctx->count);
+    for (i = 0; i < blocks; i++)
+        sha1_transform(sctx->state, &tail[i * SHA1_BLOCK_SIZE]);
+
+    for (i = 0; i < 5; i++)
+        put_be32((u8 *) out + 4 * i, sctx->state[i]);
+
+    /* Wipe context */
+    memset(sctx, 0, sizeof *sctx);
+}
+
+/*
+ * *****************************************************************
+ */
+
+#ifdef __SSE2__
+
+/* One lane of the multi-buffer engine: the message it works on. The full
+ * blocks are read from the message itself, the padded tail from pad. */
+struct mb_lane {
+    int          job;       /* -1: idle */
+    const u8    *data;      /* next block */
+    unsigned int blocks;    /* blocks left at data */
+    unsigned int tail;      /* blocks in pad, still to do after that */
+    u8           pad[2 * SHA1_BLOCK_SIZE];
+};
+
+static void mb_start(struct mb_lane *l, u32 st[5][MB_LANES], int lane,
+                     int job, const char *data, unsigned int len) {
+
+    unsigned int i, rest = len % SHA1_BLOCK_SIZE;
+
+    l->job    = job;
+    l->data   = (const u8 *) data;
+    l->blocks = len / SHA1_BLOCK_SIZE;
+
+    memcpy(l->pad, data + len - rest, rest);
+    l->tail = sha1_pad(l->pad, (u64) len << 3);
+
+    if (!l->blocks) {
+        l->data   = l->pad;
+        l->blocks = l->tail;
+        l->tail   = 0;
+    }
+
+    for (i = 0; i < 5; i++)
+        st[i][lane] = sha1_iv[i];
+}
+
+/* Advance to the next block, returns 0 when the message is done. */
+static inline int mb_next(struct mb_lane *l) {
+
+    l->data += SHA1_BLOCK_SIZE;
+    if (--l->blocks)
+        return 1;
+
+    if (!l->tail)
+        return 0;
+
+    l->data   = l->pad;
+    l->blocks = l->tail;
+    l->tail   = 0;
+    return 1;
+}
+
+#define MB_F0(b, c, d) _mm_xor_si128(_mm_and_si128(_mm_xor_si128(c, d), b), d)
+#define MB_F1(b, c, d) _mm_xor_si128(_mm_xor_si128(b, c), d)
+#define MB_F2(b, c, d) _mm_or_si128(_mm_and_si128(_mm_or_si128(b, c), d), \
+                                    _mm_and_si128(b, c))
+
+#define MB_R(f, k, a, b, c, d, e, wt)                                     \
+    e = _mm_add_epi32(_mm_add_epi32(e, f(b, c, d)),                        \
+                      _mm_add_epi32(_mm_add_epi32(wt, k), rol_epi32(a, 5))); \
+    b = rol_epi32(b, 30)
+
+/* One block of each lane. in[j] is the block for lane j. */
+static void mb_transform(u32 st[5][MB_LANES], const u8 *in[MB_LANES]) {
+
+    __m128i a, b, c, d, e, w[16], k, t;
+    u32 x[MB_LANES] __attribute__((aligned(16)));
+    int i, j;
+
+    /* transpose: w[i] holds word i of all lanes */
+    for (i = 0; i < 16; i++) {
+        for (j = 0; j < MB_LANES; j++)
+            x[j] = get_be32(in[j] + 4 * i);
+        w[i] = _mm_load_si128((const __m128i *) x);
+    }
+
+    a = _mm_load_si128((const __m128i *) st[0]);
+    b = _mm_load_si128((const __m128i *) st[1]);
+    c = _mm_load_si128((const __m128i *) st[2]);
+    d = _mm_load_si128((const __m128i *) st[3]);
+    e = _mm_load_si128((const __m128i *) st[4]);
+
+    for (i = 0; i < 80; i++) {
+        if (i >= 16)
+            w[i & 15] = rol_epi32(_mm_xor_si128(
+                _mm_xor_si128(w[(i - 3) & 15], w[(i - 8) & 15]),
+                _mm_xor_si128(w[(i - 14) & 15], w[i & 15])), 1);
+
+        if (i < 20) {
+            k = _mm_set1_epi32(K0);
+            MB_R(MB_F0, k, a, b, c, d, e, w[i & 15]);
+        } else if (i < 40) {
+            k = _mm_set1_epi32(K1);
+            MB_R(MB_F1, k, a, b, c, d, e, w[i & 15]);
+        } else if (i < 60) {
+            k = _mm_set1_epi32(K2);
+            MB_R(MB_F2, k, a, b, c, d, e, w[i & 15]);
+        } else {
+            k = _mm_set1_epi32(K3);
+            MB_R(MB_F1, k, a, b, c, d, e, w[i & 15]);
+        }
+
+        /* rename instead of moving: (a, b, c, d, e) <- (e, a, b, c, d) */
+        t = e; e = d; d = c; c = b; b = a; a = t;
+    }
+
+    _mm_store_si128((__m128i *) st[0],
+                    _mm_add_epi32(a, _mm_load_si128((const __m128i *) st[0])));
+    _mm_store_si128((__m128i *) st[1],
+                    _mm_add_epi32(b, _mm_load_si128((const __m128i *) st[1])));
+    _mm_store_si128((__m128i *) st[2],
+                    _mm_add_epi32(c, _mm_load_si128((const __m128i *) st[2])));
+    _mm_store_si128((__m128i *) st[3],
+                    _mm_add_epi32(d, _mm_load_si128((const __m128i *) st[3])));
+    _mm_store_si128((__m128i *) st[4],
+                    _mm_add_epi32(e, _mm_load_si128((const __m128i *) st[4])));
+}
+
+static void sha1_multi(unsigned int n, const char * const data[],
+                       const unsigned int len[], char * const out[]) {
+
+    static const u8 idle_block[SHA1_BLOCK_SIZE];
+    u32 st[5][MB_LANES] __attribute__((aligned(16)));
+    struct mb_lane lane[MB_LANES];
+    const u8 *in[MB_LANES];
+    unsigned int next = 0, busy = 0, i;
+    int j;
+
+    for (j = 0; j < MB_LANES; j++) {
+        lane[j].job = -1;
+        if (next < n) {
+            mb_start(&lane[j], st, j, next, data[next], len[next]);
+            next++;
+            busy++;
+        }
+    }
+
+    while (busy) {
+        for (j = 0; j < MB_LANES; j++)
+            in[j] = lane[j].job < 0 ? idle_block : lane[j].data;
+
+        mb_transform(st, in);
+
+        for (j = 0; j < MB_LANES; j++) {
+            struct mb_lane *l = &lane[j];
+
+            if (l->job < 0 || mb_next(l))
+                continue;
+
+            /* message done: store digest, refill the lane */
+            for (i = 0; i < 5; i++)
+                put_be32((u8 *) out[l->job] + 4 * i, st[i][j]);
+
+            l->job = -1;
+            busy--;
+            if (next < n) {
+                mb_start(l, st, j, next, data[next], len[next]);
+                next++;
+                busy++;
+            }
+        }
+    }
+}
+
+#else /* !__SSE2__ */
+
+static void sha1_multi(unsigned int n, const char * const data[],
+                       const unsigned int len[], char * const out[]) {
+
+    struct sha1_ctx ctx;
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        sha1_init(&ctx);
+        sha1_update(&ctx, data[i], len[i]);
+        sha1_final(&ctx, out[i]);
+    }
+}
+
+#endif /* __SSE2__ */
+
+/*
+ * *****************************************************************
+ */
+
+crypto_digest_setup_fn_t  sha1_digest_setup  = sha1_init;
+crypto_digest_update_fn_t sha1_digest_update = sha1_update;
+crypto_digest_final_fn_t  sha1_digest_final  = sha1_final;
+crypto_digest_multi_fn_t  sha1_digest_multi  = sha1_multi;
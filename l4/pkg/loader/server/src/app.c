@@ -240,29 +240,45 @@ list_app_areas(app_t *app)
     }
 }
 
-/** Check if new app_area overlaps with exisiting areas. */
+/** Check if new app_area overlaps with exisiting areas. If not, mark the
+ * area valid and insert it into the sorted area index used by the pager. */
 static int
 sanity_check_app_area(app_t *app, app_area_t **check_aa)
 {
-  int i;
-  app_area_t *aa;
+  int lo, hi, mid;
+  app_area_t *aa, *new_aa = *check_aa;
 
-  /* check for overlap */
-  for (i=0; i<app->app_area_next_free; i++)
+  /* find insert position: first valid area beginning behind new area */
+  for (lo=0, hi=app->app_area_num_sorted; lo<hi; )
     {
-      aa = app->app_area + i;
-      if (   (aa->flags & APP_AREA_VALID)
-	  && (*check_aa)->beg.app                     <  aa->beg.app+aa->size
-	  && (*check_aa)->beg.app+(*check_aa)->size-1 >= aa->beg.app)
-	{
-	  app_msg(app, "app_area (%08lx-%08lx) overlaps:",
-	         (*check_aa)->beg.app, (*check_aa)->beg.app+(*check_aa)->size);
-	  list_app_areas(app);
-	  return -L4_EINVAL;
-	}
+      mid = (lo + hi) / 2;
+      if (app->app_area[app->app_area_sorted[mid]].beg.app <= new_aa->beg.app)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* valid areas don't overlap, so only the neighbours can clash */
+  aa = (lo > 0) ? app->app_area + app->app_area_sorted[lo-1] : 0;
+  if (!aa || new_aa->beg.app >= aa->beg.app+aa->size)
+    aa = (lo < app->app_area_num_sorted)
+       ? app->app_area + app->app_area_sorted[lo] : 0;
+  if (aa &&
+      new_aa->beg.app                 <  aa->beg.app+aa->size &&
+      new_aa->beg.app+new_aa->size-1 >= aa->beg.app)
+    {
+      app_msg(app, "app_area (%08lx-%08lx) overlaps:",
+	     new_aa->beg.app, new_aa->beg.app+new_aa->size);
+      list_app_areas(app);
+      return -L4_EINVAL;
     }
 
-  (*check_aa)->flags |= APP_AREA_VALID;
+  memmove(app->app_area_sorted+lo+1, app->app_area_sorted+lo,
+	  app->app_area_num_sorted-lo);
+  app->app_area_sorted[lo] = new_aa - app->app_area;
+  app->app_area_num_sorted++;
+
+  new_aa->flags |= APP_AREA_VALID;
   return 0;
 }
 
@@ -281,19 +297,13 @@ app_find_free_virtual_area(app_t *app, l4_size_t size,
   if (low > addr)
     addr = low;
 
-  /* check for free area */
-  for (i=0; i<app->app_area_next_free; i++)
+  /* check for free area, valid areas are sorted by address */
+  for (i=0; i<app->app_area_num_sorted; i++)
     {
-      aa = app->app_area + i;
-      if ((aa->flags & APP_AREA_VALID) &&
-	   addr < aa->beg.app+aa->size && addr+size >= aa->beg.app)
-	{
-	  /* we have a clash. Set addr to the end of this area. */
-	  addr = aa->beg.app + aa->size;
-
-	  /* restart because list of addresses is not sorted */
-	  i=0;
-	}
+      aa = app->app_area + app->app_area_sorted[i];
+      if (addr < aa->beg.app+aa->size && addr+size >= aa->beg.app)
+	/* we have a clash. Set addr to the end of this area. */
+	addr = aa->beg.app + aa->size;
     }
 
   /* we went through. Our address may be after the last area. */
@@ -322,6 +332,29 @@ app_list_addr (app_t *app)
     }
 }
 
+/** Print startup timing report of an application. */
+void
+app_timing_report(app_t *app)
+{
+  app_timing_t *t = &app->timing;
+
+  app->timing.reported = 1;
+
+  if (!t->started)
+    {
+      app_msg(app, "Startup: load %lu us, not started",
+	      (unsigned long)(t->loaded - t->init));
+      return;
+    }
+
+  app_msg(app, "Startup: load %lu us, create %lu us, "
+	       "%u faults/%u pages in first %u ms, %u faults/%u pages total",
+	  (unsigned long)(t->loaded - t->init),
+	  (unsigned long)(t->started - t->loaded),
+	  t->pf_startup, t->pages_startup, APP_STARTUP_WINDOW / 1000,
+	  t->pf, t->pages);
+}
+
 /** Attach dataspace to pager. Therefore it is accessible by the application.
  *
  * \param app		application
@@ -675,7 +708,25 @@ alloc_from_tramp_page(l4_size_t size,
 
 /** @name Create application resources */
 /*@{*/
-/** Load boot modules.
+#ifdef USE_INTEGRITY
+/** Hash and detach the modules mapped for integrity measurement. */
+static void
+hash_modules(app_t *app, integrity_batch_t *hash, int measure)
+{
+  int i;
+
+  if (measure && hash->count)
+    integrity_hash_modules(app, hash);
+
+  for (i = 0; i < hash->count; i++)
+    l4rm_detach((void *)hash->data[i]);
+
+  hash->count = 0;
+}
+#endif
+
+/** Load boot modules. With USE_INTEGRITY, modules to hash are collected
+ * in hash.
  *
  * \param ct		config task descriptor
  * \param app		application descriptor
@@ -684,12 +735,19 @@ alloc_from_tramp_page(l4_size_t size,
  *			address space
  * \param tramp_page_addr address in our address space
  * \param mbi		pointer to mbi
+ * \param hash		modules mapped for hashing (USE_INTEGRITY only)
  * \return		0 on success
  *			-L4_ENOMEM if not enough space in page */
 static int
+#ifdef USE_INTEGRITY
+load_modules_batched(cfg_task_t *ct, app_t *app, l4_threadid_t fprov_id,
+		     app_addr_t *tramp_page, l4_addr_t *tramp_page_addr,
+		     l4util_mb_info_t *mbi, integrity_batch_t *hash)
+#else
 load_modules(cfg_task_t *ct, app_t *app, l4_threadid_t fprov_id,
 	     app_addr_t *tramp_page, l4_addr_t *tramp_page_addr,
 	     l4util_mb_info_t *mbi)
+#endif
 {
   if (ct->next_module > ct->module)
     {
@@ -744,9 +802,15 @@ load_modules(cfg_task_t *ct, app_t *app, l4_threadid_t fprov_id,
           if (ct->flags & CFG_F_HASH_MODULES)
             {
 #ifdef USE_INTEGRITY
-              integrity_hash_data(app, ct_mod->fname, (void *)map_addr, file_size);
-#endif
+              /* hash up to INTEGRITY_BATCH modules at once */
+              hash->name[hash->count] = ct_mod->fname;
+              hash->data[hash->count] = (const char *)map_addr;
+              hash->size[hash->count] = file_size;
+              if (++hash->count == INTEGRITY_BATCH)
+                hash_modules(app, hash, 1);
+#else
               l4rm_detach((void *)map_addr);
+#endif
             }
 
 	  /* XXX too restrictive? */
@@ -908,6 +972,37 @@ load_modules(cfg_task_t *ct, app_t *app, l4_threadid_t fprov_id,
   return 0;
 }
 
+#ifdef USE_INTEGRITY
+/** Load boot modules.
+ *
+ * \param ct		config task descriptor
+ * \param app		application descriptor
+ * \param fprov_id	file provider
+ * \param tramp_page	address of trampoline page in our / application's
+ *			address space
+ * \param tramp_page_addr address in our address space
+ * \param mbi		pointer to mbi
+ * \return		0 on success
+ *			-L4_ENOMEM if not enough space in page */
+static int
+load_modules(cfg_task_t *ct, app_t *app, l4_threadid_t fprov_id,
+	     app_addr_t *tramp_page, l4_addr_t *tramp_page_addr,
+	     l4util_mb_info_t *mbi)
+{
+  integrity_batch_t hash;
+  int error;
+
+  hash.count = 0;
+  error = load_modules_batched(ct, app, fprov_id, tramp_page,
+			       tramp_page_addr, mbi, &hash);
+
+  /* the modules left over are measured only if all could be loaded */
+  hash_modules(app, &hash, error == 0);
+
+  return error;
+}
+#endif
+
 static void
 load_vbe_info(app_t *app,
 	      app_addr_t *tramp_page, l4_addr_t *tramp_page_addr,
@@ -1344,6 +1439,7 @@ app_cont_static(app_t *app)
       list_app_areas(app);
     }
 
+  app->timing.started = app_clock();
   app_msg(app, "Started");
   return 0;
 }
@@ -1469,6 +1565,7 @@ app_cont_interp(app_t *app)
       return error;
     }
 
+  app->timing.started = app_clock();
   return 0;
 }
 
@@ -1535,6 +1632,9 @@ app_cleanup_intern(app_t *app)
 	}
     }
 
+  if (use_timing && !app->timing.reported)
+    app_timing_report(app);
+
   /* free all (pager) app_areas */
   for (aa=app->app_area; aa<app->app_area+app->app_area_next_free; aa++)
     {
@@ -1592,6 +1692,8 @@ app_init(cfg_task_t *ct, l4_taskid_t owner, app_t **ret_val)
       return error;
     }
 
+  app->timing.init = app_clock();
+
   env             = app->env;
   env->magic      = L4ENV_INFOPAGE_MAGIC;
   env->fprov_id   = ct->fprov_id;
@@ -1653,6 +1755,7 @@ app_init(cfg_task_t *ct, l4_taskid_t owner, app_t **ret_val)
       if (   (error = app_create_tid(app))
 	  || (error = app_start_interp(ct, app)))
 	;
+      app->timing.loaded = app_clock();
 
 #ifdef USE_INTEGRITY
       if (!error && ct->flags & CFG_F_HASH_BINARY)
@@ -1681,6 +1784,7 @@ app_init(cfg_task_t *ct, l4_taskid_t owner, app_t **ret_val)
   if (   (error = app_create_tid(app))
       || (error = app_start_static(ct, app)))
     ;
+  app->timing.loaded = app_clock();
 
 #ifdef USE_INTEGRITY
   if (!error && ct->flags & CFG_F_HASH_BINARY)
@@ -1800,6 +1904,7 @@ app_dump(unsigned long task_id)
           ((task_id == 0) || (task_id == app_array[i].tid.id.task)))
 	{
 	  dump_l4env_infopage(app_array + i);
+	  app_timing_report(app_array + i);
 	  if (task_id)
 	    return 0;
 	}
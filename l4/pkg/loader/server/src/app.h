@@ -14,6 +14,7 @@
 
 #include <l4/sys/types.h>
 #include <l4/l4rm/l4rm.h>
+#include <l4/sigma0/kip.h>
 
 #include "cfg.h"
 #include "debug.h"
@@ -25,6 +26,9 @@
 					  regions of an application */
 #define DEFAULT_PRIO	0x10		/**< default priority for new tasks */
 #define DEFAULT_MCP	0xff		/**< default mcp for new tasks */
+#define APP_STARTUP_WINDOW 1000000	/**< page faults within this time (us)
+					  after task creation are counted
+					  as startup faults */
 
 /** Pair of addresses. */
 typedef struct
@@ -50,6 +54,19 @@ typedef struct
   const char		*dbg_name;
 } app_area_t;
 
+/** Startup timing of an application. Times are kernel clock values (us). */
+typedef struct
+{
+  l4_cpu_time_t		init;		/**< loading started. */
+  l4_cpu_time_t		loaded;		/**< image loaded, sections attached. */
+  l4_cpu_time_t		started;	/**< task created. */
+  l4_uint32_t		pf;		/**< page faults handled by pager. */
+  l4_uint32_t		pages;		/**< pages mapped by pager. */
+  l4_uint32_t		pf_startup;	/**< page faults in startup window. */
+  l4_uint32_t		pages_startup;	/**< pages mapped in startup window. */
+  int			reported;	/**< startup report printed. */
+} app_timing_t;
+
 /** Application descriptor. */
 typedef struct
 {
@@ -59,6 +76,11 @@ typedef struct
   l4env_infopage_t	*env;		/**< ptr to environment infopage. */
   app_area_t		app_area[MAX_APP_AREA]; /**< pager regions. */
   int			app_area_next_free;	/**< number of pager regions. */
+  l4_uint8_t		app_area_sorted[MAX_APP_AREA]; /**< indices of valid
+						  pager regions, sorted by
+						  address in app. */
+  int			app_area_num_sorted;	/**< number of valid regions. */
+  app_area_t		*app_area_last;	/**< region of last page fault. */
   char			*iobitmap;	/**< I/O permission bitmap. */
   const char		*fname;		/**< app name including path. */
   const char            *name;		/**< app name excluding path. */
@@ -101,11 +123,21 @@ typedef struct
   integrity_hash_t      integrity_hash;
 #endif
   cfg_kquota_t          *kquota;        /**< kernel quota of this app */
+  app_timing_t		timing;		/**< startup timing. */
 } app_t;
 
 #define HERE_TO_APP(addr, base) \
   (base).app + (((l4_addr_t)(addr) - (base).here))
 
+extern int use_timing;
+
+/** Kernel clock (us) for timing reports. */
+static inline l4_cpu_time_t
+app_clock(void)
+{
+  return l4sigma0_kip()->clock;
+}
+
 app_t* task_to_app(l4_threadid_t tid);
 int  create_app_desc(app_t **new_app);
 
@@ -113,6 +145,7 @@ void __attribute__ ((format (printf, 2, 3)))
      app_msg(app_t *app, const char *format, ...);
 
 void app_list_addr(app_t *app);
+void app_timing_report(app_t *app);
 int  app_boot(cfg_task_t *ct, l4_taskid_t owner);
 int  app_cont(app_t *app);
 int  app_kill(l4_taskid_t task_id, l4_taskid_t caller);
@@ -13,10 +13,23 @@
 #ifndef __INGERITY_TYPES_H
 #define __INGERITY_TYPES_H
 
+#include <l4/sys/l4int.h>
 #include <l4/crypto/sha1.h>
 
 typedef char          integrity_hash_t[SHA1_DIGEST_SIZE];
 
+/** Number of modules hashed at once, see integrity_hash_modules(). */
+#define INTEGRITY_BATCH 8
+
+/** Modules which are mapped and wait to be hashed. */
+typedef struct
+{
+  int         count;
+  const char *name[INTEGRITY_BATCH];
+  const char *data[INTEGRITY_BATCH];
+  l4_size_t   size[INTEGRITY_BATCH];
+} integrity_batch_t;
+
 #ifdef USE_INTEGRITY_LYON
 #include <l4/lyon/lyon.h>
 
@@ -59,6 +59,34 @@ integrity_hash_data(app_t *app, const char *name, const char *data, size_t size)
   app_msg(app, "Hashed %s", name);
 }
 
+/** Hash the modules of a batch and empty it.
+ *
+ * The modules are hashed in parallel, then their digests are chained into
+ * the application's hash in batch order. So a module contributes
+ * SHA1(hash || name || SHA1(module)) instead of SHA1(hash || name ||
+ * module) like integrity_hash_data() does for the binary. */
+void
+integrity_hash_modules(app_t *app, integrity_batch_t *batch)
+{
+  integrity_hash_t digest[INTEGRITY_BATCH];
+  unsigned int len[INTEGRITY_BATCH];
+  char *out[INTEGRITY_BATCH];
+  int i;
+
+  for (i = 0; i < batch->count; i++)
+    {
+      len[i] = batch->size[i];
+      out[i] = digest[i];
+    }
+
+  sha1_digest_multi(batch->count, batch->data, len, out);
+
+  for (i = 0; i < batch->count; i++)
+    integrity_hash_data(app, batch->name[i], digest[i], sizeof(digest[i]));
+
+  batch->count = 0;
+}
+
 int
 integrity_report_hash(const cfg_task_t *cfg, app_t *app)
 {
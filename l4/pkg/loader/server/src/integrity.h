@@ -22,6 +22,9 @@ void
 integrity_hash_data(app_t *app, const char *name,
                     const char *data, size_t size);
 
+void
+integrity_hash_modules(app_t *app, integrity_batch_t *batch);
+
 int
 integrity_report_hash(const cfg_task_t *cfg, app_t *app);
 
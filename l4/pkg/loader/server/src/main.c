@@ -38,6 +38,7 @@ const l4_size_t l4thread_stack_size = 16384; /**< limit stack size */
 
 int use_events;
 int use_l4io;
+int use_timing;
 
 /** Main function. */
 int
@@ -53,6 +54,8 @@ main(int argc, const char **argv)
 		PARSE_CMD_SWITCH, 1, &use_events,
 		'i', "l4io", "use L4 I/O server for PCI management",
 		PARSE_CMD_SWITCH, 1, &use_l4io,
+		't', "timing", "report startup timing of applications",
+		PARSE_CMD_SWITCH, 1, &use_timing,
 		0)))
     {
       switch (error)
@@ -28,6 +28,7 @@
 #include <l4/rmgr/librmgr.h>
 #include <l4/l4rm/l4rm.h>
 #include <l4/util/l4_macros.h>
+#include <l4/util/bitops.h>
 #include <l4/loader/loader-client.h>
 #include <l4/generic_ts/generic_ts.h>
 #include <l4/dm_phys/dm_phys.h>
@@ -38,10 +39,14 @@
 #define dbg_adap_pf(x...)	//app_msg(app, x)
 #define dbg_incoming(x...)	//printf(x)
 
+#define PAGER_LOG2_CHUNK	16	/**< map up to 64KB of a dataspace
+					  area with one page fault reply */
+
 l4_threadid_t app_pager_id = L4_INVALID_ID;	/**< pager thread. */
 
 static l4_addr_t pager_map_addr_4K = 0;		/**< map addr for 4K pages. */
 static l4_addr_t pager_map_addr_4M = 0;		/**< map addr for 4M pages. */
+static l4_addr_t pager_map_addr_chunk = 0;	/**< map addr for chunks. */
 static l4_kernel_info_t *kip;			/**< address of KI page. */
 static l4_threadid_t _rmgr_pager_id;		/**< thread id of roottask pager */
 #ifdef ARCH_x86
@@ -57,16 +62,29 @@ static l4_addr_t tb_stat_map_addr  = 0;		/**< address of Tbuf status. */
 static int inline
 pf_in_app(l4_addr_t addr, app_t *app, app_area_t **app_area)
 {
-  int i;
+  int lo, hi, mid;
   app_area_t *aa;
 
-  /* Go through all app_areas we page for the application */
-  for (i=0; i<app->app_area_next_free; i++)
+  /* consecutive page faults mostly hit the same area */
+  aa = app->app_area_last;
+  if (aa && addr>=aa->beg.app && addr<aa->beg.app+aa->size)
+    {
+      *app_area = aa;
+      return 1;
+    }
+
+  /* binary search the valid app_areas, sorted by address */
+  for (lo=0, hi=app->app_area_num_sorted; lo<hi; )
     {
-      aa = app->app_area + i;
-      if ((aa->flags & APP_AREA_VALID) &&
-	  addr>=aa->beg.app && addr<aa->beg.app+aa->size)
+      mid = (lo + hi) / 2;
+      aa  = app->app_area + app->app_area_sorted[mid];
+      if (addr < aa->beg.app)
+	hi = mid;
+      else if (addr >= aa->beg.app+aa->size)
+	lo = mid + 1;
+      else
 	{
+	  app->app_area_last = aa;
 	  *app_area = aa;
 	  return 1;
 	}
@@ -75,6 +93,24 @@ pf_in_app(l4_addr_t addr, app_t *app, app_area_t **app_area)
   return 0;
 }
 
+/** Account a page fault reply for the startup timing report. */
+static void
+pf_account(app_t *app, l4_size_t size)
+{
+  app_timing_t *t = &app->timing;
+  l4_uint32_t pages = size >> L4_LOG2_PAGESIZE;
+
+  t->pf++;
+  t->pages += pages;
+  if (kip->clock - t->started < APP_STARTUP_WINDOW)
+    {
+      t->pf_startup++;
+      t->pages_startup += pages;
+    }
+  else if (use_timing && !t->reported)
+    app_timing_report(app);
+}
+
 /** Translate app address into here address. */
 l4_addr_t fastcall
 addr_app_to_here(app_t *app, l4_addr_t addr)
@@ -377,6 +413,7 @@ forward_pf_ds(app_t *app, app_area_t *aa,
   l4_uint32_t flags;
   l4_addr_t fpage_addr;
   l4_size_t fpage_size;
+  l4_offs_t rcv_offs = 0;
 
   do
     {
@@ -407,7 +444,31 @@ forward_pf_ds(app_t *app, app_area_t *aa,
 	    break;
 	}
 
-      /* 4MB test failed, send as 4K page */
+      /* 4MB test failed, try the largest aligned chunk around the page
+       * fault which lies inside the area. Such chunks are either equal or
+       * disjoint, so we never map over pages sent before. */
+      for (log2_size = PAGER_LOG2_CHUNK; log2_size > L4_LOG2_PAGESIZE;
+	   log2_size--)
+	{
+	  pfa = *dw1 & ~((1UL << log2_size) - 1);
+	  if (pfa >= aa->beg.app &&
+	      pfa + (1UL << log2_size) <= aa->beg.app+aa->size)
+	    break;
+	}
+
+      if (log2_size > L4_LOG2_PAGESIZE)
+	{
+	  /* Request the page fault page with a receive window of the chunk
+	   * size. The dataspace manager sends the largest fpage containing
+	   * this page which fits into the window. */
+	  rcv_offs  = (*dw1 & L4_PAGEMASK) - pfa;
+	  offset    = (*dw1 & L4_PAGEMASK) - aa->beg.app;
+	  size      = 1UL << log2_size;
+	  map_addr  = pager_map_addr_chunk;
+	  break;
+	}
+
+      /* send as 4K page */
       pfa       = *dw1 & L4_PAGEMASK;
       offset    = pfa - aa->beg.app;
       size      = L4_PAGESIZE;
@@ -435,8 +496,26 @@ forward_pf_ds(app_t *app, app_area_t *aa,
       enter_kdebug("app_pager");
     }
 
-  if ((error = l4dm_map_pages(&aa->ds, offset, size, map_addr, log2_size, 0,
-			      flags, &fpage_addr, &fpage_size)))
+  if (map_addr == pager_map_addr_chunk)
+    {
+      if ((error = l4dm_map_pages(&aa->ds, offset, L4_PAGESIZE,
+				  map_addr, log2_size, rcv_offs,
+				  flags | L4DM_MAP_MORE,
+				  &fpage_addr, &fpage_size)))
+	{
+	  app_msg(app, "Error %d mapping chunk of dataspace", error);
+	  return;
+	}
+
+      /* the fpage contains the page fault page but may be smaller than
+       * the chunk */
+      pfa      += fpage_addr - map_addr;
+      map_addr  = fpage_addr;
+      log2_size = l4util_bsr(fpage_size);
+    }
+  else if ((error = l4dm_map_pages(&aa->ds, offset, size, map_addr,
+				   log2_size, 0, flags,
+				   &fpage_addr, &fpage_size)))
     {
       app_msg(app, "Error %d mapping page of dataspace", error);
       return;
@@ -447,6 +526,7 @@ forward_pf_ds(app_t *app, app_area_t *aa,
   *dw2 = l4_fpage(map_addr, log2_size, fpage_flags, L4_FPAGE_GRANT).fpage;
 
   *reply = L4_IPC_SHORT_FPAGE;
+  pf_account(app, 1UL << log2_size);
 }
 
 /** Map kernel info page from rmgr. */
@@ -458,7 +538,7 @@ map_kernel_info_page(void)
   l4_uint32_t rm_area;
 #endif
 
-  if (!l4sigma0_kip_map(L4_INVALID_ID))
+  if (!(kip = l4sigma0_kip_map(L4_INVALID_ID)))
     {
       printf("Cannot map KI page\n");
       return -L4_ENOMEM;
@@ -521,6 +601,13 @@ app_pager_thread(void *data)
       enter_kdebug("app_pager");
     }
 
+  if ((error = l4rm_area_reserve(1UL << PAGER_LOG2_CHUNK, L4RM_LOG2_ALIGNED,
+			         &pager_map_addr_chunk, &rm_area)))
+    {
+      printf("Error %d reserving chunk map area\n", error);
+      enter_kdebug("app_pager");
+    }
+
   _rmgr_pager_id = rmgr_pager_id();
 
   /* shake hands with creator */
@@ -622,6 +709,7 @@ app_pager_thread(void *data)
 		      dw1 &= L4_PAGEMASK;
 		      dw2 = l4_fpage(send_addr, L4_LOG2_PAGESIZE,
 				     fpage_rw, L4_FPAGE_MAP).fpage;
+		      pf_account(app, L4_PAGESIZE);
 		    }
 		}
 	      else if (l4_msgtag_is_sigma0(tag)
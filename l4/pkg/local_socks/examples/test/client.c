@@ -31,6 +31,7 @@
 #include <l4/util/util.h>
 #include <l4/thread/thread.h>
 #include <l4/log/l4log.h>
+#include <l4/local_socks/ring.h>
 
 /* *** LOCAL INCLUDES *** */
 #include "util.h"
@@ -44,6 +45,54 @@ char LOG_tag[9]="client";
 
 /* ******************************************************************* */
 
+static void client_ring(void);
+static void client_ring(void) {
+
+  int                fd, ret, addr_len, i;
+  struct sockaddr_un addr;
+  char               msg_big[4096];
+  char               buf[32];
+  struct timeval     tv0, tv1;
+
+  /* same as the benchmark in client(), but through the shared ring */
+  fd = socket(PF_LOCAL, SOCK_STREAM, 0);
+  fill_addr(&addr, &addr_len, "/tmp/sock");
+  ret = connect(fd, (struct sockaddr *) &addr, addr_len);
+  LOG("connect(): %d; errno=%d: %s", ret, errno, strerror(errno));  
+
+  /* tell the server to attach, too */
+  ret = write(fd, "r", 1);
+  ret = local_socks_ring_attach(fd);
+  LOG("local_socks_ring_attach(): %d", ret);
+  if (ret < 0) {
+    close(fd);
+    return;
+  }
+
+  LOG("Sending the same data through the shared ring ...");
+  gettimeofday(&tv0, NULL);
+  for (i = 0; i < 500; i++) {
+    ret = local_socks_ring_send(fd, msg_big, 4096, 0);
+    if (ret <= 0)
+      break;
+  }
+  gettimeofday(&tv1, NULL);
+  LOG("elapsed time (ring): %ld ms", elapsed_time(&tv0, &tv1));
+
+  ret = shutdown(fd, SHUT_WR);
+  LOG("shutdown(): %d; errno=%d: %s", ret, errno, strerror(errno));  
+
+  ret = local_socks_ring_recv(fd, buf, 8, 0);
+  LOG("local_socks_ring_recv(): %d", ret);
+  LOG("received message via ring: '%s'", buf);
+
+  local_socks_ring_detach(fd);
+  ret = close(fd);
+  LOG("close(): %d; errno=%d: %s", ret, errno, strerror(errno));
+}
+
+/* ******************************************************************* */
+
 static void client(void *p);
 static void client(void *p) {
 
@@ -65,7 +114,8 @@ static void client(void *p) {
   LOG("connect(): %d; errno=%d: %s", ret, errno, strerror(errno));  
 
 #if 1
-  /* send a lot of data to server process */
+  /* send a lot of data to server process, copied by local_socks */
+  ret = write(fd, "c", 1);
   LOG("Sending some data to server to benchmark throughput ...");
   gettimeofday(&tv0, NULL);
   for (i = 0; i < 500; i++) {
@@ -99,6 +149,8 @@ static void client(void *p) {
   ret = close(fd);
   LOG("close(): %d; errno=%d: %s", ret, errno, strerror(errno));
 
+  client_ring();
+
 #if 1
   l4thread_started(NULL);
 #endif
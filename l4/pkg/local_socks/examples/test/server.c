@@ -31,6 +31,7 @@
 #include <l4/util/util.h>
 #include <l4/thread/thread.h>
 #include <l4/log/l4log.h>
+#include <l4/local_socks/ring.h>
 
 /* *** LOCAL INCLUDES *** */
 #include "util.h"
@@ -42,6 +43,33 @@ char LOG_tag[9]="server";
 
 /* ******************************************************************* */
 
+static void server_ring(int fd, char *msg);
+static void server_ring(int fd, char *msg) {
+
+  const void *data;
+  size_t     len;
+  int        ret;
+
+  ret = local_socks_ring_attach(fd);
+  LOG("local_socks_ring_attach(): %d", ret);
+  if (ret < 0)
+    return;
+
+  /* receive a lot of data, without copying it at all */
+  do {
+    ret = local_socks_ring_peek(fd, &data, &len, 0);
+    if (ret == 0 && len > 0)
+      ret = local_socks_ring_consume(fd, len);
+  } while (ret == 0 && len > 0);
+
+  ret = local_socks_ring_send(fd, msg, 8, 0);
+  LOG("local_socks_ring_send(): %d", ret);
+
+  local_socks_ring_detach(fd);
+}
+
+/* ******************************************************************* */
+
 static void server(void *p);
 static void server(void *p) {
 
@@ -49,6 +77,7 @@ static void server(void *p) {
   struct sockaddr_un addr0, addr1;
   char msg[] = "0123456";
   char *buf;
+  char mode;
 
   // ignore errors which might occur while opening STDIN, ...!
   errno = 0;
@@ -73,6 +102,16 @@ static void server(void *p) {
     
     buf = (char *) malloc(4096);
 
+    /* 'r': the client uses the shared ring, 'c': read()/write() */
+    ret = read(fd1, &mode, 1);
+    if (ret == 1 && mode == 'r') {
+      server_ring(fd1, msg);
+      ret = close(fd1);
+      LOG("close(): %d; errno=%d: %s", ret, errno, strerror(errno));  
+      free(buf);
+      continue;
+    }
+
 #if 1
     /* receive a lot of data */
     //ret = fcntl(fd1, F_SETFL, O_NDELAY);
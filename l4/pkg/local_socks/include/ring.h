@@ -0,0 +1,103 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   local_socks/include/ring.h
+ * \brief  Socket buffers shared between local_socks and its clients.
+ *
+ * \date   19/10/2026
+ *
+ * A connected socket can be attached with local_socks_ring_attach().
+ * local_socks then moves the buffers of both directions into a
+ * dataspace, which it shares with the clients owning the two sockets.
+ * An attached client writes to and reads from these rings directly;
+ * local_socks is only called to block, if a ring is full or empty,
+ * and to wake up the other side, if it blocks. The peer may still use
+ * read()/write(), in which case local_socks accesses the ring on its
+ * behalf.
+ *
+ * An attached socket must only be used with the local_socks_ring_*()
+ * functions, read()/write() on it fail with -EBUSY. select() and
+ * close() work as usual, but local_socks_ring_detach() must be called
+ * before close().
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#ifndef __LOCAL_SOCKS_INCLUDE_RING_H_
+#define __LOCAL_SOCKS_INCLUDE_RING_H_
+
+#include <l4/sys/compiler.h>
+#include <l4/sys/l4int.h>
+#include <sys/types.h>
+
+/* ******************************************************************* */
+
+#define LOCAL_SOCKS_RING_SIZE 32768 /* must be a power of two */
+
+/* ring->wait, set by local_socks, if someone blocks on the ring */
+#define LOCAL_SOCKS_RING_WAIT_READ  0x1 /* signal after producing data */
+#define LOCAL_SOCKS_RING_WAIT_WRITE 0x2 /* signal after consuming data */
+
+/* ring->shut, set by local_socks on shutdown() and close() */
+#define LOCAL_SOCKS_RING_SHUT_WR    0x1 /* no more data will be produced */
+#define LOCAL_SOCKS_RING_SHUT_RD    0x2 /* no more data will be consumed */
+
+/* One direction of a connection. head and tail count all bytes ever
+ * produced and consumed, the number of bytes in the ring is
+ * head - tail, the write position is head % LOCAL_SOCKS_RING_SIZE. */
+typedef struct local_socks_ring {
+  volatile l4_uint32_t head;     /* written by the producer only */
+  volatile l4_uint32_t tail;     /* written by the consumer only */
+  volatile l4_uint32_t wait;     /* written by local_socks only */
+  volatile l4_uint32_t shut;     /* written by local_socks only */
+  l4_uint32_t          pad[12];  /* keep data cache line aligned */
+  char                 data[LOCAL_SOCKS_RING_SIZE];
+} local_socks_ring_t;
+
+/* ******************************************************************* */
+
+/* Orders the update of head or tail against the following read of
+ * wait, local_socks does the same in the opposite order. */
+static inline void local_socks_ring_mb(void) {
+#if defined(__i386__)
+  __asm__ __volatile__ ("lock; addl $0,0(%%esp)" : : : "memory");
+#else
+  __sync_synchronize();
+#endif
+}
+
+static inline l4_uint32_t local_socks_ring_used(const local_socks_ring_t *r) {
+  return r->head - r->tail;
+}
+
+/* ******************************************************************* */
+
+EXTERN_C_BEGIN
+
+/* All functions return negative error codes (-EBADF, -EPIPE, -EIO if
+ * the shared indices are broken, ...).
+ * 'flags' may contain MSG_DONTWAIT. */
+
+int     local_socks_ring_attach(int fd);
+int     local_socks_ring_detach(int fd);
+
+ssize_t local_socks_ring_send(int fd, const void *buf, size_t len, int flags);
+ssize_t local_socks_ring_recv(int fd, void *buf, size_t len, int flags);
+
+/* Zero-copy interface: reserve() returns the contiguous free space at
+ * the write position, which is handed to the peer by commit(). peek()
+ * returns the contiguous data at the read position (*len == 0 means
+ * EOF), consume() frees it. Both block like send()/recv(), unless
+ * MSG_DONTWAIT is given. */
+int     local_socks_ring_reserve(int fd, void **addr, size_t *len, int flags);
+int     local_socks_ring_commit(int fd, size_t len);
+int     local_socks_ring_peek(int fd, const void **addr, size_t *len, int flags);
+int     local_socks_ring_consume(int fd, size_t len);
+
+EXTERN_C_END
+
+#endif /* __LOCAL_SOCKS_INCLUDE_RING_H_ */
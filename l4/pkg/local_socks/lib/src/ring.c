@@ -0,0 +1,379 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   local_socks/lib/src/ring.c
+ * \brief  Client side of the socket buffers shared with local_socks.
+ *
+ * \date   19/10/2026
+ *
+ * Like the l4vfs client libs, this is not thread-safe.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+/* *** GENERAL INCLUDES *** */
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+/* *** L4-SPECIFIC INCLUDES *** */
+#include <l4/l4rm/l4rm.h>
+#include <l4/l4vfs/types.h>
+#include <l4/l4vfs/file-table.h>
+#include <l4/local_socks/ring.h>
+#include <l4/local_socks/local_socks-client.h>
+
+/* ******************************************************************* */
+
+#ifndef MIN
+# define MIN(a, b) ( ((a) < (b)) ? (a) : (b) )
+#endif
+
+/* ******************************************************************* */
+
+typedef struct ring_fd {
+  l4_threadid_t      server;   /* session thread of local_socks */
+  object_handle_t    handle;
+  local_socks_ring_t *rings;   /* both rings, as shared by local_socks */
+  local_socks_ring_t *tx;      /* we produce */
+  local_socks_ring_t *rx;      /* we consume */
+} ring_fd_t;
+
+static ring_fd_t *ring_table[MAX_FILES_OPEN];
+
+/* ******************************************************************* */
+
+static inline ring_fd_t *ring_fd(int fd) {
+
+  if (fd < 0 || fd >= MAX_FILES_OPEN)
+    return NULL;
+  return ring_table[fd];
+}
+
+
+static int ring_wait(ring_fd_t *r, int mode) {
+
+  CORBA_Environment env = dice_default_environment;
+  int ret;
+
+  ret = local_socks_ring_wait_call(&r->server, r->handle, mode, &env);
+  if (DICE_HAS_EXCEPTION(&env))
+    return -EIO;
+  return ret;
+}
+
+
+static void ring_signal(ring_fd_t *r, int mode) {
+
+  CORBA_Environment env = dice_default_environment;
+
+  local_socks_ring_signal_call(&r->server, r->handle, mode, &env);
+}
+
+/* ******************************************************************* */
+
+/* Bytes in the ring, or -EIO if the index written by the peer is broken
+ * and the ring claims more than LOCAL_SOCKS_RING_SIZE bytes. */
+static int ring_used(const local_socks_ring_t *ring) {
+
+  l4_uint32_t used = local_socks_ring_used(ring);
+
+  if (used > LOCAL_SOCKS_RING_SIZE)
+    return -EIO;
+  return used;
+}
+
+
+/* Returns the free space in tx, > 0, or an error. */
+static int wait_for_space(ring_fd_t *r, int flags) {
+
+  int ret;
+
+  while (1) {
+    /* shut down by us (SHUT_WR) or the peer does not read (SHUT_RD) */
+    if (r->tx->shut)
+      return -EPIPE;
+    ret = ring_used(r->tx);
+    if (ret < 0)
+      return ret;
+    if (ret < LOCAL_SOCKS_RING_SIZE)
+      return LOCAL_SOCKS_RING_SIZE - ret;
+    if (flags & MSG_DONTWAIT)
+      return -EAGAIN;
+
+    ret = ring_wait(r, SELECT_WRITE);
+    if (ret < 0)
+      return ret;
+  }
+}
+
+
+/* Returns the bytes in rx, > 0, 0 on EOF, or an error. */
+static int wait_for_data(ring_fd_t *r, int flags) {
+
+  l4_uint32_t shut;
+  int ret;
+
+  while (1) {
+    /* local_socks sets shut after the last data became visible, so
+     * read it first to not miss data in front of EOF */
+    shut = r->rx->shut;
+    local_socks_ring_mb();
+    ret = ring_used(r->rx);
+    if (ret != 0)
+      return ret;
+    if (shut)
+      return 0; /* EOF */
+    if (flags & MSG_DONTWAIT)
+      return -EAGAIN;
+
+    ret = ring_wait(r, SELECT_READ);
+    if (ret < 0)
+      return ret;
+  }
+}
+
+
+static void produce(ring_fd_t *r, l4_uint32_t n) {
+
+  local_socks_ring_mb();
+  r->tx->head += n;
+
+  /* local_socks publishes the hint before it checks head */
+  local_socks_ring_mb();
+  if (r->tx->wait & LOCAL_SOCKS_RING_WAIT_READ)
+    ring_signal(r, SELECT_READ);
+}
+
+
+static void consume(ring_fd_t *r, l4_uint32_t n) {
+
+  local_socks_ring_mb();
+  r->rx->tail += n;
+
+  local_socks_ring_mb();
+  if (r->rx->wait & LOCAL_SOCKS_RING_WAIT_WRITE)
+    ring_signal(r, SELECT_WRITE);
+}
+
+/* ******************************************************************* */
+/* ******************************************************************* */
+
+int local_socks_ring_attach(int fd) {
+
+  CORBA_Environment env = dice_default_environment;
+  l4dm_dataspace_t  ds;
+  file_desc_t       fdesc;
+  ring_fd_t         *r;
+  int               ret, tx;
+
+  if (fd < 0 || fd >= MAX_FILES_OPEN || !ft_is_open(fd))
+    return -EBADF;
+  if (ring_table[fd])
+    return 0;
+
+  r = (ring_fd_t *) malloc(sizeof(*r));
+  if (r == NULL)
+    return -ENOMEM;
+
+  fdesc = ft_get_entry(fd);
+  ret   = local_socks_ring_attach_call(&fdesc.server_id, fdesc.object_handle,
+                                       &ds, &tx, &env);
+  if (DICE_HAS_EXCEPTION(&env)) {
+    /* not served by local_socks */
+    if (DICE_EXCEPTION_MAJOR(&env) == CORBA_SYSTEM_EXCEPTION &&
+        DICE_EXCEPTION_MINOR(&env) == CORBA_DICE_EXCEPTION_WRONG_OPCODE)
+      ret = -EOPNOTSUPP;
+    else
+      ret = -EIO;
+  }
+
+  if (ret == 0)
+    ret = l4rm_attach(&ds, 2 * sizeof(local_socks_ring_t), 0, L4DM_RW,
+                      (void **) &r->rings);
+  if (ret < 0) {
+    free(r);
+    return ret;
+  }
+
+  r->server      = fdesc.server_id;
+  r->handle      = fdesc.object_handle;
+  r->tx          = &r->rings[tx];
+  r->rx          = &r->rings[1 - tx];
+  ring_table[fd] = r;
+
+  return 0;
+}
+
+
+int local_socks_ring_detach(int fd) {
+
+  ring_fd_t *r = ring_fd(fd);
+
+  if (r == NULL)
+    return -EBADF;
+
+  /* local_socks frees the dataspace, after both sockets are closed */
+  l4rm_detach(r->rings);
+  ring_table[fd] = NULL;
+  free(r);
+
+  return 0;
+}
+
+/* ******************************************************************* */
+
+ssize_t local_socks_ring_send(int fd, const void *buf, size_t len, int flags) {
+
+  ring_fd_t   *r = ring_fd(fd);
+  const char  *msg = (const char *) buf;
+  size_t      done = 0;
+  l4_uint32_t n, n0, w_start;
+  int         ret;
+
+  if (r == NULL)
+    return -EBADF;
+
+  while (done < len) {
+
+    ret = wait_for_space(r, flags);
+    if (ret < 0)
+      return done ? (ssize_t) done : ret;
+
+    /* up to two memcpy()s, as in local_socks' send_internal() */
+    n       = MIN(len - done, (l4_uint32_t) ret);
+    w_start = r->tx->head % LOCAL_SOCKS_RING_SIZE;
+    n0      = MIN(n, LOCAL_SOCKS_RING_SIZE - w_start);
+
+    memcpy(&r->tx->data[w_start], msg + done, n0);
+    if (n > n0)
+      memcpy(&r->tx->data[0], msg + done + n0, n - n0);
+
+    produce(r, n);
+    done += n;
+  }
+
+  return done;
+}
+
+
+ssize_t local_socks_ring_recv(int fd, void *buf, size_t len, int flags) {
+
+  ring_fd_t   *r = ring_fd(fd);
+  char        *msg = (char *) buf;
+  l4_uint32_t n, n0, r_start;
+  int         ret;
+
+  if (r == NULL)
+    return -EBADF;
+
+  ret = wait_for_data(r, flags);
+  if (ret <= 0)
+    return ret;
+
+  n       = MIN(len, (l4_uint32_t) ret);
+  r_start = r->rx->tail % LOCAL_SOCKS_RING_SIZE;
+  n0      = MIN(n, LOCAL_SOCKS_RING_SIZE - r_start);
+
+  memcpy(msg, &r->rx->data[r_start], n0);
+  if (n > n0)
+    memcpy(msg + n0, &r->rx->data[0], n - n0);
+
+  consume(r, n);
+
+  return n;
+}
+
+/* ******************************************************************* */
+
+int local_socks_ring_reserve(int fd, void **addr, size_t *len, int flags) {
+
+  ring_fd_t   *r = ring_fd(fd);
+  l4_uint32_t w_start;
+  int         ret;
+
+  if (r == NULL)
+    return -EBADF;
+
+  ret = wait_for_space(r, flags);
+  if (ret < 0)
+    return ret;
+
+  w_start = r->tx->head % LOCAL_SOCKS_RING_SIZE;
+  *addr   = &r->tx->data[w_start];
+  *len    = MIN((l4_uint32_t) ret, LOCAL_SOCKS_RING_SIZE - w_start);
+
+  return 0;
+}
+
+
+int local_socks_ring_commit(int fd, size_t len) {
+
+  ring_fd_t *r = ring_fd(fd);
+  int       used;
+
+  if (r == NULL)
+    return -EBADF;
+  used = ring_used(r->tx);
+  if (used < 0)
+    return used;
+  if (len > (size_t) (LOCAL_SOCKS_RING_SIZE - used))
+    return -EINVAL;
+
+  if (len > 0)
+    produce(r, len);
+
+  return 0;
+}
+
+
+int local_socks_ring_peek(int fd, const void **addr, size_t *len, int flags) {
+
+  ring_fd_t   *r = ring_fd(fd);
+  l4_uint32_t r_start;
+  int         ret;
+
+  if (r == NULL)
+    return -EBADF;
+
+  ret = wait_for_data(r, flags);
+  if (ret < 0)
+    return ret;
+
+  if (ret == 0) {
+    *addr = NULL;
+    *len  = 0;
+    return 0;
+  }
+
+  r_start = r->rx->tail % LOCAL_SOCKS_RING_SIZE;
+  *addr   = &r->rx->data[r_start];
+  *len    = MIN((l4_uint32_t) ret, LOCAL_SOCKS_RING_SIZE - r_start);
+
+  return 0;
+}
+
+
+int local_socks_ring_consume(int fd, size_t len) {
+
+  ring_fd_t *r = ring_fd(fd);
+  int       used;
+
+  if (r == NULL)
+    return -EBADF;
+  used = ring_used(r->rx);
+  if (used < 0)
+    return used;
+  if (len > (size_t) used)
+    return -EINVAL;
+
+  if (len > 0)
+    consume(r, len);
+
+  return 0;
+}
@@ -20,6 +20,8 @@
 /* *** L4-SPECIFIC INCLUDES *** */
 #include <l4/semaphore/semaphore.h>
 #include <l4/util/macros.h>
+#include <l4/dm_generic/types.h>
+#include <l4/local_socks/ring.h>
 
 /* ******************************************************************* */
 
@@ -59,7 +61,7 @@
 #define MAX_ADDRESS_LEN 108
 
 #define MAX_BACKLOG 8
-#define SOCKET_BUFFER_SIZE 32768
+#define SOCKET_BUFFER_SIZE LOCAL_SOCKS_RING_SIZE
 #define CONNECT_TIMEOUT 60000
 
 /* ******************************************************************* */
@@ -162,16 +164,21 @@ typedef struct connect_queue {
 /* ******************************************************************* */
 
 typedef struct buffer {
-  char *bytes;
-  unsigned int  num_bytes;      /* number of bytes in buffer */
-  unsigned int  r_start;        /* to avoid unnecessary copying, the logical start of   */
-  unsigned int  w_start;        /* the buffer may be greater than zero, which means     */
-  unsigned int  read_blocked :1;/* there can be a wrap around, after less data was read */
-  unsigned int  write_blocked:1;/* from the buffer than previously was written to it    */
+  local_socks_ring_t *ring;     /* private, or part of a shared_rings_t */
+  unsigned int  read_blocked :1;
+  unsigned int  write_blocked:1;
   l4semaphore_t read_sem;
   l4semaphore_t write_sem;
 } buffer_t;
 
+/* the rings of both sockets of a connection, after a client attached
+ * one of them; freed together with the last of the two sockets */
+typedef struct shared_rings {
+  l4dm_dataspace_t   ds;
+  local_socks_ring_t *rings;    /* rings[0], rings[1] */
+  int                users;
+} shared_rings_t;
+
 /* ******************************************************************* */
 
 typedef struct notify_node {
@@ -212,7 +219,8 @@ typedef struct notify_queue {
 
 
 typedef struct socket_desc {
-  unsigned int  unused :16;
+  unsigned int  unused :15;
+  unsigned int  attached:1;      /* the owner accesses the rings directly */
   unsigned int  backlog:16;      /* max. number of connect()s to be queued */
   unsigned int  used   : 1;      /* indicates, whether this socket descriptor is used */
   unsigned int  stream : 1;      /* communication type is SOCK_STREAM */
@@ -230,6 +238,7 @@ typedef struct socket_desc {
   notify_queue_t     write_notify;  /* list of clients waiting in select() for write */
   notify_queue_t     except_notify; /* list of clients waiting in select() for exeptions */
   buffer_t           buf;           /* write buffer */
+  shared_rings_t     *shared;       /* set if buf.ring is shared */
   l4_threadid_t      owner;         /* the client which onws the socket */
 } socket_desc_t;
 
@@ -263,6 +272,9 @@ int send_internal      (job_info_t *job, int h, const char *msg, int len, int fl
 int recv_internal      (job_info_t *job, int h, char *msg, int *len, int flags);
 int fcntl_internal     (l4_threadid_t *client, int h, int cmd, long arg);
 int ioctl_internal     (l4_threadid_t *client, int h, int cmd, char **arg, int *count);
+int ring_attach_internal(l4_threadid_t *client, int h, l4dm_dataspace_t *ds, int *tx_ring);
+int ring_wait_internal  (l4_threadid_t *client, int h, int mode);
+int ring_signal_internal(l4_threadid_t *client, int h, int mode);
 
 /* ******************************************************************* */
 
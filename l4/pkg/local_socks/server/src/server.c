@@ -191,6 +191,38 @@ l4vfs_common_io_write_component(CORBA_Object _dice_corba_obj,
 
 
 
+/* read() and write() reply from worker threads, which the defaults for
+ * readv() / writev() cannot cope with. Let the client fall back to
+ * single reads and writes. */
+l4vfs_ssize_t
+l4vfs_common_io_readv_component(CORBA_Object _dice_corba_obj,
+                                object_handle_t fd,
+                                char **buf,
+                                l4vfs_size_t *count,
+                                int segments,
+                                const l4vfs_size_t *lens,
+                                CORBA_Server_Environment *_dice_corba_env)
+{
+  *count = 0;
+  return -ENOSYS;
+}
+
+
+
+l4vfs_ssize_t
+l4vfs_common_io_writev_component(CORBA_Object _dice_corba_obj,
+                                 object_handle_t fd,
+                                 const char *buf,
+                                 l4vfs_size_t count,
+                                 int segments,
+                                 const l4vfs_size_t *lens,
+                                 CORBA_Server_Environment *_dice_corba_env)
+{
+  return -ENOSYS;
+}
+
+
+
 l4_int32_t
 l4vfs_common_io_close_component(CORBA_Object _dice_corba_obj,
                                 object_handle_t object_handle,
@@ -632,6 +664,41 @@ local_socks_worker_done_component(CORBA_Object _dice_corba_obj,
   reply_to_client(j);
 }
 
+/* ******************************************************************* */
+
+int
+local_socks_ring_attach_component(CORBA_Object _dice_corba_obj,
+                                  object_handle_t fd,
+                                  l4dm_dataspace_t *ds,
+                                  int *tx_ring,
+                                  CORBA_Server_Environment *_dice_corba_env)
+{
+  return ring_attach_internal(_dice_corba_obj, fd, ds, tx_ring);
+}
+
+
+
+int
+local_socks_ring_wait_component(CORBA_Object _dice_corba_obj,
+                                object_handle_t fd,
+                                int mode,
+                                CORBA_Server_Environment *_dice_corba_env)
+{
+  /* blocks the session thread like recv() does, see NO_WORKER_THREAD */
+  return ring_wait_internal(_dice_corba_obj, fd, mode);
+}
+
+
+
+int
+local_socks_ring_signal_component(CORBA_Object _dice_corba_obj,
+                                  object_handle_t fd,
+                                  int mode,
+                                  CORBA_Server_Environment *_dice_corba_env)
+{
+  return ring_signal_internal(_dice_corba_obj, fd, mode);
+}
+
 /* ******************************************************************* */
 /* ******************************************************************* */
 
@@ -28,6 +28,8 @@
 #include <l4/util/l4_macros.h>
 #include <l4/l4vfs/select_listener.h>
 #include <l4/env/errno.h>
+#include <l4/dm_mem/dm_mem.h>
+#include <l4/l4rm/l4rm.h>
 
 /* *** LOCAL INCLUDES *** */
 #include "socket_internal.h"
@@ -78,6 +80,14 @@ static int         do_shutdown(socket_desc_t *s, int how);
 static inline int  blocking_operation_in_progress(socket_desc_t *s);
 static inline void set_peer_socket(socket_desc_t *s, socket_desc_t *peer, int state); 
 static inline void free_buf(socket_desc_t *s);
+static int         share_rings(socket_desc_t *s);
+static void        update_wait_hints(socket_desc_t *s);
+static int         mark_blocked(socket_desc_t *s, int mode);
+static void        unmark_blocked(socket_desc_t *s, int mode);
+static int         ring_snapshot(local_socks_ring_t *r, l4_uint32_t *head,
+                                 l4_uint32_t *tail);
+static inline int  ring_used(local_socks_ring_t *r);
+static void        reset_connection(socket_desc_t *s);
 
 static inline int    client_owns_handle(l4_threadid_t *client, int h);
 static int           allocate_handle(l4_threadid_t *owner);
@@ -555,7 +565,7 @@ int accept_internal(job_info_t *job, int h, const char *addr, int *addr_len) {
 int send_internal(job_info_t *job, int h, const char *msg, int len, int flags) {
 
   int ret, to_write, to_write_now;
-  int exit_loop;
+  int exit_loop, reset;
   socket_desc_t *s;
 
   LOGd_Enter(_DEBUG_ENTER, "h=%d, len=%d", h, len);
@@ -578,37 +588,59 @@ int send_internal(job_info_t *job, int h, const char *msg, int len, int flags) {
   if (flags != 0)
     LOG("Support for flags != 0 not implemented, ignoring it.");
 
-  if ( !can_send(s))
+  if ( !can_send(s)) {
+    socket_unlock(s->peer);
+    socket_unlock(s);
     return -EPIPE; /* socket is shutdown for send() */
+  }
+
+  if (s->attached) {
+    /* the owner writes to the shared ring itself */
+    socket_unlock(s->peer);
+    socket_unlock(s);
+    return -EBUSY;
+  }
  
   to_write  = len;
   exit_loop = 0;
+  reset     = 0;
 
   while (to_write > 0 && !exit_loop && can_send(s)) {
 
-    int n0, n1;
+    local_socks_ring_t *r = s->buf.ring;
+    l4_uint32_t head, tail;
+    int n0, n1, used, w_start;
 
     /* determine the number of bytes that currently fit into the buffer */
-    to_write_now = MIN(to_write, SOCKET_BUFFER_SIZE - s->buf.num_bytes);
+    used = ring_snapshot(r, &head, &tail);
+    if (used < 0) {
+      reset_connection(s);
+      reset = 1;
+      break;
+    }
+    to_write_now = MIN(to_write, SOCKET_BUFFER_SIZE - used);
 
     if (to_write_now > 0) {
-      /* We do up to two memcpy()s, if the buffer does not start at bytes[0], which
-       * means, there might be a wrap around. n0 is the the number of bytes from
-       * bytes[buf.w_start] to the end of the buffer, n1 is from bytes[0]. */
-      n0 = MIN(to_write_now, SOCKET_BUFFER_SIZE - s->buf.w_start);
-      n1 = to_write_now - n0;
+      /* We do up to two memcpy()s, if the write position is not at data[0],
+       * which means, there might be a wrap around. n0 is the the number of
+       * bytes from data[w_start] to the end of the buffer, n1 is from
+       * data[0]. */
+      w_start = head % SOCKET_BUFFER_SIZE;
+      n0      = MIN(to_write_now, SOCKET_BUFFER_SIZE - w_start);
+      n1      = to_write_now - n0;
       
       LOGd(_DEBUG, "to_write: %d of %d; w_start=%d, num=%d; n0=%d, n1=%d",
-           to_write_now, len, s->buf.w_start, s->buf.num_bytes, n0, n1);
+           to_write_now, len, w_start, used, n0, n1);
       
-      memcpy(&s->buf.bytes[s->buf.w_start], msg, n0);
+      memcpy(&r->data[w_start], msg, n0);
       if (n1 > 0)
-        memcpy(&s->buf.bytes[0], msg + n0, n1);
-      
-      s->buf.num_bytes += to_write_now;
-      msg              += to_write_now;
-      to_write         -= to_write_now;
-      s->buf.w_start    = (s->buf.w_start + to_write_now) % SOCKET_BUFFER_SIZE;
+        memcpy(&r->data[0], msg + n0, n1);
+
+      /* an attached reader must not see head before the data */
+      local_socks_ring_mb();
+      r->head   = head + to_write_now;
+      msg      += to_write_now;
+      to_write -= to_write_now;
 
       /* signal reader that there's data to be read */
       if (s->buf.read_blocked)
@@ -629,8 +661,10 @@ int send_internal(job_info_t *job, int h, const char *msg, int len, int flags) {
          (s->state & SOCKET_STATE_NONBLOCK) == 0)) {
 
       /* block until there is some room in the buffer */
+      if ( !mark_blocked(s, SELECT_WRITE))
+        continue; /* an attached reader made room in the meantime */
+
       set_sub_state_on(s, SOCKET_STATE_SENDING);
-      s->buf.write_blocked = 1;
       socket_unlock(s);
       socket_unlock(s->peer);
 
@@ -638,7 +672,7 @@ int send_internal(job_info_t *job, int h, const char *msg, int len, int flags) {
       
       set_sub_state_off(s, SOCKET_STATE_SENDING);
       if (socket_lock_peers(s) == 0) {
-        s->buf.write_blocked = 0;      
+        unmark_blocked(s, SELECT_WRITE);
       } else {
         LOG_Error("failed to regain locks for send");
         return len - to_write;
@@ -648,9 +682,10 @@ int send_internal(job_info_t *job, int h, const char *msg, int len, int flags) {
       exit_loop = 1;
   }
   
-  ret = len - to_write;
-  LOGd(_DEBUG, "sent %d bytes (h:%d->%d); w_start=%d, num_bytes=%d",
-       ret, socket_handle(s), socket_handle(s->peer), s->buf.w_start, s->buf.num_bytes);
+  ret = reset ? -ECONNRESET : len - to_write;
+  LOGd(_DEBUG, "sent %d bytes (h:%d->%d); head=%u, num_bytes=%d",
+       ret, socket_handle(s), socket_handle(s->peer), s->buf.ring->head,
+       ring_used(s->buf.ring));
  
   if (s->state & SOCKET_STATE_CLOSED)
     do_close(s);
@@ -665,7 +700,7 @@ int send_internal(job_info_t *job, int h, const char *msg, int len, int flags) {
 int recv_internal(job_info_t *job, int h, char *msg, int *len, int flags) {
 
   int ret, to_read, to_read_now;
-  int exit_loop;
+  int exit_loop, reset;
   socket_desc_t *s, *peer;
 
   LOGd_Enter(_DEBUG_ENTER, "h=%d", h);
@@ -694,47 +729,66 @@ int recv_internal(job_info_t *job, int h, char *msg, int *len, int flags) {
     return 0; /* shutdown for read -> EOF */
   }
 
+  if (s->attached) {
+    /* the owner reads from the shared ring itself */
+    socket_unlock(s->peer);
+    socket_unlock(s);
+    return -EBUSY;
+  }
+
   to_read   = *len;
   exit_loop = 0;
+  reset     = 0;
 
   while (to_read > 0 && !exit_loop && can_recv(s)) {
 
-    int n0, n1;
+    local_socks_ring_t *r = s->peer->buf.ring;
+    l4_uint32_t head, tail;
+    int n0, n1, used, r_start;
 
-    to_read_now = MIN(to_read, s->peer->buf.num_bytes);
+    used = ring_snapshot(r, &head, &tail);
+    if (used < 0) {
+      reset_connection(s);
+      reset = 1;
+      break;
+    }
+    to_read_now = MIN(to_read, used);
 
     if (to_read_now > 0) {
-      /* We do up to two memcpy()s, if the buffer does not start at bytes[0], which
-       * means, there might be a wrap around. n0 is the the number of bytes from
-       * bytes[buf.r_start] to the end of the buffer, n1 is from bytes[0]. */
-      n0 = MIN(to_read_now, SOCKET_BUFFER_SIZE - s->peer->buf.r_start);
-      n1 = to_read_now - n0;
+      /* We do up to two memcpy()s, if the read position is not at data[0],
+       * which means, there might be a wrap around. n0 is the the number of
+       * bytes from data[r_start] to the end of the buffer, n1 is from
+       * data[0]. */
+      r_start = tail % SOCKET_BUFFER_SIZE;
+      n0      = MIN(to_read_now, SOCKET_BUFFER_SIZE - r_start);
+      n1      = to_read_now - n0;
       
       LOGd(_DEBUG, "to_read_now: %d of %d; r_start=%d, num=%d; n0=%d, n1=%d",
-           to_read_now, *len, s->peer->buf.r_start, s->peer->buf.num_bytes, n0, n1);
+           to_read_now, *len, r_start, used, n0, n1);
       
-      memcpy(msg, &s->peer->buf.bytes[s->peer->buf.r_start], n0);      
+      memcpy(msg, &r->data[r_start], n0);      
       if (n1 > 0)
-        memcpy(msg + n0, &s->peer->buf.bytes[0], n1);
-      
-      s->peer->buf.num_bytes -= to_read_now;
-      to_read                -= to_read_now;
-      msg                    += to_read_now;
-      s->peer->buf.r_start    = (s->peer->buf.r_start + to_read_now) % SOCKET_BUFFER_SIZE;
+        memcpy(msg + n0, &r->data[0], n1);
+
+      /* an attached writer must not reuse the space before we copied it */
+      local_socks_ring_mb();
+      r->tail  = tail + to_read_now;
+      to_read -= to_read_now;
+      msg     += to_read_now;
 
     } else if ( !(s->peer->state & SOCKET_STATE_CLOSED)) {
       LOGd(_DEBUG, "buffer empty, waiting ...");
     }
 
     /* signal writer that there is some space in the buffer */
-    if (s->peer->buf.num_bytes < SOCKET_BUFFER_SIZE) {
+    if (used - to_read_now < SOCKET_BUFFER_SIZE) {
       if (s->peer->buf.write_blocked)
         l4semaphore_up(&s->peer->buf.write_sem);
       else
         send_select_notification(s, SELECT_WRITE);
     }
 
-    if (s->peer->buf.num_bytes == 0 && !can_send(s->peer))
+    if (used == to_read_now && !can_send(s->peer))
       exit_loop = 1;
 
     if (!exit_loop && to_read > 0 &&
@@ -742,8 +796,10 @@ int recv_internal(job_info_t *job, int h, char *msg, int *len, int flags) {
          (s->state & SOCKET_STATE_NONBLOCK && s->peer->buf.write_blocked))) {
       
       /* block until there is more data */
+      if ( !mark_blocked(s->peer, SELECT_READ))
+        continue; /* an attached writer produced data in the meantime */
+
       set_sub_state_on(s, SOCKET_STATE_RECVING);
-      s->peer->buf.read_blocked = 1;
       socket_unlock(s->peer);
       socket_unlock(s);
 
@@ -751,7 +807,7 @@ int recv_internal(job_info_t *job, int h, char *msg, int *len, int flags) {
   
       set_sub_state_off(s, SOCKET_STATE_RECVING);
       if (socket_lock_peers(s) == 0) {
-        s->peer->buf.read_blocked = 0;      
+        unmark_blocked(s->peer, SELECT_READ);
       } else {
         LOG_Error("failed to regain locks for recv");
         return *len - to_read;
@@ -762,10 +818,12 @@ int recv_internal(job_info_t *job, int h, char *msg, int *len, int flags) {
 
   ret  = *len - to_read;
   *len = ret;
+  if (reset)
+    ret = -ECONNRESET;
 
-  LOGd(_DEBUG, "recv'ed %d bytes (h:%d<-%d); r_start=%d, num_bytes=%d",
-       ret, h, socket_handle(s->peer), s->peer->buf.r_start,
-       s->peer->buf.num_bytes);
+  LOGd(_DEBUG, "recv'ed %d bytes (h:%d<-%d); tail=%u, num_bytes=%d",
+       ret, h, socket_handle(s->peer), s->peer->buf.ring->tail,
+       ring_used(s->peer->buf.ring));
   
   peer = s->peer; /* try_to_close_peer() can set s->peer=NULL */
   if (s->peer->state & SOCKET_STATE_CLOSED)
@@ -855,6 +913,173 @@ int ioctl_internal(l4_threadid_t *client, int h, int cmd, char **arg, int *count
   return ret;
 }
 
+int ring_attach_internal(l4_threadid_t *client, int h, l4dm_dataspace_t *ds,
+                         int *tx_ring) {
+
+  socket_desc_t *s;
+  int ret;
+
+  LOGd_Enter(_DEBUG_ENTER, "h=%d", h);
+
+  ret = lock_socket_peers_for_client(client, h);
+  if (ret == -EBADF)
+    return ret;
+
+  s = socket_desc(h);
+
+  if (ret < 0) {
+    socket_unlock(s);
+    return -ENOTCONN;
+  }
+
+  if (blocking_operation_in_progress(s))
+    ret = -EBUSY;
+  else if (s->shared == NULL)
+    ret = share_rings(s);
+
+  if (ret == 0)
+    ret = l4dm_share(&s->shared->ds, *client, L4DM_RW);
+
+  if (ret == 0) {
+    s->attached = 1;
+    *ds         = s->shared->ds;
+    *tx_ring    = (s->buf.ring == &s->shared->rings[0]) ? 0 : 1;
+  } else
+    LOGd(_DEBUG, "failed to attach rings of %d: %d", h, ret);
+
+  socket_unlock(s->peer);
+  socket_unlock(s);
+
+  return ret;
+}
+
+
+
+int ring_wait_internal(l4_threadid_t *client, int h, int mode) {
+
+  socket_desc_t *s, *b, *peer;
+  int ret, can_block, sub_state;
+
+  LOGd_Enter(_DEBUG_ENTER, "h=%d, mode=%d", h, mode);
+
+  if (mode != SELECT_READ && mode != SELECT_WRITE)
+    return -EINVAL;
+
+  ret = lock_socket_peers_for_client(client, h);
+  if (ret == -EBADF)
+    return ret;
+
+  s = socket_desc(h);
+
+  if (ret < 0) {
+    /* peer is gone, the client finds the rings shut */
+    socket_unlock(s);
+    return 0;
+  }
+
+  if ( !s->attached) {
+    socket_unlock(s->peer);
+    socket_unlock(s);
+    return -EINVAL;
+  }
+
+  /* the socket, whose buffer the client waits for */
+  if (mode == SELECT_READ) {
+    b         = s->peer;
+    can_block = can_recv(s) && can_send(s->peer);
+    sub_state = SOCKET_STATE_RECVING;
+  } else {
+    b         = s;
+    can_block = can_send(s) && can_recv(s->peer);
+    sub_state = SOCKET_STATE_SENDING;
+  }
+
+  if (can_block && mark_blocked(b, mode)) {
+
+    set_sub_state_on(s, sub_state);
+    socket_unlock(s->peer);
+    socket_unlock(s);
+
+    /* wait for signal from the other side, which may be a client
+     * calling ring_signal() or a send()/recv() for the peer */
+    if (mode == SELECT_READ)
+      l4semaphore_down(&b->buf.read_sem);
+    else
+      l4semaphore_down(&b->buf.write_sem);
+
+    set_sub_state_off(s, sub_state);
+    if (socket_lock_peers(s) != 0) {
+      LOG_Error("failed to regain locks for ring_wait");
+      return 0;
+    }
+    unmark_blocked(b, mode);
+  }
+
+  /* the client checks the ring again, we only do the deferred
+   * cleanup recv_internal() and send_internal() would do */
+  peer = s->peer;
+  if (mode == SELECT_READ && s->peer->state & SOCKET_STATE_CLOSED)
+    try_to_close_peer(s);
+  if (s->state & SOCKET_STATE_CLOSED)
+    do_close(s);
+
+  socket_unlock(peer);
+  socket_unlock(s);
+
+  return 0;
+}
+
+
+
+int ring_signal_internal(l4_threadid_t *client, int h, int mode) {
+
+  socket_desc_t *s;
+  int ret;
+
+  LOGd_Enter(_DEBUG_ENTER, "h=%d, mode=%d", h, mode);
+
+  ret = lock_socket_peers_for_client(client, h);
+  if (ret == -EBADF)
+    return ret;
+
+  s = socket_desc(h);
+
+  if (ret < 0) {
+    /* nobody left to wake up */
+    socket_unlock(s);
+    return 0;
+  }
+
+  switch (mode) {
+
+  case SELECT_READ:
+    /* the client produced data in s->buf */
+    if (s->buf.read_blocked)
+      l4semaphore_up(&s->buf.read_sem);
+    else
+      send_select_notification(s->peer, SELECT_READ);
+    update_wait_hints(s);
+    break;
+
+  case SELECT_WRITE:
+    /* the client consumed data from s->peer->buf */
+    if (s->peer->buf.write_blocked)
+      l4semaphore_up(&s->peer->buf.write_sem);
+    else
+      send_select_notification(s->peer, SELECT_WRITE);
+    update_wait_hints(s->peer);
+    break;
+
+  default:
+    ret = -EINVAL;
+  }
+
+  socket_unlock(s->peer);
+  socket_unlock(s);
+
+  return ret;
+}
+
 /* ******************************************************************* */
 /* ******************************************************************* */
 
@@ -868,7 +1093,8 @@ static int would_block(socket_desc_t *s, int mode) {
     /* recv() */
     else if (can_recv(s)) {
 
-      if ((s->peer->buf.num_bytes > 0) && !s->peer->buf.read_blocked)
+      if (ring_used(s->peer->buf.ring) > 0 &&
+          !s->peer->buf.read_blocked)
         return 0;
 
     } else
@@ -882,7 +1108,8 @@ static int would_block(socket_desc_t *s, int mode) {
 
     /* send() */
     else if (can_send(s)) {
-      if (s->buf.num_bytes < SOCKET_BUFFER_SIZE && !s->buf.write_blocked)
+      if (ring_used(s->buf.ring) < SOCKET_BUFFER_SIZE &&
+          !s->buf.write_blocked)
         return 0;
     } else
       return 0;
@@ -895,7 +1122,7 @@ static int would_block(socket_desc_t *s, int mode) {
 static int bytes_to_recv(socket_desc_t *s) {
 
   if (can_recv(s))
-    return s->peer->buf.num_bytes;
+    return MAX(ring_used(s->peer->buf.ring), 0);
 
   return 0;
 }
@@ -945,6 +1172,12 @@ static int do_shutdown(socket_desc_t *s, int how) {
       err += 1;
   }
 
+  /* tell attached clients, they check these flags before blocking */
+  if (how == 0 || how == 2)
+    s->peer->buf.ring->shut |= LOCAL_SOCKS_RING_SHUT_RD;
+  if (how == 1 || how == 2)
+    s->buf.ring->shut |= LOCAL_SOCKS_RING_SHUT_WR;
+
   if (s->buf.read_blocked)
     l4semaphore_up(&s->buf.read_sem);
   if (s->peer->buf.write_blocked)
@@ -978,7 +1211,7 @@ static int do_close(socket_desc_t *s) {
       free_buf(s->peer);
       free_handle(socket_handle(s->peer));
 
-    } else if (s->buf.num_bytes > 0) {
+    } else if (ring_used(s->buf.ring) > 0) {
       
       /* If there is still data in the write buffer, we defer the actual
        * freeing of the socket descriptor. This is done later by either
@@ -1015,7 +1248,7 @@ static void try_to_close_peer(socket_desc_t *s) {
   socket_desc_t *p;
   
   /* deferred freeing of peer socket descriptor necessary? */
-  if (s->peer->buf.num_bytes == 0) {
+  if (ring_used(s->peer->buf.ring) <= 0) {
 
     LOGd_Enter(_DEBUG_ENTER, "h=%d", socket_handle(s));
     
@@ -1040,16 +1273,18 @@ static inline int blocking_operation_in_progress(socket_desc_t *s) {
 
 static inline void init_buf(socket_desc_t *s) {
 
-  s->buf.bytes = CORBA_alloc(SOCKET_BUFFER_SIZE);
-  if (s->buf.bytes == NULL) {
+  s->buf.ring = CORBA_alloc(sizeof(local_socks_ring_t));
+  if (s->buf.ring == NULL) {
     /* FIXME */
     LOG_Error("Failed to allocate socket buffer!");    
+  } else {
+    s->buf.ring->head = 0;
+    s->buf.ring->tail = 0;
+    s->buf.ring->wait = 0;
+    s->buf.ring->shut = 0;
   }
   s->buf.read_sem      = L4SEMAPHORE_LOCKED;
   s->buf.write_sem     = L4SEMAPHORE_LOCKED;
-  s->buf.num_bytes     = 0;
-  s->buf.r_start       = 0;
-  s->buf.w_start       = 0;
   s->buf.write_blocked = 0;
   s->buf.read_blocked  = 0;
   s->serial_r_sem      = L4SEMAPHORE_UNLOCKED;
@@ -1059,10 +1294,166 @@ static inline void init_buf(socket_desc_t *s) {
 
 static inline void free_buf(socket_desc_t *s) {
 
-  if (s->buf.bytes) {
-    CORBA_free(s->buf.bytes);
-    s->buf.bytes = NULL;
+  shared_rings_t *sr = s->shared;
+
+  if (sr) {
+    /* the peer may still use its ring in the same dataspace */
+    s->shared   = NULL;
+    s->attached = 0;
+    if (--sr->users == 0) {
+      l4rm_detach(sr->rings);
+      l4dm_close(&sr->ds);
+      CORBA_free(sr);
+    }
+  } else if (s->buf.ring)
+    CORBA_free(s->buf.ring);
+
+  s->buf.ring = NULL;
+}
+
+
+static int share_rings(socket_desc_t *s) {
+
+  shared_rings_t *sr;
+  l4_size_t      size = 2 * sizeof(local_socks_ring_t);
+  int            ret;
+
+  sr = (shared_rings_t *) CORBA_alloc(sizeof(*sr));
+  if (sr == NULL)
+    return -ENOMEM;
+
+  ret = l4dm_mem_open(L4DM_DEFAULT_DSM, size, 0, 0, "local_socks rings",
+                      &sr->ds);
+  if (ret < 0) {
+    CORBA_free(sr);
+    return ret;
+  }
+
+  ret = l4rm_attach(&sr->ds, size, 0, L4DM_RW, (void **) &sr->rings);
+  if (ret < 0) {
+    l4dm_close(&sr->ds);
+    CORBA_free(sr);
+    return ret;
+  }
+
+  /* head and tail keep their values and so does the position of the
+   * data, which may already be in the private buffers */
+  memcpy(&sr->rings[0], s->buf.ring, sizeof(local_socks_ring_t));
+  memcpy(&sr->rings[1], s->peer->buf.ring, sizeof(local_socks_ring_t));
+  CORBA_free(s->buf.ring);
+  CORBA_free(s->peer->buf.ring);
+
+  s->buf.ring       = &sr->rings[0];
+  s->peer->buf.ring = &sr->rings[1];
+  s->shared         = sr;
+  s->peer->shared   = sr;
+  sr->users         = 2;
+
+  update_wait_hints(s);
+  update_wait_hints(s->peer);
+
+  return 0;
+}
+
+
+static void update_wait_hints(socket_desc_t *s) {
+
+  l4_uint32_t wait = 0;
+
+  /* An attached client signals local_socks after changing the ring in
+   * s->buf, if someone waits for this. Hints of select() requests may
+   * be stale, this merely costs an extra ring_signal(). */
+  if (s->buf.read_blocked ||
+      (s->peer && !notify_queue_is_empty(&s->peer->read_notify)))
+    wait |= LOCAL_SOCKS_RING_WAIT_READ;
+  if (s->buf.write_blocked || !notify_queue_is_empty(&s->write_notify))
+    wait |= LOCAL_SOCKS_RING_WAIT_WRITE;
+
+  s->buf.ring->wait = wait;
+}
+
+
+static int mark_blocked(socket_desc_t *s, int mode) {
+
+  int used;
+
+  /* Mark the reader (SELECT_READ) or writer of s->buf as blocked. An
+   * attached client changes the ring without taking the lock, so check
+   * the ring again after publishing the hint. Returns 0, if there is
+   * no need to block anymore. */
+  if (mode == SELECT_READ)
+    s->buf.read_blocked = 1;
+  else
+    s->buf.write_blocked = 1;
+
+  if (s->shared == NULL)
+    return 1;
+
+  update_wait_hints(s);
+  local_socks_ring_mb();
+
+  /* corrupted indices don't block, send()/recv() reset the connection */
+  used = ring_used(s->buf.ring);
+  if ((mode == SELECT_READ  && used != 0) ||
+      (mode == SELECT_WRITE && used < SOCKET_BUFFER_SIZE)) {
+    unmark_blocked(s, mode);
+    return 0;
   }
+
+  return 1;
+}
+
+
+static int ring_snapshot(local_socks_ring_t *r, l4_uint32_t *head,
+                         l4_uint32_t *tail) {
+
+  /* An attached client may change head and tail of a shared ring at
+   * any time and to any value. Read both once and work on the copies
+   * only. Returns the number of bytes in the ring, or -1, if the
+   * indices are inconsistent. */
+  *head = r->head;
+  *tail = r->tail;
+
+  if (*head - *tail > LOCAL_SOCKS_RING_SIZE)
+    return -1;
+
+  return (int) (*head - *tail);
+}
+
+
+static inline int ring_used(local_socks_ring_t *r) {
+
+  l4_uint32_t head, tail;
+
+  return ring_snapshot(r, &head, &tail);
+}
+
+
+static void reset_connection(socket_desc_t *s) {
+
+  LOG_Error("inconsistent ring indices on %d, resetting connection",
+            socket_handle(s));
+
+  /* shut down both sides and wake up everybody blocked on them */
+  do_shutdown(s, 2);
+  do_shutdown(s->peer, 2);
+
+  /* the data in the rings is lost, this also allows the deferred
+   * freeing in do_close() and try_to_close_peer() */
+  s->buf.ring->tail       = s->buf.ring->head;
+  s->peer->buf.ring->tail = s->peer->buf.ring->head;
+}
+
+
+static void unmark_blocked(socket_desc_t *s, int mode) {
+
+  if (mode == SELECT_READ)
+    s->buf.read_blocked = 0;
+  else
+    s->buf.write_blocked = 0;
+
+  if (s->shared)
+    update_wait_hints(s);
 }
 
 
@@ -1185,17 +1576,28 @@ void register_select_notify(l4_threadid_t *client, int h,
                       "; mode=%d; h=%d ", l4util_idstr(*notif_tid), mode, h);
 
   if (mode & SELECT_READ) {
-    if (enqueue_notify(&s->read_notify, notif_tid) == 0 &&
-        !would_block(s, SELECT_READ))
+    if (enqueue_notify(&s->read_notify, notif_tid) == 0)
       notify_now_mode |= SELECT_READ;
   }
 
   if (mode & SELECT_WRITE) {
-    if (enqueue_notify(&s->write_notify, notif_tid) == 0 &&
-        !would_block(s, SELECT_WRITE))
+    if (enqueue_notify(&s->write_notify, notif_tid) == 0)
       notify_now_mode |= SELECT_WRITE;
   }
 
+  if (peer_locked && s->shared) {
+    /* attached clients must signal us from now on, check the rings
+     * after telling them */
+    update_wait_hints(s);
+    update_wait_hints(s->peer);
+    local_socks_ring_mb();
+  }
+
+  if ((notify_now_mode & SELECT_READ) && would_block(s, SELECT_READ))
+    notify_now_mode &= ~SELECT_READ;
+  if ((notify_now_mode & SELECT_WRITE) && would_block(s, SELECT_WRITE))
+    notify_now_mode &= ~SELECT_WRITE;
+
   if (mode & SELECT_EXCEPTION) {
     /* FIXME: do we need this? */
     LOG("select() for exception fds not implemented; ignoring it");
@@ -1464,7 +1866,9 @@ static int allocate_handle(l4_threadid_t *owner) {
     socket_table[i].used  = 1;
     socket_table[i].state = SOCKET_STATE_NIL;
     socket_table[i].owner = *owner;
-    socket_table[i].buf.bytes     = NULL;
+    socket_table[i].buf.ring      = NULL;
+    socket_table[i].shared        = NULL;
+    socket_table[i].attached      = 0;
     socket_table[i].lock          = L4SEMAPHORE_LOCKED;
     socket_table[i].operation_sem = L4SEMAPHORE_LOCKED;
   } else
@@ -0,0 +1,63 @@
+/*!
+ * \file   log/examples/ring/ring_bench.c
+ * \brief  Measure the cost of LOG_printf() with and without output ring.
+ *
+ * \date   10/19/2026
+ *
+ * The first round sends every line via log_outstring IPC, the second
+ * round appends to the shared output ring opened with LOG_ring_open().
+ * Start the logserver with a large buffer (e.g. -b 100000) to keep the
+ * console out of the measurement.
+ */
+#include <stdio.h>
+#include <l4/log/l4log.h>
+#include <l4/log/server.h>
+#include <l4/util/rdtsc.h>
+
+char LOG_tag[9]=LOG_TAG;
+
+#define ROUNDS	1000
+
+static l4_cpu_time_t bench(void){
+  l4_cpu_time_t start;
+  int i;
+
+  start = l4_rdtsc();
+  for(i=0; i<ROUNDS; i++)
+    LOG_printf("ring benchmark line %d\n", i);
+  return l4_rdtsc() - start;
+}
+
+static void report(const char *mode, l4_cpu_time_t cycles){
+  LOG_printf("%-5s: %u cycles/line, %u ns/line\n", mode,
+             (unsigned)(cycles / ROUNDS),
+             (unsigned)(l4_tsc_to_ns(cycles) / ROUNDS));
+}
+
+int main(void){
+  l4_cpu_time_t ipc, ring;
+  int err;
+
+  l4_calibrate_tsc();
+
+  /* warm up, resolves the logserver */
+  LOG_printf("starting, %d lines per round\n", ROUNDS);
+  LOG_flush();
+
+  ipc = bench();
+  LOG_flush();
+
+  if((err = LOG_ring_open()) != 0){
+    LOG_Error("LOG_ring_open(): %d", err);
+    return 1;
+  }
+  ring = bench();
+  LOG_flush();
+
+  report("ipc",  ipc);
+  report("ring", ring);
+  LOG_flush();
+
+  LOG_ring_close();
+  return 0;
+}
@@ -132,6 +132,41 @@ L4_CV int LOG_channel_flush(int id);
  */
 L4_CV int LOG_channel_close(int id);
 
+/*!\brief Open a shared output ring at the logserver
+ *
+ * This function maps a ring buffer of the log library to the logserver.
+ * Afterwards, LOG_printf() and friends append their output to this ring
+ * instead of sending one IPC per line. The logserver drains the rings of
+ * all clients asynchronously. A client only signals the logserver if the
+ * fill level of its ring crosses the high watermark, or if it calls
+ * LOG_flush(). If the ring is full, output falls back to IPC.
+ *
+ * \retval 0		success, or ring was already open
+ * \retval -L4_ENOTFOUND	logserver not found
+ * \retval -L4_ENOMAP	the logserver has no free ring slot
+ * \retval -L4_ENOMEM	the ring could not be allocated
+ * \retval -L4_EIPC	some problem with server communication occured
+ *
+ * \see  LOG_ring_close().
+ * \note This function is only available when using the logserver! The
+ *       ring is allocated at the dataspace manager, so the application
+ *       must link against dm_mem and l4rm (L4Env mode).
+ */
+L4_CV int LOG_ring_open(void);
+
+/*!\brief Close the shared output ring
+ *
+ * The logserver drains the ring before it is unmapped. Further output is
+ * sent using IPC again.
+ *
+ * \retval 0  no error
+ * \retval <0 in the case of error
+ *
+ * \see  LOG_ring_open().
+ * \note This function is only available when using the logserver!
+ */
+L4_CV int LOG_ring_close(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,11 @@ extern int check_server(void);
 extern l4_threadid_t log_server;
 extern int initialized;
 
+/* shared output ring, set by LOG_ring_open() */
+extern log_ring_t *log_ring;
+extern int log_ring_id;
+extern int LOG_ring_outstring(const char *string, int flush_flag);
+
 #else
 /* Linux part*/
 
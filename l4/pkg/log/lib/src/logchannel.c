@@ -12,6 +12,7 @@
  */
 
 #include <l4/sys/types.h>
+#include <string.h>
 #include "log_comm.h"
 #include "internal.h"
 #include <l4/log/l4log.h>
@@ -127,3 +128,76 @@ int LOG_channel_close(int id)
   
   return ret;
 }
+
+/* Client output ring, allocated by LOG_ring_open() in logring.c. */
+log_ring_t *log_ring;
+int log_ring_id = -1;
+
+#ifdef __USE_L4WQLOCKS__
+#include <l4/util/lock_wq.h>
+static l4util_wq_lock_queue_base_t ring_lock_queue = { NULL };
+
+#define lock_ring()   l4util_wq_lock_queue_elem_t lock;          \
+                      l4util_wq_lock_lock(&ring_lock_queue, &lock)
+#define unlock_ring() l4util_wq_lock_unlock(&ring_lock_queue, &lock)
+#else
+#define lock_ring()   do {} while(0)
+#define unlock_ring() do {} while(0)
+#endif
+
+/*!\brief Append a string to the output ring
+ *
+ * \param string	zero-terminated string
+ * \param flush_flag	flush at the logserver after the string was drained
+ *
+ * \retval 0		string is in the ring
+ * \retval -L4_ENOMEM	ring is full, nothing appended
+ *
+ * No IPC is done unless the fill level crosses the high watermark or
+ * flushing is requested.
+ */
+int LOG_ring_outstring(const char *string, int flush_flag)
+{
+  log_ring_t *r = log_ring;
+  char *data = LOG_RING_DATA(r);
+  unsigned len = strlen(string) + 1;
+  unsigned head, fill, i;
+  int kick = 0;
+  CORBA_Environment env = dice_default_environment;
+
+  lock_ring();
+
+  head = r->head;
+  fill = LOG_RING_FILL(r);
+  if (fill + len >= LOG_RING_DATA_SIZE)
+    {
+      r->lost++;
+      unlock_ring();
+      return -L4_ENOMEM;
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      data[head++] = string[i];
+      if (head == LOG_RING_DATA_SIZE)
+        head = 0;
+    }
+  /* make the data visible before publishing the new head */
+  __asm__ __volatile__ ("" : : : "memory");
+  r->head = head;
+
+  if (fill + len >= LOG_RING_HIGH_WATERMARK && !r->kick)
+    {
+      r->kick = 1;
+      kick = 1;
+    }
+
+  unlock_ring();
+
+  if (flush_flag)
+    log_ring_drain_call (&log_server, log_ring_id, flush_flag, &env);
+  else if (kick)
+    log_ring_kick_send (&log_server, log_ring_id, &env);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*!
+ * \file   log/lib/src/logring.c
+ * \brief  Open and close the shared output ring at the logserver
+ *
+ * \date   10/19/2026
+ *
+ * This is separate from logchannel.c because the ring is allocated at the
+ * dataspace manager. Only clients calling LOG_ring_open() need to link
+ * against dm_mem and l4rm.
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#include <l4/sys/types.h>
+#include <string.h>
+#include "log_comm.h"
+#include "internal.h"
+#include <l4/log/l4log.h>
+#include <l4/log/server.h>
+#include <l4/env/errno.h>
+#include <l4/dm_mem/dm_mem.h>
+#include <l4/l4rm/l4rm.h>
+#include "log-client.h"
+
+/*!\brief Open the shared output ring at the logserver
+ *
+ * The ring must be aligned to its size to be sent as one flexpage.
+ *
+ * \return \see ring_open(), -L4_ENOMEM if the ring cannot be allocated
+ *
+ * Marshalling:
+ * - d0/d1 fpage
+ */
+int LOG_ring_open(void)
+{
+  int ret;
+  l4_snd_fpage_t f;
+  CORBA_Environment env = dice_default_environment;
+  void *ring;
+
+  if (log_ring)
+    return 0;
+  if (check_server())
+    return -L4_ENOTFOUND;
+
+  ring = l4dm_mem_allocate_named(LOG_RING_SIZE,
+                                 L4DM_PINNED | L4RM_MAP | L4RM_LOG2_ALIGNED,
+                                 "log ring");
+  if (!ring)
+    return -L4_ENOMEM;
+
+  /* the pages are present, they must be when mapping them */
+  memset(ring, 0, LOG_RING_SIZE);
+
+  f.snd_base = 0;
+  f.fpage = l4_fpage((l4_addr_t)ring, LOG_LOG2_RING_SIZE,
+                     L4_FPAGE_RW, L4_FPAGE_MAP);
+  ret = log_ring_open_call (&log_server, f, &env);
+  if (DICE_HAS_EXCEPTION(&env))
+    ret = -DICE_IPC_ERROR(&env);
+  if (ret < 0)
+    {
+      l4dm_mem_release(ring);
+      return ret;
+    }
+
+  log_ring_id = ret;
+  log_ring = (log_ring_t*)ring;
+  return 0;
+}
+
+/*!\brief Close the shared output ring
+ *
+ * Pending output is drained by the logserver before the ring is unmapped.
+ * Further output goes via log_outstring_call() again.
+ *
+ * \return \see ring_close()
+ *
+ * Marshalling:
+ * - d1 ring id
+ */
+int LOG_ring_close(void)
+{
+  int ret;
+  CORBA_Environment env = dice_default_environment;
+  log_ring_t *ring = log_ring;
+
+  if (!ring)
+    return -L4_EINVAL;
+
+  log_ring = 0;
+  ret = log_ring_close_call (&log_server, log_ring_id, &env);
+  log_ring_id = -1;
+  l4dm_mem_release(ring);
+  if (DICE_HAS_EXCEPTION(&env))
+    return -DICE_IPC_ERROR(&env);
+
+  return ret;
+}
@@ -68,6 +68,9 @@ int check_server(void)
  *
  * Marshalling:
  * - string contains the string
+ *
+ * If the client opened an output ring using LOG_ring_open(), the string
+ * is appended to the ring without IPC.
  */
 void LOG_server_outstring(const char *string)
 {
@@ -79,6 +82,11 @@ void LOG_server_outstring(const char *string)
 
   check_server();
 
+  /* Use the shared ring if it is open and has room. If not, fall back to
+   * IPC, which lets the logserver drain the ring first. */
+  if (log_ring && LOG_ring_outstring(string, flush_flag) == 0)
+    return;
+
   err = 0;
   if (initialized)
     {
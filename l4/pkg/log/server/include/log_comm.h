@@ -32,4 +32,36 @@
 #define LOG_COMMAND_MASK		0x0000ffff
 #define LOG_COMMAND_FLAG_FLUSH		0x00010000
 
+// log2 of the size of a client output ring - 16KB
+#define LOG_LOG2_RING_SIZE (14)
+// size of a client output ring, including the ring header
+#define LOG_RING_SIZE (1<<LOG_LOG2_RING_SIZE)
+// max. number of client rings the logserver accepts
+#define LOG_MAX_RINGS 32
+
+/*!\brief Header of a client output ring
+ *
+ * The ring lives in a flexpage which is mapped from the client to the
+ * logserver. The client appends zero-terminated strings at head, the
+ * logserver consumes them from tail. Both are offsets into the data area
+ * following the header, one byte is always left free to distinguish a
+ * full from an empty ring.
+ *
+ * The client signals the logserver only if the fill level crosses
+ * LOG_RING_HIGH_WATERMARK, and only if the kick flag is not already set.
+ * The logserver resets the kick flag after draining the ring.
+ */
+typedef struct{
+    volatile unsigned head;	// producer position, written by client
+    volatile unsigned tail;	// consumer position, written by logserver
+    volatile unsigned kick;	// client sent a drain request
+    volatile unsigned lost;	// nr of strings the client could not append
+} log_ring_t;
+
+#define LOG_RING_DATA_SIZE	(LOG_RING_SIZE - sizeof(log_ring_t))
+#define LOG_RING_HIGH_WATERMARK	(LOG_RING_DATA_SIZE / 4 * 3)
+#define LOG_RING_DATA(r)	((char*)((r)+1))
+#define LOG_RING_FILL(r)	(((r)->head + LOG_RING_DATA_SIZE - (r)->tail) \
+				 % LOG_RING_DATA_SIZE)
+
 #endif
@@ -49,6 +49,9 @@
 //! Set CONFIG_LOG_IPC to log the IPCs between the logserver's threads.
 #define CONFIG_LOG_IPC		0
 
+//! Set CONFIG_LOG_RING to log activities on the client output rings.
+#define CONFIG_LOG_RING		0
+
 //! Set CONFIG_LOG_NOTICE if you want state-information (recommended).
 #define CONFIG_LOG_NOTICE	1
 
@@ -0,0 +1,81 @@
+/*!
+ * \file	log/server/src/events.c
+ * \brief	Log-Server, listen for exit events at the events server
+ *
+ * \date	10/19/2026
+ *
+ * The output rings of clients that exit without closing them are released
+ * on their exit event. The release itself is done by the main thread, which
+ * owns the ring slots, so we call it using the ring_reclaim IPC.
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#include <l4/sys/types.h>
+#include <l4/events/events.h>
+#include <l4/log/l4log.h>
+#include <l4/util/l4_macros.h>
+#include <l4/util/util.h>
+
+#include "config.h"
+#include "stuff.h"
+#include "flusher.h"
+#include "events.h"
+#include "log-client.h"
+
+//! Priority of the events thread when registering at the events server
+#define EVENTS_THREAD_PRIO	0x20
+
+/*!\brief Event thread: wait for exit events and reclaim the client rings
+ */
+static void events_thread(void){
+    l4events_ch_t event_ch = L4EVENTS_EXIT_CHANNEL;
+    l4events_nr_t event_nr = L4EVENTS_NO_NR;
+    l4events_event_t event;
+
+    if(!l4events_init()){
+	LOG_Error("No events server, rings of dead clients are not released");
+	l4_sleep_forever();
+    }
+    l4events_register(event_ch, EVENTS_THREAD_PRIO);
+
+    while(1){
+	CORBA_Environment env = dice_default_environment;
+	l4_threadid_t tid;
+	long res;
+
+	res = l4events_give_ack_and_receive(&event_ch, &event, &event_nr,
+					    L4_IPC_NEVER, L4EVENTS_RECV_ACK);
+	if(res != L4EVENTS_OK){
+	    LOGd(CONFIG_LOG_RING, "Got bad event (result=%ld)", res);
+	    continue;
+	}
+
+	tid = *(l4_threadid_t*)event.str;
+	LOGd(CONFIG_LOG_RING, "Got exit event for "l4util_idfmt,
+	     l4util_idstr(tid));
+
+	log_ring_reclaim_call(&main_thread, &tid, &env);
+	if(DICE_HAS_EXCEPTION(&env))
+	    LOG_Error("calling the main thread returned %#x",
+		      DICE_IPC_ERROR(&env));
+    }
+}
+
+/*!\brief Start the events thread.
+ *
+ * Context: Main thread, after flusher_init().
+ *
+ * \retval	0 on success, error otherwise.
+ */
+int events_init(void){
+    int err;
+
+    err = thread_create(events_thread, NULL, "log.events");
+    if(err){
+	LOG_Error("Error %#x creating events thread.", err);
+    }
+    return err;
+}
@@ -0,0 +1,18 @@
+/*!
+ * \file	log/server/src/events.h
+ * \brief	Log-Server, listen for exit events at the events server
+ *
+ * \date	10/19/2026
+ *
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#ifndef __LOG_SERVER_SRC_EVENTS_H_
+#define __LOG_SERVER_SRC_EVENTS_H_
+
+extern int events_init(void);
+
+#endif
@@ -43,6 +43,8 @@
 #include "tcpip.h"
 #include "flusher.h"
 #include "stuff.h"
+#include "ring.h"
+#include "log-client.h"
 
 #if CONFIG_USE_TCPIP==0
 const unsigned client_socket=0;
@@ -287,7 +289,8 @@ int flush_buffer(void){
 /*!\brief flush-signaller - request flushing
  *
  * This function runs at a very low priority, and requests flushing the
- * buffer, if it is non-empty.
+ * buffer, if it is non-empty. It also asks the main thread to drain the
+ * client rings if they contain data. Clients only signal a full ring.
  *
  * \pre main_thread and flusher_thread must be set.
  */
@@ -302,6 +305,10 @@ static void flush_signaller(void){
      * end of the running queue. */
     rmgr_set_prio(l4_myself(), 2);
     while(1){
+	if(ring_pending()){
+	    CORBA_Environment env = dice_default_environment;
+	    log_ring_kick_send(&main_thread, -1, &env);
+	}
 	if(buffer_head!=buffer_tail){
 	    flush_buffer();
 	}
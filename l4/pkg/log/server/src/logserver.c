@@ -32,6 +32,7 @@
 #include <l4/log/l4log.h>
 #include <l4/util/parse_cmd.h>
 #include <l4/util/l4_macros.h>
+#include <l4/env/errno.h>
 
 #include "../include/log_comm.h"
 #include "stuff.h"
@@ -39,6 +40,8 @@
 #include "tcpip.h"
 #include "config.h"
 #include "muxed.h"
+#include "ring.h"
+#include "events.h"
 #include "log-server.h"
 
 int	verbose=0;
@@ -66,6 +69,7 @@ int	flush_muxed=1;		/* should we use multiplexed mode on
 #endif
 
 int prio = 0x20;
+static int use_events;
 
 char buffer_array[OUTPUT_BUFFER_SIZE];
 
@@ -181,23 +185,33 @@ static void parse_args(int argc, const char**argv){
 		  PARSE_CMD_INT, 0x20, &flusher_prio,
 		  'p', "prio", "priority of main thread",
 		  PARSE_CMD_INT, 0x20, &prio,
+		  ' ', "events", "release rings of clients on exit events",
+		  PARSE_CMD_SWITCH, 1, &use_events,
 		  0);
 
 }
 
-void
-log_outstring_component (CORBA_Object _dice_corba_obj,
-    int flush_flag,
-    const char* str,
-    CORBA_Server_Environment *_dice_corba_env)
-{
+/* Print a string received from a client, either via IPC or via its ring */
+static void print_client(l4_threadid_t client, const char*str){
     if (verbose && str && str[0])
     {
       char buf[10];
-      sprintf(buf, l4util_idfmt_adjust":", l4util_idstr(*_dice_corba_obj));
+      sprintf(buf, l4util_idfmt_adjust":", l4util_idstr(client));
       print_buffered(buf);
     }
     print_buffered(str);
+}
+
+void
+log_outstring_component (CORBA_Object _dice_corba_obj,
+    int flush_flag,
+    const char* str,
+    CORBA_Server_Environment *_dice_corba_env)
+{
+    /* The client falls back to IPC if its ring is full, print the ring
+       contents first to keep the order. */
+    ring_drain_client(*_dice_corba_obj, print_client);
+    print_client(*_dice_corba_obj, str);
     if(flush_flag ||
 	strstr(message_buffer, "***"))
 	flush_buffer();
@@ -256,6 +270,68 @@ log_channel_close_component (CORBA_Object _dice_corba_obj,
 #endif
 }
 
+int
+log_ring_open_component (CORBA_Object _dice_corba_obj,
+    l4_snd_fpage_t page,
+    CORBA_Server_Environment *_dice_corba_env)
+{
+#if CONFIG_USE_TCPIP
+    /* the receive window is used for the binary channels */
+    return -L4_ENOMAP;
+#else
+    int ret = ring_open(*_dice_corba_obj, page.fpage);
+    _dice_corba_env->rcv_fpage = ring_get_next_fpage();
+    return ret;
+#endif
+}
+
+int
+log_ring_drain_component (CORBA_Object _dice_corba_obj,
+    int ring,
+    int flush_flag,
+    CORBA_Server_Environment *_dice_corba_env)
+{
+    int ret = ring_drain(*_dice_corba_obj, ring, print_client);
+    if(flush_flag)
+	flush_buffer();
+    return ret;
+}
+
+void
+log_ring_kick_component (CORBA_Object _dice_corba_obj,
+    int ring,
+    CORBA_Server_Environment *_dice_corba_env)
+{
+    /* kicks from the flush-signaller drain all rings */
+    if(l4_task_equal(*_dice_corba_obj, main_thread))
+	ring_drain_all(print_client);
+    else
+	ring_drain(*_dice_corba_obj, ring, print_client);
+}
+
+int
+log_ring_close_component (CORBA_Object _dice_corba_obj,
+    int ring,
+    CORBA_Server_Environment *_dice_corba_env)
+{
+    int ret = ring_close(*_dice_corba_obj, ring, print_client);
+#if !CONFIG_USE_TCPIP
+    _dice_corba_env->rcv_fpage = ring_get_next_fpage();
+#endif
+    return ret;
+}
+
+int
+log_ring_reclaim_component (CORBA_Object _dice_corba_obj,
+    const l4_threadid_t *task,
+    CORBA_Server_Environment *_dice_corba_env)
+{
+    /* only our events thread knows about dead clients */
+    if(!l4_task_equal(*_dice_corba_obj, main_thread))
+	return -L4_EPERM;
+    return ring_reclaim(*task);
+}
+
 static void*
 msg_alloc(unsigned long size)
 {
@@ -288,6 +364,8 @@ int main(int argc, const char**argv){
     LOG_Error("Cannot register at nameserver, falling asleep\n");
     return 1;
   }
+  if(use_events)
+    events_init();
   if(verbose){
       printf("Server started and registered as \"%s\"\n",
 	      LOG_NAMESERVER_NAME);
@@ -308,7 +386,7 @@ int main(int argc, const char**argv){
 #if CONFIG_USE_TCPIP
   env.rcv_fpage = channel_get_next_fpage();
 #else
-  env.rcv_fpage.fpage = 0;
+  env.rcv_fpage = ring_get_next_fpage();
 #endif
   env.malloc = msg_alloc;
 
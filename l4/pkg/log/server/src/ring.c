@@ -0,0 +1,276 @@
+/*!
+ * \file	log/server/src/ring.c
+ * \brief	Log-Server, shared client output rings
+ *
+ * \date	10/19/2026
+ *
+ * Clients map a ring buffer to us using ring_open(), afterwards they
+ * append their output to this ring without IPC. The rings are drained by
+ * the main thread, which is triggered either by the client crossing the
+ * high watermark of its ring, by an explicit flush request of the client
+ * or by the flush-signaller thread polling the rings periodically.
+ *
+ * A ring slot is unused if its owner is L4_INVALID_ID. Slots of dead
+ * clients are reclaimed when the events thread reports their exit, or when
+ * a new incarnation of the same task opens a ring.
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#include <l4/sys/types.h>
+#include <l4/sys/syscalls.h>
+#include <l4/log/l4log.h>
+#include <l4/env/errno.h>
+#include <l4/util/l4_macros.h>
+#include <string.h>
+
+#include "../include/log_comm.h"
+#include "config.h"
+#include "ring.h"
+
+typedef struct{
+    l4_threadid_t owner;	// client the ring belongs to
+    log_ring_t    *ring;	// address of the ring header
+    unsigned      tail;		// consumer position, r->tail is only a copy
+} ring_slot_t;
+
+static ring_slot_t slots[LOG_MAX_RINGS];
+static int slots_initialized;
+
+/* receive windows for the rings, aligned to their size */
+static char ring_area[LOG_MAX_RINGS][LOG_RING_SIZE]
+  __attribute__((aligned(LOG_RING_SIZE)));
+
+static void init_slots(void){
+    int i;
+
+    for(i=0; i<LOG_MAX_RINGS; i++){
+	slots[i].owner = L4_INVALID_ID;
+	slots[i].ring  = (log_ring_t*)ring_area[i];
+    }
+    slots_initialized = 1;
+}
+
+static int next_free_slot(void){
+    int i;
+
+    if(!slots_initialized) init_slots();
+    for(i=0; i<LOG_MAX_RINGS; i++)
+	if(l4_is_invalid_id(slots[i].owner)) return i;
+    return -1;
+}
+
+/* Free a slot and unmap the ring from our receive window. Further accesses
+ * would otherwise hit memory the client may already have released. */
+static void release_slot(ring_slot_t *s){
+    s->owner = L4_INVALID_ID;
+    l4_fpage_unmap(l4_fpage((l4_addr_t)s->ring, LOG_LOG2_RING_SIZE, 0, 0),
+		   L4_FP_FLUSH_PAGE | L4_FP_ALL_SPACES);
+}
+
+/* Release the slots of earlier incarnations of the client's task, these
+ * tasks are dead. Their pending output is lost. */
+static void reclaim_stale(l4_threadid_t client){
+    int i;
+
+    for(i=0; i<LOG_MAX_RINGS; i++){
+	if(!l4_is_invalid_id(slots[i].owner) &&
+	   l4_tasknum_equal(slots[i].owner, client) &&
+	   !l4_task_equal(slots[i].owner, client)){
+	    LOGd(CONFIG_LOG_RING, "ring %d: owner "l4util_idfmt" is gone",
+		 i, l4util_idstr(slots[i].owner));
+	    release_slot(slots+i);
+	}
+    }
+}
+
+static ring_slot_t *get_slot(l4_threadid_t client, int id){
+    if(id<0 || id>=LOG_MAX_RINGS) return 0;
+    if(!l4_task_equal(slots[id].owner, client)) return 0;
+    return slots+id;
+}
+
+/*!\brief Return the receive window for the next ring_open() request.
+ *
+ * \return	fpage of a free slot, or a nil fpage if no slot is free
+ */
+l4_fpage_t ring_get_next_fpage(void){
+    int i = next_free_slot();
+
+    if(i<0) return l4_fpage(0, 0, 0, 0);
+    return l4_fpage((l4_addr_t)ring_area[i], LOG_LOG2_RING_SIZE, 0, 0);
+}
+
+/*!\brief Register a ring that was mapped to the receive window.
+ *
+ * \param client	the client that sent the fpage
+ * \param page		the fpage received
+ *
+ * \retval >=0		the ring id
+ * \retval -L4_ENOMAP	no free slot or fpage has wrong size
+ */
+int ring_open(l4_threadid_t client, l4_fpage_t page){
+    int i = next_free_slot();
+    log_ring_t *r;
+
+    /* the fpage went to slot i, so reclaim only after determining it */
+    reclaim_stale(client);
+    if(i<0 || page.fp.size != LOG_LOG2_RING_SIZE){
+	LOGd(CONFIG_LOG_RING, "ring_open: no slot or bad fpage size %d",
+	     page.fp.size);
+	return -L4_ENOMAP;
+    }
+    r = slots[i].ring;
+    if(r->head >= LOG_RING_DATA_SIZE || r->tail >= LOG_RING_DATA_SIZE){
+	LOGd(CONFIG_LOG_RING, "ring_open: ring not initialized");
+	return -L4_EINVAL;
+    }
+    slots[i].owner = client;
+    slots[i].tail  = r->tail;
+    LOGd(CONFIG_LOG_RING, "ring %d opened by "l4util_idfmt,
+	 i, l4util_idstr(client));
+    return i;
+}
+
+/* Drain one ring. Strings wrapping around the end of the ring are
+ * reassembled in a local buffer. Strings that are too long are
+ * truncated, as log_outstring() would do.
+ *
+ * The client can write the whole ring header at any time. We read head
+ * once and use our own copy of tail, so both stay within the data area. */
+static void drain_slot(ring_slot_t *s, ring_print_fn_t print){
+    log_ring_t *r = s->ring;
+    char *data = LOG_RING_DATA(r);
+    char buf[LOG_BUFFERSIZE+1];
+    unsigned head = r->head, tail = s->tail;
+    int len = 0;
+
+    if(head >= LOG_RING_DATA_SIZE){
+	/* client corrupted its ring, discard everything */
+	LOGd(CONFIG_LOG_RING, "ring %d: bad head %u, reset", s - slots, head);
+	s->tail = 0;
+	r->tail = 0;
+	r->head = 0;
+	return;
+    }
+    while(tail != head){
+	char c = data[tail++];
+
+	if(tail == LOG_RING_DATA_SIZE) tail = 0;
+	if(len < LOG_BUFFERSIZE) buf[len++] = c;
+	if(c == 0){
+	    buf[LOG_BUFFERSIZE] = 0;
+	    print(s->owner, buf);
+	    len = 0;
+	}
+    }
+    /* a partial string can only be left if the client is broken */
+    s->tail = tail;
+    r->tail = tail;
+    r->kick = 0;
+    if(r->lost){
+	LOGd(CONFIG_LOG_RING, "ring %d: %d strings sent via IPC",
+	     s - slots, r->lost);
+	r->lost = 0;
+    }
+}
+
+/*!\brief Drain the ring with the given id.
+ *
+ * \retval 0		success
+ * \retval -L4_EINVAL	id does not denote a ring of the client
+ */
+int ring_drain(l4_threadid_t client, int id, ring_print_fn_t print){
+    ring_slot_t *s = get_slot(client, id);
+
+    if(!s) return -L4_EINVAL;
+    drain_slot(s, print);
+    return 0;
+}
+
+/*!\brief Drain all rings of a client.
+ *
+ * Used prior to printing output a client sent via IPC, to keep the order.
+ *
+ * \return	number of drained rings
+ */
+int ring_drain_client(l4_threadid_t client, ring_print_fn_t print){
+    int i, n=0;
+
+    if(!slots_initialized) return 0;
+    for(i=0; i<LOG_MAX_RINGS; i++){
+	if(l4_task_equal(slots[i].owner, client)){
+	    drain_slot(slots+i, print);
+	    n++;
+	}
+    }
+    return n;
+}
+
+/*!\brief Drain the rings of all clients. */
+void ring_drain_all(ring_print_fn_t print){
+    int i;
+
+    if(!slots_initialized) return;
+    for(i=0; i<LOG_MAX_RINGS; i++)
+	if(!l4_is_invalid_id(slots[i].owner))
+	    drain_slot(slots+i, print);
+}
+
+/*!\brief Check if some ring contains data.
+ *
+ * Context: flush-signaller thread. We only read the ring headers.
+ */
+int ring_pending(void){
+    int i;
+
+    if(!slots_initialized) return 0;
+    for(i=0; i<LOG_MAX_RINGS; i++){
+	log_ring_t *r = slots[i].ring;
+
+	if(!l4_is_invalid_id(slots[i].owner) && r->head != slots[i].tail)
+	    return 1;
+    }
+    return 0;
+}
+
+/*!\brief Drain and unmap a ring.
+ *
+ * \retval 0		success
+ * \retval -L4_EINVAL	id does not denote a ring of the client
+ */
+int ring_close(l4_threadid_t client, int id, ring_print_fn_t print){
+    ring_slot_t *s = get_slot(client, id);
+
+    if(!s) return -L4_EINVAL;
+    drain_slot(s, print);
+    release_slot(s);
+    LOGd(CONFIG_LOG_RING, "ring %d closed", id);
+    return 0;
+}
+
+/*!\brief Release all rings of a task that exited.
+ *
+ * The rings are not drained, the client's memory may be gone already.
+ *
+ * \param task		the task, only the task number is evaluated
+ *
+ * \return	number of released rings
+ */
+int ring_reclaim(l4_threadid_t task){
+    int i, n=0;
+
+    if(!slots_initialized) return 0;
+    for(i=0; i<LOG_MAX_RINGS; i++){
+	if(!l4_is_invalid_id(slots[i].owner) &&
+	   l4_tasknum_equal(slots[i].owner, task)){
+	    release_slot(slots+i);
+	    n++;
+	}
+    }
+    if(n) LOGd(CONFIG_LOG_RING, "released %d rings of "l4util_idfmt,
+	       n, l4util_idstr(task));
+    return n;
+}
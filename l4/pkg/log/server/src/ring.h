@@ -0,0 +1,29 @@
+/*!
+ * \file	log/server/src/ring.h
+ * \brief	Log-Server, shared client output rings
+ *
+ * \date	10/19/2026
+ *
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#ifndef __LOG_SERVER_SRC_RING_H_
+#define __LOG_SERVER_SRC_RING_H_
+
+#include <l4/sys/types.h>
+
+typedef void (*ring_print_fn_t)(l4_threadid_t client, const char *str);
+
+extern l4_fpage_t ring_get_next_fpage(void);
+extern int ring_open(l4_threadid_t client, l4_fpage_t page);
+extern int ring_drain(l4_threadid_t client, int id, ring_print_fn_t print);
+extern int ring_drain_client(l4_threadid_t client, ring_print_fn_t print);
+extern void ring_drain_all(ring_print_fn_t print);
+extern int ring_pending(void);
+extern int ring_close(l4_threadid_t client, int id, ring_print_fn_t print);
+extern int ring_reclaim(l4_threadid_t task);
+
+#endif
@@ -17,7 +17,7 @@
 #include <l4/sys/types.h>
 
 
-#define MAXTHREADS 3	/* max number of thread to be created by the
+#define MAXTHREADS 4	/* max number of thread to be created by the
 			 * logserver thread lib. */
 
 /*!\brief Connection descriptor
@@ -21,7 +21,7 @@ int main(int argc, char**argv)
   l4_threadid_t id;
   int i;
 
-  for(i=0;i<NAMES_MAX_ENTRIES; i++)
+  for(i=0;i<NAMES_MAX_ENTRIES_LIMIT; i++)
     if (names_query_nr(i, name, sizeof(name), &id))
       printf(l4util_idfmt": %s\n", l4util_idstr(id), name);
 
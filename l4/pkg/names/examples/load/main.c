@@ -0,0 +1,103 @@
+/*!
+ * \file   names/examples/load/main.c
+ * \brief  Register and resolve many names to measure names performance
+ *
+ * \date   10/19/2026
+ *
+ * Registers NUM_NAMES names, which makes names grow its entry table beyond
+ * NAMES_MAX_ENTRIES, resolves them one by one and batched, queries the
+ * names by thread ID and unregisters everything again.
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#include <stdio.h>
+
+#include <l4/sys/types.h>
+#include <l4/sys/syscalls.h>
+#include <l4/util/rdtsc.h>
+#include <l4/util/l4_macros.h>
+
+#include <l4/names/libnames.h>
+
+#define NUM_NAMES	10000
+
+static char names[NUM_NAMES][NAMES_MAX_NAME_LEN + 1];
+static const char *name_ptrs[NUM_NAMES];
+static l4_threadid_t ids[NUM_NAMES];
+
+static l4_cpu_time_t start;
+
+static void
+start_timer(void)
+{
+  start = l4_rdtsc();
+}
+
+static void
+stop_timer(const char *what, int ops)
+{
+  l4_uint64_t ns = l4_tsc_to_ns(l4_rdtsc() - start);
+
+  printf("%-20s %6d ops %8u us %6u ns/op\n", what, ops,
+         (unsigned)(ns / 1000), ops ? (unsigned)(ns / ops) : 0);
+}
+
+int
+main(int argc, char* argv[])
+{
+  l4_threadid_t me = l4_myself(), id;
+  char buffer[NAMES_MAX_NAME_LEN + 1];
+  int i, ok, found;
+
+  l4_calibrate_tsc();
+
+  for (i = 0; i < NUM_NAMES; i++)
+    {
+      snprintf(names[i], sizeof(names[i]), "load.%05d", i);
+      name_ptrs[i] = names[i];
+    }
+
+  start_timer();
+  for (i = 0, ok = 0; i < NUM_NAMES; i++)
+    ok += names_register(names[i]) != 0;
+  stop_timer("register", NUM_NAMES);
+  if (ok != NUM_NAMES)
+    printf("registered only %d of %d names\n", ok, NUM_NAMES);
+
+  start_timer();
+  for (i = 0, ok = 0; i < NUM_NAMES; i++)
+    ok += names_query_name(names[i], &id) && l4_thread_equal(id, me);
+  stop_timer("query_name", NUM_NAMES);
+  if (ok != NUM_NAMES)
+    printf("query_name resolved only %d of %d names\n", ok, NUM_NAMES);
+
+  start_timer();
+  found = names_query_names(name_ptrs, ids, NUM_NAMES);
+  stop_timer("query_names", NUM_NAMES);
+  for (i = 0, ok = 0; i < NUM_NAMES; i++)
+    ok += l4_thread_equal(ids[i], me);
+  if (found != NUM_NAMES || ok != NUM_NAMES)
+    printf("query_names resolved only %d (%d) of %d names\n",
+           found, ok, NUM_NAMES);
+
+  start_timer();
+  for (i = 0; i < 1000; i++)
+    if (!names_query_id(me, buffer, sizeof(buffer)))
+      break;
+  stop_timer("query_id", i);
+
+  start_timer();
+  for (i = 0, ok = 0; i < NUM_NAMES; i++)
+    ok += names_unregister(names[i]) != 0;
+  stop_timer("unregister", NUM_NAMES);
+  if (ok != NUM_NAMES)
+    printf("unregistered only %d of %d names\n", ok, NUM_NAMES);
+
+  if (names_query_name(names[0], &id))
+    printf("%s still registered\n", names[0]);
+
+  printf("done.\n");
+  return 0;
+}
@@ -12,7 +12,14 @@
 
 /*!\brief Maximum length of a string to register with names */
 #define NAMES_MAX_NAME_LEN 32
-/*!\brief Maximum number of entries the nameserver handles */
+/*!\brief Initial number of entries the nameserver handles. The entry
+ *        table grows on demand up to ::NAMES_MAX_ENTRIES_LIMIT. */
 #define NAMES_MAX_ENTRIES 512
+/*!\brief Maximum number of entries the nameserver handles */
+#define NAMES_MAX_ENTRIES_LIMIT 16384
+/*!\brief Maximum number of names resolved by one batched query */
+#define NAMES_MAX_BATCH 32
+/*!\brief Maximum size of the name buffer of one batched query */
+#define NAMES_MAX_BATCH_LEN (NAMES_MAX_BATCH * (NAMES_MAX_NAME_LEN + 1))
 
 #endif
@@ -25,6 +25,8 @@ L4_CV int names_register_thread_weak(const char* name, l4_threadid_t id);
 L4_CV int names_unregister(const char* name);
 L4_CV int names_unregister_thread(const char* name, l4_threadid_t id);
 L4_CV int names_query_name(const char* name, l4_threadid_t* id);
+L4_CV int names_query_names(const char * const names[], l4_threadid_t ids[],
+                            int count);
 L4_CV int names_query_id(const l4_threadid_t id, char* name, const int length);
 L4_CV int names_waitfor_name(const char* name, l4_threadid_t* id, const int timeout);
 L4_CV int names_query_nr(int nr, char* name, int length, l4_threadid_t *id);
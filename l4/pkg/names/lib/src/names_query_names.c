@@ -0,0 +1,62 @@
+/*!
+ * \file   names/lib/src/names_query_names.c
+ * \brief  Implementation of names_query_names()
+ *
+ * \date   10/19/2026
+ */
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+#include <string.h>
+#include <l4/names/libnames.h>
+
+#include "names-client.h"
+#include "__libnames.h"
+
+/*!\brief Get the thread IDs registered for several names
+ * \ingroup clientapi
+ *
+ * \param  names	Array of 0-terminated names.
+ * \param  ids		Array receiving the thread IDs, L4_INVALID_ID for
+ *			names which are not registered.
+ * \param  count	Number of names.
+ *
+ * \return		Number of names found, -1 on IPC error.
+ *
+ * Up to ::NAMES_MAX_BATCH names are resolved with one request to the
+ * name service.
+ */
+int
+names_query_names(const char * const names[], l4_threadid_t ids[], int count)
+{
+  CORBA_Environment env = dice_default_environment;
+  l4_threadid_t *ns_id = names_get_ns_id();
+  char buffer[NAMES_MAX_BATCH_LEN];
+  int i, n, len, l, ret, found = 0;
+
+  if (!ns_id)
+    return -1;
+
+  for (i = 0; i < count; i += n)
+    {
+      /* pack as many names as fit into one request */
+      len = 0;
+      for (n = 0; n < NAMES_MAX_BATCH && i + n < count; n++)
+        {
+          l = strlen(names[i + n]);
+          if (l > NAMES_MAX_NAME_LEN)
+            l = NAMES_MAX_NAME_LEN;
+          memcpy(buffer + len, names[i + n], l);
+          buffer[len + l] = '\0';
+          len += l + 1;
+        }
+
+      ret = names_query_names_call(ns_id, buffer, len, ids + i, &n, &env);
+      if (DICE_HAS_EXCEPTION(&env) || n <= 0)
+        return -1;
+      found += ret;
+    }
+
+  return found;
+}
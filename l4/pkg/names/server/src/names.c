@@ -47,6 +47,8 @@ typedef struct {
   char		name[NAMES_MAX_NAME_LEN + 1];
   l4_threadid_t	id;
   int		weak;
+  int		name_next;	/* next entry in name chain or free list */
+  int		id_next;	/* next entry in task chain */
 } entry_t;
 
 #if CONFIG_EVENT
@@ -67,8 +69,16 @@ void own_output_function(const char*s);
 void parse_args(int argc, char* argv[]);
 void init_entries(void);
 
-/* this holds the registered names and thread ids */
-static entry_t entries[NAMES_MAX_ENTRIES];
+/* This holds the registered names and thread ids. The table starts with
+ * NAMES_MAX_ENTRIES entries and is doubled when full. Entries are found
+ * through two hash tables with num_entries buckets each: one hashed by
+ * name, one hashed by task number. Chains are linked by entry index, so
+ * the index of an entry (see names_query_nr()) never changes. */
+static entry_t *entries;
+static int num_entries;
+static int *name_hash;
+static int *id_hash;
+static int free_entry = -1;	/* head of free list */
 
 /* runtime debug level */
 static int verbosity = 0;
@@ -107,6 +117,158 @@ kernel_register_thread_name(l4_threadid_t id, const char *name)
     fiasco_register_thread_name(id, name);
 }
 
+static inline unsigned
+hash_name(const char *name)
+{
+  unsigned h = 2166136261U;
+  int i;
+
+  /* FNV-1a */
+  for (i = 0; i < NAMES_MAX_NAME_LEN && name[i]; i++)
+    h = (h ^ (unsigned char)name[i]) * 16777619U;
+
+  return h & (num_entries - 1);
+}
+
+static inline unsigned
+hash_id(l4_threadid_t id)
+{
+  /* entries of one task share a chain for unregister_task */
+  return (id.id.task * 2654435761U) & (num_entries - 1);
+}
+
+static void
+hash_entry(int i)
+{
+  unsigned h;
+
+  h = hash_name(entries[i].name);
+  entries[i].name_next = name_hash[h];
+  name_hash[h] = i;
+
+  h = hash_id(entries[i].id);
+  entries[i].id_next = id_hash[h];
+  id_hash[h] = i;
+}
+
+/* Unlink entry from both chains and put it onto the free list. */
+static void
+free_entry_slot(int i)
+{
+  int *p;
+
+  for (p = &name_hash[hash_name(entries[i].name)]; *p != i;
+       p = &entries[*p].name_next)
+    ;
+  *p = entries[i].name_next;
+
+  for (p = &id_hash[hash_id(entries[i].id)]; *p != i;
+       p = &entries[*p].id_next)
+    ;
+  *p = entries[i].id_next;
+
+  kernel_register_thread_name(entries[i].id, " (deleted)");
+  entries[i].id = L4_INVALID_ID;
+  entries[i].name[0] = '\0';
+  entries[i].name_next = free_entry;
+  free_entry = i;
+}
+
+/* (Re)build hash tables and free list for n entries. The first
+ * num_entries entries are kept. */
+static int
+resize_entries(int n)
+{
+  entry_t *e;
+  int *nh, *ih;
+  int i;
+
+  e  = realloc(entries, n * sizeof(entry_t));
+  nh = malloc(n * sizeof(int));
+  ih = malloc(n * sizeof(int));
+  if (!e || !nh || !ih)
+    {
+      if (e)
+        entries = e;
+      free(nh);
+      free(ih);
+      return 0;
+    }
+
+  for (i = num_entries; i < n; i++)
+    {
+      e[i].id = L4_INVALID_ID;
+      e[i].name[0] = '\0';
+    }
+
+  free(name_hash);
+  free(id_hash);
+  entries     = e;
+  name_hash   = nh;
+  id_hash     = ih;
+  num_entries = n;
+
+  for (i = 0; i < n; i++)
+    name_hash[i] = id_hash[i] = -1;
+
+  free_entry = -1;
+  for (i = n - 1; i >= 0; i--)
+    {
+      if (l4_is_invalid_id(entries[i].id))
+        {
+          entries[i].name_next = free_entry;
+          free_entry = i;
+        }
+      else
+        hash_entry(i);
+    }
+
+  return 1;
+}
+
+/* Find entry by name, prefer the non-weak entry, otherwise return the
+ * first matching weak entry. */
+static int
+lookup_name(const char *name)
+{
+  int i, w = -1;
+
+  for (i = name_hash[hash_name(name)]; i != -1; i = entries[i].name_next)
+    {
+      if (strcmp(entries[i].name, name))
+        continue;
+      /* remember weak entry, but look further */
+      if (!entries[i].weak)
+        return i;
+      if (w == -1 || i < w)
+        w = i;
+    }
+
+  return w;
+}
+
+/* Find entry by thread id, prefer the first non-weak entry. */
+static int
+lookup_id(l4_threadid_t id)
+{
+  int i, s = -1, w = -1;
+
+  for (i = id_hash[hash_id(id)]; i != -1; i = entries[i].id_next)
+    {
+      if (!l4_thread_equal(entries[i].id, id))
+        continue;
+      if (entries[i].weak)
+        {
+          if (w == -1 || i < w)
+            w = i;
+        }
+      else if (s == -1 || i < s)
+        s = i;
+    }
+
+  return s != -1 ? s : w;
+}
+
 /*!\brief Register a new thread
  *
  * The string in msg->string.rcv_str needs not to be 0-terminated! Its
@@ -125,24 +287,26 @@ server_names_register(l4_threadid_t *client,
            l4util_idstr(*client), __func__, l4util_idstr(*id),
            NAMES_MAX_NAME_LEN, name);
 
-  for (i = 0; i < NAMES_MAX_ENTRIES; i++)
-    if (!weak && !entries[i].weak &&
-        !strcmp(entries[i].name, name))
-      return 0;
-
-  for (i = 0; i < NAMES_MAX_ENTRIES; i++)
-    if (l4_is_invalid_id(entries[i].id))
-      break;
+  if (!weak)
+    for (i = name_hash[hash_name(name)]; i != -1; i = entries[i].name_next)
+      if (!entries[i].weak && !strcmp(entries[i].name, name))
+        return 0;
 
-  if (i == NAMES_MAX_ENTRIES) {
+  if (free_entry == -1 &&
+      (num_entries >= NAMES_MAX_ENTRIES_LIMIT ||
+       !resize_entries(num_entries * 2))) {
     printf("names: nameserver full\n");
     return 0;
   }
 
+  i = free_entry;
+  free_entry = entries[i].name_next;
+
   entries[i].id = *id;
   entries[i].weak = weak;
   strncpy(entries[i].name, name, NAMES_MAX_NAME_LEN);
   entries[i].name[NAMES_MAX_NAME_LEN] = 0;
+  hash_entry(i);
   kernel_register_thread_name(entries[i].id, name);
 
   if(use_logserver && !strcmp(entries[i].name, logserver_name)){
@@ -178,7 +342,7 @@ names_unregister_thread_component(CORBA_Object _dice_corba_obj,
                                   const l4_threadid_t *id,
                                   CORBA_Server_Environment *_dice_corba_env)
 {
-  int i, ret = 0;
+  int i, next, ret = 0;
 
   if (use_logserver && l4_thread_equal(logserver_id, *_dice_corba_obj)) {
     /* we must not use the logserver any longer */
@@ -191,13 +355,11 @@ names_unregister_thread_component(CORBA_Object _dice_corba_obj,
            l4util_idstr(*_dice_corba_obj), __func__, l4util_idstr(*id),
            NAMES_MAX_NAME_LEN, name);
 
-  for (i = 0; i < NAMES_MAX_ENTRIES; i++) {
+  for (i = name_hash[hash_name(name)]; i != -1; i = next) {
+    next = entries[i].name_next;
     if (l4_thread_equal(entries[i].id, *id)
         && (!strcmp(entries[i].name, name))) {
-
-      kernel_register_thread_name(entries[i].id, " (deleted)");
-      entries[i].id = L4_INVALID_ID;
-      entries[i].name[0] = '\0';
+      free_entry_slot(i);
       ret = 1;
     }
   }
@@ -211,7 +373,7 @@ names_query_name_component(CORBA_Object _dice_corba_obj,
                            l4_threadid_t *id,
                            CORBA_Server_Environment *_dice_corba_env)
 {
-  int i, w = -1;
+  int i;
 
   DEBUGMSG(2)
     printf(l4util_idfmt ": %s(\"%.*s\")\n",
@@ -221,25 +383,11 @@ names_query_name_component(CORBA_Object _dice_corba_obj,
   if (!name)
     return 0;
 
-  for (i = 0; i < NAMES_MAX_ENTRIES; i++) {
-    if (!strcmp(entries[i].name, name)) {
-      /* remember weak entry, but look further */
-      if (entries[i].weak == 1) {
-        if (w == -1)
-          w = i;
-      } else
-        break;
-    }
-  }
-  if (i == NAMES_MAX_ENTRIES) {
-    if (w == -1) {
-      DEBUGMSG(2)
-	printf("%s: name \"%.*s\" not found\n", __func__,
-	    NAMES_MAX_NAME_LEN, name);
-      return 0;
-    }
-    /* fall back to first matching weak */
-    i = w;
+  if ((i = lookup_name(name)) == -1) {
+    DEBUGMSG(2)
+      printf("%s: name \"%.*s\" not found\n", __func__,
+	  NAMES_MAX_NAME_LEN, name);
+    return 0;
   }
 
   *id = entries[i].id;
@@ -256,30 +404,15 @@ names_query_id_component(CORBA_Object _dice_corba_obj,
                          char **name,
                          CORBA_Server_Environment *_dice_corba_env)
 {
-  int i, w = -1;
+  int i;
 
   DEBUGMSG(2)
     printf(l4util_idfmt ": %s(" l4util_idfmt ")\n",
            l4util_idstr(*_dice_corba_obj), __func__, l4util_idstr(*id));
 
-  for (i = 0; i < NAMES_MAX_ENTRIES; i++) {
-    if (l4_thread_equal(entries[i].id, *id)) {
-      /* remember weak entry, but look further */
-      if (entries[i].weak == 1) {
-        if (w == -1)
-          w = i;
-      } else
-        break;
-    }
-  }
-
-  if (i == NAMES_MAX_ENTRIES) {
-    if (w == -1) {
-      *name = 0;
-      return 0;
-    }
-    /* fall back to first matching weak */
-    i = w;
+  if ((i = lookup_id(*id)) == -1) {
+    *name = 0;
+    return 0;
   }
 
   /* Content copied by IDL code */
@@ -288,6 +421,43 @@ names_query_id_component(CORBA_Object _dice_corba_obj,
   return 1;
 }
 
+long
+names_query_names_component(CORBA_Object _dice_corba_obj,
+                            const char *names,
+                            int len,
+                            l4_threadid_t ids[NAMES_MAX_BATCH],
+                            int *count,
+                            CORBA_Server_Environment *_dice_corba_env)
+{
+  int n, i, l, off = 0, found = 0;
+
+  DEBUGMSG(2)
+    printf(l4util_idfmt ": %s(%d)\n",
+           l4util_idstr(*_dice_corba_obj), __func__, *count);
+
+  if (len > NAMES_MAX_BATCH_LEN)
+    len = NAMES_MAX_BATCH_LEN;
+
+  for (n = 0; n < *count && n < NAMES_MAX_BATCH && off < len; n++) {
+    /* names must be 0-terminated within the buffer */
+    for (l = 0; off + l < len && names[off + l]; l++)
+      ;
+    if (off + l == len)
+      break;
+
+    if ((i = lookup_name(names + off)) == -1)
+      ids[n] = L4_INVALID_ID;
+    else {
+      ids[n] = entries[i].id;
+      found++;
+    }
+    off += l + 1;
+  }
+
+  *count = n;
+  return found;
+}
+
 /** Query the entry of the given number.
  *
  * \return	cmd==1 -> entry valid, cmd==0->entry invalid
@@ -303,7 +473,7 @@ names_query_nr_component (CORBA_Object _dice_corba_obj,
     printf(l4util_idfmt ": %s(%d)\n",
            l4util_idstr(*_dice_corba_obj), __func__, nr);
 
-  if (nr >= NAMES_MAX_ENTRIES || l4_is_invalid_id(entries[nr].id))
+  if (nr < 0 || nr >= num_entries || l4_is_invalid_id(entries[nr].id))
     return 0;
 
   *id = entries[nr].id;
@@ -318,22 +488,21 @@ names_unregister_task_component (CORBA_Object _dice_corba_obj,
                                  const l4_threadid_t *id,
                                  CORBA_Server_Environment *_dice_corba_env)
 {
-  int i;
+  int i, next;
 
   DEBUGMSG(1)
     printf(l4util_idfmt ": %s(" l4util_idfmt ")\n",
            l4util_idstr(*_dice_corba_obj), __func__, l4util_idstr(*id));
 
-  for (i = 0; i < NAMES_MAX_ENTRIES; i++)
+  for (i = id_hash[hash_id(*id)]; i != -1; i = next) {
+    next = entries[i].id_next;
     // We could/should use l4_task_equal here but often it is not possible
     // for a client to determine the exact task id (especially the field
     // version_id) since often the user simply wants to kill task xyz with
     // xyz specifying the task number using an Integer.
-    if (l4_tasknum_equal(entries[i].id, *id)) {
-      kernel_register_thread_name(entries[i].id, " (deleted)");
-      entries[i].id = L4_INVALID_ID;
-      entries[i].name[0] = '\0';
-    }
+    if (l4_tasknum_equal(entries[i].id, *id))
+      free_entry_slot(i);
+  }
 
   // always return success
   return 1;
@@ -349,18 +518,20 @@ names_dump_component(CORBA_Object _dice_corba_obj,
    * We need to keep track of all the names we already found, so we don't
    * display them twice.
    */
-  l4_uint32_t found_bits[NAMES_MAX_ENTRIES / 8 + 1];
+  l4_uint32_t *found_bits;
   l4_threadid_t t = L4_NIL_ID;
   int idx;
 
-  memset(found_bits, 0, NAMES_MAX_ENTRIES / 8 + 1);
+  found_bits = calloc(num_entries / 32 + 1, sizeof(l4_uint32_t));
+  if (!found_bits)
+    return;
   printf("dumping names server:\n");
 
   do {
 	  int dist = (1 << 20);
 	  idx = -1;
 	  /* For all entries (except 1st), determine the distance to the last found entry. */
-	  for (i = 0; i < NAMES_MAX_ENTRIES; ++i) {
+	  for (i = 0; i < num_entries; ++i) {
 		  /* Skip entries, if they are
 		   *   - invalid (trivial), or
 		   *   - we already found this entry. This may occur if we get a
@@ -387,16 +558,17 @@ names_dump_component(CORBA_Object _dice_corba_obj,
 				 l4util_idstr(entries[idx].id), entries[idx].name);
 	  }
   } while (idx > -1);
+
+  free(found_bits);
 }
 
 void
 init_entries(void)
 {
-  int i = NAMES_MAX_ENTRIES;
-  while (i--) {
-    entries[i].id = L4_INVALID_ID;
-    entries[i].name[0] = '\0';
-  };
+  if (!resize_entries(NAMES_MAX_ENTRIES)) {
+    printf("names: no memory for %d entries\n", NAMES_MAX_ENTRIES);
+    enter_kdebug("names");
+  }
 }
 
 void
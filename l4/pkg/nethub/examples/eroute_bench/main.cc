@@ -0,0 +1,216 @@
+/*
+ * (c) 2026 Technische Universitaet Dresden
+ *
+ * This file is part of the nethub package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*
+ * Eroute lookup benchmark, runs as a Linux program.
+ *
+ * Builds eroute tables of different sizes with random prefixes, generates
+ * a synthetic packet trace and classifies it with the linear first-match
+ * walk the server used before and with Eroute_trie.  Both must return the
+ * same eroute for every packet.
+ */
+
+#include "eroute_trie.h"
+
+#include <sys/time.h>
+#include <cstdio>
+#include <cstdlib>
+
+enum
+{
+  Num_ifaces  = 4,
+  Trace_len   = 1 << 18,
+  Rounds      = 4,
+};
+
+/* same matching rules as Eroute in sadb.h */
+struct Route
+{
+  u32 src_if;
+  u32 d_mask;
+  u32 d_addr;
+  u32 s_mask;
+  u32 s_addr;
+  u64 sel_mask;
+  u64 selector;
+  u8  protocol;
+  u32 seq;
+
+  Route *c_chain;
+  Route *t_chain;
+
+  bool matches(u32 sif, u32 daddr, u32 saddr,
+               u64 _selector, u8 _protocol ) const
+  {
+    return (src_if==(u32)-1 || src_if == sif) &&
+           !((d_addr ^ daddr) & d_mask) &&
+           !((s_addr ^ saddr) & s_mask) &&
+           !((selector ^ _selector) & sel_mask) &&
+           (protocol==0 || protocol == _protocol);
+  }
+
+  Route **trie_chain() { return &t_chain; }
+};
+
+struct Packet
+{
+  u32 iface;
+  u32 daddr;
+  u32 saddr;
+  u8  proto;
+};
+
+static u32 rnd_state = 0x2545f491;
+
+static u32 rnd()
+{
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return rnd_state;
+}
+
+static u32 prefix_mask(unsigned len)
+{ return Net::h_to_n(len ? (u32)(~0UL << (32 - len)) : 0); }
+
+static void make_route(Route *r)
+{
+  unsigned len = 8 + rnd() % 25;
+  u32 mask = prefix_mask(len);
+
+  r->src_if   = (rnd() % 3) ? rnd() % Num_ifaces : (u32)-1;
+  r->d_mask   = mask;
+  r->d_addr   = rnd() & mask;
+  r->s_mask   = (rnd() % 4) ? 0 : prefix_mask(16);
+  r->s_addr   = rnd() & r->s_mask;
+  r->sel_mask = 0;
+  r->selector = 0;
+  r->protocol = (rnd() % 4) ? 0 : 50;
+  r->c_chain  = 0;
+  r->t_chain  = 0;
+}
+
+/* Most packets hit one of the eroutes, the rest is random. */
+static void make_trace(Packet *t, Route *routes, unsigned n)
+{
+  for (unsigned i = 0; i < Trace_len; ++i)
+    {
+      Route *r = &routes[rnd() % n];
+      if (rnd() % 8)
+        {
+          t[i].daddr = r->d_addr | (rnd() & ~r->d_mask);
+          t[i].saddr = r->s_addr | (rnd() & ~r->s_mask);
+        }
+      else
+        {
+          t[i].daddr = rnd();
+          t[i].saddr = rnd();
+        }
+      t[i].iface = rnd() % Num_ifaces;
+      t[i].proto = (rnd() % 2) ? 50 : 6;
+    }
+}
+
+static Route *linear_get(Route *first, Packet const &p)
+{
+  Route *r = first;
+  while (r && !r->matches(p.iface, p.daddr, p.saddr, 0, p.proto))
+    r = r->c_chain;
+
+  return r;
+}
+
+static double now()
+{
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void report(char const *what, unsigned n, double t, unsigned hits)
+{
+  printf("%-6s %5u eroutes: %8.0f klookups/s (%u hits)\n", what, n,
+         Rounds * (double)Trace_len / t / 1000, hits / Rounds);
+}
+
+static void bench(unsigned n, Packet *trace)
+{
+  Route *routes = new Route[n];
+  Route *first = 0;
+  Eroute_trie<Route> trie;
+
+  for (unsigned i = 0; i < n; ++i)
+    {
+      make_route(&routes[i]);
+      routes[i].c_chain = first;
+      first = &routes[i];
+      trie.add(&routes[i]);
+    }
+
+  make_trace(trace, routes, n);
+
+  unsigned errors = 0;
+  for (unsigned i = 0; i < Trace_len; ++i)
+    {
+      Packet const &p = trace[i];
+      if (linear_get(first, p) != trie.get(p.iface, p.daddr, p.saddr, 0, p.proto))
+        ++errors;
+    }
+
+  unsigned hits = 0;
+  double t = now();
+  for (unsigned k = 0; k < Rounds; ++k)
+    for (unsigned i = 0; i < Trace_len; ++i)
+      hits += linear_get(first, trace[i]) != 0;
+  report("linear", n, now() - t, hits);
+
+  hits = 0;
+  t = now();
+  for (unsigned k = 0; k < Rounds; ++k)
+    for (unsigned i = 0; i < Trace_len; ++i)
+      {
+        Packet const &p = trace[i];
+        hits += trie.get(p.iface, p.daddr, p.saddr, 0, p.proto) != 0;
+      }
+  report("trie", n, now() - t, hits);
+
+  // remove every other eroute again, the index must follow
+  for (unsigned i = 0; i < n; i += 2)
+    trie.del(&routes[i]);
+  Route **r = &first;
+  while (*r)
+    if ((*r - routes) % 2 == 0)
+      *r = (*r)->c_chain;
+    else
+      r = &(*r)->c_chain;
+
+  for (unsigned i = 0; i < Trace_len; ++i)
+    {
+      Packet const &p = trace[i];
+      if (linear_get(first, p) != trie.get(p.iface, p.daddr, p.saddr, 0, p.proto))
+        ++errors;
+    }
+
+  if (errors)
+    printf("ERROR: %u lookups differ\n", errors);
+
+  trie.flush();
+  delete [] routes;
+}
+
+int main(void)
+{
+  static unsigned const sizes[] = { 8, 64, 512, 4096 };
+  Packet *trace = new Packet[Trace_len];
+
+  for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    bench(sizes[i], trace);
+
+  delete [] trace;
+  return 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * (c) 2026 Technische Universitaet Dresden
+ *
+ * This file is part of the nethub package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef L4_NH_EROUTE_TRIE_H__
+#define L4_NH_EROUTE_TRIE_H__
+
+#include "types.h"
+#include "net.h"
+
+/**
+ * Lookup structure for eroutes.
+ *
+ * There is one binary trie on the destination prefix per source interface
+ * and one for eroutes matching any interface.  Each node keeps the eroutes
+ * with exactly that destination prefix, newest first.  The remaining
+ * fields (source, selector, protocol) are checked with matches() on the
+ * few candidates found along the path of the destination address.
+ *
+ * The result is the same as a first-match walk over a list where new
+ * eroutes are put in front: every eroute gets a sequence number on add(),
+ * get() returns the matching eroute with the highest one.  Candidates and
+ * whole subtrees older than the best match found so far are skipped.
+ *
+ * Eroutes with a destination mask which is not a prefix, or with a source
+ * interface beyond Max_ifaces, are kept in a plain list.
+ *
+ * Paths are compressed, the server has only a small heap.
+ *
+ * E must provide the members src_if, d_mask, d_addr and seq, a matches()
+ * like Eroute::matches() and trie_chain() returning the link for the
+ * per-node lists.
+ */
+template< typename E >
+class Eroute_trie
+{
+public:
+  enum { Max_ifaces = 32 };
+
+  Eroute_trie();
+  ~Eroute_trie() { flush(); }
+
+  /** Index r, returns false if there was no memory for a node. */
+  bool add(E *r);
+  void del(E *r);
+  E *get(u32 src_if, u32 daddr, u32 saddr, u64 selector, u8 proto) const;
+
+  /** Drop the index, the eroutes themselves are not touched. */
+  void flush();
+
+private:
+  /**
+   * Trie node for the prefix key/len.  Nodes with a single child and
+   * without eroutes are removed, so there are at most two nodes per
+   * eroute.
+   */
+  struct Node
+  {
+    Node(u32 key, unsigned len)
+      : key(key), len(len), routes(0), max_seq(0)
+    { child[0] = child[1] = 0; }
+
+    u32 key;
+    unsigned len;
+    Node *child[2];
+    E *routes;
+    u32 max_seq;    ///< newest eroute in this subtree
+  };
+
+  static u32 mask(unsigned len)
+  { return len ? ~0UL << (32 - len) : 0; }
+
+  static unsigned bit(u32 key, unsigned pos)
+  { return (key >> (31 - pos)) & 1; }
+
+  static unsigned common_len(u32 a, u32 b, unsigned max)
+  {
+    unsigned l = 0;
+    for (u32 d = a ^ b; l < max && !(d & (1UL << (31 - l))); ++l)
+      ;
+    return l;
+  }
+
+  static unsigned prefix_len(u32 h_mask)
+  { return common_len(h_mask, ~(u32)0, 32); }
+
+  static bool is_prefix(u32 h_mask)
+  { u32 m = ~h_mask; return !(m & (m + 1)); }
+
+  static bool indexed(E const *r)
+  {
+    return is_prefix(Net::n_to_h(r->d_mask))
+      && (r->src_if < Max_ifaces || r->src_if == (u32)-1);
+  }
+
+  Node **root(u32 src_if)
+  { return &_root[src_if == (u32)-1 ? (u32)Max_ifaces : src_if]; }
+
+  static void insert(E **list, E *r);
+  static bool remove(E **list, E *r);
+  static void update_max(Node *n);
+  static void free_nodes(Node *n);
+
+  static E *scan(E *r, E *best, u32 sif, u32 daddr, u32 saddr,
+                 u64 selector, u8 proto);
+  static E *lookup(Node const *n, E *best, u32 sif, u32 daddr, u32 saddr,
+                   u64 selector, u8 proto);
+
+  Node *_root[Max_ifaces + 1];
+  E *_other;
+  u32 _seq;
+};
+
+//-------------IMPL-----------------------------------------------------------
+
+template< typename E >
+Eroute_trie<E>::Eroute_trie()
+  : _other(0), _seq(0)
+{
+  for (unsigned i = 0; i <= Max_ifaces; ++i)
+    _root[i] = 0;
+}
+
+template< typename E >
+void Eroute_trie<E>::insert(E **list, E *r)
+{
+  while (*list && (*list)->seq > r->seq)
+    list = (*list)->trie_chain();
+
+  *r->trie_chain() = *list;
+  *list = r;
+}
+
+template< typename E >
+bool Eroute_trie<E>::remove(E **list, E *r)
+{
+  while (*list && *list != r)
+    list = (*list)->trie_chain();
+
+  if (!*list)
+    return false;
+
+  *list = *r->trie_chain();
+  *r->trie_chain() = 0;
+  return true;
+}
+
+template< typename E >
+void Eroute_trie<E>::update_max(Node *n)
+{
+  u32 m = n->routes ? n->routes->seq : 0;
+  for (unsigned c = 0; c < 2; ++c)
+    if (n->child[c] && n->child[c]->max_seq > m)
+      m = n->child[c]->max_seq;
+
+  n->max_seq = m;
+}
+
+template< typename E >
+bool Eroute_trie<E>::add(E *r)
+{
+  r->seq = ++_seq;
+
+  if (!indexed(r))
+    {
+      insert(&_other, r);
+      return true;
+    }
+
+  unsigned len = prefix_len(Net::n_to_h(r->d_mask));
+  u32 key = Net::n_to_h(r->d_addr) & mask(len);
+  Node **n = root(r->src_if);
+  while (1)
+    {
+      if (!*n)
+	{
+	  if (!(*n = new Node(key, len)))
+	    return false;
+	}
+
+      unsigned l = common_len((*n)->key, key, len < (*n)->len ? len : (*n)->len);
+      if (l < (*n)->len)
+	{
+	  // r's prefix leaves the path of *n early: split it
+	  Node *s = new Node(key & mask(l), l);
+	  if (!s)
+	    return false;
+
+	  s->child[bit((*n)->key, l)] = *n;
+	  s->max_seq = (*n)->max_seq;
+	  *n = s;
+	}
+
+      if ((*n)->max_seq < r->seq)
+	(*n)->max_seq = r->seq;
+
+      if ((*n)->len == len)
+	break;
+
+      n = &(*n)->child[bit(key, (*n)->len)];
+    }
+
+  insert(&(*n)->routes, r);
+  return true;
+}
+
+template< typename E >
+void Eroute_trie<E>::del(E *r)
+{
+  if (!indexed(r))
+    {
+      remove(&_other, r);
+      return;
+    }
+
+  unsigned len = prefix_len(Net::n_to_h(r->d_mask));
+  u32 key = Net::n_to_h(r->d_addr) & mask(len);
+  Node **path[33];
+  int d = 0;
+  path[0] = root(r->src_if);
+  while (*path[d] && (*path[d])->len < len)
+    {
+      path[d + 1] = &(*path[d])->child[bit(key, (*path[d])->len)];
+      ++d;
+    }
+
+  Node *n = *path[d];
+  if (!n || n->len != len || n->key != key || !remove(&n->routes, r))
+    return;
+
+  // drop nodes which became empty or pass-through, bottom up
+  for (; d >= 0; --d)
+    {
+      n = *path[d];
+      if (!n->routes && (!n->child[0] || !n->child[1]))
+	{
+	  *path[d] = n->child[0] ? n->child[0] : n->child[1];
+	  delete n;
+	}
+      else
+	update_max(n);
+    }
+}
+
+template< typename E >
+E *Eroute_trie<E>::scan(E *r, E *best, u32 sif, u32 daddr, u32 saddr,
+                        u64 selector, u8 proto)
+{
+  for (; r && (!best || r->seq > best->seq); r = *r->trie_chain())
+    if (r->matches(sif, daddr, saddr, selector, proto))
+      return r;
+
+  return best;
+}
+
+template< typename E >
+E *Eroute_trie<E>::lookup(Node const *n, E *best, u32 sif, u32 daddr,
+                          u32 saddr, u64 selector, u8 proto)
+{
+  u32 key = Net::n_to_h(daddr);
+  for (; n && (!best || n->max_seq > best->seq); n = n->child[bit(key, n->len)])
+    {
+      if ((key ^ n->key) & mask(n->len))
+	break;
+
+      best = scan(n->routes, best, sif, daddr, saddr, selector, proto);
+      if (n->len == 32)
+	break;
+    }
+
+  return best;
+}
+
+template< typename E >
+E *Eroute_trie<E>::get(u32 src_if, u32 daddr, u32 saddr, u64 selector,
+                       u8 proto) const
+{
+  E *best = scan(_other, 0, src_if, daddr, saddr, selector, proto);
+  if (src_if < Max_ifaces)
+    best = lookup(_root[src_if], best, src_if, daddr, saddr, selector, proto);
+
+  return lookup(_root[Max_ifaces], best, src_if, daddr, saddr, selector,
+                proto);
+}
+
+template< typename E >
+void Eroute_trie<E>::free_nodes(Node *n)
+{
+  if (!n)
+    return;
+
+  free_nodes(n->child[0]);
+  free_nodes(n->child[1]);
+  delete n;
+}
+
+template< typename E >
+void Eroute_trie<E>::flush()
+{
+  for (unsigned i = 0; i <= Max_ifaces; ++i)
+    {
+      free_nodes(_root[i]);
+      _root[i] = 0;
+    }
+
+  _other = 0;
+}
+
+#endif // L4_NH_EROUTE_TRIE_H__
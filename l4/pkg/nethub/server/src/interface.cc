@@ -12,12 +12,12 @@
 #include <l4/cxx/l4iostream.h>
 #include <l4/cxx/l4types.h>
 
-void Tx_iface::xmit( Iface *i, unsigned slot )
+void Tx_iface::xmit( Iface *i, u32 slots )
 {
   int err;
   l4_msgdope_t r;
   
-  err = l4_ipc_send( peer(), 0, (l4_umword_t)i, slot, L4_IPC_NEVER, &r );
+  err = l4_ipc_send( peer(), 0, (l4_umword_t)i, slots, L4_IPC_NEVER, &r );
   if (err)
     L4::cout << "IPC error from router to worker: " 
              << (L4::MsgDope)r << '\n';
@@ -115,13 +115,13 @@ public:
   { return _peer; }
 
   /**
-   * Transmit packet via this interface.
+   * Transmit a batch of packets via this interface.
    * 
    * \param i the incoming interface.
-   * \param slot the slot in the incoming interface that contains 
-   *        the packet
+   * \param slots bit mask of the slots in the incoming interface that 
+   *        contain packets for this interface, handled lowest slot first.
    */
-  void xmit(Iface *i, unsigned slot);
+  void xmit(Iface *i, u32 slots);
 
 private:
   l4_threadid_t _peer;
@@ -180,6 +180,7 @@ public:
 #endif
 
 public:
+  enum { Ring_slots = 32 };
 
   /**
    * Create a pointer to an incoming interface pcket ring.
@@ -91,7 +91,7 @@ Ip_fwd::~Ip_fwd()
 struct Message
 {
   l4_umword_t w[2];
-  unsigned rx_slot() const { return w[1]; }
+  u32 rx_slots() const { return w[1]; }
   Iface *rx_iface() const { return (Iface*)w[0]; }
   
   unsigned long tx_len() const { return w[1]; }
@@ -105,6 +105,7 @@ void  Ip_fwd::run()
   Rx_pkt in_pkt;
   Iface *in_if = 0;
   Routing_entry *route = 0;
+  u32 pending = 0;
   l4_threadid_t snd, other;
   l4_msgdope_t result;
   int err;
@@ -119,8 +120,13 @@ void  Ip_fwd::run()
 
   while(1) 
     {
+      // next packet of the current batch, no IPC needed
+      while (!in_pkt.valid() && pending)
+	in_pkt = next_pkt(in_if, pending, route, in);
+
       if (!in_pkt.valid()) 
 	{
+	  batch_done();
           while((err = l4_ipc_wait( &other, 0, 
 	                            &m.w[0], &m.w[1], 
 	  			    L4_IPC_NEVER, 
@@ -177,46 +183,13 @@ void  Ip_fwd::run()
      
       if (!in_pkt.valid() && _rcv == other)
 	{
-          // got packet from routing fabric
-	  
-	  // L4::cout << self() << " got packet to send from " << other << '\n';
-	  in_if= m.rx_iface();
-	  unsigned rx_slot = m.rx_slot();
-	  
-	  in_pkt = in_if->packet(rx_slot);
-	  route = in_if->get_route(rx_slot);
+          // got a batch of packets from routing fabric
 	  
-	  in = in_pkt.packet();
-
-	  // again at least the header must be valid
-	  if(in->head_len() < 5 || in->version()!=4) 
-	    {
-	      in_pkt.clear_flags();
-	      L4::cerr << "waring: (" << self() 
-		       << ") wrong IP version or header size\n";
-	      in_pkt.invalidate();
-	      out_iface->tx_empty();
-	      out_iface->inc_tx_drop_count();
-	    }
-	  else
-	    {
-#if 0
-	  L4::cout << "IN: saddr=" << (Ip_address)Net::n_to_h(in->saddr()) 
-	           << " daddr=" << (Ip_address)Net::n_to_h(in->daddr())
-		   << " proto=" << (unsigned)in->protocol()
-		   << " len=" << (unsigned)in->len()
-		   << " (" << (unsigned)in->is_fragment() << ")\n";
-#endif
-	
-	      if(test_checksum && !in->check_checksum()) 
-		{
-		  in_pkt.clear_flags();
-		  L4::cerr << "warning: (" << self() << ") bad IP checksum\n";
-		  in_pkt.invalidate();
-		  out_iface->tx_empty();
-	          out_iface->inc_tx_drop_count();
-		}
-	    }
+	  // L4::cout << self() << " got packets to send from " << other << '\n';
+	  in_if = m.rx_iface();
+	  pending = m.rx_slots();
+	  while (!in_pkt.valid() && pending)
+	    in_pkt = next_pkt(in_if, pending, route, in);
 	}
 #if 0
       if( in && !out )
@@ -274,6 +247,64 @@ void  Ip_fwd::run()
     }
 }
 
+/**
+ * Take the lowest slot of the pending batch.
+ * 
+ * Packets with a broken header are dropped, the returned packet pointer
+ * is invalid then.
+ */
+Rx_pkt Ip_fwd::next_pkt( Iface *in_if, u32 &pending, Routing_entry *&route,
+                         Ip_packet *&in )
+{
+  unsigned slot = 0;
+  while (!(pending & (1UL << slot)))
+    ++slot;
+
+  pending &= ~(1UL << slot);
+
+  Rx_pkt in_pkt = in_if->packet(slot);
+  if (!in_pkt.valid())
+    return in_pkt;
+
+  route = in_if->get_route(slot);
+  in = in_pkt.packet();
+
+  // again at least the header must be valid
+  if(in->head_len() < 5 || in->version()!=4) 
+    {
+      in_pkt.clear_flags();
+      L4::cerr << "waring: (" << self() 
+	       << ") wrong IP version or header size\n";
+      in_pkt.invalidate();
+      out_iface->tx_empty();
+      out_iface->inc_tx_drop_count();
+    }
+  else
+    {
+#if 0
+      L4::cout << "IN: saddr=" << (Ip_address)Net::n_to_h(in->saddr()) 
+	       << " daddr=" << (Ip_address)Net::n_to_h(in->daddr())
+	       << " proto=" << (unsigned)in->protocol()
+	       << " len=" << (unsigned)in->len()
+	       << " (" << (unsigned)in->is_fragment() << ")\n";
+#endif
+    
+      if(test_checksum && !in->check_checksum()) 
+	{
+	  in_pkt.clear_flags();
+	  L4::cerr << "warning: (" << self() << ") bad IP checksum\n";
+	  in_pkt.invalidate();
+	  out_iface->tx_empty();
+	  out_iface->inc_tx_drop_count();
+	}
+    }
+
+  return in_pkt;
+}
+
+void Ip_fwd::batch_done()
+{}
+
 Ip_fwd::Fwd_result Ip_fwd::forward( Routing_entry *, 
                                     Ip_packet *in, Ip_packet *out)
 {
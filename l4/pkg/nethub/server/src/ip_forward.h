@@ -41,6 +41,9 @@ private:
   bool test_checksum;
   Iface *out_iface;
 
+  Rx_pkt next_pkt( Iface *in_if, u32 &pending, Routing_entry *&route,
+                   Ip_packet *&in );
+
 public:
 
   enum Fwd_result {
@@ -65,6 +68,12 @@ public:
   bool has_receiver() { return _rcv.is_valid(); }
 
   virtual Fwd_result forward( Routing_entry *re, Ip_packet *in, Ip_packet *out );
+
+  /**
+   * Called when all packets of a batch from the routing fabric are 
+   * handled, before waiting for the next one.
+   */
+  virtual void batch_done();
   virtual char const *const name() const;
   virtual void print( L4::BasicOStream &s ) const;  
 };
@@ -22,13 +22,10 @@ Ip_ipsec_fwd::do_ipsec_forward(Routing_entry *re,
 
   SA *x = (SA*)re;
 
-  SA::Expire cause;
-  
   switch (x->type())
     {
     case SA::pas: 
-      if ((cause = x->send_bytes(in->len()))!=SA::no_lt)
-	x->expired(cause);
+      account(x, in->len());
       return Ip_fwd::forward(re, in, out);
       
     case SA::esp:
@@ -86,8 +83,7 @@ Ip_ipsec_fwd::do_ipsec_forward(Routing_entry *re,
 	out->len(out->head_len()*4 + p_len);
 	out->set_checksum();
 
-	if ((cause = x->send_bytes(in_len)) != SA::no_lt)
-	  x->expired(cause);
+	account(x, in_len);
 
 	return fwd_ok;
       }
@@ -160,10 +156,7 @@ Ip_ipsec_fwd::esp_forward(Routing_entry *re, Ip_packet *in, Ip_packet *out)
       e_out->un_esp();
     }
 
-  SA::Expire cause;
-  
-  if ((cause = x->send_bytes(p_len)) != SA::no_lt)
-    x->expired(cause);
+  account(x, p_len);
 
   return fwd_ok;
 }
@@ -193,8 +186,6 @@ Ip_ipsec_fwd::forward(Routing_entry *re, Ip_packet *in, Ip_packet *out)
       return fwd_drop;
     }
  
-  SA::Expire cause;
-  
   switch(s->type()) 
     {
     case SA::esp:
@@ -202,14 +193,40 @@ Ip_ipsec_fwd::forward(Routing_entry *re, Ip_packet *in, Ip_packet *out)
     case SA::ah:
       return ah_forward(re, in, out);
     case SA::pas:
-      if ((cause = s->send_bytes(in->len())) != SA::no_lt)
-	s->expired(cause);
+      account(s, in->len());
       return Ip_fwd::forward( re, in, out );
     default: /*drop*/
       return fwd_drop;
   };
 }
 
+void Ip_ipsec_fwd::flush_account()
+{
+  SA::Expire cause;
+
+  if (_acct_sa && (cause = _acct_sa->send_bytes(_acct_bytes)) != SA::no_lt)
+    _acct_sa->expired(cause);
+
+  _acct_sa = 0;
+  _acct_bytes = 0;
+}
+
+void Ip_ipsec_fwd::account(SA *x, unsigned long bytes)
+{
+  if (x != _acct_sa)
+    {
+      flush_account();
+      _acct_sa = x;
+    }
+
+  _acct_bytes += bytes;
+}
+
+void Ip_ipsec_fwd::batch_done()
+{
+  flush_account();
+}
+
 void Ip_ipsec_fwd::print(L4::BasicOStream &s) const
 {
   s << "Ip_ipsec_fwd: decryptor + authenticator with SPD";
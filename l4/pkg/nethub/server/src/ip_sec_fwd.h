@@ -22,12 +22,24 @@ namespace L4 {
 class Ip_ipsec_fwd : public Ip_fwd
 {
 public:
-  Ip_ipsec_fwd(Iface *out) : Ip_fwd(out) {}
+  Ip_ipsec_fwd(Iface *out) : Ip_fwd(out), _acct_sa(0), _acct_bytes(0) {}
   Fwd_result forward( Routing_entry *re, Ip_packet *in, Ip_packet *out );
+  void batch_done();
   Fwd_result do_ipsec_forward( Routing_entry *re, Ip_packet *in, Ip_packet *out);
   Fwd_result esp_forward( Routing_entry *re, Ip_packet *in, Ip_packet *out );
   Fwd_result ah_forward( Routing_entry *re, Ip_packet *in, Ip_packet *out );
   void print( L4::BasicOStream &s ) const;
+
+private:
+  void account( SA *x, unsigned long bytes );
+  void flush_account();
+
+  /*
+   * Lifetimes are accounted once per run of packets using the same SA
+   * within a batch, not for every packet.
+   */
+  SA *_acct_sa;
+  unsigned long _acct_bytes;
 };
 
 #endif // L4_NH_IP_SEC_FWD_H__
@@ -9,6 +9,7 @@
 
 #include "interface.h"
 #include "routing_fab.h"
+#include "ip_sec.h"
 
 #include <l4/sys/types.h>
 #include <l4/sys/ipc.h>
@@ -26,7 +27,6 @@ void Routing_fab::run()
   
   while (1)
     {
-      Rx_pkt in;
       Iface *in_if;
       l4_threadid_t other;
       l4_msgdope_t result;
@@ -35,41 +35,122 @@ void Routing_fab::run()
 
       // L4::cout << "router check for incoming packets\n";
       while ((in_if = ifl->next_active(iface_num)))
-	{
-	  // L4::cout << "found active interface\n";
-	  unsigned slot;
-	  in = in_if->next_to_handle(slot);
-	  if (in.valid())
-	    {
-	      // L4::cout << "route pkt from iface " << iface_num << '\n';
-	      Routing_entry *re = rtab->route(iface_num, in.packet());
-	      if (!re)
-		{
-		  /*
-		  L4::cout << "no route for packet: [if=" << iface_num
-		           << "; " << Ip_addr(in.packet()->saddr(),(u32)-1) 
-			   << "->" << Ip_addr(in.packet()->daddr(),(u32)-1) 
-			   << "]\n";
-	          */
-		  // drop this packet
-		  in.clear_flags();
-		  in_if->inc_rx_drop_count();
-		}
-	      else
-		{
-		  // L4::cout << " transmit slot " << slot 
-		  //          << " re=" << re << '\n';
-		  in_if->set_route( slot, re );
- 		  re->destination()->xmit(in_if, slot);
-		}
-	    }
-	}
+	route_batch(in_if, iface_num);
       
       // wait for notification
       l4_ipc_wait( &other, 0, &d1, &d2, L4_IPC_NEVER, &result );
     }
 }
 
+/**
+ * Key of the routing decision for a packet, packets with the same key
+ * from the same interface get the same route.
+ */
+struct Flow
+{
+  Flow() : daddr(0), saddr(0), spi(0), proto(0) {}
+
+  Flow(Ip_packet *p)
+    : daddr(p->daddr()), saddr(p->saddr()), spi(0), proto(p->protocol())
+  {
+    if (proto == IP_ESP_PROTO || proto == IP_AH_PROTO)
+      spi = static_cast<Ipsec_packet*>(p)->spi();
+  }
+
+  bool operator == (Flow const &o) const
+  { 
+    return daddr == o.daddr && saddr == o.saddr && spi == o.spi 
+           && proto == o.proto; 
+  }
+
+  u32 daddr, saddr, spi;
+  u8 proto;
+};
+
+static void xmit_batch(Iface *in_if, Tx_iface **dest, u32 *slots, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i)
+    dest[i]->xmit(in_if, slots[i]);
+}
+
+/**
+ * Route the pending packets of one interface.
+ * 
+ * The routing table is asked once for each run of packets of the same
+ * flow.  The packets are grouped by destination and each destination
+ * gets a single message carrying the slots of all its packets.  A batch
+ * ends at the end of the ring, so that the slot order is the ring order.
+ */
+void Routing_fab::route_batch( Iface *in_if, unsigned iface_num )
+{
+  Tx_iface *dest[Max_dests];
+  u32 slots[Max_dests];
+  unsigned ndests = 0;
+  unsigned last = 0;
+  Routing_entry *re = 0;
+  Flow prev;
+
+  for (unsigned n = 0; n < Iface::Ring_slots && in_if->active(); ++n)
+    {
+      unsigned slot;
+      Rx_pkt in = in_if->next_to_handle(slot);
+      if (!in.valid())
+	break;
+
+      if (n && slot <= last)
+	{
+	  xmit_batch(in_if, dest, slots, ndests);
+	  ndests = 0;
+	}
+      last = slot;
+
+      Flow f(in.packet());
+      if (!n || !(f == prev))
+	re = rtab->route(iface_num, in.packet());
+      prev = f;
+
+      if (!re)
+	{
+	  /*
+	  L4::cout << "no route for packet: [if=" << iface_num
+		   << "; " << Ip_addr(in.packet()->saddr(),(u32)-1) 
+		   << "->" << Ip_addr(in.packet()->daddr(),(u32)-1) 
+		   << "]\n";
+	  */
+	  // drop this packet
+	  in.clear_flags();
+	  in_if->inc_rx_drop_count();
+	  continue;
+	}
+
+      // L4::cout << " transmit slot " << slot 
+      //          << " re=" << re << '\n';
+      in_if->set_route( slot, re );
+
+      Tx_iface *d = re->destination();
+      unsigned i;
+      for (i = 0; i < ndests && dest[i] != d; ++i)
+	;
+
+      if (i == Max_dests)
+	{
+	  xmit_batch(in_if, dest, slots, ndests);
+	  ndests = 0;
+	  i = 0;
+	}
+
+      if (i == ndests)
+	{
+	  dest[ndests] = d;
+	  slots[ndests++] = 0;
+	}
+
+      slots[i] |= 1UL << slot;
+    }
+
+  xmit_batch(in_if, dest, slots, ndests);
+}
+
 void Routing_fab::unresolved_fault( void *priv )
 {
   L4::cout << "Unresolved Fault -> killing interface and restarting router\n";
@@ -28,6 +28,10 @@ public:
   void unresolved_fault( void *priv );
       
 private:
+  enum { Max_dests = 8 };
+
+  void route_batch( Iface *in_if, unsigned iface_num );
+
   Routing_table *rtab;  
   Iface_vector *ifl;
   unsigned long stack[1024];
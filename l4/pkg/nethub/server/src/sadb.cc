@@ -36,6 +36,9 @@ unsigned Eroute_table::add(Eroute *r)
   if (e)
     return 0;
 
+  if (!trie.add(r))
+    return 0;
+
   *r->chain() = first;
   first = r;
   return 1;
@@ -44,11 +47,7 @@ unsigned Eroute_table::add(Eroute *r)
 Eroute *Eroute_table::get(u32 src_if, u32 daddr, u32 saddr, u64 _selector,
                           u8 _proto) const
 {
-  Eroute *r = first;
-  while (r && !r->matches(src_if, daddr,saddr,_selector,_proto))
-    r = *r->chain();
-
-  return r;
+  return trie.get(src_if, daddr, saddr, _selector, _proto);
 }
 
 Routing_entry *Eroute_table::route(unsigned iface, Ip_packet *p) const
@@ -128,6 +127,7 @@ unsigned Eroute_table::del(u32 src_if, u32 dmask, u32 daddr,
   if (!*r)
     return ENOTFND;
   Eroute *next = *(*r)->chain();
+  trie.del(*r);
   delete *r;
   *r = next;
   return EOK;
@@ -189,6 +189,7 @@ void Eroute_table::flush()
   Eroute *r = first;
   _if_mode = 0;
   first = 0;
+  trie.flush();
   while (r)
     {
       Eroute *n = *r->chain();
@@ -15,6 +15,7 @@
 #include "routing.h"
 #include "ip.h"
 #include "ip_sec.h"
+#include "eroute_trie.h"
 
 class SADB;
 class Ike_connector;
@@ -258,7 +259,7 @@ public:
     : src_if(src_if), d_mask(d_mask), d_addr(d_addr), 
       s_mask(s_mask), s_addr(s_addr), 
       sel_mask(sel_mask), selector(selector),
-      protocol(protocol), _sa(sa), c_chain(0)
+      protocol(protocol), seq(0), _sa(sa), c_chain(0), t_chain(0)
   {}
 
   ~Eroute()
@@ -300,6 +301,9 @@ public:
   Eroute **chain() 
   { return &c_chain; }
 
+  Eroute **trie_chain()
+  { return &t_chain; }
+
   void re(Base_sa *sa)
   { _sa = sa; }
   
@@ -318,10 +322,12 @@ public:
   u64 sel_mask;
   u64 selector;
   u8  protocol;
+  u32 seq;
   
 private:
   Base_sa *_sa;
   Eroute *c_chain;
+  Eroute *t_chain;
 
 };
 
@@ -449,6 +455,7 @@ private:
   u32 _if_mode;
   SADB *sadb;
   Eroute *first;
+  Eroute_trie<Eroute> trie;
   Ike_connector *ike_connector;
 };
 
@@ -0,0 +1,98 @@
+/*
+ * \brief   Portable pixel line kernels and runtime selection
+ * \date    2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** GENERAL INCLUDES ***/
+#include <string.h>
+
+/*** LOCAL INCLUDES ***/
+#include "blit.h"
+
+
+static void copy_c(void *dst, const void *src, int bytes) {
+	memcpy(dst, src, bytes);
+}
+
+
+static void fill32_c(u32 *dst, u32 val, int n) {
+	for (; n--; dst++) *dst = val;
+}
+
+
+static void half16_c(u16 *dst, const u16 *src, u16 add, int n) {
+	for (; n--; src++, dst++) *dst = ((*src >> 1) & 0x7bef) + add;
+}
+
+
+static void half32_c(u32 *dst, const u32 *src, u32 add, int n) {
+	for (; n--; src++, dst++) *dst = ((*src >> 1) & 0x7f7f7f) + add;
+}
+
+
+static void key32_c(u32 *dst, const u32 *src, int n) {
+	for (; n--; src++, dst++) if (*src) *dst = *src;
+}
+
+
+static void label32_c(u32 *dst, const u8 *mask, u32 color, int n) {
+	for (; n--; mask++, dst++) if (*mask) *dst = color;
+}
+
+
+blit_ops blit_c = {
+	copy_c,
+	fill32_c,
+	half16_c,
+	half32_c,
+	key32_c,
+	label32_c,
+};
+
+blit_ops *blit = &blit_c;
+
+
+/*** CHECK IF THE CPU SUPPORTS SSE2 ***/
+static int cpu_has_sse2(void) {
+#if defined(__x86_64__)
+	return 1;   /* part of the architecture */
+#elif defined(__i386__)
+	unsigned long flags_a, flags_b;
+	u32 eax, edx;
+
+	/* check if the cpuid instruction is present (EFLAGS.ID is writable) */
+	asm volatile ("pushf; pop %0; mov %0, %1; xor %2, %0;"
+	              "push %0; popf; pushf; pop %0; push %1; popf"
+	              : "=&r" (flags_a), "=&r" (flags_b)
+	              : "i" (0x200000));
+	if (!((flags_a ^ flags_b) & 0x200000)) return 0;
+
+	/* save ebx, which may hold the GOT pointer */
+	asm volatile ("push %%ebx; cpuid; pop %%ebx"
+	              : "=a" (eax), "=d" (edx) : "a" (1) : "ecx");
+
+	/* FXSR (24) implies that the kernel saves the SSE registers */
+	return (edx & (1 << 26)) && (edx & (1 << 24));
+#else
+	return 0;
+#endif
+}
+
+
+const char *blit_init(void) {
+	if (cpu_has_sse2()) {
+		blit = &blit_sse2;
+		return "SSE2";
+	}
+	blit = &blit_c;
+	return "C";
+}
@@ -0,0 +1,181 @@
+/*
+ * \brief   SSE2 pixel line kernels
+ * \date    2026-10-19
+ *
+ * This file must be compiled with -msse2. The kernels are only used if
+ * blit_init detected SSE2 at runtime.
+ *
+ * Most destinations are in the write-combined frame buffer. Reading it
+ * is very slow, so the kernels never read the destination. Masked
+ * kernels skip blocks without any pixel to set and store fully covered
+ * blocks at once.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** GENERAL INCLUDES ***/
+#include <string.h>
+
+/*** LOCAL INCLUDES ***/
+#include "blit.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+
+/*** COPY BYTES ***
+ *
+ * Lines are short and most of them go to the frame buffer, which is
+ * write-combined anyway. Non-temporal stores plus a fence per line were
+ * several times slower than plain stores.
+ */
+static void copy_sse2(void *dst, const void *src, int bytes) {
+	u8 *d = dst;
+	const u8 *s = src;
+
+	for (; bytes >= 64; bytes -= 64, s += 64, d += 64) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(s +  0));
+		__m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+		__m128i c = _mm_loadu_si128((const __m128i *)(s + 32));
+		__m128i e = _mm_loadu_si128((const __m128i *)(s + 48));
+		_mm_storeu_si128((__m128i *)(d +  0), a);
+		_mm_storeu_si128((__m128i *)(d + 16), b);
+		_mm_storeu_si128((__m128i *)(d + 32), c);
+		_mm_storeu_si128((__m128i *)(d + 48), e);
+	}
+
+	memcpy(d, s, bytes);
+}
+
+
+/*** FILL 32BIT WORDS ***/
+static void fill32_sse2(u32 *dst, u32 val, int n) {
+	__m128i v = _mm_set1_epi32(val);
+
+	for (; n >= 16; n -= 16, dst += 16) {
+		_mm_storeu_si128((__m128i *)(dst +  0), v);
+		_mm_storeu_si128((__m128i *)(dst +  4), v);
+		_mm_storeu_si128((__m128i *)(dst +  8), v);
+		_mm_storeu_si128((__m128i *)(dst + 12), v);
+	}
+	for (; n >= 4; n -= 4, dst += 4)
+		_mm_storeu_si128((__m128i *)dst, v);
+
+	for (; n--; dst++) *dst = val;
+}
+
+
+static void half16_sse2(u16 *dst, const u16 *src, u16 add, int n) {
+	__m128i m = _mm_set1_epi16(0x7bef);
+	__m128i a = _mm_set1_epi16(add);
+
+	for (; n >= 8; n -= 8, src += 8, dst += 8) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		s = _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(s, 1), m), a);
+		_mm_storeu_si128((__m128i *)dst, s);
+	}
+	for (; n--; src++, dst++) *dst = ((*src >> 1) & 0x7bef) + add;
+}
+
+
+static void half32_sse2(u32 *dst, const u32 *src, u32 add, int n) {
+	__m128i m = _mm_set1_epi32(0x7f7f7f);
+	__m128i a = _mm_set1_epi32(add);
+
+	for (; n >= 4; n -= 4, src += 4, dst += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		s = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(s, 1), m), a);
+		_mm_storeu_si128((__m128i *)dst, s);
+	}
+	for (; n--; src++, dst++) *dst = ((*src >> 1) & 0x7f7f7f) + add;
+}
+
+
+/*** SET PARTIALLY COVERED BLOCK OF FOUR PIXELS ***
+ *
+ * maskmovdqu would avoid the branches but it bypasses the cache, which
+ * makes it much slower than single stores for drawing into buffers.
+ */
+static inline void key_block(u32 *dst, const u32 *src, int mb) {
+	if (!(mb & 0x000f)) dst[0] = src[0];
+	if (!(mb & 0x00f0)) dst[1] = src[1];
+	if (!(mb & 0x0f00)) dst[2] = src[2];
+	if (!(mb & 0xf000)) dst[3] = src[3];
+}
+
+
+static inline void label_block(u32 *dst, const u8 *mask, u32 color) {
+	if (mask[0]) dst[0] = color;
+	if (mask[1]) dst[1] = color;
+	if (mask[2]) dst[2] = color;
+	if (mask[3]) dst[3] = color;
+}
+
+
+static void key32_sse2(u32 *dst, const u32 *src, int n) {
+	__m128i zero = _mm_setzero_si128();
+
+	for (; n >= 4; n -= 4, src += 4, dst += 4) {
+		__m128i s  = _mm_loadu_si128((const __m128i *)src);
+		__m128i tp = _mm_cmpeq_epi32(s, zero);
+		int     mb = _mm_movemask_epi8(tp);
+
+		if (mb == 0xffff) continue;   /* all four pixels transparent */
+		if (mb == 0)                  /* all four pixels opaque      */
+			_mm_storeu_si128((__m128i *)dst, s);
+		else
+			key_block(dst, src, mb);
+	}
+	for (; n--; src++, dst++) if (*src) *dst = *src;
+}
+
+
+static void label32_sse2(u32 *dst, const u8 *mask, u32 color, int n) {
+	__m128i zero = _mm_setzero_si128();
+	__m128i col  = _mm_set1_epi32(color);
+	u32 m4;
+
+	for (; n >= 4; n -= 4, mask += 4, dst += 4) {
+		__m128i m;
+
+		memcpy(&m4, mask, 4);
+		if (!m4) continue;
+
+		/* widen the four mask bytes to 32bit lanes */
+		m = _mm_cvtsi32_si128(m4);
+		m = _mm_unpacklo_epi8(m, zero);
+		m = _mm_unpacklo_epi16(m, zero);
+		m = _mm_cmpeq_epi32(m, zero);
+
+		if (_mm_movemask_epi8(m) == 0)
+			_mm_storeu_si128((__m128i *)dst, col);
+		else
+			label_block(dst, mask, color);
+	}
+	for (; n--; mask++, dst++) if (*mask) *dst = color;
+}
+
+
+blit_ops blit_sse2 = {
+	copy_sse2,
+	fill32_sse2,
+	half16_sse2,
+	half32_sse2,
+	key32_sse2,
+	label32_sse2,
+};
+
+#else /* __SSE2__ */
+
+/* never selected on this platform, see blit_init */
+blit_ops blit_sse2;
+
+#endif /* __SSE2__ */
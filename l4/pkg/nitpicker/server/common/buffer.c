@@ -13,9 +13,6 @@
  * COPYING file for details.
  */
 
-/*** L4 INCLUDES ***/
-#include <l4/l4rm/l4rm.h>
-
 /*** LOCAL INCLUDES ***/
 #include "nitpicker.h"
 
@@ -54,7 +51,7 @@ int nitpicker_import_buffer_component(CORBA_Object _dice_corba_obj,
 
 	c->buffers[id].ds = *ds;
 
-	TRY(l4rm_attach(ds, w*h*scr_depth/8, 0, L4DM_RW, &c->buffers[id].data),
+	TRY(attach_ds(ds, w*h*scr_depth/8, &c->buffers[id].data),
 	    "Cannot attach dataspace");
 
 	return id;
@@ -71,7 +68,7 @@ void nitpicker_remove_buffer_component(CORBA_Object _dice_corba_obj,
 	if (!(b = lookup_buffer(_dice_corba_obj, buf_id))) return;
 
 	/* clean up local address space */
-	l4rm_detach(b->data);
+	detach_ds(b->data);
 
 	/* mark buffer id as free */
 	b->state = STATE_FREE;
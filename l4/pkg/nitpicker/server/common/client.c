@@ -13,15 +13,12 @@
  * COPYING file for details.
  */
 
-/*** L4 INCLUDES ***/
-#include <l4/l4rm/l4rm.h>
-#include <l4/names/libnames.h>
-
 /*** LOCAL INCLUDES ***/
 #include "nitpicker.h"
 
 
-static client *first_client = NULL; /* head of client list */
+static client *first_client = NULL; /* head of client list      */
+static client *last_client  = NULL; /* client of the last lookup */
 
 
 /*************************************************
@@ -44,7 +41,7 @@ void add_client(CORBA_Object tid, char *addr, int max_views, int max_buffers) {
 
 	if (tid) {
 		new_client->tid = *tid;
-		names_query_id(new_client->tid, &new_client->label[0], CLIENT_LABEL_LEN - 1);
+		query_client_label(tid, &new_client->label[0], CLIENT_LABEL_LEN - 1);
 	}
 
 	/* insert client struct into client list */
@@ -70,9 +67,10 @@ void remove_client(CORBA_Object tid) {
 
 	/* exclude client from client list */
 	UNCHAIN_LISTELEMENT(client, &first_client, next, c);
+	if (c == last_client) last_client = NULL;
 
 	/* unmap client memory */
-	l4rm_detach(c);
+	detach_ds(c);
 }
 
 
@@ -80,8 +78,11 @@ void remove_client(CORBA_Object tid) {
 client *find_client(CORBA_Object tid) {
 	client *c;
 
+	/* most requests look up the same client several times */
+	if (last_client && dice_obj_eq(&last_client->tid, tid)) return last_client;
+
 	for (c = first_client; c; c = c->next)
-		if (dice_obj_eq(&c->tid, tid)) return c;
+		if (dice_obj_eq(&c->tid, tid)) return last_client = c;
 
 	return NULL;
 }
@@ -104,10 +105,10 @@ int nitpicker_donate_memory_component(CORBA_Object _dice_corba_obj,
 	remove_client(_dice_corba_obj);
 
 	/* map memory locally */
-	TRY(l4rm_attach(ds, sizeof(buffer)*max_buffers
-	                  + sizeof(view)*max_views
-	                  + sizeof(client), 0, L4DM_RW, (void **)&addr),
-	                   "Cannot attach dataspace");
+	TRY(attach_ds(ds, sizeof(buffer)*max_buffers
+	                + sizeof(view)*max_views
+	                + sizeof(client), (void **)&addr),
+	                 "Cannot attach dataspace");
 
 	/*
 	 * FIXME: We need to revoke the access right
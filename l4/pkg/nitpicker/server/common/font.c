@@ -42,8 +42,8 @@ int font_string_height(font *f, char *str) {
 /*** INITIALIZE FONT HANDLING ***/
 void font_init(void) {
 	builtin_font.offset_table =   (s32 *)&_binary_default_tff_start;
-	builtin_font.width_table  =   (s32 *)((u32)&_binary_default_tff_start + 1024);
-	builtin_font.img_w        = *((u32 *)((u32)&_binary_default_tff_start + 2048));
-	builtin_font.img_h        = *((u32 *)((u32)&_binary_default_tff_start + 2052));
-	builtin_font.image        =    (u8 *)((u32)&_binary_default_tff_start + 2056);
+	builtin_font.width_table  =   (s32 *)((adr)&_binary_default_tff_start + 1024);
+	builtin_font.img_w        = *((u32 *)((adr)&_binary_default_tff_start + 2048));
+	builtin_font.img_h        = *((u32 *)((adr)&_binary_default_tff_start + 2052));
+	builtin_font.image        =    (u8 *)((adr)&_binary_default_tff_start + 2056);
 }
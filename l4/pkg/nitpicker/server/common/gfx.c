@@ -0,0 +1,36 @@
+/*
+ * \brief   Selection of the graphics backend
+ * \date    2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+#include "blit.h"
+
+gfx_interface *gfx;   /* pointer to generic graphics backend */
+
+
+/*** INIT GRAPHICS BACKEND FOR THE GIVEN COLOR DEPTH ***/
+int gfx_init(int depth) {
+
+	switch (depth) {
+		case 16: gfx = &gfx16; break;
+		case 32: gfx = &gfx32; break;
+		default:
+			printf("Error: color depth of %d bits is not supported\n", depth);
+			return -1;
+	}
+
+	printf("Nitpicker: %d bit graphics with %s line kernels\n",
+	       depth, blit_init());
+	return 0;
+}
@@ -15,12 +15,25 @@
 
 /*** LOCAL INCLUDES ***/
 #include "nitpicker.h"
+#include "blit.h"
 
 
 #define RGBA_TO_RGB16(c) (((c&0xf8000000)>>16)|((c&0x00fc0000)>>13)|((c&0x0000f800)>>11))
 #define GFX_ALPHA(rgba) (rgba&255)
 
 
+/*** FILL LINE OF 16BIT PIXELS ***
+ *
+ * The line is filled 32bit-wise. Unaligned first and last pixels are
+ * set separately.
+ */
+static inline void fill_line_16(u16 *dst, u16 color, int n) {
+	if (n && ((long)dst & 2)) { *dst++ = color; n--; }
+	if (n >> 1) blit->fill32((u32 *)dst, ((u32)color << 16) | color, n >> 1);
+	if (n & 1) dst[n - 1] = color;
+}
+
+
 /*** DRAW FILLED BOX TO 16BIT SCREEN ***/
 static void draw_box_16(u16 *dst, int dst_llen, int x1, int y1, int w, int h,
                         u32 rgba) {
@@ -46,12 +59,8 @@ static void draw_box_16(u16 *dst, int dst_llen, int x1, int y1, int w, int h,
 
 	/* solid fill */
 	if (alpha & 0x80) {
-		for (y = y1; y <= y2; y++) {
-			dst = dst_line + x1;
-			for (x = x1; x <= x2; x++, dst++)
-				*dst = color;
-			dst_line += dst_llen;
-		}
+		for (y = y1; y <= y2; y++, dst_line += dst_llen)
+			fill_line_16(dst_line + x1, color, x2 - x1 + 1);
 		
 	/* mix colors for alpha mode */
 	} else {
@@ -67,96 +76,6 @@ static void draw_box_16(u16 *dst, int dst_llen, int x1, int y1, int w, int h,
 }
 
 
-/*** COPY SINGLE PIXEL COLUMN */
-static inline void copy_column(u16 *src, u16 *dst, int h, int src_w, int dst_w) {
-	if (h) for (; h--; src += src_w, dst += dst_w) *dst = *src;
-}
-
-
-/*** COPY PIXEL BLOCK 32BIT-WISE ***
- *
- * \param  s     source address
- * \param  d     32bit-aligned destination address
- * \param  w     number of 32bit words to copy per line
- * \param  line  line length in 16bit pixels
- */
-static inline void copy_block_32bit(u16 *src, u16 *dst, int w, int h,
-                                   int src_w, int dst_w) {
-	long d0, d1 ,d2;
-
-	asm volatile ("cld; mov %%ds, %%ax; mov %%ax, %%es" : : : "eax");
-	for (; h--; src += src_w, dst += dst_w ) {
-		asm volatile ("rep movsl"
-		 : "=S" (d0), "=D" (d1), "=c" (d2)
-		 : "S" (src), "D" (dst), "c" (w));
-	}
-}
-
-
-/*** COPY 32BYTE CHUNKS VIA MMX ***/
-static inline void copy_32byte_chunks(void *src, void *dst, int size) {
-	int dummy;
-	asm volatile (
-		"emms                             \n\t"
-		"xor    %%ecx,%%ecx               \n\t"
-		".align 16                        \n\t"
-		"0:                               \n\t"
-		"movq   (%%esi,%%ecx,8),%%mm0     \n\t"
-		"movq   8(%%esi,%%ecx,8),%%mm1    \n\t"
-		"movq   16(%%esi,%%ecx,8),%%mm2   \n\t"
-		"movq   24(%%esi,%%ecx,8),%%mm3   \n\t"
-		"movntq %%mm0,(%%edi,%%ecx,8)     \n\t"
-		"movntq %%mm1,8(%%edi,%%ecx,8)    \n\t"
-		"movntq %%mm2,16(%%edi,%%ecx,8)   \n\t"
-		"movntq %%mm3,24(%%edi,%%ecx,8)   \n\t"
-		"add    $4,%%ecx                  \n\t"
-		"dec    %%ebx                     \n\t"
-		"jnz    0b                        \n\t"
-		"sfence                           \n\t"
-		"emms                             \n\t"
-		: "=d" (dummy)
-		: "S" (src), "D" (dst), "b" (size)
-		: "eax", "ecx", "memory"
-	);
-}
-
-
-static inline void prefetch_32byte_chunks(void *src, int size) {
-	int dummy;
-	asm volatile (
-	    "xor    %%ecx,%%ecx               \n\t"
-		"0:                               \n\t"
-		"movl   (%%esi,%%ecx,8),%%eax     \n\t"
-		"movl   32(%%esi,%%ecx,8),%%eax   \n\t"
-		"add    $8,%%ecx                  \n\t"
-		"dec    %%ebx                     \n\t"
-		"jnz    0b                        \n\t"
-		: "=d" (dummy)
-		: "S" (src), "b" (size>>1)
-		: "eax", "ecx", "memory"
-	);
-}
-
-
-
-/*** COPY PIXEL BLOCK WITH A SIZE OF MULTIPLE OF 16 PIXELS ***
- *
- * \param  w      width in 16 pixel chunks
- * \param  line   line width in pixels
- */
-static inline void copy_block_32byte(u16 *src,   u16 *dst, int w, int h,
-                                     int  src_w, int  dst_w) {
-	int i;
-	u16 *s, *d;
-
-//	if (w>>1) for (i = h, s = src; i--; s += line)
-//		prefetch_32byte_chunks(s, w);
-
-	if (w) for (i = h, s = src, d = dst; i--; s += src_w, d += dst_w)
-		copy_32byte_chunks(s, d, w);
-}
-
-
 /*** DRAW CLIPPED 16BIT IMAGE TO 16BIT SCREEN ***/
 static void draw_img_16(u16 *dst, int dst_llen, int x, int y, int img_w,
                         int img_h, u16 *src, int op, u32 rgba) {
@@ -165,14 +84,6 @@ static void draw_img_16(u16 *dst, int dst_llen, int x, int y, int img_w,
 	u16 *s, *d;
 	u16  tint = (RGBA_TO_RGB16(rgba) >> 1) & 0x7bef;
 
-#if 0
-	/* flickerdiflacker */
-	draw_box_16(dst, x, y, w, h, -1);
-	draw_box_16(dst, x, y, w, h, GFX_RGB(0,0,0));
-	draw_box_16(dst, x, y, w, h, -1);
-	draw_box_16(dst, x, y, w, h, GFX_RGB(0,0,0));
-#endif
-
 	dst += y*dst_llen + x;
 
 	/* left clipping */
@@ -205,8 +116,7 @@ static void draw_img_16(u16 *dst, int dst_llen, int x, int y, int img_w,
 
 		case GFX_OP_DARKEN:
 			for (j = h; j--; src += img_w, dst += dst_llen)
-				for (i = w, s = src, d = dst; i--; s++, d++)
-					*d = (*s >> 1) & 0x7bef;
+				blit->half16(dst, src, 0, w);
 			break;
 
 		case GFX_OP_ALPHA:
@@ -217,39 +127,12 @@ static void draw_img_16(u16 *dst, int dst_llen, int x, int y, int img_w,
 
 		case GFX_OP_TINT:
 			for (j = h; j--; src += img_w, dst += dst_llen)
-				for (i = w, s = src, d = dst; i--; s++, d++)
-					*d = ((*s >> 1) & 0x7bef) + tint;
+				blit->half16(dst, src, tint, w);
 			break;
 
 		case GFX_OP_SOLID:
-			{
-				/* copy unaligned column */
-				if (w && ((long)dst & 2)) {
-					copy_column(src, dst, h, img_w, dst_llen);
-					w--; src++; dst++;
-				}
-
-				/* now, we are on a 32bit aligned destination address */
-
-				/* copy 16byte chunks */
-				if (w >> 4) {
-					copy_block_32byte(src, dst, w >> 4, h, img_w, dst_llen);
-					src += w & ~15;
-					dst += w & ~15;
-					w    = w &  15;
-				}
-
-				/* copy two-pixel chunks */
-				if (w >> 1) {
-					copy_block_32bit(src, dst, w >> 1, h, img_w, dst_llen);
-					src += w & ~1;
-					dst += w & ~1;
-					w    = w &  1;
-				}
-
-				/* handle trailing row */
-				if (w) copy_column(src, dst, h, img_w, dst_llen);
-			}
+			for (j = h; j--; src += img_w, dst += dst_llen)
+				blit->copy(dst, src, w*2);
 			break;
 	}
 }
@@ -360,12 +243,10 @@ static void draw_string_16(u16 *dst, int dst_llen, s16 x, s16 y, font *font,
  * typed pointers for source and destination types.
  */
 
-static gfx_interface gfx16 = {
+gfx_interface gfx16 = {
 	(void (*)(void *, int, int, int, int, int, u32))              draw_box_16,
 	(void (*)(void *, int, int, int, int, int, void *, int, u32)) draw_img_16,
 	(void (*)(void *, int, int, int, font *, u32, u8 *))          draw_string_16,
 };
 
-gfx_interface *gfx = &gfx16;   /* pointer to generic graphics backend */
-
 
@@ -0,0 +1,181 @@
+/*
+ * \brief   32bit graphics functions for Nitpicker
+ * \date    2026-10-19
+ *
+ * Pixels are stored as 0x00RRGGBB. A zero pixel is transparent for
+ * the alpha operation, just as for 16bit.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+#include "blit.h"
+
+
+#define RGBA_TO_RGB32(c) ((c) >> 8)
+#define GFX_ALPHA(rgba) (rgba&255)
+
+
+/*** DRAW FILLED BOX TO 32BIT SCREEN ***/
+static void draw_box_32(u32 *dst, int dst_llen, int x1, int y1, int w, int h,
+                        u32 rgba) {
+	int y;
+	u32 *dst_line;
+	u32 color;
+	int x2 = x1 + w - 1;
+	int y2 = y1 + h - 1;
+
+	/* check clipping */
+	if (x1 < clip_x1) x1 = clip_x1;
+	if (y1 < clip_y1) y1 = clip_y1;
+	if (x2 > clip_x2) x2 = clip_x2;
+	if (y2 > clip_y2) y2 = clip_y2;
+	if (x1 > x2) return;
+	if (y1 > y2) return;
+
+	color    = RGBA_TO_RGB32(rgba);
+	dst_line = dst + dst_llen*y1 + x1;
+
+	/* solid fill */
+	if (GFX_ALPHA(rgba) & 0x80) {
+		for (y = y1; y <= y2; y++, dst_line += dst_llen)
+			blit->fill32(dst_line, color, x2 - x1 + 1);
+
+	/* mix colors for alpha mode */
+	} else {
+		color = (color >> 1) & 0x7f7f7f;    /* 50% alpha mode */
+		for (y = y1; y <= y2; y++, dst_line += dst_llen)
+			blit->half32(dst_line, dst_line, color, x2 - x1 + 1);
+	}
+}
+
+
+/*** DRAW CLIPPED 32BIT IMAGE TO 32BIT SCREEN ***/
+static void draw_img_32(u32 *dst, int dst_llen, int x, int y, int img_w,
+                        int img_h, u32 *src, int op, u32 rgba) {
+	int  j;
+	int  w = img_w, h = img_h;
+	u32  tint = (RGBA_TO_RGB32(rgba) >> 1) & 0x7f7f7f;
+
+	dst += y*dst_llen + x;
+
+	/* left clipping */
+	if (x < clip_x1) {
+		w   -= (clip_x1 - x);
+		src += (clip_x1 - x);
+		dst += (clip_x1 - x);
+		x = clip_x1;
+	}
+
+	/* right clipping */
+	if (x + w - 1 > clip_x2) w -= (x + w - 1 - clip_x2);
+
+	/* top clipping */
+	if (y < clip_y1) {
+		h   -= (clip_y1 - y);
+		src += (clip_y1 - y)*img_w;
+		dst += (clip_y1 - y)*dst_llen;
+		y = clip_y1;
+	}
+
+	/* bottom clipping */
+	if (y + h - 1 > clip_y2) h -= (y + h - 1 - clip_y2);
+
+	/* anything left? */
+	if ((w <= 0) || (h <= 0)) return;
+
+	/* paint... */
+	switch (op) {
+
+		case GFX_OP_DARKEN:
+			for (j = h; j--; src += img_w, dst += dst_llen)
+				blit->half32(dst, src, 0, w);
+			break;
+
+		case GFX_OP_ALPHA:
+			for (j = h; j--; src += img_w, dst += dst_llen)
+				blit->key32(dst, src, w);
+			break;
+
+		case GFX_OP_TINT:
+			for (j = h; j--; src += img_w, dst += dst_llen)
+				blit->half32(dst, src, tint, w);
+			break;
+
+		case GFX_OP_SOLID:
+			for (j = h; j--; src += img_w, dst += dst_llen)
+				blit->copy(dst, src, w*4);
+			break;
+	}
+}
+
+
+/*** DRAW STRING TO 32BIT SCREEN ***
+ *
+ * Each character is clipped individually, its lines are set via the
+ * label kernel using the font image as mask.
+ */
+static void draw_string_32(u32 *dst, int dst_llen, s16 x, s16 y, font *font,
+                           s32 rgba, u8 *str) {
+	s32 *wtab = font->width_table;
+	s32 *otab = font->offset_table;
+	int img_w = font->img_w;
+	int h     = font->img_h;
+	u8  *src  = font->image;
+	u32 color = RGBA_TO_RGB32((u32)rgba);
+	int j, cx1, cx2;
+	u8  *s;
+	u32 *d;
+
+	if (!str || !dst) return;
+
+	/* check top clipping */
+	if (y < clip_y1) {
+		src += (clip_y1 - y)*img_w;   /* skip upper lines in font image    */
+		h   -= (clip_y1 - y);         /* decrement number of lines to draw */
+		y    = clip_y1;
+	}
+
+	/* check bottom clipping */
+	if (h > clip_y2 - y + 1)
+		h = clip_y2 - y + 1;
+
+	if (h < 1) return;
+
+	dst += y*dst_llen;
+
+	for (; *str && (x <= clip_x2); x += wtab[*str], str++) {
+
+		/* visible part of the character */
+		cx1 = x < clip_x1 ? clip_x1 : x;
+		cx2 = x + wtab[*str] - 1;
+		if (cx2 > clip_x2) cx2 = clip_x2;
+		if (cx1 > cx2) continue;
+
+		s = src + otab[*str] + cx1 - x;
+		d = dst + cx1;
+		for (j = h; j--; s += img_w, d += dst_llen)
+			blit->label32(d, s, color, cx2 - cx1 + 1);
+	}
+}
+
+
+/*
+ * We need to cast the functions to be compliant with
+ * the gfx interface because the implementations use
+ * typed pointers for source and destination types.
+ */
+
+gfx_interface gfx32 = {
+	(void (*)(void *, int, int, int, int, int, u32))              draw_box_32,
+	(void (*)(void *, int, int, int, int, int, void *, int, u32)) draw_img_32,
+	(void (*)(void *, int, int, int, font *, u32, u8 *))          draw_string_32,
+};
@@ -14,16 +14,11 @@
  */
 
 /*** L4 INCLUDES ***/
-#include <l4/input/macros.h>
 #include <l4/nitpicker/event.h>
-#include <l4/util/util.h>
-#include <l4/sys/syscalls.h>
-
-/* FIXME: DICE should name the error functions for client and server different */
-#include <l4/nitpicker/nitevent-client.h>   /* deliver input events */
 
 /*** LOCAL INCLUDES ***/
 #include "nitpicker.h"
+#include "keycodes.h"
 
 #include "bigmouse.c"             /* graphics for the mouse cursor */
 
@@ -38,6 +33,7 @@ int            mode      = 0;                /* current nitpicker mode   */
 int            mx, my;                       /* current mouse position   */
 CORBA_Object   myself;
 static int     num_keys;                     /* nb of currently pressed keys */
+static u32     mouse_pixels_32[16][16];      /* mouse cursor for 32bit   */
 
 
 /*** INTERFACE: PROVIDE INFORMATION ABOUT THE PHYSICAL SCREEN ***/
@@ -97,21 +93,6 @@ static void refresh_screen(void) {
  *** INPUT EVENT HANDLING ***
  ****************************/
 
-/*** SEND INPUT EVENT TO CURRENTLY FOCUSED CLIENT ***/
-static void event_send(CORBA_Object dst, unsigned long token,
-                       int type, int code,
-                       int rx, int ry, int mx, int my) {
-	CORBA_Environment env = dice_default_environment;
-	if (!dst) return;
-
-	env.timeout = l4_ipc_timeout(781,7,781,7);
-	nitevent_event_send(dst, token, type, code, rx, ry, mx, my, &env);
-
-//	if (env.major != CORBA_NO_EXCEPTION)
-//		printf("nitevent_event_send: IPC error %d\n", env._p.ipc_error);
-}
-
-
 /*** SET MOUSE CURSOR TO THE SPECIFIED POSITION ***/
 static void set_mousepos(int new_mx, int new_my) {
 
@@ -202,7 +183,7 @@ void handle_normal_input(int type, int code, int rx, int ry) {
 			/* block and handle kill mode */
 			while (mode & MODE_KILL) {
 				foreach_input_event(handle_kill_input);
-				l4_usleep(10*1000);
+				input_wait();
 			}
 
 		} else if (code == BTN_LEFT || code == BTN_RIGHT || code == BTN_MIDDLE) {
@@ -260,8 +241,7 @@ int main(int argc, char **argv) {
 	printf("sizeof(client) = %d\nsizeof(view)   = %d\nsizeof(buffer) = %d\n",
 	       sizeof(client), sizeof(view), sizeof(buffer));
 
-	CORBA_Object_base dummy = l4_myself();
-	myself = &dummy;
+	myself = server_self();
 
 	/* init and install memory space for our own client */
 	add_client(myself, &self_client_struct[0], 10, 10);
@@ -269,6 +249,7 @@ int main(int argc, char **argv) {
 	/* sub-system initialization */
 	TRY(native_startup(argc, argv), "Native startup failed");
 	TRY(scr_init(),   "Screen init failed");
+	TRY(gfx_init(scr_depth), "Graphics init failed");
 	TRY(input_init(), "Input init failed");
 
 	/* create buffer for the mouse cursor graphics */
@@ -277,6 +258,18 @@ int main(int argc, char **argv) {
 		b->w    =  bigmouse_trp.width;
 		b->h    =  bigmouse_trp.height;
 		b->data = &bigmouse_trp.pixels[0][0];
+
+		/* convert RGB565 cursor, black remains transparent */
+		if (scr_depth == 32) {
+			int i, j;
+			for (j = 0; j < 16; j++) for (i = 0; i < 16; i++) {
+				u32 c = (u16)bigmouse_trp.pixels[j][i];
+				mouse_pixels_32[j][i] = ((c & 0xf800) << 8)
+				                      | ((c & 0x07e0) << 5)
+				                      | ((c & 0x001f) << 3);
+			}
+			b->data = &mouse_pixels_32[0][0];
+		}
 	}
 
 	/* create view for the mouse cursor */
@@ -304,7 +297,7 @@ int main(int argc, char **argv) {
 	menu_buf = lookup_buffer(myself, menu_buf_id);
 	menu_buf->w = scr_width;
 	menu_buf->h = 16;
-	menu_buf->data = malloc(scr_width*2*16);
+	menu_buf->data = malloc(scr_width*(scr_depth/8)*16);
 	menubar_set_text("", "");
 
 	menu_view_id = nitpicker_new_view_component(myself, menu_buf_id, 0, 0);
@@ -23,6 +23,189 @@ unsigned long      curr_token;   /* token of focused view      */
 CORBA_Object_base  curr_evrec;   /* current event receiver     */
 
 
+/******************
+ *** VIEW INDEX ***
+ ******************/
+
+/*
+ * The screen is divided into a grid of cells. For each column and each
+ * row of the grid, a bitmap marks the stack positions of the views that
+ * touch it, including their border. Because views are rectangles, a
+ * view touches a range of cells exactly if it touches one of the columns
+ * and one of the rows of the range. Views outside the screen are
+ * assigned to the columns and rows at the screen edge. Moving a view
+ * updates only the bits of the view. Changes of the view stack renumber
+ * the stack positions, so the index is rebuilt lazily at its next use.
+ * If the view stack is too large for the index, the view stack is
+ * walked linearly.
+ */
+#define INDEX_WORDS (MAX_INDEX_VIEWS/32)
+
+static view *index_views[MAX_INDEX_VIEWS];     /* views by stack position */
+static u32   col_views[MAX_GRID_W][INDEX_WORDS];
+static u32   row_views[MAX_GRID_H][INDEX_WORDS];
+static int   index_num_views;
+static int   index_dirty = 1;                  /* index must be rebuilt   */
+static int   index_valid;                      /* index can be used       */
+static int   grid_shift, grid_w, grid_h;       /* cell size and grid size */
+
+
+/*** UTILITY: DETERMINE GRID COLUMN OR ROW OF A SCREEN COORDINATE ***/
+static inline int grid_pos(int p, int size) {
+	if (p < 0) p = 0;
+	p >>= grid_shift;
+	return (p < size) ? p : size - 1;
+}
+
+
+/*** UTILITY: SET OR CLEAR THE BIT OF A VIEW IN ALL COLUMNS AND ROWS IT TOUCHES ***/
+static void mark_view(view *v, int set) {
+	int i, gx1, gy1, gx2, gy2, w = v->z >> 5;
+	int x1 = v->x - BORDER, x2 = v->x + v->w - 1 + BORDER;
+	int y1 = v->y - BORDER, y2 = v->y + v->h - 1 + BORDER;
+	u32 bit = 1U << (v->z & 31);
+
+	if ((x1 > x2) || (y1 > y2)) return;
+
+	gx1 = grid_pos(x1, grid_w); gx2 = grid_pos(x2, grid_w);
+	gy1 = grid_pos(y1, grid_h); gy2 = grid_pos(y2, grid_h);
+
+	if (set) {
+		for (i = gx1; i <= gx2; i++) col_views[i][w] |= bit;
+		for (i = gy1; i <= gy2; i++) row_views[i][w] |= bit;
+	} else {
+		for (i = gx1; i <= gx2; i++) col_views[i][w] &= ~bit;
+		for (i = gy1; i <= gy2; i++) row_views[i][w] &= ~bit;
+	}
+}
+
+
+/*** UTILITY: REBUILD VIEW INDEX FROM THE VIEW STACK ***/
+static void rebuild_index(void) {
+	int i;
+	view *v;
+
+	index_dirty = 0;
+	index_valid = 0;
+
+	if ((scr_width <= 0) || (scr_height <= 0)) return;
+
+	/* choose the smallest cell size for which the grid fits the screen */
+	for (grid_shift = 6; ((scr_width  - 1) >> grid_shift) >= MAX_GRID_W
+	                  || ((scr_height - 1) >> grid_shift) >= MAX_GRID_H; grid_shift++);
+	grid_w = ((scr_width  - 1) >> grid_shift) + 1;
+	grid_h = ((scr_height - 1) >> grid_shift) + 1;
+
+	memset(col_views, 0, sizeof(col_views));
+	memset(row_views, 0, sizeof(row_views));
+
+	/* assign stack positions */
+	for (i = 0, v = first_view; v; v = v->next, i++) {
+		if (i == MAX_INDEX_VIEWS) return;
+		v->z = i;
+		index_views[i] = v;
+		mark_view(v, 1);
+	}
+	index_num_views = i;
+	index_valid = 1;
+}
+
+
+/*** UTILITY: CHECK IF VIEW IS PART OF AN UP-TO-DATE VIEW INDEX ***/
+static inline int in_index(view *v) {
+	return !index_dirty && index_valid && v
+	    && (v->z < index_num_views) && (index_views[v->z] == v);
+}
+
+
+/*** UTILITY: BRING VIEW INDEX UP TO DATE AND CHECK IF IT COVERS A VIEW ***/
+static inline int indexed(view *v) {
+	if (index_dirty) rebuild_index();
+	return in_index(v);
+}
+
+
+/*
+ * Candidate lists are NULL-terminated arrays of the views that may
+ * intersect the area of a draw_rec call or a label placement. Like the
+ * visible rectangles, the lists of nested draw_rec calls are stacked.
+ */
+static view *view_cands[MAX_VIEW_CANDS];
+static int   num_view_cands;   /* top of the candidate stack */
+
+
+/*** UTILITY: ADD VIEW TO CANDIDATE LIST IF IT TOUCHES THE SPECIFIED AREA ***
+ *
+ * \return  1 if the view covers the area such that the views behind
+ *          cannot become visible within the area
+ */
+static inline int add_cand(view *v, int x1, int y1, int x2, int y2) {
+
+	if ((v->x - BORDER > x2) || (v->x + v->w - 1 + BORDER < x1)
+	 || (v->y - BORDER > y2) || (v->y + v->h - 1 + BORDER < y1)) return 0;
+
+	view_cands[num_view_cands++] = v;
+
+	return !(v->flags & VIEW_FLAGS_TRANSPARENT)
+	    && (v->x <= x1) && (v->x + v->w - 1 >= x2)
+	    && (v->y <= y1) && (v->y + v->h - 1 >= y2);
+}
+
+
+/*** UTILITY: COLLECT VIEWS FROM CV TO LV THAT TOUCH THE SPECIFIED AREA ***
+ *
+ * The views are taken from the columns and rows touched by the area
+ * or, if combining their bitmaps is more expensive than looking at all
+ * views from cv to lv, directly from the stack order.
+ *
+ * \param lv  last view to consider or NULL for the end of the view stack
+ * \return    start of the candidate list in the candidate stack or
+ *            -1 if the view stack must be walked instead
+ */
+static int collect_cands(view *cv, view *lv, int x1, int y1, int x2, int y2) {
+	int w, z, gx, gy, gx1, gy1, gx2, gy2, covered = 0;
+	int base = num_view_cands;
+	int w1, w2;   /* first and last bitmap word of the views from cv to lv */
+	int last;     /* stack position of lv                                  */
+
+	if (!indexed(cv) || (x1 > x2) || (y1 > y2)) return -1;
+
+	last = in_index(lv) ? lv->z : index_num_views - 1;
+	if (MAX_VIEW_CANDS - base <= last - cv->z + 1) return -1;
+
+	gx1 = grid_pos(x1, grid_w); gx2 = grid_pos(x2, grid_w);
+	gy1 = grid_pos(y1, grid_h); gy2 = grid_pos(y2, grid_h);
+	w1  = cv->z >> 5;
+	w2  = last >> 5;
+
+	if ((gx2 - gx1 + gy2 - gy1 + 2)*(w2 - w1 + 1) > last - cv->z + 1) {
+		for (z = cv->z; z <= last; z++)
+			if (add_cand(index_views[z], x1, y1, x2, y2)) break;
+
+		view_cands[num_view_cands++] = NULL;
+		return base;
+	}
+
+	/* take views that touch a column and a row of the area in stack order */
+	for (w = w1; (w <= w2) && !covered; w++) {
+		u32 bits = 0, rows = 0;
+
+		for (gx = gx1; gx <= gx2; gx++) bits |= col_views[gx][w];
+		for (gy = gy1; gy <= gy2; gy++) rows |= row_views[gy][w];
+		bits &= rows;
+
+		/* ignore the views in front of cv and behind lv */
+		if (w == w1) bits &= ~0U << (cv->z & 31);
+		if (w == w2) bits &= ~0U >> (31 - (last & 31));
+
+		for (; bits && !covered; bits &= bits - 1)
+			covered = add_cand(index_views[w*32 + __builtin_ctz(bits)], x1, y1, x2, y2);
+	}
+	view_cands[num_view_cands++] = NULL;
+	return base;
+}
+
+
 /**********************************
  *** FUNCTIONS FOR INTERNAL USE ***
  **********************************/
@@ -49,47 +232,69 @@ static inline void draw_frame(view *cv) {
 }
 
 
-/*** UTILITY: DRAW VIEW TO PHYSICAL SCREEN ***/
-static inline void draw_view(view *cv) {
+/*** UTILITY: DETERMINE PAINT OPERATION FOR A VIEW ***/
+static int view_op(view *cv) {
 
 	/* dimming in x-ray mode but not in kill mode */
 	int op = (mode == MODE_SECURE) ? GFX_OP_DARKEN : GFX_OP_SOLID;
 
 	if (!(mode & MODE_KILL)) {
-//		if (curr_view && (curr_view->buf == cv->buf)) op = GFX_OP_SOLID;
 		if (curr_view && (curr_view == cv)) op = GFX_OP_SOLID;
 		if (cv->flags & VIEW_FLAGS_FRONT)   op = GFX_OP_SOLID;
 	}
 
-	push_clipping(cv->x, cv->y, cv->w, cv->h);
-
-	/* draw views behind the current view */
-	if (cv->flags & VIEW_FLAGS_TRANSPARENT) {
-		draw_rec(cv->next, 0, 0, MAX(clip_x1, cv->x), MAX(clip_y1, cv->y),
-		                         MIN(clip_x2, cv->x + cv->w - 1),
-		                         MIN(clip_y2, cv->y + cv->h - 1));
-
-		/* if we have a transparent background, draw the foreground masked */
+	/* if we have a transparent background, draw the foreground masked */
+	if (cv->flags & VIEW_FLAGS_TRANSPARENT)
 		op = GFX_OP_ALPHA;
-	}
 
 	if ((mode & MODE_KILL) && !(cv->flags & VIEW_FLAGS_TRANSPARENT))
 		op = GFX_OP_TINT;
 
-	/* draw buffer */
-	if (cv->buf && cv->buf->data)
-		gfx->draw_img(scr_adr, scr_llen, cv->x - cv->buf_x, cv->y - cv->buf_y,
-		              cv->buf->w, cv->buf->h, cv->buf->data, op, GFX_RGB(255,0,0));
-	else
-		gfx->draw_box(scr_adr, scr_llen, cv->x, cv->y, cv->w, cv->h,
-		              GFX_RGB(50,60,70));
+	return op;
+}
+
+
+/*** UTILITY: DRAW VIEW TO PHYSICAL SCREEN ***
+ *
+ * The view is drawn within the current clipping area only. The frame
+ * and the label are skipped if they do not touch the clipping area.
+ *
+ * \param op          paint operation determined by view_op
+ * \param frame_only  draw only the frame but not the buffer
+ */
+static inline void draw_view(view *cv, int op, int frame_only) {
+
+	if (!frame_only) {
+		push_clipping(cv->x, cv->y, cv->w, cv->h);
+
+		/* draw views behind the current view */
+		if (cv->flags & VIEW_FLAGS_TRANSPARENT)
+			draw_rec(cv->next, 0, 0, clip_x1, clip_y1, clip_x2, clip_y2);
 
-	pop_clipping();
+		/* draw buffer */
+		if (cv->buf && cv->buf->data)
+			gfx->draw_img(scr_adr, scr_llen, cv->x - cv->buf_x, cv->y - cv->buf_y,
+			              cv->buf->w, cv->buf->h, cv->buf->data, op, GFX_RGB(255,0,0));
+		else
+			gfx->draw_box(scr_adr, scr_llen, cv->x, cv->y, cv->w, cv->h,
+			              GFX_RGB(50,60,70));
 
-	if (mode) draw_frame(cv);
+		pop_clipping();
+	}
+
+	if (!mode) return;
+
+	/* frame is only visible if the clipping area exceeds the view area */
+	if ((clip_x1 < cv->x) || (clip_x2 >= cv->x + cv->w)
+	 || (clip_y1 < cv->y) || (clip_y2 >= cv->y + cv->h))
+		draw_frame(cv);
+
+	if (frame_only) return;
 
-	/* draw label */
-	if (mode && (cv->flags & VIEW_FLAGS_LABEL) && cv->label) {
+	/* draw label, including its outline */
+	if ((cv->flags & VIEW_FLAGS_LABEL) && cv->label
+	 && (clip_x1 <= cv->lx + cv->lw + 3) && (clip_x2 >= cv->lx)
+	 && (clip_y1 <= cv->ly + cv->lh + 3) && (clip_y2 >= cv->ly)) {
 		u32 fgcol = (cv == curr_view) ? GFX_RGB(255,255,127) : GFX_RGB(216,216,216);
 		push_clipping(cv->x, cv->y, cv->w, cv->h);
 		DRAW_LABEL(scr_adr, scr_llen, cv->lx + 2, cv->ly+2, GFX_RGB(0, 0, 0),
@@ -128,28 +333,30 @@ static int intersect(view *v, int x1, int y1, int x2, int y2,
 }
 
 
+static int label_cut_w;    /* widest visible area of the view            */
+static int label_placed;   /* flag that indicates a successful placement */
+
+
 /*** UTILITY: POSITION THE LABEL SUCH THAT IT IS VISIBLE ***
  *
  * \param cv         current view in the view stack
+ * \param cand       position of cv in the candidate list or NULL
  * \param lv         view of the label to position
  * \param cx1, cy1   left top point of visible area at current depth
  * \param cx2, cy2   right bottom point of visible area
  */
-static void place_label_rec(view *cv, view *lv,
+static void place_label_rec(view *cv, view **cand, view *lv,
                             int cx1, int cy1, int cx2, int cy2) {
 
-	int sx1, sy1, sx2, sy2;  /* intersection area                          */
-	static int cut_w;        /* widest visible area of the view            */
-	static int placed;       /* flag that indicates a successful placement */
+	int sx1, sy1, sx2, sy2;  /* intersection area */
+	view **nc  = cand ? cand + 1 : NULL;
+	view *next = cand ? *nc : (cv ? cv->next : NULL);
 
 	/* sanity check */
 	if (!cv || !lv) return;
 
-	/* init for the first iteration */
-	if (cv == first_view->next) cut_w = placed = 0;
-
 	/* do not replace a label that has already a cosy position */
-	if (placed) return;
+	if (label_placed) return;
 
 	/* if there is an intersection */
 	if (intersect(cv, cx1, cy1, cx2, cy2, &sx1, &sy1, &sx2, &sy2)) {
@@ -161,8 +368,7 @@ static void place_label_rec(view *cv, view *lv,
 			if ((sx2 - sx1 + 1 > cv->lw) && (sy2 - sy1 + 1 > cv->lh)) {
 				cv->lx = sx1 + (sx2 - sx1 + 1 - cv->lw)/2;
 				cv->ly = sy1;
-				placed = 1;   /* mark label as placed */
-				return;
+				label_placed = 1;   /* mark label as placed */
 
 			} else if (sy2 - sy1 + 1 > cv->lh) {
 
@@ -174,31 +380,35 @@ static void place_label_rec(view *cv, view *lv,
 				 * This way, we exhibit as much information of the label
 				 * as possible.
 				 */
-				if ((sx2 - sx1 + 1 > cut_w) && !placed) {
+				if (sx2 - sx1 + 1 > label_cut_w) {
 					cv->lx = sx1;
 					cv->ly = sy1;
-					cut_w = sx2 - sx1 + 1;
+					label_cut_w = sx2 - sx1 + 1;
 				}
 			}
+
+			/* views behind the desired view cannot cover its label */
+			return;
 		}
 
 		/* check the next view of the view stack */
-		if (cv->next == NULL) return;
+		if (next == NULL) return;
 
-		if (sy1 > cy1) place_label_rec(cv->next, lv, cx1, cy1, cx2, sy1 - 1);
-		if (sx1 > cx1) place_label_rec(cv->next, lv, cx1, cy1, sx1 - 1, cy2);
-		if (sx2 < cx2) place_label_rec(cv->next, lv, sx2 + 1, cy1, cx2, cy2);
-		if (sy2 < cy2) place_label_rec(cv->next, lv, cx1, sy2 + 1, cx2, cy2);
+		if (sy1 > cy1) place_label_rec(next, nc, lv, cx1, cy1, cx2, sy1 - 1);
+		if (sx1 > cx1) place_label_rec(next, nc, lv, cx1, cy1, sx1 - 1, cy2);
+		if (sx2 < cx2) place_label_rec(next, nc, lv, sx2 + 1, cy1, cx2, cy2);
+		if (sy2 < cy2) place_label_rec(next, nc, lv, cx1, sy2 + 1, cx2, cy2);
 
-	} else place_label_rec(cv->next, lv, cx1, cy1, cx2, cy2);
+	} else place_label_rec(next, nc, lv, cx1, cy1, cx2, cy2);
 }
 
 
 /*** UTILITY: PLACE LABEL TO A VISIBLE POSITION ***/
 static void place_label(view *v) {
 	int old_lx = v->lx, old_ly = v->ly;
-	int x1 = v->x, x2 = x1 + v->w - 1;
-	int y1 = v->y, y2 = y1 + v->h - 1;
+	int x1 = MAX(0, v->x), x2 = MIN(scr_width  - 1, v->x + v->w - 1);
+	int y1 = MAX(0, v->y), y2 = MIN(scr_height - 1, v->y + v->h - 1);
+	int cands = collect_cands(first_view->next, v, x1, y1, x2, y2);
 
 	v->lx = v->x;
 	v->ly = v->y;
@@ -206,8 +416,13 @@ static void place_label(view *v) {
 	      + font_string_width (default_font, v->client_name) + 5;
 	v->lh = font_string_height(default_font, v->label);
 
-	place_label_rec(first_view->next, v, MAX(0, x1), MAX(0, y1),
-	                MIN(scr_width - 1, x2), MIN(scr_height - 1, y2));
+	label_cut_w = label_placed = 0;
+	if (cands < 0)
+		place_label_rec(first_view->next, NULL, v, x1, y1, x2, y2);
+	else {
+		place_label_rec(view_cands[cands], &view_cands[cands], v, x1, y1, x2, y2);
+		num_view_cands = cands;
+	}
 
 	/* do not update labels when they are not visible */
 	if (mode != MODE_SECURE) return;
@@ -217,10 +432,18 @@ static void place_label(view *v) {
 }
 
 
-/*** UTILITY: POSITION LABELS THAT ARE AFFECTED BY SPECIFIED AREA ***/
-static void label_area(int x1, int y1, int x2, int y2) {
-	view *cv = first_view->next;   /* ignore the mouse view */
-	int ix1, iy1, ix2, iy2;        /* intersection area     */
+/*** UTILITY: POSITION LABELS THAT ARE AFFECTED BY SPECIFIED AREA ***
+ *
+ * The label position of a view depends only on the views in front of
+ * it. If only one view changed, the views in front of it are skipped.
+ *
+ * \param cv  first view that may be affected
+ */
+static void label_area(view *cv, int x1, int y1, int x2, int y2) {
+	int ix1, iy1, ix2, iy2;   /* intersection area */
+
+	/* ignore the mouse view and views that are not part of the view stack */
+	if (!indexed(cv) || (cv == first_view)) cv = first_view->next;
 
 	/* reposition label of each intersecting view but the last one (background) */
 	for (; cv->next ; cv = cv->next) {
@@ -274,6 +497,8 @@ static void activate_background(view *v) {
 
 	if (dice_obj_eq(&curr_view->owner, &v->owner))
 		CHAIN_LISTELEMENT(&first_view, next, get_last_normal_view(), v);
+
+	invalidate_view_index();
 }
 
 
@@ -291,38 +516,135 @@ static void activate_background(view *v) {
  *** NITPICKER FUNCTIONS ***
  ***************************/
 
-/*** DRAW VIEWS IN SPECIFIED AREA ***/
-void draw_rec(view *cv, view *dst, buffer *exc,
-              int cx1, int cy1, int cx2, int cy2) {
+/*
+ * The visible area is partitioned into disjoint rectangles, each covered
+ * by exactly one view. Instead of drawing each rectangle as soon as it
+ * is found, the rectangles are collected and drawn view by view. The
+ * paint operation is determined once per view, the frame and the label
+ * are drawn only into rectangles that they touch. Transparent views call
+ * draw_rec recursively while being drawn. Their rectangles are stacked
+ * on top of the ones of the calling draw_rec.
+ */
+static struct vis_rect {
+	view *v;
+	int   x1, y1, x2, y2;
+} vis_rects[MAX_VIS_RECTS];
+
+static int num_vis_rects;   /* top of the rectangle stack */
+
+
+/*** UTILITY: DRAW COLLECTED RECTANGLES, GROUPED BY VIEW ***/
+static void flush_rects(int base, buffer *exc) {
+	int i, j, op, frame_only;
+	int top = num_vis_rects;
+	view *cv;
+
+	for (i = base; i < top; i++) {
+		if (!(cv = vis_rects[i].v)) continue;
+
+		op         = view_op(cv);
+		frame_only = cv->buf && (cv->buf == exc);
+
+		for (j = i; j < top; j++) {
+			struct vis_rect *r = &vis_rects[j];
+			if (r->v != cv) continue;
+
+			push_clipping(r->x1, r->y1, r->x2 - r->x1 + 1, r->y2 - r->y1 + 1);
+			draw_view(cv, op, frame_only);
+			pop_clipping();
+			r->v = NULL;
+		}
+	}
+	num_vis_rects = base;
+}
+
+
+/*** UTILITY: ADD VISIBLE RECTANGLE OF A VIEW ***
+ *
+ * A draw_rec call uses at most half of the free rectangle slots and
+ * leaves the other half to the calls of the transparent views it draws.
+ * When its half is full, the collected rectangles are drawn. If there
+ * is no slot left at all, the rectangle is drawn immediately.
+ */
+static void add_rect(view *cv, buffer *exc, int base,
+                     int x1, int y1, int x2, int y2) {
+	struct vis_rect *r;
+	int limit = base + (MAX_VIS_RECTS - base)/2;
+
+	if (limit == base) {
+		push_clipping(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+		draw_view(cv, view_op(cv), cv->buf && (cv->buf == exc));
+		pop_clipping();
+		return;
+	}
+
+	if (num_vis_rects == limit) flush_rects(base, exc);
+
+	r = &vis_rects[num_vis_rects++];
+	r->v  = cv;
+	r->x1 = x1; r->y1 = y1;
+	r->x2 = x2; r->y2 = y2;
+}
+
+
+/*** UTILITY: COLLECT VISIBLE RECTANGLES OF VIEWS IN SPECIFIED AREA ***
+ *
+ * \param cand  position of cv in the candidate list or NULL if the
+ *              following views are taken from the view stack
+ */
+static void collect_rec(view *cv, view **cand, view *dst, buffer *exc, int base,
+                        int cx1, int cy1, int cx2, int cy2) {
 
 	int sx1, sy1, sx2, sy2;
-	view *next = cv ? cv->next : NULL;
+	view **nc  = cand ? cand + 1 : NULL;
+	view *next = cand ? *nc : (cv ? cv->next : NULL);
 
 	if (!cv) return;
 
 	/* if there is an intersection - subdivide area */
 	if (!intersect(cv, cx1, cy1, cx2, cy2, &sx1, &sy1, &sx2, &sy2)) {
-		draw_rec(cv->next, dst, exc, cx1, cy1, cx2, cy2);
+		collect_rec(next, nc, dst, exc, base, cx1, cy1, cx2, cy2);
 		return;
 	}
 
 	if (next && (sy1 > cy1))
-		draw_rec(next, dst, exc, cx1, cy1, cx2, sy1 - 1);
+		collect_rec(next, nc, dst, exc, base, cx1, cy1, cx2, sy1 - 1);
 	if (next && (sx1 > cx1))
-		draw_rec(next, dst, exc, cx1, MAX(cy1, sy1), sx1 - 1, MIN(cy2, sy2));
+		collect_rec(next, nc, dst, exc, base, cx1, MAX(cy1, sy1), sx1 - 1, MIN(cy2, sy2));
 
-	/* draw current view */
-	if ((!dst || (dst == cv) || (cv->flags & VIEW_FLAGS_TRANSPARENT))) {
-		push_clipping(sx1, sy1, sx2 - sx1 + 1, sy2 - sy1 + 1);
-		if (!cv->buf || cv->buf != exc) draw_view(cv);
-		else if (mode) draw_frame(cv);
-		pop_clipping();
-	}
+	/* remember visible rectangle of current view */
+	if ((!dst || (dst == cv) || (cv->flags & VIEW_FLAGS_TRANSPARENT)))
+		add_rect(cv, exc, base, sx1, sy1, sx2, sy2);
 
 	if (next && (sx2 < cx2))
-		draw_rec(next, dst, exc, sx2 + 1, MAX(cy1, sy1), cx2, MIN(cy2, sy2));
+		collect_rec(next, nc, dst, exc, base, sx2 + 1, MAX(cy1, sy1), cx2, MIN(cy2, sy2));
 	if (next && (sy2 < cy2))
-		draw_rec(next, dst, exc, cx1, sy2 + 1, cx2, cy2);
+		collect_rec(next, nc, dst, exc, base, cx1, sy2 + 1, cx2, cy2);
+}
+
+
+/*** DRAW VIEWS IN SPECIFIED AREA ***/
+void draw_rec(view *cv, view *dst, buffer *exc,
+              int cx1, int cy1, int cx2, int cy2) {
+
+	int base  = num_vis_rects;
+	int cands = collect_cands(cv, NULL, cx1, cy1, cx2, cy2);
+
+	if (cands < 0)
+		collect_rec(cv, NULL, dst, exc, base, cx1, cy1, cx2, cy2);
+	else
+		collect_rec(view_cands[cands], &view_cands[cands], dst, exc, base,
+		            cx1, cy1, cx2, cy2);
+
+	flush_rects(base, exc);
+
+	if (cands >= 0) num_view_cands = cands;
+}
+
+
+/*** MARK VIEW INDEX AS OUTDATED ***/
+void invalidate_view_index(void) {
+	index_dirty = 1;
 }
 
 
@@ -363,6 +685,27 @@ void refresh_view(view *v, view *dst, int x, int y, int w, int h) {
 /*** FIND THE VIEW AT THE SPECIFIED SCREEN POSITION ***/
 view *find_view(int x, int y) {
 	view *cv = first_view->next;
+	int w;
+
+	/* look only at the views that touch the cell at the position */
+	if (indexed(first_view) && (x >= 0) && (x < scr_width)
+	                        && (y >= 0) && (y < scr_height)) {
+
+		int gx = x >> grid_shift, gy = y >> grid_shift;
+
+		for (w = 0; w <= (index_num_views - 1) >> 5; w++) {
+			u32 bits = col_views[gx][w] & row_views[gy][w];
+
+			if (w == 0) bits &= ~1U;   /* ignore the mouse view */
+
+			for (; bits; bits &= bits - 1) {
+				cv = index_views[w*32 + __builtin_ctz(bits)];
+				if ((x >= cv->x) && (x < cv->x + cv->w)
+				 && (y >= cv->y) && (y < cv->y + cv->h)) return cv;
+			}
+		}
+		return NULL;
+	}
 
 	for (; cv; cv = cv->next) {
 		if ((x >= cv->x) && (x < cv->x + cv->w)
@@ -440,6 +783,7 @@ int nitpicker_new_view_component(CORBA_Object _dice_corba_obj,
 
 	/* place view at top most stack position after staytop views */
 	CHAIN_LISTELEMENT(&first_view, next, get_last_staytop_view(), (&c->views[id]));
+	invalidate_view_index();
 
 	return id;
 }
@@ -470,13 +814,14 @@ void nitpicker_destroy_view_component(CORBA_Object _dice_corba_obj,
 
 	/* remove view from the view stack list */
 	UNCHAIN_LISTELEMENT(view, &first_view, next, v);
+	invalidate_view_index();
 
 	/* dealloc view label and mark view as free */
 	v->state = STATE_FREE;
 
 	/* refresh the original view area and update labels */
 	draw_rec(first_view, NULL, NULL, x1, y1, x2, y2);
-	label_area(x1, y1, x2, y2);
+	label_area(NULL, x1, y1, x2, y2);
 }
 
 
@@ -495,6 +840,9 @@ int nitpicker_set_view_port_component(CORBA_Object _dice_corba_obj,
 	x1 = v->x; x2 = v->x + v->w - 1;
 	y1 = v->y; y2 = v->y + v->h - 1;
 
+	/* the stack order is unchanged, only the cells of the view change */
+	if (in_index(v)) mark_view(v, 0);
+
 	v->buf_x = buf_x;
 	v->buf_y = buf_y;
 	v->x = x;
@@ -502,6 +850,8 @@ int nitpicker_set_view_port_component(CORBA_Object _dice_corba_obj,
 	v->w = w;
 	v->h = h;
 
+	if (in_index(v)) mark_view(v, 1);
+
 	/* determine compound area */
 	x1 = MIN(x1, x) - BORDER;
 	y1 = MIN(y1, y) - BORDER;
@@ -512,7 +862,7 @@ int nitpicker_set_view_port_component(CORBA_Object _dice_corba_obj,
 	draw_rec(first_view, NULL, do_redraw ? NULL : v->buf, x1, y1, x2, y2);
 
 	/* reposition labels that are affected of the changed area */
-	if (!(v->flags & VIEW_FLAGS_STAYTOP)) label_area(x1, y1, x2, y2);
+	if (!(v->flags & VIEW_FLAGS_STAYTOP)) label_area(v, x1, y1, x2, y2);
 
 	return NITPICKER_OK;
 }
@@ -570,12 +920,13 @@ int nitpicker_stack_view_component(CORBA_Object _dice_corba_obj, int view_id,
 
 		lv = cv;
 	}
+	invalidate_view_index();
 
 	/* refresh affected screen area */
 	if (do_redraw)
 		refresh_view(v, 0, 0, 0, v->w, v->h);
 
-	label_area(v->x, v->y, v->x + v->w - 1, v->y + v->h - 1);
+	label_area(NULL, v->x, v->y, v->x + v->w - 1, v->y + v->h - 1);
 
 	return NITPICKER_OK;
 }
@@ -617,6 +968,7 @@ int nitpicker_set_background_component(CORBA_Object _dice_corba_obj, int view_id
 
 		/* move view in front of the nitpicker background */
 		UNCHAIN_LISTELEMENT(view, &first_view, next, c->bg);
+		invalidate_view_index();
 
 		if (curr_view && dice_obj_eq(&c->bg->owner, &curr_view->owner))
 			activate_background(c->bg);
@@ -0,0 +1,57 @@
+/*
+ * \brief   Nitpicker pixel line kernels
+ * \date    2026-10-19
+ *
+ * The inner loops of the gfx backends operate on single pixel lines.
+ * They are implemented in plain C and, if the CPU supports it, with
+ * SSE2. blit_init selects the fastest variant at runtime.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef _NITPICKER_BLIT_H_
+#define _NITPICKER_BLIT_H_
+
+#include "types.h"
+
+typedef struct blit_ops {
+
+	/*** COPY BYTES, SOURCE AND DESTINATION MUST NOT OVERLAP ***/
+	void (*copy)    (void *dst, const void *src, int bytes);
+
+	/*** SET N 32BIT WORDS TO VAL ***/
+	void (*fill32)  (u32 *dst, u32 val, int n);
+
+	/*** DST = ((SRC >> 1) & 0x7bef) + ADD FOR N 16BIT PIXELS ***/
+	void (*half16)  (u16 *dst, const u16 *src, u16 add, int n);
+
+	/*** DST = ((SRC >> 1) & 0x7f7f7f) + ADD FOR N 32BIT PIXELS ***/
+	void (*half32)  (u32 *dst, const u32 *src, u32 add, int n);
+
+	/*** COPY N 32BIT PIXELS THAT ARE NOT ZERO ***/
+	void (*key32)   (u32 *dst, const u32 *src, int n);
+
+	/*** SET 32BIT PIXELS TO COLOR WHERE THE 8BIT MASK IS NOT ZERO ***/
+	void (*label32) (u32 *dst, const u8 *mask, u32 color, int n);
+
+} blit_ops;
+
+extern blit_ops *blit;        /* kernels selected by blit_init */
+extern blit_ops  blit_c;      /* portable kernels              */
+extern blit_ops  blit_sse2;   /* SSE2 kernels, x86 only        */
+
+
+/*** SELECT KERNELS FOR THE CURRENT CPU ***
+ *
+ * \return  name of the selected kernel set
+ */
+extern const char *blit_init(void);
+
+#endif /* _NITPICKER_BLIT_H_ */
@@ -81,6 +81,15 @@ typedef struct gfx_interface {
 
 } gfx_interface;
 
-extern gfx_interface *gfx;
+extern gfx_interface *gfx;     /* backend selected by gfx_init */
+extern gfx_interface  gfx16;   /* RGB565 pixels                */
+extern gfx_interface  gfx32;   /* XRGB8888 pixels              */
+
+
+/*** SELECT GRAPHICS BACKEND FOR SCREEN DEPTH ***
+ *
+ * \return  0 on success, -1 if the depth is not supported
+ */
+extern int gfx_init(int depth);
 
 #endif /* _NITPICKER_GFX_H_ */
@@ -28,4 +28,12 @@ extern int input_init(void);
 extern void foreach_input_event(void (*handle)(int type, int code, int rx, int ry));
 
 
+/*** WAIT A MOMENT FOR NEW INPUT EVENTS ***
+ *
+ * This function is used while nitpicker blocks for user input,
+ * e.g., in kill mode.
+ */
+extern void input_wait(void);
+
+
 #endif /* _NITPICKER_VIEW_H_ */
@@ -21,8 +21,13 @@
  *** COMPILE TIME CONFIGURATION ***
  **********************************/
 
-#define MAX_CLIPSTACK    64   /* maximum size of clipping stack */
-#define MAX_INPUT_EVENTS 64   /* size of input event queue      */
+#define MAX_CLIPSTACK      64   /* maximum size of clipping stack   */
+#define MAX_INPUT_EVENTS   64   /* size of input event queue        */
+#define MAX_VIS_RECTS     512   /* rectangles collected by draw_rec */
+#define MAX_VIEW_CANDS   2048   /* views considered by draw_rec     */
+#define MAX_INDEX_VIEWS  1024   /* views covered by the view index  */
+#define MAX_GRID_W         32   /* columns of the view index        */
+#define MAX_GRID_H         32   /* rows of the view index           */
 
 
 #define NITPICKER_OK                0
@@ -35,6 +40,7 @@
  ************************/
 
 #include <stdio.h>
+#include <string.h>
 #include <strings.h>
 #include <stdlib.h>
 
@@ -26,6 +26,33 @@ extern CORBA_Object nit_server;
 extern int dice_obj_eq(CORBA_Object o1, CORBA_Object o2);
 
 
+/*** REQUEST ID OF NITPICKER ITSELF ***/
+extern CORBA_Object server_self(void);
+
+
+/*** MAP DATASPACE OF A CLIENT INTO THE LOCAL ADDRESS SPACE ***
+ *
+ * \param ds    dataspace to map
+ * \param size  number of bytes to map
+ * \param addr  resulting local address
+ * \return      0 on success
+ */
+extern int attach_ds(const l4dm_dataspace_t *ds, int size, void **addr);
+
+
+/*** REMOVE DATASPACE FROM THE LOCAL ADDRESS SPACE ***/
+extern void detach_ds(void *addr);
+
+
+/*** REQUEST NAME OF A CLIENT TO BE USED AS LABEL ***/
+extern void query_client_label(CORBA_Object tid, char *dst, int max_len);
+
+
+/*** SEND INPUT EVENT TO CLIENT ***/
+extern void event_send(CORBA_Object dst, unsigned long token, int type, int code,
+                       int rx, int ry, int mx, int my);
+
+
 /*** START PROCESSING CLIENT REQUESTS ***
  *
  * Normally, this function does not return.
@@ -45,6 +45,7 @@ typedef struct view {
 	struct view *next;            /* next view in ordered stacking list     */
 	CORBA_Object_base listener;   /* receiver of events for this view       */
 	CORBA_Object_base owner;      /* associated client id                   */
+	int z;                        /* stack position, set by the view index  */
 } view;
 
 extern CORBA_Object_base curr_evrec;    /* current event receiver   */
@@ -53,6 +54,14 @@ extern view             *curr_view;     /* currently focused view   */
 extern view             *first_view;    /* first view of view stack */
 
 
+/*** MARK VIEW INDEX AS OUTDATED ***
+ *
+ * Must be called whenever the view stack or the position
+ * or size of a view changes.
+ */
+extern void invalidate_view_index(void);
+
+
 /*** LOOK UP VIEW STRUCTURE ***/
 extern view *lookup_view(CORBA_Object tid, int view_id);
 
@@ -15,6 +15,7 @@
 
 /*** L4 INCLUDES ***/
 #include <l4/sys/syscalls.h>                /* for l4_myself()      */
+#include <l4/util/util.h>                   /* for l4_usleep()      */
 #include <l4/input/libinput.h>              /* input device driver  */
 #include <l4/input/macros.h>                /* key and button codes */
 #include <l4/generic_io/libio.h>            /* l4io mode for input  */
@@ -98,6 +99,12 @@ void foreach_input_event(void (*handle)(int type, int code, int rx, int ry)) {
 }
 
 
+/*** WAIT A MOMENT FOR NEW INPUT EVENTS ***/
+void input_wait(void) {
+	l4_usleep(10*1000);
+}
+
+
 /*** INITIALIZE INPUT SUBSYSTEM ***/
 int input_init(void) {
 
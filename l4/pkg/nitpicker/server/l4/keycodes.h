@@ -0,0 +1,20 @@
+/*
+ * \brief   Key codes used by Nitpicker
+ * \date    2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef _NITPICKER_KEYCODES_H_
+#define _NITPICKER_KEYCODES_H_
+
+#include <l4/input/macros.h>
+
+#endif /* _NITPICKER_KEYCODES_H_ */
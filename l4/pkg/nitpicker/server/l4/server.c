@@ -16,6 +16,10 @@
 /*** L4 INCLUDES ***/
 #include <l4/sys/syscalls.h>
 #include <l4/names/libnames.h>
+#include <l4/l4rm/l4rm.h>
+
+/* FIXME: DICE should name the error functions for client and server different */
+#include <l4/nitpicker/nitevent-client.h>   /* deliver input events */
 
 /*** LOCAL INCLUDES ***/
 #include "nitpicker.h"
@@ -40,6 +44,46 @@ int dice_obj_eq(CORBA_Object o1, CORBA_Object o2) {
 }
 
 
+/*** REQUEST ID OF NITPICKER ITSELF ***/
+CORBA_Object server_self(void) {
+	static CORBA_Object_base self;
+	self = l4_myself();
+	return &self;
+}
+
+
+/*** MAP DATASPACE OF A CLIENT INTO THE LOCAL ADDRESS SPACE ***/
+int attach_ds(const l4dm_dataspace_t *ds, int size, void **addr) {
+	return l4rm_attach(ds, size, 0, L4DM_RW, addr);
+}
+
+
+/*** REMOVE DATASPACE FROM THE LOCAL ADDRESS SPACE ***/
+void detach_ds(void *addr) {
+	l4rm_detach(addr);
+}
+
+
+/*** REQUEST NAME OF A CLIENT AT THE NAMES SERVER ***/
+void query_client_label(CORBA_Object tid, char *dst, int max_len) {
+	names_query_id(*tid, dst, max_len);
+}
+
+
+/*** SEND INPUT EVENT TO CLIENT ***/
+void event_send(CORBA_Object dst, unsigned long token, int type, int code,
+                int rx, int ry, int mx, int my) {
+	CORBA_Environment env = dice_default_environment;
+	if (!dst) return;
+
+	env.timeout = l4_ipc_timeout(781,7,781,7);
+	nitevent_event_send(dst, token, type, code, rx, ry, mx, my, &env);
+
+//	if (env.major != CORBA_NO_EXCEPTION)
+//		printf("nitevent_event_send: IPC error %d\n", env._p.ipc_error);
+}
+
+
 /*** CUSTOM IMPLEMENTATION FOR NITPICKER SERVER LOOP ***
  *
  * We need the custom implementation to check for input events
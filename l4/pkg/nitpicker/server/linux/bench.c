@@ -0,0 +1,194 @@
+/*
+ * \brief   Nitpicker compositing benchmark
+ * \date    2026-10-19
+ *
+ * A number of clients create overlapping views. The views are then
+ * moved, restacked, and refreshed through the same interface functions
+ * that serve remote clients on L4. Each phase is timed separately.
+ * The pseudo random sequence is fixed so that runs can be compared.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** GENERAL INCLUDES ***/
+#include <sys/time.h>
+#include <arpa/inet.h>
+
+/*** L4 INCLUDES ***/
+#include <l4/nitpicker/event.h>
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+#include "host.h"
+
+#define BENCH_CLIENTS   4     /* the views are spread over the clients */
+#define BENCH_BUFFERS   2     /* buffers per client                    */
+#define BENCH_BUF_W   320
+#define BENCH_BUF_H   240
+
+static CORBA_Object_base tid[BENCH_CLIENTS];
+static int num_views;
+static unsigned long seed = 1;
+
+
+/*** UTILITY: PSEUDO RANDOM NUMBER IN THE RANGE 0..MAX-1 ***/
+static int rnd(int max) {
+	seed = seed*1103515245 + 12345;
+	return max > 0 ? (int)((seed >> 16) % max) : 0;
+}
+
+
+/*** UTILITY: CURRENT TIME IN MICROSECONDS ***/
+static double now_usec(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec*1000.0*1000.0 + tv.tv_usec;
+}
+
+
+/*** UTILITY: PRINT RESULT OF A BENCHMARK PHASE ***/
+static void report(char *name, int ops, double usec) {
+	printf("%-22s %7d ops  %10.1f ops/s  %8.1f usec/op\n", name, ops,
+	       usec > 0 ? ops*1000.0*1000.0/usec : 0, ops ? usec/ops : 0);
+}
+
+
+/*** UTILITY: FILL BUFFER WITH A PATTERN THAT DIFFERS PER BUFFER ***/
+static void fill_buffer(buffer *b, int idx) {
+	int x, y;
+
+	for (y = 0; y < b->h; y++) for (x = 0; x < b->w; x++) {
+		int r = (x*4 + idx*40) & 255, g = (y*4) & 255, bl = (idx*70) & 255;
+		if (scr_depth == 16)
+			((u16 *)b->data)[y*b->w + x] = ((r & 0xf8) << 8) | ((g & 0xfc) << 3) | (bl >> 3);
+		else
+			((u32 *)b->data)[y*b->w + x] = (r << 16) | (g << 8) | bl;
+	}
+}
+
+
+/*** UTILITY: DETERMINE CLIENT AND VIEW ID OF A BENCHMARK VIEW ***/
+static void view_id(int i, CORBA_Object *t, int *id) {
+	*t  = &tid[i % BENCH_CLIENTS];
+	*id = i / BENCH_CLIENTS;
+}
+
+
+/*** CREATE CLIENTS, BUFFERS, AND VIEWS OF THE BENCHMARK ***/
+int bench_setup(int views) {
+	int i, j, max_views = (views + BENCH_CLIENTS - 1) / BENCH_CLIENTS;
+
+	num_views = views;
+
+	for (i = 0; i < BENCH_CLIENTS; i++) {
+		char *mem = malloc(sizeof(client) + max_views*sizeof(view)
+		                                  + BENCH_BUFFERS*sizeof(buffer));
+		TRY(!mem, "Out of memory");
+
+		tid[i].sin_family      = AF_INET;
+		tid[i].sin_port        = htons(i + 1);
+		tid[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		add_client(&tid[i], mem, max_views, BENCH_BUFFERS);
+
+		for (j = 0; j < BENCH_BUFFERS; j++) {
+			int id = nitpicker_import_buffer_component(&tid[i], NULL,
+			                                           BENCH_BUF_W, BENCH_BUF_H, NULL);
+			buffer *b = lookup_buffer(&tid[i], id);
+
+			TRY(!b, "Cannot create buffer");
+			TRY(!(b->data = malloc(BENCH_BUF_W*BENCH_BUF_H*scr_depth/8)), "Out of memory");
+			fill_buffer(b, i*BENCH_BUFFERS + j);
+		}
+	}
+
+	for (i = 0; i < num_views; i++) {
+		CORBA_Object t;
+		int id, w = 64 + rnd(BENCH_BUF_W - 64), h = 48 + rnd(BENCH_BUF_H - 48);
+		char title[MAX_LABEL];
+
+		view_id(i, &t, &id);
+		TRY(nitpicker_new_view_component(t, rnd(BENCH_BUFFERS), NULL, NULL) != id,
+		    "Cannot create view %d", i);
+
+		snprintf(title, sizeof(title), "view %d", i);
+		nitpicker_set_view_title_component(t, id, title, NULL);
+		nitpicker_set_view_port_component(t, id, rnd(BENCH_BUF_W - w), rnd(BENCH_BUF_H - h),
+		                                  rnd(scr_width - w), 16 + rnd(scr_height - 16 - h),
+		                                  w, h, 1, NULL);
+	}
+	printf("Benchmark: %d views of %d clients on %dx%dx%d\n",
+	       num_views, BENCH_CLIENTS, scr_width, scr_height, scr_depth);
+	return 0;
+}
+
+
+/*** MOVE, RESTACK, AND REFRESH THE BENCHMARK VIEWS AND REPORT TIMINGS ***/
+void bench_run(int num_ops) {
+	int i, id, full_ops = MAX(num_ops / 10, 1);
+	CORBA_Object t;
+	double start;
+	view *v;
+
+	/* redraw of the whole screen */
+	start = now_usec();
+	for (i = 0; i < full_ops; i++)
+		draw_rec(first_view, NULL, NULL, 0, 0, scr_width - 1, scr_height - 1);
+	report("draw_rec (screen)", full_ops, now_usec() - start);
+
+	/* update of view areas including the views in front */
+	start = now_usec();
+	for (i = 0; i < num_ops; i++) {
+		view_id(rnd(num_views), &t, &id);
+		if (!(v = lookup_view(t, id))) continue;
+		refresh_view(v, NULL, rnd(v->w), rnd(v->h), 1 + rnd(v->w), 1 + rnd(v->h));
+	}
+	report("refresh_view", num_ops, now_usec() - start);
+
+	/* pointer motion, which moves the mouse view and looks up the view below */
+	start = now_usec();
+	for (i = 0; i < num_ops; i++)
+		handle_normal_input(NITEVENT_TYPE_MOTION, 0, rnd(33) - 16, rnd(33) - 16);
+	report("pointer motion", num_ops, now_usec() - start);
+
+	/* client-side buffer updates, affecting all views of the buffer */
+	start = now_usec();
+	for (i = 0; i < num_ops; i++) {
+		int x = rnd(BENCH_BUF_W), y = rnd(BENCH_BUF_H);
+		nitpicker_refresh_component(&tid[rnd(BENCH_CLIENTS)], rnd(BENCH_BUFFERS),
+		                            x, y, 1 + rnd(BENCH_BUF_W - x),
+		                            1 + rnd(BENCH_BUF_H - y), NULL);
+	}
+	report("refresh (buffer)", num_ops, now_usec() - start);
+
+	/* dragging of views by a few pixels */
+	start = now_usec();
+	for (i = 0; i < num_ops; i++) {
+		view_id(rnd(num_views), &t, &id);
+		if (!(v = lookup_view(t, id))) continue;
+		nitpicker_set_view_port_component(t, id, v->buf_x, v->buf_y,
+		                                  v->x + rnd(17) - 8, v->y + rnd(17) - 8,
+		                                  v->w, v->h, 1, NULL);
+	}
+	report("move", num_ops, now_usec() - start);
+
+	/* pull views to the front or behind other views of their client */
+	start = now_usec();
+	for (i = 0; i < num_ops; i++) {
+		int neighbor = -1, behind = 0;
+
+		view_id(rnd(num_views), &t, &id);
+		if (rnd(2)) {
+			neighbor = rnd((num_views + BENCH_CLIENTS - 1) / BENCH_CLIENTS);
+			behind   = 1;
+		}
+		nitpicker_stack_view_component(t, id, neighbor, behind, 1, NULL);
+	}
+	report("restack", num_ops, now_usec() - start);
+}
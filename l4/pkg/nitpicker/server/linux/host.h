@@ -0,0 +1,35 @@
+/*
+ * \brief   Nitpicker functions specific to the Linux host
+ * \date    2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+#ifndef _NITPICKER_HOST_H_
+#define _NITPICKER_HOST_H_
+
+
+/*** WRITE SCREEN CONTENT TO PPM FILE ***/
+extern int scr_dump(char *filename);
+
+
+/*** CHECK IF THE INPUT SCRIPT HAS EVENTS LEFT ***/
+extern int input_pending(void);
+
+
+/*** CREATE CLIENTS, BUFFERS, AND VIEWS OF THE BENCHMARK ***/
+extern int bench_setup(int num_views);
+
+
+/*** MOVE, RESTACK, AND REFRESH THE BENCHMARK VIEWS AND REPORT TIMINGS ***/
+extern void bench_run(int num_ops);
+
+
+#endif /* _NITPICKER_HOST_H_ */
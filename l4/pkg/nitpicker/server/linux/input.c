@@ -0,0 +1,99 @@
+/*
+ * \brief   Nitpicker scripted input for Linux
+ * \date    2026-10-19
+ *
+ * Input events are read from the script file specified at startup.
+ * Each line contains one event:
+ *
+ *   motion <rx> <ry>    relative mouse motion
+ *   wheel <rx> <ry>     wheel motion
+ *   press <code>        key or button press, Linux key codes
+ *   release <code>      key or button release
+ *   sync                end of the events of one input poll
+ *
+ * Empty lines and lines starting with '#' are ignored.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** GENERAL INCLUDES ***/
+#include <string.h>
+
+/*** L4 INCLUDES ***/
+#include <l4/nitpicker/event.h>
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+
+extern char *config_script;   /* defined in startup.c */
+
+static FILE *script;
+static int   script_line;
+
+
+/***************************
+ *** INPUT EVENT HANDLER ***
+ ***************************/
+
+/*** READ EVENTS FROM SCRIPT UP TO THE NEXT SYNC LINE AND HANDLE THEM ***/
+void foreach_input_event(void (*handle)(int type, int code, int rx, int ry)) {
+	char line[128], cmd[16];
+	int a, b, n;
+
+	while (script && fgets(line, sizeof(line), script)) {
+
+		script_line++;
+		n = sscanf(line, "%15s %d %d", cmd, &a, &b);
+		if ((n < 1) || (cmd[0] == '#')) continue;
+
+		if      (!strcmp(cmd, "sync"))              return;
+		else if (!strcmp(cmd, "motion")  && n == 3) handle(NITEVENT_TYPE_MOTION,  0, a, b);
+		else if (!strcmp(cmd, "wheel")   && n == 3) handle(NITEVENT_TYPE_WHEEL,   0, a, b);
+		else if (!strcmp(cmd, "press")   && n >= 2) handle(NITEVENT_TYPE_PRESS,   a, 0, 0);
+		else if (!strcmp(cmd, "release") && n >= 2) handle(NITEVENT_TYPE_RELEASE, a, 0, 0);
+		else printf("Warning: %s:%d: invalid input event\n", config_script, script_line);
+	}
+
+	/* end of script */
+	if (script) {
+		fclose(script);
+		script = NULL;
+	}
+}
+
+
+/*** CHECK IF THE SCRIPT HAS EVENTS LEFT ***/
+int input_pending(void) {
+	return script != NULL;
+}
+
+
+/*** WAIT A MOMENT FOR NEW INPUT EVENTS ***
+ *
+ * Nothing can happen anymore once the script is finished.
+ */
+void input_wait(void) {
+	if (script) return;
+
+	printf("Error: input script ended while waiting for input\n");
+	exit(1);
+}
+
+
+/*** INITIALIZE INPUT SUBSYSTEM ***/
+int input_init(void) {
+
+	if (!config_script) return 0;
+
+	TRY(!(script = fopen(config_script, "r")), "Cannot open input script %s",
+	    config_script);
+
+	return 0;
+}
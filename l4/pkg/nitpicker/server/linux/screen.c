@@ -0,0 +1,75 @@
+/*
+ * \brief   Nitpicker in-memory screen for Linux
+ * \date    2026-10-19
+ *
+ * Nitpicker draws into a frame buffer in memory. Its content can be
+ * written to a PPM file via scr_dump.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+
+int    scr_width, scr_height;  /* screen dimensions      */
+int    scr_depth;              /* color depth            */
+int    scr_llen;               /* bytes per scanline     */
+void  *scr_adr;                /* frame buffer adress    */
+
+extern int config_scr_width;   /* defined in startup.c   */
+extern int config_scr_height;
+extern int config_scr_depth;
+
+
+/*** SET UP SCREEN ***/
+int scr_init(void) {
+
+	scr_width  = config_scr_width;
+	scr_height = config_scr_height;
+	scr_depth  = config_scr_depth;
+	scr_llen   = scr_width;
+
+	TRY(!(scr_adr = calloc(scr_width*scr_height, scr_depth/8)),
+	    "Cannot allocate frame buffer of %dx%dx%d", scr_width, scr_height, scr_depth);
+
+	printf("Resolution:         %dx%dx%d (in memory)\n",
+	       scr_width, scr_height, scr_depth);
+	return 0;
+}
+
+
+/*** WRITE SCREEN CONTENT TO PPM FILE ***/
+int scr_dump(char *filename) {
+	int i;
+	FILE *f = fopen(filename, "wb");
+
+	TRY(!f, "Cannot open %s", filename);
+
+	fprintf(f, "P6\n%d %d\n255\n", scr_width, scr_height);
+	for (i = 0; i < scr_width*scr_height; i++) {
+		u32 c;
+		u8  rgb[3];
+
+		if (scr_depth == 16) {
+			c = ((u16 *)scr_adr)[i];
+			rgb[0] = (c >> 8) & 0xf8;
+			rgb[1] = (c >> 3) & 0xfc;
+			rgb[2] = (c << 3) & 0xf8;
+		} else {
+			c = ((u32 *)scr_adr)[i];
+			rgb[0] = c >> 16;
+			rgb[1] = c >> 8;
+			rgb[2] = c;
+		}
+		fwrite(rgb, 1, 3, f);
+	}
+	fclose(f);
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * \brief   Nitpicker server for the Linux host
+ * \date    2026-10-19
+ *
+ * There are no remote clients on the host. Instead, the benchmark
+ * creates clients within the nitpicker process and calls the
+ * interface functions directly. The memory of these clients is
+ * allocated via malloc. Once the benchmark and the input script are
+ * done, start_server returns and nitpicker exits.
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** GENERAL INCLUDES ***/
+#include <arpa/inet.h>
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+#include "host.h"
+
+CORBA_Object_base nit_tid, *nit_server;
+
+static int num_events;          /* input events sent to clients */
+
+extern char *config_dump;       /* defined in startup.c */
+extern int   config_bench_views;
+extern int   config_bench_ops;
+
+
+/*** COMPARE IF TWO CORBA OBJECTS ARE THE SAME ***/
+int dice_obj_eq(CORBA_Object o1, CORBA_Object o2) {
+	if (!o1 && !o2) return 1;
+	if (!o1 || !o2) return 0;
+	return (o1->sin_addr.s_addr == o2->sin_addr.s_addr)
+	    && (o1->sin_port        == o2->sin_port);
+}
+
+
+/*** REQUEST ID OF NITPICKER ITSELF ***/
+CORBA_Object server_self(void) {
+	static CORBA_Object_base self;
+	self.sin_family      = AF_INET;
+	self.sin_port        = 0;
+	self.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	return &self;
+}
+
+
+/*** DATASPACES ARE NOT SUPPORTED ON THE HOST ***/
+int attach_ds(const l4dm_dataspace_t *ds, int size, void **addr) {
+	printf("Error: dataspaces are not supported on the host\n");
+	return -1;
+}
+
+
+/*** FREE CLIENT MEMORY ***/
+void detach_ds(void *addr) {
+	free(addr);
+}
+
+
+/*** NAME CLIENTS BY THEIR PORT ***/
+void query_client_label(CORBA_Object tid, char *dst, int max_len) {
+	snprintf(dst, max_len, "client%d", ntohs(tid->sin_port));
+}
+
+
+/*** COUNT INPUT EVENTS, THERE IS NOBODY TO RECEIVE THEM ***/
+void event_send(CORBA_Object dst, unsigned long token, int type, int code,
+                int rx, int ry, int mx, int my) {
+	if (dst) num_events++;
+}
+
+
+/*** RUN BENCHMARK AND INPUT SCRIPT ***/
+int start_server(void) {
+
+	nit_tid    = *server_self();
+	nit_server = &nit_tid;
+
+	if (config_bench_views)
+		TRY(bench_setup(config_bench_views), "Benchmark setup failed");
+
+	/* replay input script, e.g., to set the mode or focus */
+	while (input_pending())
+		foreach_input_event(handle_normal_input);
+
+	if (config_bench_views)
+		bench_run(config_bench_ops);
+
+	printf("Nitpicker: %d input events delivered to clients\n", num_events);
+
+	if (config_dump)
+		TRY(scr_dump(config_dump), "Cannot write screen dump");
+
+	return 0;
+}
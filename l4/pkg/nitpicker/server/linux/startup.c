@@ -0,0 +1,63 @@
+/*
+ * \brief   Nitpicker Linux specific startup and configuration
+ * \date    2026-10-19
+ */
+
+/*
+ * Copyright (C) 2026  Technische Universitaet Dresden
+ * Operating Systems Research Group
+ *
+ * This file is part of the nitpicker package, which is distributed under
+ * the  terms  of the  GNU General Public Licence 2.  Please see the
+ * COPYING file for details.
+ */
+
+/*** GENERAL INCLUDES ***/
+#include <getopt.h>
+
+/*** LOCAL INCLUDES ***/
+#include "nitpicker.h"
+
+int   config_scr_width  = 1024;   /* size of the in-memory screen      */
+int   config_scr_height = 768;
+int   config_scr_depth  = 16;     /* color depth of the in-memory screen */
+char *config_script;              /* file with scripted input events   */
+char *config_dump;                /* file to write the final screen to */
+int   config_bench_views;         /* number of views of the benchmark  */
+int   config_bench_ops  = 1000;   /* operations per benchmark phase    */
+
+
+/*** PARSE COMMAND LINE ARGUMENTS AND SET GLOBAL CONFIG VARIABLES ***/
+int native_startup(int argc, char **argv) {
+	int c;
+
+	static struct option long_options[] = {
+		{"width",   1, 0, 'w'},
+		{"height",  1, 0, 'h'},
+		{"depth",   1, 0, 'd'},
+		{"script",  1, 0, 's'},
+		{"dump",    1, 0, 'o'},
+		{"bench",   1, 0, 'b'},
+		{"ops",     1, 0, 'n'},
+		{0, 0, 0, 0}
+	};
+
+	while ((c = getopt_long(argc, argv, "w:h:d:s:o:b:n:", long_options, NULL)) != -1) {
+
+		switch (c) {
+			case 'w': config_scr_width   = atol(optarg); break;
+			case 'h': config_scr_height  = atol(optarg); break;
+			case 'd': config_scr_depth   = atol(optarg); break;
+			case 's': config_script      = optarg;       break;
+			case 'o': config_dump        = optarg;       break;
+			case 'b': config_bench_views = atol(optarg); break;
+			case 'n': config_bench_ops   = atol(optarg); break;
+			default:
+				printf("Usage: %s [--width <w>] [--height <h>] [--depth 16|32]\n"
+				       "       [--script <file>] [--dump <file>]\n"
+				       "       [--bench <views>] [--ops <n>]\n", argv[0]);
+				return -1;
+		}
+	}
+	return 0;
+}
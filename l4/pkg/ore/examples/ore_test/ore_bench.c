@@ -0,0 +1,229 @@
+/****************************************************************
+ * Packets per second through ORe using string IPC, DSI and     *
+ * shared-memory rings.                                         *
+ *                                                              *
+ * tx:   one connection sends to a MAC which is not local, so   *
+ *       every packet goes to the NIC.                          *
+ * loop: two connections on the same device, one sends to the  *
+ *       other and the receiver fetches every batch. This does  *
+ *       not work for DSI, because the DSI worker does no local *
+ *       delivery.                                              *
+ *                                                              *
+ * (c) 2026 Technische Universitaet Dresden                     *
+ * This file is part of DROPS, which is distributed under the   *
+ * terms of the GNU General Public License 2. Please see the    *
+ * COPYING file for details.                                    *
+ ****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <l4/log/l4log.h>
+#include <l4/util/util.h>
+#include <l4/util/rdtsc.h>
+#include <l4/ore/ore.h>
+#include <l4/sys/ipc.h>
+#include <l4/env/errno.h>
+#include <l4/dm_generic/types.h>
+#include <l4/dm_mem/dm_mem.h>
+
+#define ETH_HLEN        14
+#define DS_SIZE         1024*1024
+
+#define BENCH_DEVICE    "eth0"
+#define BENCH_PACKETS   20000
+#define BENCH_BATCH     32
+#define BENCH_SLOT      2048
+
+char LOG_tag[9] = "ore_bnch";
+
+l4_ssize_t l4libc_heapsize = 256 * 1024;
+
+enum
+{
+    MODE_STRING,
+    MODE_DSI,
+    MODE_RING,
+    MODE_MAX,
+};
+
+static const char *mode_name[MODE_MAX] = { "string", "dsi", "ring" };
+
+static const unsigned char remote_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+static char packet[BENCH_SLOT];
+static char rx_buf[BENCH_SLOT];
+
+/* Open a connection using the given transport. */
+static int bench_open(int mode, unsigned char mac[6])
+{
+    l4ore_config conf = L4ORE_DEFAULT_CONFIG;
+    int ret = 0;
+
+    switch (mode)
+    {
+    case MODE_DSI:
+        ret = l4dm_mem_open(L4DM_DEFAULT_DSM, DS_SIZE, 0, L4DM_CONTIGUOUS,
+                            "bench send dataspace", &conf.ro_send_ds);
+        if (!ret)
+            ret = l4dm_mem_open(L4DM_DEFAULT_DSM, DS_SIZE, 0, L4DM_CONTIGUOUS,
+                                "bench recv dataspace", &conf.ro_recv_ds);
+        break;
+    case MODE_RING:
+        ret = l4dm_mem_open(L4DM_DEFAULT_DSM, L4ORE_RING_DS_SIZE, 0, 0,
+                            "bench ring dataspace", &conf.ro_ring_ds);
+        break;
+    }
+
+    if (ret)
+    {
+        LOG_Error("creating dataspace: %d (%s)", ret, l4env_errstr(ret));
+        return ret;
+    }
+
+    return l4ore_open(BENCH_DEVICE, mac, &conf);
+}
+
+/* Buffer to build the next packet in. DSI needs the packet inside the send
+ * area, rings avoid the copy if the packet is built in the slot. */
+static char *bench_buf(int mode, int handle, int i)
+{
+    char *buf = NULL;
+
+    if (mode == MODE_DSI)
+        buf = l4ore_get_send_area(handle);
+    if (buf)
+        return buf + (i % 64) * BENCH_SLOT;
+
+    if (mode == MODE_RING)
+        buf = l4ore_ring_get_tx_buf(handle);
+
+    return buf ? buf : packet;
+}
+
+static void bench_fill(char *buf, const unsigned char dst[6],
+                       const unsigned char src[6], int size)
+{
+    memcpy(buf, dst, 6);
+    memcpy(buf + 6, src, 6);
+    buf[12] = (size - ETH_HLEN) >> 8;
+    buf[13] = (size - ETH_HLEN) & 0xFF;
+}
+
+static void bench_report(const char *test, int mode, int size,
+                         int packets, l4_cpu_time_t tsc)
+{
+    l4_uint64_t us = l4_tsc_to_ns(tsc) / 1000;
+
+    if (us == 0)
+        us = 1;
+    LOG_printf("%-4s %-6s %4d bytes: %6d packets in %8u us = %7u pps\n",
+               test, mode_name[mode], size, packets, (unsigned)us,
+               (unsigned)((l4_uint64_t)packets * 1000000 / us));
+}
+
+static void bench_tx(int mode, int size)
+{
+    unsigned char mac[6];
+    l4_cpu_time_t start;
+    int handle, i;
+
+    handle = bench_open(mode, mac);
+    if (handle < 0)
+    {
+        LOG_printf("tx   %-6s: open failed: %d\n", mode_name[mode], handle);
+        return;
+    }
+    if (mode == MODE_DSI && !l4ore_get_send_area(handle))
+    {
+        LOG_printf("tx   %-6s: not supported by this build\n", mode_name[mode]);
+        l4ore_close(handle);
+        return;
+    }
+
+    start = l4_rdtsc();
+    for (i = 0; i < BENCH_PACKETS; i++)
+    {
+        char *buf = bench_buf(mode, handle, i);
+
+        bench_fill(buf, remote_mac, mac, size);
+        if (l4ore_send(handle, buf, size))
+            break;
+    }
+    bench_report("tx", mode, size, i, l4_rdtsc() - start);
+
+    l4ore_close(handle);
+}
+
+static void bench_loop(int mode, int size)
+{
+    unsigned char mac_tx[6], mac_rx[6];
+    l4_cpu_time_t start;
+    int tx, rx, i, received = 0, lost = 0;
+
+    tx = bench_open(mode, mac_tx);
+    rx = bench_open(mode, mac_rx);
+    if (tx < 0 || rx < 0)
+    {
+        LOG_printf("loop %-6s: open failed: %d %d\n", mode_name[mode], tx, rx);
+        return;
+    }
+
+    start = l4_rdtsc();
+    for (i = 0; i < BENCH_PACKETS; i += BENCH_BATCH)
+    {
+        int j;
+
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            char *buf = bench_buf(mode, tx, i + j);
+
+            bench_fill(buf, mac_rx, mac_tx, size);
+            l4ore_send(tx, buf, size);
+        }
+
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            char *buf    = rx_buf;
+            l4_size_t len = sizeof(rx_buf);
+
+            if (l4ore_recv_blocking(rx, &buf, &len,
+                                    l4_timeout(L4_IPC_TIMEOUT_NEVER,
+                                               l4_timeout_rel(100, 10))))
+            {
+                lost += BENCH_BATCH - j;
+                break;
+            }
+            received++;
+        }
+    }
+    bench_report("loop", mode, size, received, l4_rdtsc() - start);
+    if (lost)
+        LOG_printf("loop %-6s: %d packets lost\n", mode_name[mode], lost);
+
+    l4ore_close(tx);
+    l4ore_close(rx);
+}
+
+int main(int argc, char **argv)
+{
+    static const int sizes[] = { 64, 1514 };
+    unsigned s;
+    int mode;
+
+    l4_calibrate_tsc();
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        for (mode = 0; mode < MODE_MAX; mode++)
+            bench_tx(mode, sizes[s]);
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        bench_loop(MODE_STRING, sizes[s]);
+        bench_loop(MODE_RING, sizes[s]);
+    }
+
+    LOG("Finished. Going to sleep.");
+    l4_sleep_forever();
+    return 0;
+}
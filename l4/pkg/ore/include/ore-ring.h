@@ -0,0 +1,97 @@
+/****************************************************************
+ * (c) 2026 Technische Universitaet Dresden                     *
+ * This file is part of DROPS, which is distributed under the   *
+ * terms of the GNU General Public License 2. Please see the    *
+ * COPYING file for details.                                    *
+ ****************************************************************/
+
+#ifndef __ORE_RING_H
+#define __ORE_RING_H
+
+#include <l4/sys/types.h>
+#include <l4/sys/consts.h>
+
+/* Shared-memory rings for ORe.
+ *
+ * The client allocates a dataspace of L4ORE_RING_DS_SIZE bytes and passes it
+ * in l4ore_config.ro_ring_ds to l4ore_open(). The first page holds a TX and
+ * an RX descriptor ring, followed by one packet buffer per slot of each ring.
+ *
+ * Indices are free-running 32 bit counters, a slot is addressed by
+ * (index & L4ORE_RING_MASK). The producer fills the buffer, writes the size
+ * and then advances head. The consumer advances tail when it is done with
+ * the buffer.
+ *
+ * TX: the client is the producer, ORe hands the buffers to the NIC without
+ * copying and advances tail once the driver released them. If ORe runs out
+ * of work it sets doorbell to 1. A client which finds doorbell set after
+ * publishing packets resets it and sends a single ring_kick() to the worker.
+ *
+ * RX: ORe is the producer. A client finding the ring empty calls ring_wait(),
+ * which is answered as soon as a packet was added.
+ */
+
+#define L4ORE_RING_SLOTS        256     //!< slots per ring, power of 2
+#define L4ORE_RING_MASK         (L4ORE_RING_SLOTS - 1)
+#define L4ORE_RING_BUF_SIZE     2048    //!< buffer size per slot
+#define L4ORE_RING_HDR_SIZE     L4_PAGESIZE
+
+/* size of the ring dataspace */
+#define L4ORE_RING_DS_SIZE      (L4ORE_RING_HDR_SIZE + \
+                                 2 * L4ORE_RING_SLOTS * L4ORE_RING_BUF_SIZE)
+
+/* x86 keeps stores in order and loads in order, so publishing a slot and
+ * reading it only needs a compiler barrier. A store followed by a load of
+ * another word (head vs. doorbell) needs a locked instruction. */
+#define l4ore_ring_barrier()    __asm__ __volatile__ ("" : : : "memory")
+#define l4ore_ring_mb()         __asm__ __volatile__ ("lock; addl $0,0(%%esp)" \
+                                                      : : : "memory")
+
+/*!\brief Descriptor ring
+ * \ingroup sharedmem
+ */
+typedef struct l4ore_ring
+{
+    volatile l4_uint32_t head;      //!< next slot the producer fills
+    volatile l4_uint32_t tail;      //!< next slot the consumer releases
+    volatile l4_uint32_t doorbell;  //!< 1 if the consumer waits for a kick
+    volatile l4_uint32_t dropped;   //!< packets dropped because of a full ring
+    volatile l4_uint32_t size[L4ORE_RING_SLOTS];  //!< packet size per slot
+} l4ore_ring_t;
+
+/*!\brief Ring dataspace layout, packet buffers follow at L4ORE_RING_HDR_SIZE
+ * \ingroup sharedmem
+ */
+typedef struct l4ore_ring_area
+{
+    l4ore_ring_t tx;
+    l4ore_ring_t rx;
+} l4ore_ring_area_t;
+
+/*!\brief Number of used slots, at most L4ORE_RING_SLOTS even if the
+ *        peer corrupted the indices */
+L4_INLINE l4_uint32_t l4ore_ring_used(l4ore_ring_t *r);
+L4_INLINE l4_uint32_t l4ore_ring_used(l4ore_ring_t *r)
+{
+    l4_uint32_t used = r->head - r->tail;
+
+    return used > L4ORE_RING_SLOTS ? L4ORE_RING_SLOTS : used;
+}
+
+/*!\brief Buffer of TX slot idx */
+L4_INLINE char *l4ore_ring_tx_buf(l4ore_ring_area_t *a, l4_uint32_t idx);
+L4_INLINE char *l4ore_ring_tx_buf(l4ore_ring_area_t *a, l4_uint32_t idx)
+{
+    return (char *)a + L4ORE_RING_HDR_SIZE
+           + (idx & L4ORE_RING_MASK) * L4ORE_RING_BUF_SIZE;
+}
+
+/*!\brief Buffer of RX slot idx */
+L4_INLINE char *l4ore_ring_rx_buf(l4ore_ring_area_t *a, l4_uint32_t idx);
+L4_INLINE char *l4ore_ring_rx_buf(l4ore_ring_area_t *a, l4_uint32_t idx)
+{
+    return (char *)a + L4ORE_RING_HDR_SIZE
+           + (L4ORE_RING_SLOTS + (idx & L4ORE_RING_MASK)) * L4ORE_RING_BUF_SIZE;
+}
+
+#endif
@@ -40,6 +40,7 @@ typedef struct ore_connection_configuration
     l4dm_dataspace_t ro_recv_ctl_ds;            //!< receive control area (DSI)
     dsi_socket_ref_t  ro_recv_client_socketref; //!< the client's socket for receiving packets
     dsi_socket_ref_t  ro_recv_ore_socketref;    //!< ORe's socket for incoming packets
+    l4dm_dataspace_t ro_ring_ds;                //!< TX/RX descriptor rings (see ore-ring.h)
     char ro_orename[16];            //!< name of the ORe instance we connect to
 } l4ore_config;
 
@@ -58,6 +59,7 @@ typedef struct ore_connection_configuration
                                 LOG("conf->send_ore_socket = %d", (conf).ro_send_ore_socketref.socket);   \
                                 LOG("conf->recv_client_socket = %d", (conf).ro_recv_client_socketref.socket);   \
                                 LOG("conf->recv_ore_socket = %d", (conf).ro_recv_ore_socketref.socket);   \
+                                LOG("conf->ring_ds   = DS %d", (conf).ro_ring_ds.id);       \
                                 LOG("conf->orename = %s", (conf).ro_orename); \
                             }
 
@@ -91,6 +93,7 @@ typedef struct ore_connection_configuration
                         L4DM_INVALID_DATASPACE, L4DM_INVALID_DATASPACE, \
                         {-1, L4_INVALID_ID, L4_INVALID_ID, L4_INVALID_ID},  \
                         {-1, L4_INVALID_ID, L4_INVALID_ID, L4_INVALID_ID},  \
+                        L4DM_INVALID_DATASPACE,                         \
                         {'O', 'R', 'e', 0, 0, 0, 0, 0, 0, 0},    \
                     }
 
@@ -101,6 +104,7 @@ typedef struct ore_connection_configuration
                         L4DM_INVALID_DATASPACE, L4DM_INVALID_DATASPACE, \
                         {-1, L4_INVALID_ID, L4_INVALID_ID, L4_INVALID_ID},  \
                         {-1, L4_INVALID_ID, L4_INVALID_ID, L4_INVALID_ID},  \
+                        L4DM_INVALID_DATASPACE,                         \
                         {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},    \
                     }
 
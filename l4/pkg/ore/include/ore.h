@@ -9,6 +9,7 @@
 #define __ORE_H
 
 #include <l4/ore/ore-types.h>
+#include <l4/ore/ore-ring.h>
 #include <l4/dm_generic/types.h>
 
 /* distinguish blocking and non-blocking calls */
@@ -121,4 +122,39 @@ L4_CV void *l4ore_get_recv_area(int handle);
  * \param addr      packet address
  */
 L4_CV void l4ore_packet_to_pool(void *addr);
+
+/*!\brief Get the buffer of the next free TX ring slot.
+ * \ingroup sharedmem
+ *
+ * A packet built in this buffer and passed to l4ore_send() is not copied.
+ *
+ * \param handle    connection handle
+ *
+ * \return          slot buffer of L4ORE_RING_BUF_SIZE bytes,
+ *                  NULL if the ring is full or the connection uses no rings
+ */
+L4_CV void *l4ore_ring_get_tx_buf(int handle);
+
+/*!\brief Receive packet from the RX ring without copying it.
+ * \ingroup sharedmem
+ *
+ * The packet stays valid until it is released with l4ore_ring_release().
+ *
+ * \param handle    connection handle
+ * \param buf       returns the packet address within the ring dataspace
+ * \param size      returns the packet size
+ * \param timeout   IPC timeout if the ring is empty
+ *
+ * \return          0 success
+ * \return          <0 error
+ */
+L4_CV int l4ore_ring_recv(int handle, char **buf, l4_size_t *size,
+                          l4_timeout_t timeout);
+
+/*!\brief Release the oldest packet returned by l4ore_ring_recv().
+ * \ingroup sharedmem
+ *
+ * \param handle    connection handle
+ */
+L4_CV void l4ore_ring_release(int handle);
 #endif
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <l4/names/libnames.h>
 #include <l4/log/l4log.h>
+#include <l4/l4rm/l4rm.h>
 #include "local.h"
 
 // perform open actions
@@ -21,5 +22,11 @@ void ore_do_close(int handle)
   ore_manager_close_call(&descriptor_table[handle].remote_manager_thread, 
 		                 &channel, &_dice_corba_env);
 
+  if (descriptor_table[handle].ring)
+    {
+      l4rm_detach(descriptor_table[handle].ring);
+      descriptor_table[handle].ring = NULL;
+    }
+
   // TODO: dispose dataspaces ?
 }
@@ -9,6 +9,7 @@
 #include <stdlib.h>
 
 #include <l4/names/libnames.h>
+#include <l4/l4rm/l4rm.h>
 
 ore_client_conn_desc descriptor_table[CONN_MAX];
 int ore_initialized = 0;
@@ -120,6 +121,29 @@ int l4ore_open(char *device, unsigned char mac[6], l4ore_config *conf)
         return -1;
     }
 
+    descriptor_table[desc].ring = NULL;
+
+    // sending and receiving via shared-memory rings
+    if (!l4dm_is_invalid_ds(conf->ro_ring_ds))
+    {
+        LOG("sending and receiving via rings");
+        err = __l4ore_init_ring(descriptor_table[desc].remote_manager_thread,
+                                conf, &descriptor_table[desc].ring);
+        if (err)
+        {
+            release_descriptor(desc);
+            return err;
+        }
+        // rings replace the DSI dataspaces
+        conf->ro_send_ds                            = L4DM_INVALID_DATASPACE;
+        conf->ro_recv_ds                            = L4DM_INVALID_DATASPACE;
+        descriptor_table[desc].ring_rx_next         = 0;
+        descriptor_table[desc].send_func            = ore_send_ring;
+        descriptor_table[desc].rx_func_blocking     = ore_recv_ring_blocking;
+        descriptor_table[desc].rx_func_nonblocking  = ore_recv_ring_nonblocking;
+    }
+    else
+    {
 #ifdef ORE_DSI
     // sending via string IPC
     if (l4dm_is_invalid_ds(conf->ro_send_ds))
@@ -160,11 +184,20 @@ int l4ore_open(char *device, unsigned char mac[6], l4ore_config *conf)
     descriptor_table[desc].rx_func_nonblocking = ore_recv_string_nonblocking;
     descriptor_table[desc].send_func        = ore_send_string;
 #endif
+    }
 
     ret = ore_do_open(desc, device, mac, conf);
     // return reason of failed open()
     if (l4_is_invalid_id(ret))
     {
+        if (descriptor_table[desc].ring)
+        {
+            LOG_Error("ore_open() returned INVALID_ID");
+            l4rm_detach(descriptor_table[desc].ring);
+            descriptor_table[desc].ring = NULL;
+            release_descriptor(desc);
+            return -1;
+        }
 #ifdef ORE_DSI
         if (l4dm_is_invalid_ds(conf->ro_send_ds) || 
             l4dm_is_invalid_ds(conf->ro_recv_ds))
@@ -15,6 +15,7 @@
 #include <l4/util/l4_macros.h>
 #include <l4/env/errno.h>
 #include <l4/ore/ore-dsi.h>
+#include <l4/ore/ore-ring.h>
 #include <l4/dm_mem/dm_mem.h>
 #include <stdlib.h>
 #include "ore_rxtx-client.h"
@@ -30,6 +31,8 @@ typedef struct ore_client_conn_desc{
     dsi_socket_t *local_recv_socket;        // DSI rx socket
     void *send_addr;                        // address of send DS
     void *recv_addr;                        // start of recv DS
+    l4ore_ring_area_t *ring;                // shared TX/RX rings
+    l4_uint32_t ring_rx_next;               // next RX slot to read
     int (*send_func)(l4ore_handle_t, int, char *, l4_size_t);
     int (*rx_func_blocking)(l4ore_handle_t, int, char **, l4_size_t *, l4_timeout_t);
     int (*rx_func_nonblocking)(l4ore_handle_t, int, char **, l4_size_t *);
@@ -56,6 +59,13 @@ int __l4ore_init_send_socket(l4ore_handle_t, l4ore_config *conf, dsi_socket_t **
 int __l4ore_init_recv_socket(l4ore_handle_t, l4ore_config *conf, dsi_socket_t **, void **); 
 void __l4ore_remember_packet(dsi_socket_t *, dsi_packet_t *, void *, l4_size_t);
 
+// shared memory ring functions
+int ore_send_ring(l4ore_handle_t channel, int handle, char *data, l4_size_t size);
+int ore_recv_ring_blocking(l4ore_handle_t channel, int handle, char **data, l4_size_t *size, l4_timeout_t);
+int ore_recv_ring_nonblocking(l4ore_handle_t channel, int handle, char **data, l4_size_t *size);
+
+int __l4ore_init_ring(l4ore_handle_t, l4ore_config *conf, l4ore_ring_area_t **);
+
 void ore_do_close(int handle);
 
 #endif //_LOCAL_H_
@@ -0,0 +1,219 @@
+/****************************************************************
+ * (c) 2026 Technische Universitaet Dresden                     *
+ * This file is part of DROPS, which is distributed under the   *
+ * terms of the GNU General Public License 2. Please see the    *
+ * COPYING file for details.                                    *
+ ****************************************************************/
+
+#include "local.h"
+#include <stdlib.h>
+#include <string.h>
+#include <dice/dice.h>
+#include <l4/l4rm/l4rm.h>
+#include <l4/sys/ipc.h>
+#include <l4/util/atomic.h>
+
+/* attach the ring dataspace and share it with ORe */
+int __l4ore_init_ring(l4ore_handle_t server, l4ore_config *conf,
+                      l4ore_ring_area_t **ring)
+{
+    l4_size_t size;
+    int ret;
+
+    ret = l4dm_mem_size(&conf->ro_ring_ds, &size);
+    if (ret || size < L4ORE_RING_DS_SIZE)
+    {
+        LOG_Error("ring dataspace too small, need %d bytes", L4ORE_RING_DS_SIZE);
+        return -L4_EINVAL;
+    }
+
+    ret = l4rm_attach(&conf->ro_ring_ds, L4ORE_RING_DS_SIZE, 0,
+                      L4DM_RW | L4RM_MAP, (void **)ring);
+    if (ret)
+    {
+        LOG_Error("attaching ring dataspace failed: %d (%s)", ret,
+                  l4env_strerror(-ret));
+        return ret;
+    }
+
+    memset(*ring, 0, sizeof(l4ore_ring_area_t));
+
+    ret = l4dm_share(&conf->ro_ring_ds, server, L4DM_RW);
+    if (ret)
+    {
+        LOG_Error("sharing ring dataspace failed: %d (%s)", ret,
+                  l4env_strerror(-ret));
+        l4rm_detach(*ring);
+        *ring = NULL;
+        return ret;
+    }
+
+    return 0;
+}
+
+/* Ring the doorbell if the worker went idle. */
+static void ring_kick(l4ore_handle_t channel, l4ore_ring_area_t *ring)
+{
+    DICE_DECLARE_ENV(_dice_corba_env);
+    _dice_corba_env.malloc = (dice_malloc_func)malloc;
+    _dice_corba_env.free   = (dice_free_func)free;
+
+    if (ring->tx.doorbell && l4util_cmpxchg32(&ring->tx.doorbell, 1, 0))
+        ore_rxtx_ring_kick_send(&channel, &_dice_corba_env);
+}
+
+void *l4ore_ring_get_tx_buf(int handle)
+{
+    l4ore_ring_area_t *ring = descriptor_table[handle].ring;
+
+    if (!ring || l4ore_ring_used(&ring->tx) >= L4ORE_RING_SLOTS)
+        return NULL;
+
+    return l4ore_ring_tx_buf(ring, ring->tx.head);
+}
+
+/* Put the packet into the next TX slot. If data already is the buffer
+ * returned by l4ore_ring_get_tx_buf(), nothing is copied. Only the first
+ * packet after the worker went idle costs an IPC.
+ */
+int ore_send_ring(l4ore_handle_t channel, int handle,
+                  char *data, l4_size_t size)
+{
+    l4ore_ring_area_t *ring = descriptor_table[handle].ring;
+    l4_uint32_t head        = ring->tx.head;
+    char *slot;
+
+    if (size > L4ORE_RING_BUF_SIZE)
+        return -L4_EINVAL;
+
+    while (head - ring->tx.tail >= L4ORE_RING_SLOTS)
+    {
+        // ring full: make sure ORe works on it and wait for the NIC
+        ring_kick(channel, ring);
+        l4_ipc_sleep(l4_timeout(L4_IPC_TIMEOUT_0, l4_timeout_rel(250, 2)));
+    }
+
+    slot = l4ore_ring_tx_buf(ring, head);
+    if (data != slot)
+        memcpy(slot, data, size);
+    ring->tx.size[head & L4ORE_RING_MASK] = size;
+    l4ore_ring_barrier();
+    ring->tx.head = head + 1;
+
+    // the worker sets the doorbell before it checks head for the last time
+    l4ore_ring_mb();
+    ring_kick(channel, ring);
+
+    return 0;
+}
+
+/* Wait until the RX ring holds an unread packet. */
+static int ring_rx_wait(l4ore_handle_t channel, int handle, int blocking,
+                        l4_timeout_t timeout)
+{
+    l4ore_ring_area_t *ring = descriptor_table[handle].ring;
+    DICE_DECLARE_ENV(_dice_corba_env);
+    _dice_corba_env.malloc = (dice_malloc_func)malloc;
+    _dice_corba_env.free   = (dice_free_func)free;
+
+    while (ring->rx.head == descriptor_table[handle].ring_rx_next)
+    {
+        int ret;
+
+        if (!blocking)
+            return -L4_ENODATA;
+
+        _dice_corba_env.timeout = timeout;
+        ret = ore_rxtx_ring_wait_call(&channel,
+                                      descriptor_table[handle].ring_rx_next,
+                                      &_dice_corba_env);
+        if (DICE_HAS_EXCEPTION(&_dice_corba_env))
+        {
+            switch (DICE_IPC_ERROR(&_dice_corba_env))
+            {
+            case L4_IPC_ENOT_EXISTENT:
+                return -L4_ENOTFOUND;
+            case L4_IPC_SETIMEOUT:
+            case L4_IPC_RETIMEOUT:
+                return -L4_ETIME;
+            default:
+                return -L4_EIPC;
+            }
+        }
+        if (ret)
+            return ret;
+    }
+
+    // ORe wrote the slot before publishing head
+    l4ore_ring_barrier();
+    return 0;
+}
+
+/* Copy the next packet to the caller's buffer and release the slot. */
+static int ring_recv_copy(l4ore_handle_t channel, int handle, char **data,
+                          l4_size_t *size, int blocking, l4_timeout_t timeout)
+{
+    l4ore_ring_area_t *ring = descriptor_table[handle].ring;
+    l4_uint32_t idx;
+    l4_size_t len;
+    int ret;
+
+    ret = ring_rx_wait(channel, handle, blocking, timeout);
+    if (ret)
+        return ret;
+
+    idx = descriptor_table[handle].ring_rx_next;
+    len = ring->rx.size[idx & L4ORE_RING_MASK];
+
+    // buffer too small: tell the caller what is needed, keep the packet
+    if (len > *size)
+        return len;
+
+    memcpy(*data, l4ore_ring_rx_buf(ring, idx), len);
+    *size = len;
+
+    descriptor_table[handle].ring_rx_next++;
+    ring->rx.tail++;
+
+    return 0;
+}
+
+int ore_recv_ring_blocking(l4ore_handle_t channel, int handle,
+                           char **data, l4_size_t *size, l4_timeout_t timeout)
+{
+    return ring_recv_copy(channel, handle, data, size, 1, timeout);
+}
+
+int ore_recv_ring_nonblocking(l4ore_handle_t channel, int handle,
+                              char **data, l4_size_t *size)
+{
+    return ring_recv_copy(channel, handle, data, size, 0, L4_IPC_NEVER);
+}
+
+int l4ore_ring_recv(int handle, char **buf, l4_size_t *size,
+                    l4_timeout_t timeout)
+{
+    ore_client_conn_desc *d = &descriptor_table[handle];
+    int ret;
+
+    if (!d->ring)
+        return -L4_EINVAL;
+
+    ret = ring_rx_wait(d->remote_worker_thread, handle, 1, timeout);
+    if (ret)
+        return ret;
+
+    *buf  = l4ore_ring_rx_buf(d->ring, d->ring_rx_next);
+    *size = d->ring->rx.size[d->ring_rx_next & L4ORE_RING_MASK];
+    d->ring_rx_next++;
+
+    return 0;
+}
+
+void l4ore_ring_release(int handle)
+{
+    ore_client_conn_desc *d = &descriptor_table[handle];
+
+    if (d->ring && d->ring->rx.tail != d->ring_rx_next)
+        d->ring->rx.tail++;
+}
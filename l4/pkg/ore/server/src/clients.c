@@ -31,6 +31,7 @@ void init_connection_table(void)
         ore_connection_table[i].channel_lock = L4LOCK_UNLOCKED;
         ore_connection_table[i].in_use       = 0;
         ore_connection_table[i].worker       = L4_INVALID_ID;
+        ore_connection_table[i].ring         = NULL;
     }
 }
 
@@ -191,6 +192,21 @@ static int __init_workers(int channel, l4ore_config *conf)
         ore_connection_table[channel].rx_reply_func     = rx_to_client_string;
         ore_connection_table[channel].netif_rx_func     = netif_rx_string;
     }
+
+    // Rings: packets never go through the rx/tx lists, the string worker
+    // only serves doorbells and waiting clients.
+    if (!l4dm_is_invalid_ds(conf->ro_ring_ds))
+    {
+        ret = init_ring_client(channel, conf);
+        if (ret)
+        {
+            LOG_Error("Error initializing rings. Shutting down worker thread.");
+            l4thread_shutdown(l4thread_id(ore_connection_table[channel].worker));
+            return ret;
+        }
+        ore_connection_table[channel].rx_reply_func     = rx_to_client_ring;
+        ore_connection_table[channel].netif_rx_func     = netif_rx_ring;
+    }
     
     return 0;
 }
@@ -203,6 +219,8 @@ int setup_connection(char *device_name, ore_mac mac,
                      l4ore_config *conf, int channel,
                      l4_threadid_t *owner)
 {
+    int ret;
+
     LOGd_Enter(ORE_DEBUG);
     LOGd(ORE_DEBUG, "setting up connection for "l4util_idfmt, l4util_idstr(*owner));
     LOGd(ORE_DEBUG, "device name: %s", device_name);
@@ -237,8 +255,19 @@ int setup_connection(char *device_name, ore_mac mac,
     // default value for the worker
     ore_connection_table[channel].worker            = L4_INVALID_ID;
     ore_connection_table[channel].worker_dsi        = L4_INVALID_ID;
+    ore_connection_table[channel].ring              = NULL;
 
-    __init_workers(channel, conf);
+    // make sure free_connection() finds valid lists if we fail below
+    INIT_LIST_HEAD(&ore_connection_table[channel].rx_list);
+    INIT_LIST_HEAD(&ore_connection_table[channel].tx_list);
+
+    ret = __init_workers(channel, conf);
+    if (ret)
+    {
+        l4lock_unlock(&ore_connection_table[channel].tx_startlock);
+        free_connection(channel);
+        return ret;
+    }
 
     // take over configuration, fill in the read-only values
     ore_connection_table[channel].config            = *conf;
@@ -274,6 +303,8 @@ int free_connection(int handle)
         clear_rxtx_list(&ore_connection_table[handle].tx_list);
     }
 
+    free_ring_client(handle);
+
     if (ore_connection_table[handle].dev
         && memcmp(ore_connection_table[handle].mac,
            ore_connection_table[handle].dev->dev_addr, 6) == 0)
@@ -61,10 +61,10 @@ static int __netif_rx(struct sk_buff *skb)
 		// so that we can hand out full packets up to our clients.
 		skb_push(skb, skb->dev->hard_header_len);
 
-	/* the IRQ thread does no longer own this skb, however we don't
-	 * free it, because this is done by the clients afterwards
+	/* Clients queueing the skb take their own reference. We keep ours until
+	 * all channels have seen the packet, so that receivers copying the data
+	 * (DSI, rings) do not have to care about freeing it.
 	 */
-	atomic_dec(&skb->users);
 
 	while (channel >= 0 && channel < ORE_CONFIG_MAX_CONNECTIONS) {
 		int ret = NET_RX_SUCCESS;
@@ -83,5 +83,7 @@ static int __netif_rx(struct sk_buff *skb)
 		channel = find_channel_for_skb(skb, channel+1);
 	}
 
+	kfree_skb(skb);
+
   return NET_RX_SUCCESS;
 }
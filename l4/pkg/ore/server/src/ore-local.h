@@ -15,6 +15,7 @@
 
 #include <l4/log/l4log.h>
 #include <l4/ore/ore.h>
+#include <l4/ore/ore-ring.h>
 #include <l4/dm_generic/types.h>
 #include <l4/dm_mem/dm_mem.h>
 #include <l4/env/errno.h>
@@ -112,6 +113,12 @@ typedef struct ore_connection_t{
     dsi_socket_t      *tx_socket;     // socket for receiving send packets from DSI client
     // }
     l4lock_t          tx_startlock;
+
+    l4ore_ring_area_t *ring;          // shared TX/RX rings, NULL if not used
+    l4_uint32_t       ring_tx_next;   // next TX slot to hand to the NIC
+    l4_uint32_t       ring_tx_tail;   // oldest TX slot not yet released
+    l4_uint32_t       ring_rx_next;   // RX slot the waiting client reads next
+    struct sk_buff    *ring_skb[L4ORE_RING_SLOTS]; // TX skbs, one per slot
     
     l4lock_t          channel_lock;   // channel lock
     l4_int32_t        flags;          // server-side connection flags
@@ -171,6 +178,12 @@ int tx_component_string(CORBA_Object, const char *,
 
 int netif_rx_dsi(int , struct sk_buff *);
 
+/* rx/tx functions for the shared-memory ring case */
+int init_ring_client(int channel, l4ore_config *conf);
+void free_ring_client(int channel);
+void rx_to_client_ring(int channel);
+int netif_rx_ring(int , struct sk_buff *);
+
 /* IRQ handling */
 extern void custom_irq_handler(l4_threadid_t, l4_umword_t, l4_umword_t);
 extern void irq_handler(l4_int32_t irq, void *arg);
@@ -0,0 +1,459 @@
+/****************************************************************
+ * The shared-memory ring module for ORe.                       *
+ *                                                              *
+ * Clients using rings put packets into a TX descriptor ring    *
+ * and fetch them from an RX descriptor ring, both living in a  *
+ * dataspace shared with ORe (see l4/ore/ore-ring.h). IPC is    *
+ * only needed to wake up an idle worker or a waiting client.   *
+ *                                                              *
+ * (c) 2026 Technische Universitaet Dresden                     *
+ * This file is part of DROPS, which is distributed under the   *
+ * terms of the GNU General Public License 2. Please see the    *
+ * COPYING file for details.                                    *
+ ****************************************************************/
+
+#include <linux/mm.h>
+#include <linux/skbuff.h>
+#include <linux/netdevice.h>
+
+#include <l4/sys/types.h>
+#include <l4/sys/ipc.h>
+#include <l4/l4rm/l4rm.h>
+#include <l4/util/atomic.h>
+#include <l4/util/l4_macros.h>
+
+#include "ore-local.h"
+
+#ifndef CONFIG_ORE_DDE24
+#include <l4/dde/ddekit/pgtab.h>
+#endif
+
+#ifdef CONFIG_ORE_PACKET_TRACE
+#include <l4/ore/packet_debug.h>
+#endif
+
+/* Add the ring dataspace to (or remove it from) DDE's physical memory
+ * management, so that drivers may DMA directly from the TX buffers. Unlike
+ * add_dde_region() in dsi.c this does not require a contiguous dataspace,
+ * every physically contiguous chunk is handled on its own.
+ */
+static int ring_dde_region(l4dm_dataspace_t *ds, void *addr, int add)
+{
+    l4_offs_t offs = 0;
+    l4_addr_t phys;
+    l4_size_t size;
+    int ret;
+
+    while (offs < L4ORE_RING_DS_SIZE)
+    {
+        ret = l4dm_mem_ds_phys_addr(ds, offs, L4ORE_RING_DS_SIZE - offs,
+                                    &phys, &size);
+        if (ret)
+        {
+            LOG_Error("error getting physical address of ring dataspace.");
+            return ret;
+        }
+        if (size > L4ORE_RING_DS_SIZE - offs)
+            size = L4ORE_RING_DS_SIZE - offs;
+
+        LOGd(ORE_DEBUG_COMPONENTS, "%s ring region %p -> %p, size %d",
+             add ? "adding" : "removing", addr + offs, (void *)phys, size);
+#ifdef CONFIG_ORE_DDE24
+        if (add)
+            l4dde_add_region((l4_addr_t)addr + offs, phys, size);
+        else
+            l4dde_remove_region((l4_addr_t)addr + offs, size);
+#else
+        if (add)
+            ddekit_pgtab_set_region_with_size(addr + offs, phys, size,
+                                              PTE_TYPE_OTHER);
+        else
+            ddekit_pgtab_clear_region(addr + offs, PTE_TYPE_OTHER);
+#endif
+        offs += size;
+    }
+
+    return 0;
+}
+
+/* Attach the client's ring dataspace and set up the TX skb pool. */
+int init_ring_client(int channel, l4ore_config *conf)
+{
+    ore_connection_t *c = &ore_connection_table[channel];
+    l4ore_ring_area_t *ring;
+    l4_size_t size;
+    int i, ret;
+
+    LOGd_Enter(ORE_DEBUG_COMPONENTS);
+
+    ret = l4dm_mem_size(&conf->ro_ring_ds, &size);
+    if (ret || size < L4ORE_RING_DS_SIZE)
+    {
+        LOG_Error("ring dataspace too small (%d, need %d bytes)",
+                  ret ? ret : size, L4ORE_RING_DS_SIZE);
+        return -L4_EINVAL;
+    }
+
+    ret = l4rm_attach(&conf->ro_ring_ds, L4ORE_RING_DS_SIZE, 0,
+                      L4DM_RW | L4RM_MAP, (void **)&ring);
+    if (ret)
+    {
+        LOG_Error("error attaching ring dataspace: %d (%s)", ret,
+                  l4env_strerror(-ret));
+        return ret;
+    }
+
+    ret = ring_dde_region(&conf->ro_ring_ds, ring, 1);
+    if (ret)
+    {
+        l4rm_detach(ring);
+        return ret;
+    }
+
+    /* The skbs only wrap the TX buffers in the dataspace. Each one is
+     * reused for its slot: we keep a reference, so the driver's kfree_skb()
+     * just drops the users count back to 1 once the packet went out. */
+    for (i = 0; i < L4ORE_RING_SLOTS; i++)
+    {
+        c->ring_skb[i] = alloc_skb(0, GFP_KERNEL);
+        if (c->ring_skb[i] == NULL)
+        {
+            LOG_Error("failed to allocate ring skb");
+            while (--i >= 0)
+                kfree_skb(c->ring_skb[i]);
+            ring_dde_region(&conf->ro_ring_ds, ring, 0);
+            l4rm_detach(ring);
+            return -L4_ENOMEM;
+        }
+    }
+
+    c->ring_tx_next = ring->tx.tail;
+    c->ring_tx_tail = ring->tx.tail;
+    c->ring_rx_next = ring->rx.head;
+    c->ring         = ring;
+
+    // the worker is idle, the first packet needs a kick
+    ring->tx.doorbell = 1;
+
+    return 0;
+}
+
+/* Advance the TX tail over all slots the driver is done with. The client
+ * can write tx->tail, so we only use our own copy and publish it. */
+static void ring_tx_reclaim(ore_connection_t *c)
+{
+    while (c->ring_tx_tail != c->ring_tx_next
+           && atomic_read(&c->ring_skb[c->ring_tx_tail & L4ORE_RING_MASK]->users) == 1)
+        c->ring_tx_tail++;
+
+    c->ring->tx.tail = c->ring_tx_tail;
+}
+
+/* Release rings. The client may not use them anymore, but the NIC may still
+ * be sending from them, so give it some time to finish. */
+void free_ring_client(int channel)
+{
+    ore_connection_t *c = &ore_connection_table[channel];
+    int i;
+
+    if (c->ring == NULL)
+        return;
+
+    for (i = 0; i < 100; i++)
+    {
+        ring_tx_reclaim(c);
+        if (c->ring_tx_tail == c->ring_tx_next)
+            break;
+        l4_ipc_sleep(l4_timeout(L4_IPC_TIMEOUT_0, l4_timeout_rel(250, 2)));
+    }
+    if (c->ring_tx_tail != c->ring_tx_next)
+        LOG_Error("%d ring packets still in flight",
+                  c->ring_tx_next - c->ring_tx_tail);
+
+    for (i = 0; i < L4ORE_RING_SLOTS; i++)
+    {
+        kfree_skb(c->ring_skb[i]);
+        c->ring_skb[i] = NULL;
+    }
+
+    ring_dde_region(&c->config.ro_ring_ds, c->ring, 0);
+    l4rm_detach(c->ring);
+    c->ring = NULL;
+}
+
+/* Hand an skb to the device driver. */
+static void ring_hard_xmit(struct net_device *dev, struct sk_buff *skb)
+{
+    int xmit;
+
+    do
+    {
+        while (netif_queue_stopped(dev))
+        {
+            /* see tx_component_string() */
+            l4_ipc_sleep(l4_timeout(L4_IPC_TIMEOUT_0, l4_timeout_rel(250,2)));
+        }
+
+        xmit_lock(dev->name);
+        if (dev->netdev_ops)
+            xmit = dev->netdev_ops->ndo_start_xmit(skb, dev);
+        else
+            xmit = dev->hard_start_xmit(skb, dev);
+        xmit_unlock(dev->name);
+        if (xmit)
+            LOG_Error("Error sending packet: %d", xmit);
+    } while (xmit != 0);
+}
+
+/* Send the packet in TX slot idx. */
+static void ring_xmit(int channel, l4_uint32_t idx)
+{
+    ore_connection_t *c = &ore_connection_table[channel];
+    struct sk_buff *skb = c->ring_skb[idx & L4ORE_RING_MASK];
+    l4_uint32_t size    = c->ring->tx.size[idx & L4ORE_RING_MASK];
+    int i = -1;
+
+    if (size > L4ORE_RING_BUF_SIZE)
+        size = L4ORE_RING_BUF_SIZE;
+
+    // The driver must not try to pad the frame itself, because the tail
+    // of our skbs is not within its head buffer.
+    if (size < ETH_ZLEN)
+    {
+        memset(l4ore_ring_tx_buf(c->ring, idx) + size, 0, ETH_ZLEN - size);
+        size = ETH_ZLEN;
+    }
+
+    // this reference is dropped by the driver after sending
+    skb_get(skb);
+    skb->data = l4ore_ring_tx_buf(c->ring, idx);
+    skb->len  = size;
+    skb->tail = skb->data + size;
+    skb->dev  = c->dev;
+
+    LOG_MAC_s(ORE_DEBUG_PACKET_SEND, "ring packet for:", skb->data);
+
+#ifdef CONFIG_ORE_PACKET_TRACE
+    packet_debug((unsigned char *)skb->data);
+#endif
+
+    /* Local clients get a copy, the slot is reused as soon as the NIC is
+     * done with it while they may keep the packet queued. */
+    if (find_channel_for_mac(skb->data, 0) >= 0)
+    {
+        rxtx_entry_t ent;
+
+        ent.skb          = alloc_skb(size, GFP_KERNEL);
+        ent.in_dataspace = 0;
+        if (ent.skb)
+        {
+            memcpy(ent.skb->data, skb->data, size);
+            ent.skb->len = size;
+            ent.skb->dev = c->dev;
+            i = local_deliver(&ent, channel);
+            kfree_skb(ent.skb);
+        }
+    }
+
+    if (i < 0 || mac_is_broadcast(skb->data))
+    {
+        ring_hard_xmit(c->dev, skb);
+        c->packets_sent++;
+    }
+    else
+        kfree_skb(skb);
+}
+
+/* Send all packets the client published. Before going idle, set the
+ * doorbell and look for packets added in the meantime. */
+static void ring_tx_drain(int channel)
+{
+    ore_connection_t *c = &ore_connection_table[channel];
+    l4ore_ring_t *tx    = &c->ring->tx;
+    l4_uint32_t head;
+
+    while (1)
+    {
+        ring_tx_reclaim(c);
+
+        /* Read head once. It must be within L4ORE_RING_SLOTS of our tail and
+         * not behind the slots we already sent, otherwise the client
+         * corrupted it. We then drop its unsent packets. */
+        head = tx->head;
+        if (head - c->ring_tx_tail > L4ORE_RING_SLOTS
+            || head - c->ring_tx_tail < c->ring_tx_next - c->ring_tx_tail)
+        {
+            LOG_Error("TX ring corrupted, resetting");
+            tx->head = head = c->ring_tx_next;
+        }
+
+        // the client wrote the slots before publishing head
+        l4ore_ring_barrier();
+        while (c->ring_tx_next != head)
+        {
+            ring_xmit(channel, c->ring_tx_next);
+            c->ring_tx_next++;
+        }
+
+        ring_tx_reclaim(c);
+
+        tx->doorbell = 1;
+        l4ore_ring_mb();
+        if (c->ring_tx_next == tx->head
+            || !l4util_cmpxchg32(&tx->doorbell, 1, 0))
+            break;
+    }
+}
+
+/* TX doorbell: the client added packets while we were idle. */
+CORBA_void
+ore_rxtx_ring_kick_component(CORBA_Object _dice_corba_obj,
+                             CORBA_Server_Environment *_dice_corba_env)
+{
+    int channel = *(int *)l4thread_data_get_current(__l4ore_tls_id_key);
+
+    LOGd(ORE_DEBUG_COMPONENTS, "ring kick on channel %d", channel);
+
+    if (sanity_check_rxtx(channel, *_dice_corba_obj) < 0)
+        return;
+
+    if (ore_connection_table[channel].ring == NULL)
+    {
+        LOG_Error("Kick on connection without rings.");
+        return;
+    }
+
+    if (ore_connection_table[channel].config.rw_active == 0)
+    {
+        LOG_Error("Trying to send via inactive connection.");
+        return;
+    }
+
+    ring_tx_drain(channel);
+}
+
+/* Client found the RX ring empty. Reply now if a packet arrived in the
+ * meantime, otherwise remember the client and let netif_rx_ring() wake
+ * us up. */
+CORBA_int
+ore_rxtx_ring_wait_component(CORBA_Object _dice_corba_obj,
+                             l4_uint32_t rx_next,
+                             CORBA_short *_dice_reply,
+                             CORBA_Server_Environment *_dice_corba_env)
+{
+    int ret;
+    int channel = *(int *)l4thread_data_get_current(__l4ore_tls_id_key);
+    ore_connection_t *c = &ore_connection_table[channel];
+
+    LOGd(ORE_DEBUG_COMPONENTS, "ring wait on channel %d", channel);
+
+    ret = sanity_check_rxtx(channel, *_dice_corba_obj);
+    if (ret < 0)
+        return ret;
+
+    if (c->ring == NULL)
+        return -L4_EINVAL;
+
+    l4lock_lock(&c->channel_lock);
+    if (c->ring->rx.head == rx_next)
+    {
+        c->waiting_client = *_dice_corba_obj;
+        c->ring_rx_next   = rx_next;
+        c->flags         |= ORE_FLAG_RX_WAITING;
+        *_dice_reply      = DICE_NO_REPLY;
+    }
+    l4lock_unlock(&c->channel_lock);
+
+    return 0;
+}
+
+/* Reply to a client waiting in ring_wait(). Called by the worker after
+ * netif_rx_ring() sent an rx_notify. */
+void rx_to_client_ring(int h)
+{
+    ore_connection_t *c = &ore_connection_table[h];
+    l4_threadid_t client;
+    DICE_DECLARE_SERVER_ENV(env);
+
+    env.timeout = L4_IPC_SEND_TIMEOUT_0;
+    env.malloc  = (dice_malloc_func)CORBA_alloc;
+    env.free    = (dice_free_func)CORBA_free;
+
+    l4lock_lock(&c->channel_lock);
+    if (!(c->flags & ORE_FLAG_RX_WAITING) || c->ring->rx.head == c->ring_rx_next)
+    {
+        l4lock_unlock(&c->channel_lock);
+        return;
+    }
+    c->flags &= ~ORE_FLAG_RX_WAITING;
+    client    = c->waiting_client;
+    l4lock_unlock(&c->channel_lock);
+
+    LOGd(ORE_DEBUG_COMPONENTS, "waking up "l4util_idfmt, l4util_idstr(client));
+    ore_rxtx_ring_wait_reply(&client, 0, &env);
+}
+
+/* netif_rx() for the ring module.
+ *
+ * Copies the packet into the next RX slot and wakes up the client if it
+ * waits in ring_wait(). A client busy with earlier packets gets no IPC at
+ * all. If the ring is full, the packet is dropped.
+ */
+int netif_rx_ring(int h, struct sk_buff *skb)
+{
+    ore_connection_t *c = &ore_connection_table[h];
+    l4ore_ring_t *rx;
+    l4_uint32_t head;
+    int notify;
+
+#ifdef CONFIG_ORE_PACKET_TRACE
+    packet_debug((unsigned char *)skb->data);
+#endif
+
+    l4lock_lock(&c->channel_lock);
+
+    // see netif_rx_string()
+    if (c->in_use == 0 || c->ring == NULL)
+    {
+        l4lock_unlock(&c->channel_lock);
+        return NET_RX_SUCCESS;
+    }
+
+    rx   = &c->ring->rx;
+    head = rx->head;
+    if (skb->len > L4ORE_RING_BUF_SIZE || head - rx->tail >= L4ORE_RING_SLOTS)
+    {
+        LOGd(ORE_DEBUG_PACKET, "RX ring full - dropping packet");
+        rx->dropped++;
+        l4lock_unlock(&c->channel_lock);
+        return NET_RX_SUCCESS;
+    }
+
+    memcpy(l4ore_ring_rx_buf(c->ring, head), skb->data, skb->len);
+    rx->size[head & L4ORE_RING_MASK] = skb->len;
+    l4ore_ring_barrier();
+    rx->head = head + 1;
+    c->packets_received++;
+
+    notify = (c->flags & ORE_FLAG_RX_WAITING)
+             && !l4_thread_equal(c->worker, l4_myself());
+    l4lock_unlock(&c->channel_lock);
+
+    if (notify)
+    {
+        DICE_DECLARE_ENV(_dice_corba_env);
+        _dice_corba_env.malloc = (dice_malloc_func)CORBA_alloc;
+        _dice_corba_env.free   = (dice_free_func)CORBA_free;
+        l4_threadid_t worker = c->worker;
+
+        /* Unlike netif_rx_string() we wait a little for the worker. The
+         * client already blocks in ring_wait(), so the worker is only busy
+         * for a short time and a lost notification would stall the client
+         * until the next packet. */
+        _dice_corba_env.timeout = l4_timeout(l4_timeout_rel(250, 2),
+                                             L4_IPC_TIMEOUT_0);
+        ore_notify_rx_notify_send(&worker, &_dice_corba_env);
+    }
+
+    return NET_RX_SUCCESS;
+}
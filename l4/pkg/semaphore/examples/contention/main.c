@@ -0,0 +1,148 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   semaphore/examples/contention/main.c
+ * \brief  Measure contended semaphore throughput, semaphore thread vs.
+ *         kernel semaphore mode
+ *
+ * \date   10/19/2026
+ *
+ * For 2 to 64 threads, every thread does LOOPS down/up pairs on one shared
+ * semaphore with a short critical section in between. We report the time
+ * per down/up pair for a semaphore using the semaphore thread and for one
+ * set up with l4semaphore_init_ksem().
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+/* L4/L4Env includes */
+#include <stdio.h>
+#include <l4/sys/types.h>
+#include <l4/env/errno.h>
+#include <l4/util/rdtsc.h>
+#include <l4/util/atomic.h>
+#include <l4/log/l4log.h>
+#include <l4/thread/thread.h>
+#include <l4/util/util.h>
+#include <l4/util/macros.h>
+
+/* Sempahore includes */
+#include <l4/semaphore/semaphore.h>
+
+#define MAX_THREADS      64
+#define LOOPS            2000
+#define CRITICAL_WORK    50
+
+char LOG_tag[9] = "sem_cont";
+
+static l4semaphore_t sem;
+static l4semaphore_t done = L4SEMAPHORE_LOCKED_INITIALIZER;
+static volatile int start;
+static volatile unsigned long shared_counter;
+
+/*****************************************************************************/
+/**
+ * \brief Worker thread, down/up loop
+ */
+/*****************************************************************************/
+static void
+worker(void * data)
+{
+  int i, j;
+
+  while (!start)
+    l4_thread_switch(L4_NIL_ID);
+
+  for (i = 0; i < LOOPS; i++)
+    {
+      l4semaphore_down(&sem);
+      for (j = 0; j < CRITICAL_WORK; j++)
+        shared_counter++;
+      l4semaphore_up(&sem);
+    }
+
+  l4semaphore_up(&done);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Run one round
+ *
+ * \param  num           Number of threads
+ *
+ * \return cycles per down/up pair
+ */
+/*****************************************************************************/
+static unsigned long
+run(int num)
+{
+  l4thread_t t[MAX_THREADS];
+  l4_cpu_time_t begin, end;
+  int i;
+
+  start = 0;
+  shared_counter = 0;
+  for (i = 0; i < num; i++)
+    {
+      t[i] = l4thread_create(worker, NULL, L4THREAD_CREATE_ASYNC);
+      if (t[i] < 0)
+        {
+          LOG_Error("create thread %d failed: %s (%d)!", i,
+                    l4env_errstr(t[i]), t[i]);
+          num = i;
+          break;
+        }
+    }
+
+  begin = l4_rdtsc();
+  start = 1;
+  for (i = 0; i < num; i++)
+    l4semaphore_down(&done);
+  end = l4_rdtsc();
+
+  if (shared_counter != (unsigned long)num * LOOPS * CRITICAL_WORK)
+    LOG_Error("lost updates: %lu", shared_counter);
+
+  for (i = 0; i < num; i++)
+    l4thread_shutdown(t[i]);
+
+  return num ? (unsigned long)((end - begin) / (num * LOOPS)) : 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief Main
+ */
+/*****************************************************************************/
+int
+main(void)
+{
+  int num, ret;
+  unsigned long ipc, ksem;
+
+  l4_calibrate_tsc();
+
+  printf("threads  sem thread  kernel sem  (cycles per down/up)\n");
+  for (num = 2; num <= MAX_THREADS; num *= 2)
+    {
+      sem = L4SEMAPHORE_UNLOCKED;
+      ipc = run(num);
+
+      ret = l4semaphore_init_ksem(&sem, 1);
+      if (ret < 0)
+        {
+          LOG_Error("kernel semaphore: %s (%d)", l4env_errstr(ret), ret);
+          return 1;
+        }
+      ksem = run(num);
+      l4semaphore_free(&sem);
+
+      printf("%7d  %10lu  %10lu\n", num, ipc, ksem);
+    }
+
+  return 0;
+}
@@ -53,6 +53,12 @@ l4semaphore_down(l4semaphore_t * sem)
   unsigned dummy;
   l4_msgdope_t result;
 
+  if (EXPECT_FALSE(sem->ksem != 0))
+    {
+      l4semaphore_ksem_down(sem);
+      return;
+    }
+
   __asm__ __volatile__ 
     (
      "decl    0(%%ecx)           \n\t"        /* decrement counter */
@@ -119,6 +125,12 @@ l4semaphore_up(l4semaphore_t * sem)
   unsigned dummy;
   l4_msgdope_t result;
 
+  if (EXPECT_FALSE(sem->ksem != 0))
+    {
+      l4semaphore_ksem_up(sem);
+      return;
+    }
+
   __asm__ __volatile__
     (
      "incl    0(%%ecx)           \n\t"        /* increment counter */
@@ -29,6 +29,9 @@ l4semaphore_try_down(l4semaphore_t * sem)
 {
   int old,tmp;
 
+  if (sem->ksem != 0)
+    return l4semaphore_ksem_try_down(sem);
+
   /* try to decrement the semaphore counter */
   do
     {
@@ -62,6 +65,9 @@ l4semaphore_down_timed(l4semaphore_t * sem, unsigned timeout)
   if (timeout == 0)
     return !l4semaphore_try_down(sem);
 
+  if (sem->ksem != 0)
+    return l4semaphore_ksem_down_timed(sem, timeout);
+
   /* decrement counter, check result */
   do
     {
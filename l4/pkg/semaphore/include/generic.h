@@ -50,6 +50,12 @@ l4semaphore_up(l4semaphore_t * sem)
   l4_umword_t dummy;
 #endif
 
+  if (sem->ksem != 0)
+    {
+      l4semaphore_ksem_up(sem);
+      return;
+    }
+
   /* increment semaphore counter */
   do
     {
@@ -121,6 +127,12 @@ l4semaphore_down(l4semaphore_t * sem)
   l4_umword_t dummy;
   l4_msgdope_t result;
 
+  if (sem->ksem != 0)
+    {
+      l4semaphore_ksem_down(sem);
+      return;
+    }
+
   /* decrement counter, check result */
   do
     {
@@ -0,0 +1,119 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   semaphore/include/ksem.h
+ * \brief  Semaphore implementation using kernel user semaphores
+ *
+ * \date   10/19/2026
+ *
+ * Semaphores initialized with l4semaphore_init_ksem() use a kernel user
+ * semaphore (l4_usem_*) instead of the semaphore thread. If the semaphore
+ * is locked, a down operation first spins for a while, hoping that the
+ * holder releases it soon. The spin limit adapts per semaphore: it grows
+ * if spinning succeeded and shrinks if we had to block anyway.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#ifndef _L4_SEMAPHORE_KSEM_H
+#define _L4_SEMAPHORE_KSEM_H
+
+#include <l4/sys/types.h>
+#include <l4/sys/user_locks.h>
+#include <l4/util/atomic.h>
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+#include <l4/util/cpu.h>
+#endif
+
+/*****************************************************************************
+ * spin until the semaphore counter becomes positive, adapt spin limit
+ *****************************************************************************/
+L4_INLINE void
+l4semaphore_ksem_spin(l4semaphore_t * sem)
+{
+  int i, limit = sem->spin;
+
+  for (i = 0; i < limit; i++)
+    {
+      if (sem->usem.counter > 0)
+        {
+          /* spinning paid off, allow longer spins */
+          if (limit < L4SEMAPHORE_KSEM_SPIN_MAX)
+            sem->spin = limit + (limit >> 3) + 1;
+          return;
+        }
+#if defined(ARCH_x86) || defined(ARCH_amd64)
+      l4util_cpu_pause();
+#else
+      __asm__ __volatile__ ("" : : : "memory");
+#endif
+    }
+
+  /* we will block anyway, spin shorter next time, but keep spinning at
+   * all, otherwise the limit could never grow again */
+  limit >>= 1;
+  sem->spin = limit < L4SEMAPHORE_KSEM_SPIN_MIN
+    ? L4SEMAPHORE_KSEM_SPIN_MIN : limit;
+}
+
+/*****************************************************************************
+ * decrement semaphore counter, spin and block in kernel if locked
+ *****************************************************************************/
+L4_INLINE void
+l4semaphore_ksem_down(l4semaphore_t * sem)
+{
+  if (sem->usem.counter <= 0)
+    l4semaphore_ksem_spin(sem);
+
+  l4_usem_down(sem->ksem, &sem->usem);
+}
+
+/*****************************************************************************
+ * decrement semaphore counter, block in kernel with timeout if locked
+ *****************************************************************************/
+L4_INLINE int
+l4semaphore_ksem_down_timed(l4semaphore_t * sem, unsigned timeout)
+{
+  if (sem->usem.counter <= 0)
+    l4semaphore_ksem_spin(sem);
+
+  return l4_usem_down_to(sem->ksem, &sem->usem,
+                         l4util_micros2l4to(timeout == ~0U ? 
+                                            ~0U : timeout * 1000))
+    != L4_USEM_OK;
+}
+
+/*****************************************************************************
+ * decrement semaphore counter, return error if locked
+ *****************************************************************************/
+L4_INLINE int
+l4semaphore_ksem_try_down(l4semaphore_t * sem)
+{
+  l4_mword_t old;
+
+  do
+    {
+      old = sem->usem.counter;
+      if (old <= 0)
+        return 0;
+    }
+  while (!l4util_cmpxchg((volatile l4_umword_t *)&sem->usem.counter,
+                         (l4_umword_t)old, (l4_umword_t)(old - 1)));
+
+  return 1;
+}
+
+/*****************************************************************************
+ * increment semaphore counter, kernel wakes up blocked threads
+ *****************************************************************************/
+L4_INLINE void
+l4semaphore_ksem_up(l4semaphore_t * sem)
+{
+  l4_usem_up(sem->ksem, &sem->usem);
+}
+
+#endif /* !_L4_SEMAPHORE_KSEM_H */
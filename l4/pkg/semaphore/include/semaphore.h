@@ -22,6 +22,7 @@
 #include <l4/env/cdefs.h>
 #include <l4/thread/thread.h>
 #include <l4/util/util.h>
+#include <l4/sys/user_locks.h>
 
 /*****************************************************************************
  *** configuration
@@ -46,6 +47,21 @@
  */
 #define L4SEMAPHORE_RESTART_IPC       1
 
+/**
+ * kernel semaphore mode: max. number of spin iterations before blocking
+ */
+#define L4SEMAPHORE_KSEM_SPIN_MAX     256
+
+/**
+ * kernel semaphore mode: min. number of spin iterations before blocking
+ */
+#define L4SEMAPHORE_KSEM_SPIN_MIN     4
+
+/**
+ * kernel semaphore mode: initial number of spin iterations
+ */
+#define L4SEMAPHORE_KSEM_SPIN_INIT    32
+
 /*****************************************************************************
  *** types
  *****************************************************************************/
@@ -58,6 +74,10 @@ typedef struct l4semaphore
   volatile int  counter;      /**< semaphore counter */
   int           pending;      /**< wakeup notification pending counter */
   void *        queue;        /**< wait queue */
+  unsigned long ksem;         /**< kernel semaphore, 0 if the semaphore
+                               **  thread is used */
+  l4_u_semaphore_t usem;      /**< kernel semaphore counter */
+  int           spin;         /**< adaptive spin limit (kernel semaphore) */
 } l4semaphore_t;
 
 /*****************************************************************************
@@ -70,7 +90,7 @@ typedef struct l4semaphore
  * \ingroup api_sem
  * \param   x            Initial value for semaphore counter
  */
-#define L4SEMAPHORE_INITIALIZER(x)  {(x), 0, NULL}
+#define L4SEMAPHORE_INITIALIZER(x)  {(x), 0, NULL, 0, {0, 0}, 0}
 
 /**
  * \brief   Semaphore value generator, use this to initialize plain semaphores
@@ -160,6 +180,42 @@ l4semaphore_init(void);
 L4_CV int
 l4semaphore_set_thread_prio(l4_prio_t prio);
 
+/*****************************************************************************/
+/**
+ * \brief   Initialize semaphore, use kernel semaphore to block
+ * \ingroup api_sem
+ *
+ * \param   sem          Semaphore structure
+ * \param   count        Initial value for semaphore counter
+ *
+ * \return  0 on success (\a sem uses a kernel semaphore), error code
+ *          otherwise (\a sem is initialized to use the semaphore thread):
+ *          - -#L4_ENOTSUPP  kernel does not support user semaphores
+ *          - -#L4_ENOMEM    no kernel semaphore available
+ *
+ * Contended down operations on \a sem spin for a short, adaptive time and
+ * then block directly in the kernel instead of calling the semaphore
+ * thread. The semaphore can only be used by threads of the calling task.
+ * Semaphores set up this way must be released using l4semaphore_free().
+ */
+/*****************************************************************************/
+L4_CV int
+l4semaphore_init_ksem(l4semaphore_t * sem, int count);
+
+/*****************************************************************************/
+/**
+ * \brief   Release kernel semaphore of a semaphore
+ * \ingroup api_sem
+ *
+ * \param   sem          Semaphore structure
+ *
+ * Threads still blocked on \a sem are woken up. Does nothing if \a sem
+ * does not use a kernel semaphore.
+ */
+/*****************************************************************************/
+L4_CV void
+l4semaphore_free(l4semaphore_t * sem);
+
 /*****************************************************************************/
 /**
  * \brief   Decrement semaphore counter, block if result is \< 0
@@ -234,6 +290,7 @@ __END_DECLS;
  *** implementation
  *****************************************************************************/
 
+#include <l4/semaphore/ksem.h>
 #include <l4/semaphore/archindep.h>
 
 #if L4SEMAPHORE_ASM
@@ -37,4 +37,14 @@
  */ 
 #define L4SEMAPHORE_SORT_WQ           1
 
+/**
+ * First kernel object index used for kernel semaphores
+ */
+#define L4SEMAPHORE_KSEM_BASE         64
+
+/**
+ * Max. number of kernel semaphores per task
+ */
+#define L4SEMAPHORE_MAX_KSEM          256
+
 #endif /* !_SEMAPHORE___CONFIG_H */
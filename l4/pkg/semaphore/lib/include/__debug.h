@@ -25,5 +25,6 @@
 
 /* 1 enables debug output, 0 disables */
 #define DEBUG_INIT              0
+#define DEBUG_KSEM              0
 
 #endif /* !_SEMAPHORE___DEBUG_H */
@@ -0,0 +1,161 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   semaphore/lib/src/ksem.c
+ * \brief  Kernel semaphore allocation
+ *
+ * \date   10/19/2026
+ *
+ * Semaphores set up with l4semaphore_init_ksem() block on a kernel user
+ * semaphore instead of calling the semaphore thread. Kernel semaphores
+ * are named by an index in the task's kernel object space, we manage the
+ * range [L4SEMAPHORE_KSEM_BASE, L4SEMAPHORE_KSEM_BASE+L4SEMAPHORE_MAX_KSEM)
+ * with a bitmap.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+/* L4 includes */
+#include <l4/sys/types.h>
+#include <l4/sys/syscalls.h>
+#include <l4/sys/user_locks.h>
+#include <l4/sigma0/kip.h>
+#include <l4/env/errno.h>
+#include <l4/util/bitops.h>
+#include <l4/util/macros.h>
+
+/* Lib includes */
+#include <l4/semaphore/semaphore.h>
+#include "__config.h"
+#include "__debug.h"
+
+#define KSEM_WORDS \
+  ((L4SEMAPHORE_MAX_KSEM + L4_MWORD_BITS - 1) / L4_MWORD_BITS)
+
+/* allocated kernel semaphores */
+static l4_umword_t ksem_map[KSEM_WORDS];
+
+/* kernel support: 0 not yet checked, 1 available, -1 not available */
+static int ksem_avail = 0;
+
+/*****************************************************************************/
+/**
+ * \brief  Allocate kernel semaphore index
+ *
+ * \return Index, 0 if none available
+ */
+/*****************************************************************************/
+static unsigned long
+__alloc_ksem(void)
+{
+  int i;
+
+  for (i = 0; i < L4SEMAPHORE_MAX_KSEM; i++)
+    {
+      if (l4util_test_bit(i % L4_MWORD_BITS, &ksem_map[i / L4_MWORD_BITS]))
+        continue;
+
+      /* bts is atomic, another thread might have been faster */
+      if (!l4util_test_and_set_bit(i % L4_MWORD_BITS,
+                                   &ksem_map[i / L4_MWORD_BITS]))
+        return L4SEMAPHORE_KSEM_BASE + i;
+    }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Release kernel semaphore index
+ *
+ * \param  ksem          Index
+ */
+/*****************************************************************************/
+static void
+__free_ksem(unsigned long ksem)
+{
+  int i = ksem - L4SEMAPHORE_KSEM_BASE;
+
+  l4util_clear_bit(i % L4_MWORD_BITS, &ksem_map[i / L4_MWORD_BITS]);
+}
+
+/*****************************************************************************
+ *** API functions
+ *****************************************************************************/
+
+/*****************************************************************************/
+/**
+ * \brief  Initialize semaphore, use kernel semaphore to block
+ * \ingroup api_sem
+ *
+ * \param  sem           Semaphore structure
+ * \param  count         Initial value for semaphore counter
+ *
+ * \return 0 on success, error code otherwise
+ */
+/*****************************************************************************/
+int
+l4semaphore_init_ksem(l4semaphore_t * sem, int count)
+{
+  unsigned long ksem;
+
+  *sem = L4SEMAPHORE_INIT(count);
+
+  if (ksem_avail == 0)
+    ksem_avail = l4sigma0_kip_kernel_has_feature("usemaphore") ? 1 : -1;
+  if (ksem_avail < 0)
+    return -L4_ENOTSUPP;
+
+  ksem = __alloc_ksem();
+  if (ksem == 0)
+    {
+      LOGdL(DEBUG_KSEM, "no kernel semaphore left");
+      return -L4_ENOMEM;
+    }
+
+  if (l4_usem_new(ksem, count, &sem->usem) != 0)
+    {
+      LOGdL(DEBUG_ERRORS, "L4semaphore: creating kernel semaphore %lu failed",
+            ksem);
+      __free_ksem(ksem);
+      return -L4_ENOMEM;
+    }
+
+  sem->spin = L4SEMAPHORE_KSEM_SPIN_INIT;
+  sem->ksem = ksem;
+
+  LOGdL(DEBUG_KSEM, "sem %p, kernel semaphore %lu", sem, ksem);
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Release kernel semaphore of a semaphore
+ * \ingroup api_sem
+ *
+ * \param  sem           Semaphore structure
+ */
+/*****************************************************************************/
+void
+l4semaphore_free(l4semaphore_t * sem)
+{
+  l4_fpage_t fp;
+  unsigned long ksem = sem->ksem;
+
+  if (ksem == 0)
+    return;
+
+  sem->ksem = 0;
+
+  /* unmapping the kernel object destroys it, blocked threads return */
+  fp = l4_iofpage(ksem, 0, 0);
+  fp.iofp.zero2 = 2;
+  l4_fpage_unmap(fp, L4_FP_ALL_SPACES);
+
+  __free_ksem(ksem);
+}
@@ -0,0 +1,158 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   thread/examples/pool/main.c
+ * \brief  Thread pool test and benchmark
+ *
+ * \date   10/19/2026
+ *
+ * Runs a parallel loop over an array and a recursive task tree with
+ * futures, compares the loop with the sequential version.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+/* L4 includes */
+#include <l4/sys/types.h>
+#include <l4/util/macros.h>
+#include <l4/util/rdtsc.h>
+#include <l4/log/l4log.h>
+#include <l4/env/errno.h>
+#include <l4/thread/thread.h>
+#include <l4/thread/pool.h>
+
+char LOG_tag[9] = "pooltest";
+
+#define ARRAY_SIZE  (256 * 1024)
+#define FIB_N       18
+#define FIB_CUTOFF  8
+
+static l4_uint32_t array[ARRAY_SIZE];
+static l4thread_pool_t pool;
+
+/*****************************************************************************/
+/**
+ * \brief  Loop body, some arithmetic per element
+ */
+/*****************************************************************************/
+static void
+scale(l4_umword_t begin, l4_umword_t end, void * arg)
+{
+  l4_umword_t i;
+  int k;
+
+  for (i = begin; i < end; i++)
+    for (k = 0; k < 16; k++)
+      array[i] = array[i] * 1103515245 + 12345;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Recursive task tree
+ */
+/*****************************************************************************/
+typedef struct fib_arg
+{
+  int n;
+  int res;
+} fib_arg_t;
+
+static int
+fib_seq(int n)
+{
+  return (n < 2) ? n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+static void
+fib_task(void * data)
+{
+  fib_arg_t * f = data;
+  fib_arg_t a, b;
+  l4thread_future_t future;
+
+  if (f->n < FIB_CUTOFF)
+    {
+      f->res = fib_seq(f->n);
+      return;
+    }
+
+  a.n = f->n - 1;
+  b.n = f->n - 2;
+  l4thread_future_init(&future, 2);
+  l4thread_pool_submit(&pool, fib_task, &a, &future);
+  l4thread_pool_submit(&pool, fib_task, &b, &future);
+  l4thread_future_wait(&pool, &future);
+
+  f->res = a.res + b.res;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Main
+ */
+/*****************************************************************************/
+int
+main(void)
+{
+  l4_cpu_time_t start, seq, par;
+  l4_uint32_t check;
+  l4thread_future_t future;
+  fib_arg_t f;
+  int i, num, ret;
+
+  l4_calibrate_tsc();
+
+  for (num = 1; num <= 8; num *= 2)
+    {
+      ret = l4thread_pool_create(&pool, num, L4THREAD_DEFAULT_PRIO);
+      if (ret < 0)
+        Panic("create pool failed: %s (%d)", l4env_errstr(ret), ret);
+
+      /* sequential reference */
+      for (i = 0; i < ARRAY_SIZE; i++)
+        array[i] = i;
+      start = l4_rdtsc();
+      scale(0, ARRAY_SIZE, NULL);
+      seq = l4_rdtsc() - start;
+      check = 0;
+      for (i = 0; i < ARRAY_SIZE; i++)
+        check ^= array[i];
+
+      /* parallel loop */
+      for (i = 0; i < ARRAY_SIZE; i++)
+        array[i] = i;
+      start = l4_rdtsc();
+      l4thread_pool_for(&pool, 0, ARRAY_SIZE, 0, scale, NULL);
+      par = l4_rdtsc() - start;
+      for (i = 0; i < ARRAY_SIZE; i++)
+        check ^= array[i];
+      if (check != 0)
+        LOG_Error("parallel loop result differs!");
+
+      LOG_printf("%d workers: loop seq %u us, par %u us\n", num,
+                 (unsigned)(l4_tsc_to_ns(seq) / 1000),
+                 (unsigned)(l4_tsc_to_ns(par) / 1000));
+
+      /* task tree, waited for from outside the pool */
+      f.n = FIB_N;
+      l4thread_future_init(&future, 1);
+      start = l4_rdtsc();
+      l4thread_pool_submit(&pool, fib_task, &f, &future);
+      l4thread_future_wait(&pool, &future);
+      par = l4_rdtsc() - start;
+      if (f.res != fib_seq(FIB_N))
+        LOG_Error("fib(%d) = %d, expected %d", FIB_N, f.res, fib_seq(FIB_N));
+
+      LOG_printf("%d workers: fib(%d) %u us\n", num, FIB_N,
+                 (unsigned)(l4_tsc_to_ns(par) / 1000));
+
+      l4thread_pool_destroy(&pool);
+    }
+
+  LOG("done.");
+  return 0;
+}
@@ -0,0 +1,256 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   thread/include/l4/thread/pool.h
+ * \brief  Thread pool with work stealing, public API
+ *
+ * \date   10/19/2026
+ *
+ * A thread pool keeps a fixed set of worker threads which are created once
+ * by l4thread_pool_create(). Each worker owns a deque of tasks: it pushes
+ * and pops tasks at the bottom, idle workers steal the oldest task from the
+ * top of another worker's deque. Tasks submitted by threads outside the
+ * pool go to a shared injection queue. Idle workers block in an IPC receive
+ * and are woken up by the submitter.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+/* L4 includes */
+#include <l4/sys/types.h>
+#include <l4/sys/l4int.h>
+#include <l4/env/cdefs.h>
+#include <l4/util/lock.h>
+#include <l4/thread/thread.h>
+
+/*****************************************************************************
+ *** defines
+ *****************************************************************************/
+
+#define L4THREAD_POOL_MAX_WORKERS  16         /**< \ingroup api_pool
+					       **  max. number of workers
+					       **/
+#define L4THREAD_POOL_DEQUE_SIZE   256        /**< \ingroup api_pool
+					       **  tasks per deque
+					       **/
+
+/*****************************************************************************
+ *** data types
+ *****************************************************************************/
+
+/**
+ * Task function type.
+ * \ingroup api_pool
+ *
+ * \param   arg          Argument pointer passed on submission
+ */
+typedef L4_CV void (* l4thread_pool_fn_t) (void * arg);
+
+/**
+ * Range function type for l4thread_pool_for().
+ * \ingroup api_pool
+ *
+ * \param   begin        First index of the chunk
+ * \param   end          First index after the chunk
+ * \param   arg          Argument pointer passed to l4thread_pool_for()
+ */
+typedef L4_CV void (* l4thread_pool_range_fn_t) (l4_umword_t begin,
+                                                 l4_umword_t end,
+                                                 void * arg);
+
+/**
+ * Future, tracks completion of one or more tasks.
+ * \ingroup api_pool
+ *
+ * Initialize with l4thread_future_init(), the storage must stay valid
+ * until l4thread_future_wait() returned.
+ */
+typedef struct l4thread_future
+{
+  volatile l4_uint32_t pending;  ///< number of unfinished tasks
+  volatile l4_uint32_t wait;     ///< waiter state
+  l4_threadid_t        waiter;   ///< thread blocked in l4thread_future_wait()
+} l4thread_future_t;
+
+/**
+ * Deque entry
+ * \internal
+ */
+typedef struct l4thread_pool_task
+{
+  l4thread_pool_fn_t  fn;        ///< task function
+  void *              arg;       ///< argument
+  l4thread_future_t * future;    ///< future to signal, may be NULL
+} l4thread_pool_task_t;
+
+/**
+ * Task deque, the owner works at bottom, thieves take from top
+ * \internal
+ */
+typedef struct l4thread_pool_deque
+{
+  l4util_simple_lock_t lock;     ///< deque lock
+  l4_uint32_t          top;      ///< oldest task
+  l4_uint32_t          bottom;   ///< next free slot
+  l4thread_pool_task_t tasks[L4THREAD_POOL_DEQUE_SIZE];
+} l4thread_pool_deque_t;
+
+struct l4thread_pool;
+
+/**
+ * Worker descriptor
+ * \internal
+ */
+typedef struct l4thread_pool_worker
+{
+  struct l4thread_pool *  pool;  ///< pool the worker belongs to
+  l4thread_t              id;    ///< worker thread
+  l4_threadid_t           l4_id; ///< L4 id of the worker thread
+  volatile l4_uint32_t    idle;  ///< worker blocks in receive
+  unsigned                victim;///< next worker to steal from
+  l4thread_pool_deque_t   deque; ///< task deque
+} l4thread_pool_worker_t;
+
+/**
+ * Thread pool
+ * \ingroup api_pool
+ */
+typedef struct l4thread_pool
+{
+  int                    num;          ///< number of workers
+  volatile int           shutdown;     ///< pool is shutting down
+  l4thread_pool_deque_t  inject;       ///< tasks from non-pool threads
+  l4thread_pool_worker_t workers[L4THREAD_POOL_MAX_WORKERS];
+} l4thread_pool_t;
+
+/*****************************************************************************
+ *** prototypes
+ *****************************************************************************/
+
+__BEGIN_DECLS;
+
+/*****************************************************************************/
+/**
+ * \brief   Create thread pool
+ * \ingroup api_pool
+ *
+ * \param   pool         Pool descriptor
+ * \param   num          Number of worker threads,
+ *                       1 .. #L4THREAD_POOL_MAX_WORKERS
+ * \param   prio         Worker priority, #L4THREAD_DEFAULT_PRIO to use the
+ *                       default priority
+ *
+ * \return  0 on success, error code otherwise:
+ *          - -#L4_EINVAL    invalid number of workers
+ *          - -#L4_ENOTHREAD no thread available
+ */
+/*****************************************************************************/
+L4_CV int
+l4thread_pool_create(l4thread_pool_t * pool, int num, l4_prio_t prio);
+
+/*****************************************************************************/
+/**
+ * \brief   Shutdown thread pool
+ * \ingroup api_pool
+ *
+ * \param   pool         Pool descriptor
+ *
+ * Tasks which are still queued are not executed.
+ */
+/*****************************************************************************/
+L4_CV void
+l4thread_pool_destroy(l4thread_pool_t * pool);
+
+/*****************************************************************************/
+/**
+ * \brief   Submit task
+ * \ingroup api_pool
+ *
+ * \param   pool         Pool descriptor
+ * \param   fn           Task function
+ * \param   arg          Task argument
+ * \param   future       Future to signal on completion, initialized by
+ *                       l4thread_future_init(). May be NULL.
+ *
+ * If called by a worker, the task is pushed to the worker's own deque,
+ * otherwise to the injection queue of the pool. If the queue is full, the
+ * task is executed by the caller.
+ */
+/*****************************************************************************/
+L4_CV void
+l4thread_pool_submit(l4thread_pool_t * pool, l4thread_pool_fn_t fn,
+                     void * arg, l4thread_future_t * future);
+
+/*****************************************************************************/
+/**
+ * \brief   Parallel loop
+ * \ingroup api_pool
+ *
+ * \param   pool         Pool descriptor
+ * \param   begin        First index
+ * \param   end          First index after the range
+ * \param   grain        Max. number of indices per task, 0 to choose
+ *                       based on the number of workers
+ * \param   fn           Range function
+ * \param   arg          Argument passed to \a fn
+ *
+ * Split [begin, end) into chunks of at most \a grain indices, run them in
+ * the pool and wait until all chunks are done.
+ */
+/*****************************************************************************/
+L4_CV void
+l4thread_pool_for(l4thread_pool_t * pool, l4_umword_t begin, l4_umword_t end,
+                  l4_umword_t grain, l4thread_pool_range_fn_t fn, void * arg);
+
+/*****************************************************************************/
+/**
+ * \brief   Initialize future
+ * \ingroup api_pool
+ *
+ * \param   future       Future
+ * \param   count        Number of tasks which will signal the future
+ */
+/*****************************************************************************/
+L4_CV void
+l4thread_future_init(l4thread_future_t * future, int count);
+
+/*****************************************************************************/
+/**
+ * \brief   Check whether all tasks of a future are done
+ * \ingroup api_pool
+ *
+ * \param   future       Future
+ *
+ * \return  1 if done, 0 otherwise
+ */
+/*****************************************************************************/
+L4_CV int
+l4thread_future_done(l4thread_future_t * future);
+
+/*****************************************************************************/
+/**
+ * \brief   Wait for a future
+ * \ingroup api_pool
+ *
+ * \param   pool         Pool the tasks were submitted to
+ * \param   future       Future
+ *
+ * A worker of \a pool executes other tasks while waiting. Other threads
+ * block in an IPC receive until the last task signals the future. Such a
+ * thread must not expect other IPC while waiting, server threads should
+ * use l4thread_pool_defer() instead.
+ */
+/*****************************************************************************/
+L4_CV void
+l4thread_future_wait(l4thread_pool_t * pool, l4thread_future_t * future);
+
+__END_DECLS;
+
+#endif /* !_THREAD_POOL_H */
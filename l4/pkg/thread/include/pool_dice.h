@@ -0,0 +1,79 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   thread/include/l4/thread/pool_dice.h
+ * \brief  Hand DICE server requests to a thread pool
+ *
+ * \date   10/19/2026
+ *
+ * Usage: the server interface inherits from l4thread::pool_completion
+ * (<l4/thread/pool.idl>), the deferred operation is declared
+ * [allow_reply_only]. Its component function calls l4thread_pool_defer(),
+ * which suppresses the reply of the server loop. The work function runs
+ * in a pool worker, afterwards the reply function runs in the server loop
+ * thread and sends the reply using the generated *_reply() stub.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+#ifndef _THREAD_POOL_DICE_H
+#define _THREAD_POOL_DICE_H
+
+#include <dice/dice.h>
+#include <l4/thread/pool.h>
+
+/**
+ * Reply function type, called in the server loop thread.
+ * \ingroup api_pool
+ *
+ * \param   client       Client which sent the request
+ * \param   arg          Argument pointer passed to l4thread_pool_defer()
+ */
+typedef L4_CV void (* l4thread_pool_reply_fn_t) (CORBA_Object client,
+                                                 void * arg);
+
+/**
+ * Deferred request, the storage must stay valid until the reply function
+ * was called.
+ * \ingroup api_pool
+ */
+typedef struct l4thread_pool_job
+{
+  l4thread_pool_fn_t       fn;      ///< work function, runs in a worker
+  l4thread_pool_reply_fn_t reply;   ///< reply function, runs in server loop
+  void *                   arg;     ///< argument for fn and reply
+  CORBA_Object_base        client;  ///< client to reply to
+  l4_threadid_t            server;  ///< server loop thread
+} l4thread_pool_job_t;
+
+__BEGIN_DECLS;
+
+/*****************************************************************************/
+/**
+ * \brief   Defer a request to the thread pool
+ * \ingroup api_pool
+ *
+ * \param   pool         Pool descriptor
+ * \param   job          Job descriptor
+ * \param   client       Client (_dice_corba_obj of the component function)
+ * \param   _dice_reply  Reply flag of the component function
+ * \param   fn           Work function
+ * \param   reply        Reply function
+ * \param   arg          Argument passed to \a fn and \a reply
+ *
+ * Must be called by the server loop thread from a component function.
+ */
+/*****************************************************************************/
+L4_CV void
+l4thread_pool_defer(l4thread_pool_t * pool, l4thread_pool_job_t * job,
+                    CORBA_Object client, l4_int16_t * _dice_reply,
+                    l4thread_pool_fn_t fn, l4thread_pool_reply_fn_t reply,
+                    void * arg);
+
+__END_DECLS;
+
+#endif /* !_THREAD_POOL_DICE_H */
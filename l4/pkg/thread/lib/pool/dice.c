@@ -0,0 +1,101 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   thread/lib/pool/dice.c
+ * \brief  Hand DICE server requests to a thread pool
+ *
+ * \date   10/19/2026
+ *
+ * A reply must be sent by the thread the client called. The worker
+ * therefore reports the finished job to the server loop thread with a
+ * oneway pool_completion::done message, the server loop calls the reply
+ * function of the job.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+/* L4/L4Env includes */
+#include <l4/sys/types.h>
+#include <l4/util/macros.h>
+
+/* library includes */
+#include <l4/thread/pool_dice.h>
+#include "pool-client.h"
+#include "pool-server.h"
+
+/*****************************************************************************/
+/**
+ * \brief  Job wrapper, runs in a pool worker
+ */
+/*****************************************************************************/
+static void
+__job_task(void * data)
+{
+  l4thread_pool_job_t * job = data;
+  CORBA_Environment env = dice_default_environment;
+
+  job->fn(job->arg);
+
+  l4thread_pool_completion_done_send(&job->server, (l4_addr_t)job, &env);
+}
+
+/*****************************************************************************
+ *** API functions
+ *****************************************************************************/
+
+/*****************************************************************************/
+/**
+ * \brief  Defer a request to the thread pool
+ *
+ * \param  pool          Pool descriptor
+ * \param  job           Job descriptor
+ * \param  client        Client
+ * \param  _dice_reply   Reply flag of the component function
+ * \param  fn            Work function
+ * \param  reply         Reply function
+ * \param  arg           Argument
+ */
+/*****************************************************************************/
+void
+l4thread_pool_defer(l4thread_pool_t * pool, l4thread_pool_job_t * job,
+                    CORBA_Object client, l4_int16_t * _dice_reply,
+                    l4thread_pool_fn_t fn, l4thread_pool_reply_fn_t reply,
+                    void * arg)
+{
+  job->fn = fn;
+  job->reply = reply;
+  job->arg = arg;
+  job->client = *client;
+  job->server = l4_myself();
+
+  *_dice_reply = DICE_NO_REPLY;
+  l4thread_pool_submit(pool, __job_task, job, NULL);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Deferred job finished, send reply
+ */
+/*****************************************************************************/
+void
+l4thread_pool_completion_done_component(CORBA_Object _dice_corba_obj,
+                                        l4_addr_t job,
+                                        CORBA_Server_Environment *
+                                        _dice_corba_env)
+{
+  l4thread_pool_job_t * j = (l4thread_pool_job_t *)job;
+
+  /* only our own workers may complete jobs */
+  if (!l4_task_equal(*_dice_corba_obj, l4_myself()))
+    {
+      LOG_Error("completion from foreign task "l4util_idfmt,
+                l4util_idstr(*_dice_corba_obj));
+      return;
+    }
+
+  j->reply(&j->client, j->arg);
+}
@@ -0,0 +1,622 @@
+/* $Id$ */
+/*****************************************************************************/
+/**
+ * \file   thread/lib/pool/pool.c
+ * \brief  Thread pool with per-worker deques and work stealing
+ *
+ * \date   10/19/2026
+ *
+ * Each worker pops tasks from the bottom of its own deque. If it is empty,
+ * the worker takes tasks from the injection queue of the pool and then
+ * tries to steal the oldest task of the other workers. If no task is
+ * found, the worker marks itself idle and blocks in an open receive.
+ *
+ * Wakeup protocol: a waker claims an idle worker by changing its idle flag
+ * from 1 to 0 and then sends a short IPC. A worker which finds new work
+ * after setting its idle flag tries the same transition itself, if this
+ * fails it was claimed and must receive the wakeup IPC. Futures use the
+ * same scheme for threads outside the pool.
+ */
+/*****************************************************************************/
+
+/* (c) 2026 Technische Universitaet Dresden
+ * This file is part of DROPS, which is distributed under the terms of the
+ * GNU General Public License 2. Please see the COPYING file for details.
+ */
+
+/* L4/L4Env includes */
+#include <l4/sys/types.h>
+#include <l4/sys/ipc.h>
+#include <l4/sys/syscalls.h>
+#include <l4/env/errno.h>
+#include <l4/util/atomic.h>
+#include <l4/util/lock.h>
+#include <l4/util/macros.h>
+
+/* library includes */
+#include <l4/thread/thread.h>
+#include <l4/thread/pool.h>
+
+/* future waiter states */
+#define FUTURE_NONE     0
+#define FUTURE_WAITING  1
+#define FUTURE_WOKEN    2
+
+/* thread data key to find the worker descriptor of the current thread */
+static int worker_key = -1;
+
+/*****************************************************************************
+ *** deque
+ *****************************************************************************/
+
+/*****************************************************************************/
+/**
+ * \brief  Initialize deque
+ */
+/*****************************************************************************/
+static void
+__deque_init(l4thread_pool_deque_t * d)
+{
+  l4_simple_unlock(&d->lock);
+  d->top = d->bottom = 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Push task to bottom of deque
+ *
+ * \return 0 on success, -1 if deque is full
+ */
+/*****************************************************************************/
+static int
+__deque_push(l4thread_pool_deque_t * d, l4thread_pool_task_t * t)
+{
+  l4_simple_lock(&d->lock);
+  if (d->bottom - d->top == L4THREAD_POOL_DEQUE_SIZE)
+    {
+      l4_simple_unlock(&d->lock);
+      return -1;
+    }
+  d->tasks[d->bottom % L4THREAD_POOL_DEQUE_SIZE] = *t;
+  d->bottom++;
+  l4_simple_unlock(&d->lock);
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Pop newest task from bottom of deque (owner)
+ *
+ * \return 1 if task returned, 0 if deque is empty
+ */
+/*****************************************************************************/
+static int
+__deque_pop(l4thread_pool_deque_t * d, l4thread_pool_task_t * t)
+{
+  if (d->bottom == d->top)
+    return 0;
+
+  l4_simple_lock(&d->lock);
+  if (d->bottom == d->top)
+    {
+      l4_simple_unlock(&d->lock);
+      return 0;
+    }
+  d->bottom--;
+  *t = d->tasks[d->bottom % L4THREAD_POOL_DEQUE_SIZE];
+  l4_simple_unlock(&d->lock);
+
+  return 1;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Steal oldest task from top of deque
+ *
+ * \return 1 if task returned, 0 if deque is empty
+ */
+/*****************************************************************************/
+static int
+__deque_steal(l4thread_pool_deque_t * d, l4thread_pool_task_t * t)
+{
+  if (d->bottom == d->top)
+    return 0;
+
+  l4_simple_lock(&d->lock);
+  if (d->bottom == d->top)
+    {
+      l4_simple_unlock(&d->lock);
+      return 0;
+    }
+  *t = d->tasks[d->top % L4THREAD_POOL_DEQUE_SIZE];
+  d->top++;
+  l4_simple_unlock(&d->lock);
+
+  return 1;
+}
+
+/*****************************************************************************
+ *** helpers
+ *****************************************************************************/
+
+/*****************************************************************************/
+/**
+ * \brief  Return worker descriptor of current thread
+ *
+ * \return Worker descriptor, NULL if the current thread is not a worker
+ *         of \a pool
+ */
+/*****************************************************************************/
+static inline l4thread_pool_worker_t *
+__current_worker(l4thread_pool_t * pool)
+{
+  l4thread_pool_worker_t * w;
+
+  if (worker_key < 0)
+    return NULL;
+
+  w = l4thread_data_get_current(worker_key);
+  return (w && w->pool == pool) ? w : NULL;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Check if the pool has queued tasks
+ */
+/*****************************************************************************/
+static int
+__has_work(l4thread_pool_t * pool)
+{
+  int i;
+
+  if (pool->inject.bottom != pool->inject.top)
+    return 1;
+  for (i = 0; i < pool->num; i++)
+    if (pool->workers[i].deque.bottom != pool->workers[i].deque.top)
+      return 1;
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Find task for worker: own deque, injection queue, steal
+ *
+ * \return 1 if task found, 0 otherwise
+ */
+/*****************************************************************************/
+static int
+__get_task(l4thread_pool_worker_t * w, l4thread_pool_task_t * t)
+{
+  l4thread_pool_t * pool = w->pool;
+  int i;
+
+  if (__deque_pop(&w->deque, t))
+    return 1;
+
+  if (__deque_steal(&pool->inject, t))
+    return 1;
+
+  for (i = 0; i < pool->num; i++)
+    {
+      l4thread_pool_worker_t * v = &pool->workers[w->victim];
+
+      w->victim = (w->victim + 1) % pool->num;
+      if (v != w && __deque_steal(&v->deque, t))
+        return 1;
+    }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Send wakeup IPC
+ */
+/*****************************************************************************/
+static void
+__wakeup(l4_threadid_t t)
+{
+  l4_msgdope_t result;
+  int ret;
+
+  do
+    ret = l4_ipc_send(t, L4_IPC_SHORT_MSG, 0, 0, L4_IPC_NEVER, &result);
+  while (ret == L4_IPC_SECANCELED);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Wait for wakeup IPC from a thread of our task
+ */
+/*****************************************************************************/
+static void
+__wait_wakeup(volatile l4_uint32_t * flag, l4_uint32_t value)
+{
+  l4_threadid_t src;
+  l4_umword_t dw0, dw1;
+  l4_msgdope_t result;
+  int ret;
+
+  do
+    ret = l4_ipc_wait(&src, L4_IPC_SHORT_MSG, &dw0, &dw1,
+                      L4_IPC_NEVER, &result);
+  while (ret || !l4_task_equal(src, l4_myself()) || *flag != value);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Wakeup one idle worker
+ */
+/*****************************************************************************/
+static void
+__wakeup_worker(l4thread_pool_t * pool)
+{
+  l4_uint32_t barrier;
+  int i;
+
+  /* full barrier: the pushed task must be visible before we read the idle
+   * flags, pairs with setting the idle flag in __worker_thread() */
+  l4util_xchg32(&barrier, 0);
+
+  for (i = 0; i < pool->num; i++)
+    {
+      l4thread_pool_worker_t * w = &pool->workers[i];
+
+      if (w->idle && l4util_cmpxchg32(&w->idle, 1, 0))
+        {
+          __wakeup(w->l4_id);
+          return;
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Signal completion of one task to a future
+ */
+/*****************************************************************************/
+static void
+__future_signal(l4thread_future_t * f)
+{
+  if (l4util_sub32_res(&f->pending, 1) != 0)
+    return;
+
+  if (l4util_cmpxchg32(&f->wait, FUTURE_WAITING, FUTURE_WOKEN))
+    __wakeup(f->waiter);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Execute task
+ */
+/*****************************************************************************/
+static inline void
+__run_task(l4thread_pool_task_t * t)
+{
+  t->fn(t->arg);
+  if (t->future)
+    __future_signal(t->future);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Worker thread
+ */
+/*****************************************************************************/
+static void
+__worker_thread(void * data)
+{
+  l4thread_pool_worker_t * w = data;
+  l4thread_pool_t * pool = w->pool;
+  l4thread_pool_task_t t;
+
+  l4thread_data_set_current(worker_key, w);
+
+  while (!pool->shutdown)
+    {
+      if (__get_task(w, &t))
+        {
+          __run_task(&t);
+          continue;
+        }
+
+      /* nothing to do, go idle. Use xchg as full barrier, the idle flag
+       * must be visible before we look for work again. */
+      l4util_xchg32(&w->idle, 1);
+      if ((__has_work(pool) || pool->shutdown) &&
+          l4util_cmpxchg32(&w->idle, 1, 0))
+        continue;
+
+      __wait_wakeup(&w->idle, 0);
+    }
+}
+
+/*****************************************************************************
+ *** API functions
+ *****************************************************************************/
+
+/*****************************************************************************/
+/**
+ * \brief  Create thread pool
+ *
+ * \param  pool          Pool descriptor
+ * \param  num           Number of workers
+ * \param  prio          Worker priority
+ *
+ * \return 0 on success, error code otherwise.
+ */
+/*****************************************************************************/
+int
+l4thread_pool_create(l4thread_pool_t * pool, int num, l4_prio_t prio)
+{
+  int i;
+  l4thread_t t;
+
+  if (num < 1 || num > L4THREAD_POOL_MAX_WORKERS)
+    return -L4_EINVAL;
+
+  if (worker_key < 0)
+    {
+      worker_key = l4thread_data_allocate_key();
+      if (worker_key < 0)
+        return worker_key;
+    }
+
+  pool->num = 0;
+  pool->shutdown = 0;
+  __deque_init(&pool->inject);
+
+  for (i = 0; i < num; i++)
+    {
+      l4thread_pool_worker_t * w = &pool->workers[i];
+
+      w->pool = pool;
+      w->idle = 0;
+      w->victim = (i + 1) % num;
+      __deque_init(&w->deque);
+    }
+
+  for (i = 0; i < num; i++)
+    {
+      l4thread_pool_worker_t * w = &pool->workers[i];
+
+      t = l4thread_create_long(L4THREAD_INVALID_ID, __worker_thread, ".pool",
+                               L4THREAD_INVALID_SP, L4THREAD_DEFAULT_SIZE,
+                               prio, w, L4THREAD_CREATE_ASYNC);
+      if (t < 0)
+        {
+          LOG_Error("create worker %d failed: %s (%d)", i, l4env_errstr(t), t);
+          l4thread_pool_destroy(pool);
+          return t;
+        }
+
+      w->id = t;
+      w->l4_id = l4thread_l4_id(t);
+      pool->num++;
+    }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Shutdown thread pool
+ *
+ * \param  pool          Pool descriptor
+ */
+/*****************************************************************************/
+void
+l4thread_pool_destroy(l4thread_pool_t * pool)
+{
+  int i;
+
+  pool->shutdown = 1;
+  for (i = 0; i < pool->num; i++)
+    {
+      l4thread_pool_worker_t * w = &pool->workers[i];
+
+      if (l4util_cmpxchg32(&w->idle, 1, 0))
+        __wakeup(w->l4_id);
+      l4thread_shutdown(w->id);
+    }
+  pool->num = 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Submit task
+ *
+ * \param  pool          Pool descriptor
+ * \param  fn            Task function
+ * \param  arg           Task argument
+ * \param  future        Future to signal on completion, may be NULL
+ */
+/*****************************************************************************/
+void
+l4thread_pool_submit(l4thread_pool_t * pool, l4thread_pool_fn_t fn,
+                     void * arg, l4thread_future_t * future)
+{
+  l4thread_pool_worker_t * w = __current_worker(pool);
+  l4thread_pool_task_t t;
+
+  t.fn = fn;
+  t.arg = arg;
+  t.future = future;
+
+  if (__deque_push(w ? &w->deque : &pool->inject, &t) < 0)
+    {
+      /* queue full, do it ourselves */
+      __run_task(&t);
+      return;
+    }
+
+  __wakeup_worker(pool);
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Initialize future
+ *
+ * \param  future        Future
+ * \param  count         Number of tasks
+ */
+/*****************************************************************************/
+void
+l4thread_future_init(l4thread_future_t * future, int count)
+{
+  future->pending = count;
+  future->wait = FUTURE_NONE;
+  future->waiter = L4_INVALID_ID;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Check whether all tasks of a future are done
+ *
+ * \param  future        Future
+ *
+ * \return 1 if done, 0 otherwise
+ */
+/*****************************************************************************/
+int
+l4thread_future_done(l4thread_future_t * future)
+{
+  return future->pending == 0;
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Wait for a future
+ *
+ * \param  pool          Pool descriptor
+ * \param  future        Future
+ */
+/*****************************************************************************/
+void
+l4thread_future_wait(l4thread_pool_t * pool, l4thread_future_t * future)
+{
+  l4thread_pool_worker_t * w = __current_worker(pool);
+  l4thread_pool_task_t t;
+
+  if (w)
+    {
+      /* worker: help while waiting, blocking might deadlock the pool */
+      while (future->pending)
+        {
+          if (__get_task(w, &t))
+            __run_task(&t);
+          else
+            l4_thread_switch(L4_NIL_ID);
+        }
+      return;
+    }
+
+  if (future->pending == 0)
+    return;
+
+  future->waiter = l4_myself();
+  /* full barrier, the flag must be visible before we read pending */
+  l4util_xchg32(&future->wait, FUTURE_WAITING);
+
+  /* last task might have finished before we set the waiting flag */
+  if (future->pending == 0 &&
+      l4util_cmpxchg32(&future->wait, FUTURE_WAITING, FUTURE_NONE))
+    return;
+
+  __wait_wakeup(&future->wait, FUTURE_WOKEN);
+  future->wait = FUTURE_NONE;
+}
+
+/*****************************************************************************
+ *** parallel for
+ *****************************************************************************/
+
+/**
+ * Shared loop descriptor, chunks are handed out by an atomic counter
+ */
+typedef struct pool_for
+{
+  volatile l4_umword_t     next;   ///< first index of next chunk
+  l4_umword_t              end;    ///< end of range
+  l4_umword_t              grain;  ///< chunk size
+  l4thread_pool_range_fn_t fn;     ///< range function
+  void *                   arg;    ///< argument
+} pool_for_t;
+
+/*****************************************************************************/
+/**
+ * \brief  Loop task, process chunks until the range is exhausted
+ */
+/*****************************************************************************/
+static void
+__for_task(void * data)
+{
+  pool_for_t * f = data;
+  l4_umword_t cur, nxt;
+
+  while (1)
+    {
+      do
+        {
+          cur = f->next;
+          if (cur >= f->end)
+            return;
+          nxt = (f->end - cur > f->grain) ? cur + f->grain : f->end;
+        }
+      while (!l4util_cmpxchg(&f->next, cur, nxt));
+
+      f->fn(cur, nxt, f->arg);
+    }
+}
+
+/*****************************************************************************/
+/**
+ * \brief  Parallel loop
+ *
+ * \param  pool          Pool descriptor
+ * \param  begin         First index
+ * \param  end           First index after the range
+ * \param  grain         Max. number of indices per chunk, 0 for default
+ * \param  fn            Range function
+ * \param  arg           Argument passed to \a fn
+ */
+/*****************************************************************************/
+void
+l4thread_pool_for(l4thread_pool_t * pool, l4_umword_t begin, l4_umword_t end,
+                  l4_umword_t grain, l4thread_pool_range_fn_t fn, void * arg)
+{
+  pool_for_t f;
+  l4thread_future_t future;
+  int i, tasks;
+
+  if (begin >= end)
+    return;
+
+  if (grain == 0)
+    {
+      /* about four chunks per worker for load balancing */
+      grain = (end - begin) / (pool->num * 4);
+      if (grain == 0)
+        grain = 1;
+    }
+
+  f.next = begin;
+  f.end = end;
+  f.grain = grain;
+  f.fn = fn;
+  f.arg = arg;
+
+  /* one task per worker, each one processes chunks until the range is
+   * exhausted */
+  tasks = (end - begin + grain - 1) / grain;
+  if (tasks > pool->num)
+    tasks = pool->num;
+
+  l4thread_future_init(&future, tasks);
+  for (i = 0; i < tasks; i++)
+    l4thread_pool_submit(pool, __for_task, &f, &future);
+
+  l4thread_future_wait(pool, &future);
+}
@@ -48,13 +48,17 @@ void *(*fastmemcpy_func) (void *to, const void *from, size_t len);
 #define DOPE_FMT 		VID_FMT_RAW
 #define DOPE_COLORSPACE 	VID_YUV420
 #define DOPE_CP_INIT_STR 	"vernervscr.setmode(%d,%d,\"YUV420\")"
+#define DOPE_BUFFERS		3	/* decoder never waits for the redraw */
 
 /* attr from/for DOpE */
 typedef struct
 {
   long app_id;			/* DOpE application id */
   void *vernervscr_id;		/* vscreen id */
-  u16 *scr_addr;		/* addr for shared mem */
+  u16 *scr_addr;		/* addr for shared mem (buffer to draw into) */
+  u16 *scr_buf[DOPE_BUFFERS];	/* frame buffers of the vscreen */
+  int num_bufs;			/* number of mapped frame buffers */
+  int back;			/* index of the buffer to draw into */
   int scr_width;		/* screen size */
   int scr_height;
   int xdim;			/* video size */
@@ -171,6 +175,7 @@ int
 vo_dope_init (plugin_ctrl_t * attr, stream_info_t * info)
 {
   char req_buf[16];		/* receive buffer for dope_req */
+  int i;
 
   if ((info->vi.xdim == 0) || (info->vi.ydim == 0))
   {
@@ -219,6 +224,7 @@ vo_dope_init (plugin_ctrl_t * attr, stream_info_t * info)
   /* open window with rt-widget */
   dope_cmd (gui_state.app_id, "vernerwin=new Window()");
   dope_cmd (gui_state.app_id, "vernervscr=new VScreen()");
+  dope_cmdf (gui_state.app_id, "vernervscr.set(-buffers %d)", DOPE_BUFFERS);
 
   /* set vscreen mode */
   dope_cmdf (gui_state.app_id, DOPE_CP_INIT_STR, info->vi.xdim,
@@ -244,8 +250,18 @@ vo_dope_init (plugin_ctrl_t * attr, stream_info_t * info)
   gui_state.vernervscr_id =
     vscr_get_server_id (gui_state.app_id, "vernervscr");
 
-  /* map vscreen buffer to local address space */
-  gui_state.scr_addr = vscr_get_fb (gui_state.app_id, "vernervscr");
+  /* map vscreen buffers to local address space */
+  for (i = 0; i < DOPE_BUFFERS; i++)
+  {
+    gui_state.scr_buf[i] = vscr_get_buffer (gui_state.app_id, "vernervscr", i);
+    if (!gui_state.scr_buf[i])
+      break;
+  }
+  gui_state.num_bufs = i;
+
+  /* buffer 0 is on screen, draw into the next one */
+  gui_state.back = (gui_state.num_bufs > 1) ? 1 : 0;
+  gui_state.scr_addr = gui_state.scr_buf[gui_state.back];
   if (!gui_state.scr_addr)
   {
     LOG_Error ("invalid address");
@@ -375,6 +391,17 @@ vo_dope_step (plugin_ctrl_t * attr, void *addr)
     gui_state.osd_frames_to_display--;
   }
 
+  /* hand the frame over to DOpE and continue with a free buffer */
+  if (gui_state.num_bufs > 1)
+  {
+    ret = vscr_server_publish (gui_state.vernervscr_id, gui_state.back);
+    if (ret >= 0 && ret < gui_state.num_bufs)
+    {
+      gui_state.back = ret;
+      gui_state.scr_addr = gui_state.scr_buf[ret];
+    }
+  }
+
   /* get end of waiting time */
   end = get_time_microsec ();
   attr->step_time_us = end - start;